@@ -5,35 +5,197 @@
 KrumpVSTAudioProcessor::KrumpVSTAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
-        .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-      apvts(*this, nullptr, "PARAMETERS", createParameterLayout())
+        .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+        .withInput("Sidechain", juce::AudioChannelSet::stereo(), false)),
+      apvts(*this, nullptr, "PARAMETERS", createParameterLayout(effectParameterPool, presetMorpher))
 {
+    effectParameterPool.setProcessor(this);
+    effectChain.setParameterPool(&effectParameterPool);
+    effectChain.setPresetMorpher(&presetMorpher);
+    effectChain.setModulationMatrix(&modulationMatrix);
+
+    // リバーブの値はスナップショットに含め、すべてのパラメータの操作終了で履歴を積む
+    for (int i = 0; i < ReverbParameters::numParameters; ++i)
+        if (auto* parameter = apvts.getParameter(getParameterId(static_cast<ReverbParameters::Index>(i))))
+            editHistory.trackParameter(*parameter);
+
+    for (auto* parameter : getParameters())
+        editHistory.listenForGestures(*parameter);
+
+    for (int i = 0; i < ReverbParameters::numParameters; ++i)
+        reverbParameterValues[static_cast<size_t>(i)] = apvts.getRawParameterValue(getParameterId(static_cast<ReverbParameters::Index>(i)));
 }
 
 KrumpVSTAudioProcessor::~KrumpVSTAudioProcessor()
 {
+    cancelPendingUpdate();
 }
 
 void KrumpVSTAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    reverbEffect.prepareToPlay(sampleRate, samplesPerBlock);
+    // DSP カーネルの命令セットは最初の prepareToPlay で CPU を見て1回だけ決まり、以下の prepare はその表を受け取る
+    DspKernels::getBest();
+
+    // チェーンとリバーブはサブブロック単位でしか呼ばれないので、その長さで準備する
+    const int subBlockSize = effectChain.getSubBlockScheduler().getMaximumBlockSize();
+    reverbEffect.prepareToPlay(sampleRate, subBlockSize, getChannelLayoutOfBus(false, 0));
+    samplerEngine.prepare(sampleRate, samplesPerBlock);
+    sidechainBuffer.setSize(maxSidechainChannels, samplesPerBlock);
+    chunkMidi.ensureSize(4096);
+    inputMeter.prepare(sampleRate);
+    outputMeter.prepare(sampleRate);
+    spectrumAnalyzer.prepare(sampleRate);
+    effectChain.prepare({ sampleRate,
+                          static_cast<juce::uint32>(samplesPerBlock),
+                          static_cast<juce::uint32>(getTotalNumOutputChannels()) });
+
+    updateReportedLatency();
 }
 
 void KrumpVSTAudioProcessor::releaseResources()
 {
     reverbEffect.reset();
+    effectChain.reset();
+    samplerEngine.releaseResources();
+}
+
+bool KrumpVSTAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    const auto output = layouts.getMainOutputChannelSet();
+    if (output != juce::AudioChannelSet::mono()
+        && output != juce::AudioChannelSet::stereo()
+        && output != juce::AudioChannelSet::create5point1()
+        && output != juce::AudioChannelSet::create7point1point4())
+        return false;
+
+    // サイドチェインは無効・モノ・ステレオのいずれか
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto sidechain = layouts.getChannelSet(true, 1);
+        if (!sidechain.isDisabled()
+            && sidechain != juce::AudioChannelSet::mono()
+            && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
+
+    const auto input = layouts.getMainInputChannelSet();
+    return input == output
+        || (input == juce::AudioChannelSet::mono() && output == juce::AudioChannelSet::stereo());
 }
 
 void KrumpVSTAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    reverbEffect.setRoomSize(apvts.getRawParameterValue("RoomSize")->load());
-    reverbEffect.setDamping(apvts.getRawParameterValue("Damping")->load());
-    reverbEffect.setWetLevel(apvts.getRawParameterValue("Wet")->load());
-    reverbEffect.setDryLevel(apvts.getRawParameterValue("Dry")->load());
-    reverbEffect.setWidth(apvts.getRawParameterValue("Width")->load());
-    reverbEffect.setFreezeMode(apvts.getRawParameterValue("Freeze")->load() > 0.5f);
-    reverbEffect.processBlock(buffer);
+    juce::ScopedNoDenormals noDenormals;
+
+    // サイドチェインの退避先はオーディオスレッドで確保し直さない。
+    // prepare 時より長いブロックは、その長さごとの区間に分けて順に処理する
+    const int numSamples = buffer.getNumSamples();
+    const int chunkSize = juce::jmax(1, sidechainBuffer.getNumSamples());
+    if (numSamples <= chunkSize)
+    {
+        processChunk(buffer, midiMessages);
+    }
+    else
+    {
+        for (int startSample = 0; startSample < numSamples; startSample += chunkSize)
+        {
+            const int chunkLength = juce::jmin(chunkSize, numSamples - startSample);
+            juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), startSample, chunkLength);
+            chunkMidi.clear();
+            chunkMidi.addEvents(midiMessages, startSample, chunkLength, -startSample);
+            processChunk(chunk, chunkMidi);
+        }
+    }
+
     midiMessages.clear();
+
+    // プリセットのロードやエフェクトのモード切り替えでレイテンシが変わった場合は、
+    // メッセージスレッドで補償遅延を作り直してからホストへ通知する
+    if (effectChain.isLatencyCompensationStale()
+        || effectChain.getProcessingLatencySamples() + reverbEffect.getLatencySamples() != reportedLatency.load())
+        triggerAsyncUpdate();
+}
+
+void KrumpVSTAudioProcessor::processChunk(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    // サイドチェインのチャンネルはメイン出力と重なることがある（モノ入力・ステレオ出力など）ので、
+    // 出力を書き換える前に退避しておく
+    const int numSamples = buffer.getNumSamples();
+    const auto sidechainInput = getBusBuffer(buffer, true, 1);
+    const int numSidechainChannels = juce::jmin(sidechainInput.getNumChannels(), sidechainBuffer.getNumChannels());
+    for (int ch = 0; ch < numSidechainChannels; ++ch)
+        sidechainBuffer.copyFrom(ch, 0, sidechainInput, ch, 0, numSamples);
+
+    // モノ入力・ステレオ出力では入力を両チャンネルへ広げてからステレオとして処理する。
+    // それ以外で入力より多い出力チャンネルは中身が不定なので消しておく
+    const int numInputChannels = getMainBusNumInputChannels();
+    const int numOutputChannels = getMainBusNumOutputChannels();
+    if (numInputChannels == 1 && numOutputChannels == 2)
+        buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+    else
+        for (int ch = numInputChannels; ch < numOutputChannels; ++ch)
+            buffer.clear(ch, 0, numSamples);
+
+    // 以降はメイン出力のチャンネルだけを扱う
+    auto mainBuffer = getBusBuffer(buffer, false, 0);
+
+    inputMeter.measureBlock(mainBuffer);
+    samplerEngine.process(mainBuffer, midiMessages);
+    spectrumAnalyzer.pushSamples(SpectrumAnalyzer::preFilter, mainBuffer);
+
+    // チェーンとリバーブは固定長のサブブロックごとに続けて通す（パラメータはサブブロックの境界で反映する）
+    effectChain.getSubBlockScheduler().process(mainBuffer, [this, numSidechainChannels](juce::AudioBuffer<float>& subBlock, int startSample)
+    {
+        effectChain.process(subBlock);
+
+        // チェーンの処理中に求めたモジュレーションをホストの値に足してからリバーブへ渡す
+        ReverbEffect::ParameterValues reverbValues;
+        for (size_t i = 0; i < reverbValues.size(); ++i)
+        {
+            const auto& descriptor = ReverbParameters::descriptors[i];
+            const float offset = modulationMatrix.getReverbOffset(static_cast<int>(i)) * (descriptor.maximum - descriptor.minimum);
+            reverbValues[i] = juce::jlimit(descriptor.minimum, descriptor.maximum,
+                                           reverbParameterValues[i]->load(std::memory_order_relaxed) + offset);
+        }
+        reverbEffect.setParameterValues(reverbValues);
+
+        const juce::AudioBuffer<float> sidechain(sidechainBuffer.getArrayOfWritePointers(), numSidechainChannels,
+                                                 startSample, subBlock.getNumSamples());
+        reverbEffect.processBlock(subBlock, &sidechain);
+    });
+
+    outputMeter.measureBlock(mainBuffer);
+    spectrumAnalyzer.pushSamples(SpectrumAnalyzer::postReverb, mainBuffer);
+}
+
+void KrumpVSTAudioProcessor::handleAsyncUpdate()
+{
+    effectChain.updateLatencyCompensation();
+    updateReportedLatency();
+}
+
+void KrumpVSTAudioProcessor::updateReportedLatency()
+{
+    // チェーン（並列経路は補償済みの最長経路）とリバーブは直列なので遅延は和になる
+    reportedLatency = effectChain.getLatencySamples() + reverbEffect.getLatencySamples();
+    setLatencySamples(reportedLatency);
+}
+
+void KrumpVSTAudioProcessor::setReverbReducedRate(bool shouldUseReducedRate)
+{
+    if (shouldUseReducedRate == reverbEffect.getReducedRateWetPath())
+        return;
+
+    // suspendProcessing はコールバックのロックを取るので、戻った時点で processBlock は走っていない。
+    // その間にリバーブだけを準備し直す（再生前なら次の prepareToPlay で反映される）
+    suspendProcessing(true);
+    reverbEffect.setReducedRateWetPath(shouldUseReducedRate);
+    if (getSampleRate() > 0.0)
+        reverbEffect.prepareToPlay(getSampleRate(), effectChain.getSubBlockScheduler().getMaximumBlockSize(),
+                                   getChannelLayoutOfBus(false, 0));
+    suspendProcessing(false);
+
+    updateReportedLatency();
 }
 
 juce::AudioProcessorEditor* KrumpVSTAudioProcessor::createEditor()
@@ -45,6 +207,10 @@ void KrumpVSTAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
     auto state = apvts.copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    samplerEngine.saveToXml(*xml);
+    effectChain.saveToXml(*xml->createNewChildElement("EffectChain"));
+    modulationMatrix.saveToXml(*xml->createNewChildElement("Modulation"));
+    xml->createNewChildElement("ReverbOptions")->setAttribute("ReducedRateWetPath", getReverbReducedRate());
     copyXmlToBinary(*xml, destData);
 }
 
@@ -52,20 +218,70 @@ void KrumpVSTAudioProcessor::setStateInformation(const void* data, int sizeInByt
 {
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState.get() != nullptr)
+    {
         if (xmlState->hasTagName(apvts.state.getType()))
+        {
+            // パッドの割り当ては APVTS の外で管理する
+            samplerEngine.loadFromXml(*xmlState);
+            if (auto* padsXml = xmlState->getChildByName("SamplerPads"))
+                xmlState->removeChildElement(padsXml, true);
+
+            // チェーンを先に復元してスロットを結び付け直してから、スロットの値をAPVTSから戻す
+            if (auto* chainXml = xmlState->getChildByName("EffectChain"))
+            {
+                effectChain.loadFromXml(*chainXml);
+                xmlState->removeChildElement(chainXml, true);
+            }
+
+            // ルートはチェーンのエフェクトの並びを参照するので、チェーンの後に戻す
+            if (auto* modulationXml = xmlState->getChildByName("Modulation"))
+            {
+                modulationMatrix.loadFromXml(*modulationXml);
+                xmlState->removeChildElement(modulationXml, true);
+            }
+            else
+            {
+                modulationMatrix.clear();
+            }
+
+            if (auto* optionsXml = xmlState->getChildByName("ReverbOptions"))
+            {
+                setReverbReducedRate(optionsXml->getBoolAttribute("ReducedRateWetPath"));
+                xmlState->removeChildElement(optionsXml, true);
+            }
+
             apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+
+            // 復元した状態を履歴の起点にする
+            editHistory.clear();
+        }
+    }
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout KrumpVSTAudioProcessor::createParameterLayout(EffectParameterPool& effectParameters,
+                                                                                                  PresetMorpher& morpher)
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    for (const auto& descriptor : ReverbParameters::descriptors)
+    {
+        const auto id = getParameterId(static_cast<ReverbParameters::Index>(descriptor.index));
+        const juce::String name(descriptor.name.data(), descriptor.name.size());
+
+        if (descriptor.type == KrumpParameters::Type::boolValue)
+            layout.add(std::make_unique<juce::AudioParameterBool>(id, name, descriptor.defaultValue > 0.5f));
+        else
+            layout.add(std::make_unique<juce::AudioParameterFloat>(id, name, descriptor.minimum, descriptor.maximum, descriptor.defaultValue));
+    }
+
+    effectParameters.addParametersTo(layout);
+    morpher.addParametersTo(layout);
+    return layout;
 }
 
-juce::AudioProcessorValueTreeState::ParameterLayout KrumpVSTAudioProcessor::createParameterLayout()
+juce::String KrumpVSTAudioProcessor::getParameterId(ReverbParameters::Index index)
 {
-    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("RoomSize", "Room Size", 0.0f, 1.0f, 0.5f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("Damping",  "Damping",  0.0f, 1.0f, 0.5f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("Wet",      "Wet",      0.0f, 1.0f, 0.33f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("Dry",      "Dry",      0.0f, 1.0f, 0.4f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("Width",    "Width",    0.0f, 1.0f, 1.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("Freeze",   "Freeze",   0.0f, 1.0f, 0.0f));
-    return { params.begin(), params.end() };
+    const auto id = ReverbParameters::get(index).id;
+    return juce::String(id.data(), id.size());
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
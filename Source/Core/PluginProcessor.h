@@ -3,8 +3,16 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include "../DSP/ReverbEffect.h"
+#include "../../src/EffectChain.h"
+#include "../../src/core/EditHistory.h"
+#include "../../src/presets/PresetMorpher.h"
+#include "../../src/presets/PresetManager.h"
+#include "../../src/audio/modulation/ModulationMatrix.h"
+#include "../../src/audio/sampler/SamplerEngine.h"
+#include "../../src/audio/analysis/SpectrumAnalyzer.h"
 
-class KrumpVSTAudioProcessor : public juce::AudioProcessor
+class KrumpVSTAudioProcessor : public juce::AudioProcessor,
+                               private juce::AsyncUpdater
 {
 public:
     KrumpVSTAudioProcessor();
@@ -12,13 +20,16 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+
+    // 出力はモノ・ステレオ・5.1・7.1.4。入力は出力と同じか、ステレオ出力に対するモノ入力
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
 
     const juce::String getName() const override { return JucePlugin_Name; }
-    bool acceptsMidi() const override { return false; }
+    bool acceptsMidi() const override { return true; }
     bool producesMidi() const override { return false; }
     double getTailLengthSeconds() const override { return 0.0; }
 
@@ -40,17 +51,75 @@ public:
     void setFreezeMode(bool value) { reverbEffect.setFreezeMode(value); }
 
     // Parameter getters
-    float getRoomSize() const { return reverbEffect.getParameter(0); }
-    float getDamping() const { return reverbEffect.getParameter(1); }
-    float getWetLevel() const { return reverbEffect.getParameter(2); }
-    float getDryLevel() const { return reverbEffect.getParameter(3); }
-    float getWidth() const { return reverbEffect.getParameter(4); }
-    bool getFreezeMode() const { return reverbEffect.getParameter(5) > 0.5f; }
+    float getRoomSize() const { return reverbEffect.getParameter(ReverbParameters::roomSize); }
+    float getDamping() const { return reverbEffect.getParameter(ReverbParameters::damping); }
+    float getWetLevel() const { return reverbEffect.getParameter(ReverbParameters::wetLevel); }
+    float getDryLevel() const { return reverbEffect.getParameter(ReverbParameters::dryLevel); }
+    float getWidth() const { return reverbEffect.getParameter(ReverbParameters::width); }
+    bool getFreezeMode() const { return reverbEffect.getParameter(ReverbParameters::freezeMode) > 0.5f; }
+
+    // リバーブのウェットを低いレートで処理する（メッセージスレッド。高いサンプルレート向けで、遅延が増える）
+    void setReverbReducedRate(bool shouldUseReducedRate);
+    bool getReverbReducedRate() const { return reverbEffect.getReducedRateWetPath(); }
+
+    // チェーン内エフェクト用のホストパラメータ（APVTSのレイアウト構築時に参照するため apvts より先に宣言する）
+    EffectParameterPool effectParameterPool;
+
+    // プリセット間のモーフィング（モーフ位置のホストパラメータを持つので apvts より先に宣言する）
+    PresetMorpher presetMorpher;
 
     juce::AudioProcessorValueTreeState apvts;
-    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout(EffectParameterPool& effectParameters,
+                                                                                      PresetMorpher& morpher);
+
+    // 生成済みテーブルの記述子からAPVTSのパラメータIDを得る
+    static juce::String getParameterId(ReverbParameters::Index index);
+
+    // リバーブの前段に挿入されるエフェクトチェーン（インスタンスごとのプールを持つ）
+    EffectChain effectChain;
+
+    // チェーン編集・パラメータ操作・プリセットロードのアンドゥ/リドゥ（effectChain より後に宣言する）
+    EditHistory editHistory { effectChain };
+
+    // LFO / エンベロープフォロワー / ステップシーケンサーによるチェーンとリバーブのパラメータ変調（effectChain より後に宣言する）
+    ModulationMatrix modulationMatrix { effectChain };
+
+    // プリセットの保存・読み込みとライブラリの検索（エディターを閉じていても使え、開き直しても走査し直さない。effectChain より後に宣言する）
+    PresetManager presetManager { effectChain };
+
+    // モーフパネルで各コーナーに選んだプリセット（エディターを閉じても残す）
+    std::array<juce::File, PresetMorpher::maxCorners> morphCornerFiles;
+
+    // パッドサンプラー（MIDIノート 36-51 / GUIのパッドで発音し、エフェクトチェーンを通る）
+    SamplerEngine samplerEngine;
+
+    // 入出力レベル（オーディオスレッドが書き込み、エディターがタイマーで読み出す）
+    LevelMeterSource inputMeter;
+    LevelMeterSource outputMeter;
+
+    // エディターのスペクトラム表示用（エディターが閉じている間は停止）
+    SpectrumAnalyzer spectrumAnalyzer;
 
 private:
+    void handleAsyncUpdate() override;
+    void updateReportedLatency();
+
+    // prepare 時のブロック長以内の1区間を処理する（processBlock が長いブロックをこの長さに切って呼ぶ）
+    void processChunk(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
+
+    // サイドチェインはモノかステレオ（isBusesLayoutSupported）
+    static constexpr int maxSidechainChannels = 2;
+
     ReverbEffect reverbEffect;
+
+    // サイドチェイン入力の退避先（ダッキングのキー）。prepareToPlay で1回だけ確保する
+    juce::AudioBuffer<float> sidechainBuffer;
+
+    // 長いブロックを区切るときの区間ごとのMIDI（prepareToPlay で領域を確保しておく）
+    juce::MidiBuffer chunkMidi;
+
+    // APVTSが所有する値へのポインタ。ReverbParameters のインデックスで引き、文字列検索をしない
+    std::array<std::atomic<float>*, ReverbParameters::numParameters> reverbParameterValues {};
+    std::atomic<int> reportedLatency { 0 };
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KrumpVSTAudioProcessor)
 };
\ No newline at end of file
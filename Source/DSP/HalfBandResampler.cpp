@@ -0,0 +1,213 @@
+#include "HalfBandResampler.h"
+
+namespace
+{
+    // 0次の第1種変形ベッセル関数（カイザー窓用）
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+const std::array<float, HalfBandResampler::numTaps>& HalfBandResampler::getCoefficients()
+{
+    // 偶数位置 h[2i] だけを持つ。カイザー窓 (beta = 8, 阻止域はおよそ -80dB) 付きの sinc で、
+    // 中央の 0.5 と合わせて直流の利得が 1 になるよう正規化する
+    static const auto coefficients = []
+    {
+        std::array<float, numTaps> taps {};
+        constexpr double beta = 8.0;
+        const double length = 2.0 * halfLength;
+
+        double sum = 0.0;
+        std::array<double, numTaps> values {};
+        for (int i = 0; i < numTaps; ++i)
+        {
+            const double n = 2.0 * i;
+            const double offset = (n - halfLength) * 0.5;
+            const double sinc = std::sin(juce::MathConstants<double>::pi * offset) / (juce::MathConstants<double>::pi * offset);
+            const double ratio = (2.0 * n) / length - 1.0;
+            const double window = besselI0(beta * std::sqrt(juce::jmax(0.0, 1.0 - ratio * ratio))) / besselI0(beta);
+            values[static_cast<size_t>(i)] = 0.5 * sinc * window;
+            sum += values[static_cast<size_t>(i)];
+        }
+
+        for (int i = 0; i < numTaps; ++i)
+            taps[static_cast<size_t>(i)] = static_cast<float>(values[static_cast<size_t>(i)] * 0.5 / sum);
+        return taps;
+    }();
+
+    return coefficients;
+}
+
+void HalfBandResampler::prepare(int newNumStages, int maximumBlockSize)
+{
+    numStages = juce::jlimit(0, maxStages, newNumStages);
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+
+    const int factor = getFactor();
+    const int maxInput = maxBlockSize + factor;
+
+    int stageInput = maxInput;
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& stage = stages[static_cast<size_t>(s)];
+        const int stageOutput = stageInput / 2 + 1;
+        stage.downEven.assign(static_cast<size_t>(halfLength + stageOutput), 0.0f);
+        stage.downOdd.assign(static_cast<size_t>(oddDelay + stageOutput), 0.0f);
+        stage.up.assign(static_cast<size_t>(halfLength + stageOutput), 0.0f);
+        stage.output.assign(static_cast<size_t>(stageOutput), 0.0f);
+        stageInput = stageOutput;
+    }
+
+    inputScratch.assign(static_cast<size_t>(maxInput), 0.0f);
+    highScratch.assign(static_cast<size_t>(maxInput), 0.0f);
+    upScratch.assign(static_cast<size_t>(maxInput), 0.0f);
+    outputFifo.assign(static_cast<size_t>(maxBlockSize + 2 * factor), 0.0f);
+    reset();
+}
+
+void HalfBandResampler::reset()
+{
+    for (auto& stage : stages)
+    {
+        std::fill(stage.downEven.begin(), stage.downEven.end(), 0.0f);
+        std::fill(stage.downOdd.begin(), stage.downOdd.end(), 0.0f);
+        std::fill(stage.up.begin(), stage.up.end(), 0.0f);
+    }
+
+    // 端数の持ち越し分だけ出力を先行させておくと、毎ブロック必ず numSamples を取り出せる
+    numPending = 0;
+    numQueued = getFactor() - 1;
+    std::fill(outputFifo.begin(), outputFifo.end(), 0.0f);
+}
+
+int HalfBandResampler::getLatencySamples() const
+{
+    // 各段の間引き・補間はそれぞれ halfLength サンプル（その段の入力レート）遅れる。
+    // 段 s は 2^s 倍の間隔なので合計 2 * halfLength * (倍率 - 1)。これに出力の先行分を足す
+    const int factor = getFactor();
+    return (2 * halfLength + 1) * (factor - 1);
+}
+
+int HalfBandResampler::downsample(const float* input, int numSamples, float* low)
+{
+    if (numStages == 0)
+    {
+        juce::FloatVectorOperations::copy(low, input, numSamples);
+        return numSamples;
+    }
+
+    // 前回の端数の後ろに今回の入力をつなぎ、倍率の倍数だけを処理する
+    const int factor = getFactor();
+    const int total = numPending + numSamples;
+    const int numGroups = total / factor;
+    const int used = numGroups * factor;
+
+    float* scratch = inputScratch.data();
+    juce::FloatVectorOperations::copy(scratch + numPending, input, numSamples);
+
+    const float* stageInput = scratch;
+    int stageLength = used;
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& stage = stages[static_cast<size_t>(s)];
+        float* stageOutput = s == numStages - 1 ? low : stage.output.data();
+        downsampleStage(stage, stageInput, stageLength, stageOutput);
+        stageInput = stageOutput;
+        stageLength /= 2;
+    }
+
+    numPending = total - used;
+    for (int i = 0; i < numPending; ++i)
+        scratch[i] = scratch[used + i];
+
+    return numGroups;
+}
+
+void HalfBandResampler::upsample(const float* low, int numLow, float* output, int numSamples)
+{
+    if (numStages == 0)
+    {
+        juce::FloatVectorOperations::copy(output, low, numSamples);
+        return;
+    }
+
+    // 低い段から順に2倍ずつ戻し、最後の段は出力FIFOの末尾へ直接書く
+    const float* stageInput = low;
+    int stageLength = numLow;
+    for (int s = numStages - 1; s >= 0; --s)
+    {
+        float* stageOutput = s == 0 ? outputFifo.data() + numQueued
+                                    : ((s & 1) != 0 ? highScratch.data() : upScratch.data());
+        upsampleStage(stages[static_cast<size_t>(s)], stageInput, stageLength, stageOutput);
+        stageInput = stageOutput;
+        stageLength *= 2;
+    }
+
+    numQueued += stageLength;
+    jassert(numQueued >= numSamples);
+
+    const int available = juce::jmin(numSamples, numQueued);
+    juce::FloatVectorOperations::copy(output, outputFifo.data(), available);
+    numQueued -= available;
+    for (int i = 0; i < numQueued; ++i)
+        outputFifo[static_cast<size_t>(i)] = outputFifo[static_cast<size_t>(available + i)];
+}
+
+void HalfBandResampler::downsampleStage(Stage& stage, const float* input, int numInput, float* output)
+{
+    const auto& taps = getCoefficients();
+    const int numOutput = numInput / 2;
+
+    // 偶数サンプルはFIRの枝、奇数サンプルは中央係数 (0.5) の遅延の枝へ振り分ける
+    float* even = stage.downEven.data();
+    float* odd = stage.downOdd.data();
+    for (int n = 0; n < numOutput; ++n)
+    {
+        even[halfLength + n] = input[2 * n];
+        odd[oddDelay + n] = input[2 * n + 1];
+    }
+
+    for (int n = 0; n < numOutput; ++n)
+    {
+        float sum = 0.5f * odd[n];
+        const float* history = even + n;
+        for (int i = 0; i < numTaps; ++i)
+            sum += taps[static_cast<size_t>(i)] * history[i];
+        output[n] = sum;
+    }
+
+    std::copy(even + numOutput, even + numOutput + halfLength, even);
+    std::copy(odd + numOutput, odd + numOutput + oddDelay, odd);
+}
+
+void HalfBandResampler::upsampleStage(Stage& stage, const float* input, int numInput, float* output)
+{
+    const auto& taps = getCoefficients();
+    constexpr int centreDelay = (halfLength - 1) / 2;
+
+    float* history = stage.up.data();
+    std::copy(input, input + numInput, history + halfLength);
+
+    // 偶数の出力はFIRの枝（ゼロ挿入の分だけ2倍）、奇数の出力は中央係数による遅延だけ
+    for (int n = 0; n < numInput; ++n)
+    {
+        float sum = 0.0f;
+        const float* window = history + n;
+        for (int i = 0; i < numTaps; ++i)
+            sum += taps[static_cast<size_t>(i)] * window[i];
+
+        output[2 * n] = 2.0f * sum;
+        output[2 * n + 1] = history[halfLength + n - centreDelay];
+    }
+
+    std::copy(history + numInput, history + numInput + halfLength, history);
+}
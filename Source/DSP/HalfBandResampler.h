@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <vector>
+
+/**
+ * 1チャンネル分の 2^n 倍ダウン/アップサンプラー（リアルタイム用）
+ * - 2倍のハーフバンドFIRを段数分つなぐ。ハーフバンドは中央以外の奇数位置の係数が 0 なので、
+ *   ポリフェーズに分けると片方の枝は単なる遅延になり、演算は偶数位置の (halfLength + 1) タップだけで済む
+ * - 係数は中央に対して対称なので、間引き・補間とも前向きの内積で計算できる
+ * - ブロック長が倍率で割り切れない場合は端数を次回へ持ち越し、出力側は倍率 - 1 サンプル先行して埋めておく。
+ *   このため入出力の遅延は常に getLatencySamples() で一定になる
+ */
+class HalfBandResampler
+{
+public:
+    static constexpr int maxStages = 3;
+    static constexpr int halfLength = 23; // フィルタ長は 2 * halfLength + 1（halfLength は奇数）
+
+    HalfBandResampler() = default;
+
+    // numStages 段（倍率 2^numStages）で準備する。0 なら何もしない
+    void prepare(int numStages, int maximumBlockSize);
+    void reset();
+
+    // input の numSamples を間引いて low に書き、書いた数を返す（low は maximumBlockSize / 倍率 + 1 以上）
+    int downsample(const float* input, int numSamples, float* low);
+
+    // low の numLow サンプルを補間し、output へちょうど numSamples を書き出す
+    void upsample(const float* low, int numLow, float* output, int numSamples);
+
+    int getFactor() const { return 1 << numStages; }
+    int getLatencySamples() const;
+
+private:
+    struct Stage
+    {
+        std::vector<float> downEven; // 偶数サンプルの履歴 + 作業領域
+        std::vector<float> downOdd;  // 奇数サンプル（遅延の枝）の履歴 + 作業領域
+        std::vector<float> up;       // 補間側の履歴 + 作業領域
+        std::vector<float> output;   // この段で間引いた結果（次の段の入力）
+    };
+
+    static constexpr int numTaps = halfLength + 1;
+    static constexpr int oddDelay = (halfLength + 1) / 2;
+    static const std::array<float, numTaps>& getCoefficients();
+
+    static void downsampleStage(Stage& stage, const float* input, int numInput, float* output);
+    static void upsampleStage(Stage& stage, const float* input, int numInput, float* output);
+
+    int numStages = 0;
+    int maxBlockSize = 0;
+    std::array<Stage, maxStages> stages;
+
+    std::vector<float> inputScratch; // 持ち越した端数 + 今回の入力
+    int numPending = 0;
+
+    std::vector<float> highScratch;  // 補間の中間結果（段ごとに交互に使う）
+    std::vector<float> upScratch;
+    std::vector<float> outputFifo;
+    int numQueued = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HalfBandResampler)
+};
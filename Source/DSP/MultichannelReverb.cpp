@@ -0,0 +1,187 @@
+#include "MultichannelReverb.h"
+
+namespace
+{
+    // juce::Reverb と同じ 44.1kHz 基準のチューニング
+    constexpr int combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
+    constexpr int allPassTunings[] = { 556, 441, 341, 225 };
+
+    // グループごとに遅延長をずらしてグループ間の相関を減らす（juce::Reverb の左右差と同じ幅）
+    constexpr int groupSpread = 23;
+}
+
+void MultichannelReverb::prepare(double sampleRate, int numChannels, int maximumBlockSize, int excludedChannel)
+{
+    excluded = excludedChannel;
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+
+    // リバーブに通すチャンネルを SIMD の幅ずつ詰めてグループにする
+    groups.clear();
+    int lane = lanes;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (ch == excluded)
+            continue;
+
+        if (lane == lanes)
+        {
+            groups.emplace_back();
+            groups.back().channels.fill(-1);
+            lane = 0;
+        }
+
+        groups.back().channels[static_cast<size_t>(lane++)] = ch;
+    }
+
+    const double scale = sampleRate / 44100.0;
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        auto& group = groups[g];
+        const int spread = groupSpread * static_cast<int>(g);
+
+        for (int i = 0; i < numCombs; ++i)
+            group.combs[static_cast<size_t>(i)].buffer.resize(static_cast<size_t>(juce::roundToInt((combTunings[i] + spread) * scale)));
+
+        for (int i = 0; i < numAllPasses; ++i)
+            group.allPasses[static_cast<size_t>(i)].buffer.resize(static_cast<size_t>(juce::roundToInt((allPassTunings[i] + spread) * scale)));
+    }
+
+    scratch.resize(static_cast<size_t>(maxBlockSize));
+    dampings.allocate(static_cast<size_t>(maxBlockSize), true);
+    feedbacks.allocate(static_cast<size_t>(maxBlockSize), true);
+    wetGains.allocate(static_cast<size_t>(maxBlockSize), true);
+    dryGains.allocate(static_cast<size_t>(maxBlockSize), true);
+
+    // juce::Reverb と同じ 10ms で係数を追従させる
+    for (auto* smoother : { &damping, &feedback, &wetGain, &dryGain })
+    {
+        smoother->reset(sampleRate, 0.01);
+        smoother->setCurrentAndTargetValue(smoother->getTargetValue());
+    }
+
+    reset();
+}
+
+void MultichannelReverb::reset()
+{
+    for (auto& group : groups)
+    {
+        for (auto& comb : group.combs)
+        {
+            std::fill(comb.buffer.begin(), comb.buffer.end(), Vector::expand(0.0f));
+            comb.index = 0;
+        }
+
+        for (auto& allPass : group.allPasses)
+        {
+            std::fill(allPass.buffer.begin(), allPass.buffer.end(), Vector::expand(0.0f));
+            allPass.index = 0;
+        }
+
+        group.combFilterStates.fill(Vector::expand(0.0f));
+    }
+}
+
+void MultichannelReverb::setParameters(const juce::Reverb::Parameters& newParameters)
+{
+    // juce::Reverb と同じ換算。ステレオの左右の混ぜ合わせがないので、チャンネルごとのウェットは wet1 + wet2 に当たる
+    const bool frozen = newParameters.freezeMode >= 0.5f;
+    damping.setTargetValue(frozen ? 0.0f : newParameters.damping * 0.4f);
+    feedback.setTargetValue(frozen ? 1.0f : newParameters.roomSize * 0.28f + 0.7f);
+    wetGain.setTargetValue(newParameters.wetLevel * 3.0f);
+    dryGain.setTargetValue(newParameters.dryLevel * 2.0f);
+    inputGain = frozen ? 0.0f : 0.015f;
+}
+
+void MultichannelReverb::process(juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+        processChunk(buffer, start, juce::jmin(maxBlockSize, numSamples - start));
+}
+
+void MultichannelReverb::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // スムージングは全チャンネル共通なので、サンプルごとの値を先に一度だけ求める
+    for (int i = 0; i < numSamples; ++i)
+    {
+        dampings[i] = damping.getNextValue();
+        feedbacks[i] = feedback.getNextValue();
+        wetGains[i] = wetGain.getNextValue();
+        dryGains[i] = dryGain.getNextValue();
+    }
+
+    for (auto& group : groups)
+        processGroup(group, buffer, startSample, numSamples);
+
+    // リバーブに通さないチャンネル（LFE）はドライだけ
+    if (juce::isPositiveAndBelow(excluded, buffer.getNumChannels()))
+        juce::FloatVectorOperations::multiply(buffer.getWritePointer(excluded, startSample), dryGains, numSamples);
+}
+
+void MultichannelReverb::processGroup(Group& group, juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int numChannels = buffer.getNumChannels();
+    Vector* frames = scratch.data();
+
+    // チャンネルをレーンへ並べ替える（空きレーンと存在しないチャンネルは 0）
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        const int ch = group.channels[static_cast<size_t>(lane)];
+        const float* source = ch >= 0 && ch < numChannels ? buffer.getReadPointer(ch, startSample) : nullptr;
+        for (int i = 0; i < numSamples; ++i)
+            frames[i].set(static_cast<size_t>(lane), source != nullptr ? source[i] : 0.0f);
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const Vector dry = frames[i];
+        const Vector input = dry * inputGain;
+        const Vector damp = Vector::expand(dampings[i]);
+        const Vector damp1 = Vector::expand(1.0f - dampings[i]);
+        const Vector fb = Vector::expand(feedbacks[i]);
+
+        // 並列のコムフィルター
+        Vector output = Vector::expand(0.0f);
+        for (int c = 0; c < numCombs; ++c)
+        {
+            auto& comb = group.combs[static_cast<size_t>(c)];
+            auto& last = group.combFilterStates[static_cast<size_t>(c)];
+            Vector& slot = comb.buffer[static_cast<size_t>(comb.index)];
+
+            const Vector delayed = slot;
+            last = delayed * damp1 + last * damp;
+            slot = input + last * fb;
+            output += delayed;
+
+            if (++comb.index >= static_cast<int>(comb.buffer.size()))
+                comb.index = 0;
+        }
+
+        // 直列のオールパス
+        for (auto& allPass : group.allPasses)
+        {
+            Vector& slot = allPass.buffer[static_cast<size_t>(allPass.index)];
+            const Vector delayed = slot;
+            slot = output + delayed * 0.5f;
+            output = delayed - output;
+
+            if (++allPass.index >= static_cast<int>(allPass.buffer.size()))
+                allPass.index = 0;
+        }
+
+        frames[i] = output * wetGains[i] + dry * dryGains[i];
+    }
+
+    // レーンからチャンネルへ戻す
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        const int ch = group.channels[static_cast<size_t>(lane)];
+        if (ch < 0 || ch >= numChannels)
+            continue;
+
+        float* destination = buffer.getWritePointer(ch, startSample);
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = frames[i].get(static_cast<size_t>(lane));
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+
+/**
+ * サラウンド（5.1 / 7.1.4 など）用のリバーブ
+ * - juce::Reverb と同じ Freeverb 構成（コム8本 + オールパス4本）とパラメータの対応を使う
+ * - チャンネルを SIMD の幅ごとのグループにまとめ、各レーンが1チャンネルを受け持つ。
+ *   遅延線はレーンを並べた SIMDRegister の配列なので、1回の読み書きでグループ全体を処理する
+ * - 各チャンネルは自分の入力だけからテールを作る（ステレオの左右の混ぜ合わせと width は使わない）。
+ *   グループごとに遅延長を少しずらし、グループ間のテールの相関を減らす
+ * - excludedChannel（LFE など）はリバーブに通さず、ドライの利得だけをかける
+ */
+class MultichannelReverb
+{
+public:
+    using Vector = juce::dsp::SIMDRegister<float>;
+    static constexpr int numCombs = 8;
+    static constexpr int numAllPasses = 4;
+    static constexpr int lanes = static_cast<int>(Vector::SIMDNumElements);
+
+    MultichannelReverb() = default;
+
+    void prepare(double sampleRate, int numChannels, int maximumBlockSize, int excludedChannel = -1);
+    void reset();
+    void setParameters(const juce::Reverb::Parameters& newParameters);
+
+    void process(juce::AudioBuffer<float>& buffer);
+
+    int getNumGroups() const { return static_cast<int>(groups.size()); }
+
+private:
+    struct DelayLine
+    {
+        std::vector<Vector> buffer;
+        int index = 0;
+    };
+
+    struct Group
+    {
+        std::array<int, lanes> channels {}; // 使わないレーンは -1
+        std::array<DelayLine, numCombs> combs;
+        std::array<Vector, numCombs> combFilterStates {};
+        std::array<DelayLine, numAllPasses> allPasses;
+    };
+
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void processGroup(Group& group, juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    std::vector<Group> groups;
+    int excluded = -1;
+    int maxBlockSize = 512;
+    std::vector<Vector> scratch; // 1グループ分をレーンに並べた作業領域
+
+    // ブロック内のスムージング済みの値（全グループで共有する）
+    juce::HeapBlock<float> dampings, feedbacks, wetGains, dryGains;
+    juce::SmoothedValue<float> damping, feedback, wetGain, dryGain;
+    float inputGain = 0.015f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultichannelReverb)
+};
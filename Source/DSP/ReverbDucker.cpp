@@ -0,0 +1,58 @@
+#include "ReverbDucker.h"
+
+void ReverbDucker::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    reset();
+}
+
+void ReverbDucker::reset()
+{
+    envelope = 0.0f;
+    currentGain = 1.0f;
+}
+
+void ReverbDucker::setParameters(float newAmount, float newThresholdDb, float newAttackMs, float newReleaseMs)
+{
+    amount = juce::jlimit(0.0f, 1.0f, newAmount);
+    thresholdDb = newThresholdDb;
+    attackMs = juce::jmax(0.1f, newAttackMs);
+    releaseMs = juce::jmax(0.1f, newReleaseMs);
+}
+
+void ReverbDucker::process(const juce::AudioBuffer<float>& key, int startSample, int numSamples, float* gains)
+{
+    if (numSamples <= 0)
+        return;
+
+    float peak = 0.0f;
+    for (int ch = 0; ch < key.getNumChannels(); ++ch)
+        peak = juce::jmax(peak, key.getMagnitude(ch, startSample, numSamples));
+
+    // 1次フィルターを numSamples サンプル分まとめて進める: coeff^n = exp(-n / (time * fs))
+    const float timeMs = peak > envelope ? attackMs : releaseMs;
+    const float coefficient = std::exp(-static_cast<float>(numSamples) / (timeMs * 0.001f * static_cast<float>(sampleRate)));
+    envelope = peak + (envelope - peak) * coefficient;
+
+    const float target = getTargetGain();
+    if (target == currentGain)
+    {
+        juce::FloatVectorOperations::fill(gains, target, numSamples);
+        return;
+    }
+
+    const float step = (target - currentGain) / static_cast<float>(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        gains[i] = currentGain + step * static_cast<float>(i + 1);
+
+    currentGain = target;
+}
+
+float ReverbDucker::getTargetGain() const
+{
+    if (amount <= 0.0f)
+        return 1.0f;
+
+    const float overDb = juce::Decibels::gainToDecibels(envelope, -100.0f) - thresholdDb;
+    return 1.0f - amount * juce::jlimit(0.0f, 1.0f, overDb / kneeDb);
+}
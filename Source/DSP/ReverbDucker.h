@@ -0,0 +1,44 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * リバーブのウェットを下げるダッキング（キーはサイドチェインかドライ入力）
+ * - 検出はブロック単位。キーの各チャンネルのピークを AudioBuffer::getMagnitude（ベクトル化された最小/最大探索）で求め、
+ *   アタック/リリースの1次フィルターをブロックにつき1回だけ進める（係数はブロック長のぶん累乗したもの）
+ * - エンベロープがしきい値を超えると、kneeDb 上で最大の深さ（1 - amount）に達するまで直線的にゲインを下げる
+ * - ゲインは前のブロックの値から今回の目標値までサンプルごとに直線で動かし、ブロック境界で段差を作らない
+ */
+class ReverbDucker
+{
+public:
+    static constexpr float kneeDb = 12.0f;
+
+    ReverbDucker() = default;
+
+    void prepare(double newSampleRate);
+    void reset();
+
+    // amount は 0（何もしない）〜 1（ウェットを消す）
+    void setParameters(float newAmount, float newThresholdDb, float newAttackMs, float newReleaseMs);
+
+    // key の numSamples からゲインを求め、gains へ numSamples 分書く
+    void process(const juce::AudioBuffer<float>& key, int startSample, int numSamples, float* gains);
+
+    float getEnvelopeDb() const { return juce::Decibels::gainToDecibels(envelope, -100.0f); }
+    float getCurrentGain() const { return currentGain; }
+
+private:
+    float getTargetGain() const;
+
+    double sampleRate = 44100.0;
+    float amount = 0.0f;
+    float thresholdDb = -30.0f;
+    float attackMs = 10.0f;
+    float releaseMs = 250.0f;
+
+    float envelope = 0.0f;
+    float currentGain = 1.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReverbDucker)
+};
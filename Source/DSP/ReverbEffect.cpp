@@ -4,123 +4,306 @@ ReverbEffect::~ReverbEffect()
 {
 }
 
-void ReverbEffect::prepareToPlay(double sampleRate, int samplesPerBlock)
+void ReverbEffect::prepareToPlay(double sampleRate, int samplesPerBlock, const juce::AudioChannelSet& layout)
 {
-    juce::ignoreUnused(sampleRate, samplesPerBlock);
+    maxBlockSize = juce::jmax(1, samplesPerBlock);
+    kernels = &DspKernels::getBest();
+
+    const int numChannels = layout.size();
+    kernel = numChannels <= 1 ? Kernel::mono
+           : numChannels == 2 ? Kernel::stereo
+                              : Kernel::multichannel;
+
+    // 内部レートが上限以下になるまで2倍ずつ間引く（44.1/48kHz では間引かない）
+    int numStages = 0;
+    if (reducedRateRequested && kernel != Kernel::multichannel)
+        while (numStages < HalfBandResampler::maxStages && sampleRate / (1 << numStages) > maxInternalSampleRate)
+            ++numStages;
+
+    internalSampleRate = sampleRate / (1 << numStages);
+    reverb.setSampleRate(internalSampleRate);
+
+    if (kernel == Kernel::multichannel)
+        multichannelReverb.prepare(sampleRate, numChannels, maxBlockSize,
+                                   layout.getChannelIndexForType(juce::AudioChannelSet::LFE));
+
+    for (auto& resampler : resamplers)
+        resampler.prepare(numStages, maxBlockSize);
+
+    numReverbChannels = kernel == Kernel::mono ? 1 : kernel == Kernel::stereo ? 2 : numChannels;
+    dryBuffer.setSize(numReverbChannels, maxBlockSize);
+    dryGains.allocate(static_cast<size_t>(maxBlockSize), true);
+    duckGains.allocate(static_cast<size_t>(maxBlockSize), true);
+    smoothedDryGain.reset(sampleRate, 0.01);
+    ducker.prepare(sampleRate);
+
+    if (numStages > 0)
+    {
+        const int latency = getLatencySamples();
+        lowBuffer.setSize(numReverbChannels, maxBlockSize / resamplers[0].getFactor() + 1);
+        wetBuffer.setSize(numReverbChannels, maxBlockSize);
+        dryDelay.setSize(numReverbChannels, juce::nextPowerOfTwo(latency + 1));
+        dryDelayMask = dryDelay.getNumSamples() - 1;
+    }
+
     updateParameters();
+    smoothedDryGain.setCurrentAndTargetValue(smoothedDryGain.getTargetValue());
+    reset();
 }
 
-void ReverbEffect::processBlock(juce::AudioBuffer<float>& buffer)
+void ReverbEffect::processBlock(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* sidechain)
 {
-    reverb.processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples());
+    const int numSamples = buffer.getNumSamples();
+    if (numSamples == 0 || buffer.getNumChannels() == 0)
+        return;
+
+    // ホストのブロックが prepare 時より大きい場合に備えて分割する
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+        processChunk(buffer, start, juce::jmin(maxBlockSize, numSamples - start), sidechain);
+}
+
+void ReverbEffect::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                const juce::AudioBuffer<float>* sidechain)
+{
+    // prepare 時より少ないチャンネルで呼ばれてもモノとして扱い、存在しないチャンネルには触れない
+    const int numChannels = juce::jmin(numReverbChannels, buffer.getNumChannels());
+
+    // キー: サイドチェインが選ばれていて届いていればそれ、なければリバーブに入る前のドライ
+    const bool useSidechain = values[ReverbParameters::duckSidechain] > 0.5f && sidechain != nullptr
+                           && sidechain->getNumChannels() > 0 && sidechain->getNumSamples() >= startSample + numSamples;
+    const juce::AudioBuffer<float> dryKey(buffer.getArrayOfWritePointers(), numChannels, startSample, numSamples);
+    if (useSidechain)
+        ducker.process(*sidechain, startSample, numSamples, duckGains);
+    else
+        ducker.process(dryKey, 0, numSamples, duckGains);
+
+    for (int i = 0; i < numSamples; ++i)
+        dryGains[i] = smoothedDryGain.getNextValue();
+
+    if (resamplers[0].getFactor() > 1)
+    {
+        processReducedRate(buffer, startSample, numSamples);
+        return;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        dryBuffer.copyFrom(ch, 0, buffer, ch, startSample, numSamples);
+
+    juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), startSample, numSamples);
+    if (kernel == Kernel::multichannel)
+        multichannelReverb.process(block);
+    else if (numChannels == 1)
+        reverb.processMono(block.getWritePointer(0), numSamples);
+    else
+        reverb.processStereo(block.getWritePointer(0), block.getWritePointer(1), numSamples);
+
+    // 出力 = ウェット * ダッキング + ドライ
+    for (int ch = 0; ch < numChannels; ++ch)
+        kernels->mixWithGains(buffer.getWritePointer(ch, startSample), duckGains,
+                              dryBuffer.getReadPointer(ch), dryGains, numSamples);
+}
+
+void ReverbEffect::processReducedRate(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // ウェット: 間引く → 低いレートでリバーブ（ドライ 0）→ 補間して元のレートへ
+    const int numChannels = juce::jmin(numReverbChannels, buffer.getNumChannels());
+    int numLow = 0;
+    for (int ch = 0; ch < numChannels; ++ch)
+        numLow = resamplers[static_cast<size_t>(ch)].downsample(buffer.getReadPointer(ch, startSample), numSamples,
+                                                                 lowBuffer.getWritePointer(ch));
+
+    if (numLow > 0)
+    {
+        if (numChannels == 1)
+            reverb.processMono(lowBuffer.getWritePointer(0), numLow);
+        else
+            reverb.processStereo(lowBuffer.getWritePointer(0), lowBuffer.getWritePointer(1), numLow);
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        resamplers[static_cast<size_t>(ch)].upsample(lowBuffer.getReadPointer(ch), numLow,
+                                                     wetBuffer.getWritePointer(ch), numSamples);
+
+    // ドライ: 元のレートのまま補間と同じだけ遅らせてウェット（ダッキング済み）に足す
+    const int latency = getLatencySamples();
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* data = buffer.getWritePointer(ch, startSample);
+        const float* wet = wetBuffer.getReadPointer(ch);
+        float* ring = dryDelay.getWritePointer(ch);
+
+        int write = dryDelayWrite;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            ring[write] = data[i];
+            data[i] = duckGains[i] * wet[i] + dryGains[i] * ring[(write - latency) & dryDelayMask];
+            write = (write + 1) & dryDelayMask;
+        }
+    }
+
+    dryDelayWrite = (dryDelayWrite + numSamples) & dryDelayMask;
 }
 
 void ReverbEffect::reset()
 {
     reverb.reset();
+    multichannelReverb.reset();
+    for (auto& resampler : resamplers)
+        resampler.reset();
+    dryDelay.clear();
+    dryDelayWrite = 0;
+    ducker.reset();
 }
 
 void ReverbEffect::setRoomSize(float value)
 {
-    parameters.roomSize = value;
-    updateParameters();
+    setParameter(ReverbParameters::roomSize, value);
 }
 
 void ReverbEffect::setDamping(float value)
 {
-    parameters.damping = value;
-    updateParameters();
+    setParameter(ReverbParameters::damping, value);
 }
 
 void ReverbEffect::setWetLevel(float value)
 {
-    parameters.wetLevel = value;
-    updateParameters();
+    setParameter(ReverbParameters::wetLevel, value);
 }
 
 void ReverbEffect::setDryLevel(float value)
 {
-    parameters.dryLevel = value;
-    updateParameters();
+    setParameter(ReverbParameters::dryLevel, value);
 }
 
 void ReverbEffect::setWidth(float value)
 {
-    parameters.width = value;
-    updateParameters();
+    setParameter(ReverbParameters::width, value);
 }
 
 void ReverbEffect::setFreezeMode(bool value)
 {
-    parameters.freezeMode = value ? 1.0f : 0.0f;
+    setParameter(ReverbParameters::freezeMode, value ? 1.0f : 0.0f);
+}
+
+void ReverbEffect::setParameterValues(const ParameterValues& newValues)
+{
+    if (newValues == values)
+        return;
+
+    values = newValues;
     updateParameters();
 }
 
 juce::StringArray ReverbEffect::getParameterNames() const
 {
-    return {"Room Size", "Damping", "Wet Level", "Dry Level", "Width", "Freeze"};
+    juce::StringArray names;
+    for (const auto& descriptor : ReverbParameters::descriptors)
+        names.add(juce::String(descriptor.name.data(), descriptor.name.size()));
+    return names;
 }
 
 juce::StringArray ReverbEffect::getParameterLabels() const
 {
-    return {"%", "%", "%", "%", "%", ""};
+    juce::StringArray labels;
+    for (const auto& descriptor : ReverbParameters::descriptors)
+        labels.add(juce::String(descriptor.unit.data(), descriptor.unit.size()));
+    return labels;
 }
 
 juce::Array<float> ReverbEffect::getParameterRanges() const
 {
-    return {0.0f, 1.0f, 0.5f};  // min, max, default
+    // min, max, default の組をパラメータ順に並べる
+    juce::Array<float> ranges;
+    for (const auto& descriptor : ReverbParameters::descriptors)
+    {
+        ranges.add(descriptor.minimum);
+        ranges.add(descriptor.maximum);
+        ranges.add(descriptor.defaultValue);
+    }
+    return ranges;
 }
 
 void ReverbEffect::setParameter(int parameterIndex, float value)
 {
-    switch (parameterIndex)
-    {
-        case 0: setRoomSize(value); break;
-        case 1: setDamping(value); break;
-        case 2: setWetLevel(value); break;
-        case 3: setDryLevel(value); break;
-        case 4: setWidth(value); break;
-        case 5: setFreezeMode(value > 0.5f); break;
-        default: break;
-    }
+    if (!juce::isPositiveAndBelow(parameterIndex, static_cast<int>(ReverbParameters::numParameters)))
+        return;
+
+    const auto& descriptor = ReverbParameters::descriptors[static_cast<size_t>(parameterIndex)];
+    values[static_cast<size_t>(parameterIndex)] = descriptor.type == KrumpParameters::Type::boolValue
+                                                      ? (value > 0.5f ? 1.0f : 0.0f)
+                                                      : juce::jlimit(descriptor.minimum, descriptor.maximum, value);
+    updateParameters();
 }
 
 float ReverbEffect::getParameter(int parameterIndex) const
 {
-    switch (parameterIndex)
-    {
-        case 0: return parameters.roomSize;
-        case 1: return parameters.damping;
-        case 2: return parameters.wetLevel;
-        case 3: return parameters.dryLevel;
-        case 4: return parameters.width;
-        case 5: return parameters.freezeMode;
-        default: return 0.0f;
-    }
+    if (!juce::isPositiveAndBelow(parameterIndex, static_cast<int>(ReverbParameters::numParameters)))
+        return 0.0f;
+
+    return values[static_cast<size_t>(parameterIndex)];
 }
 
 void ReverbEffect::updateParameters()
 {
+    juce::Reverb::Parameters parameters;
+    parameters.roomSize = values[ReverbParameters::roomSize];
+    parameters.damping = values[ReverbParameters::damping];
+    parameters.wetLevel = values[ReverbParameters::wetLevel];
+    parameters.dryLevel = values[ReverbParameters::dryLevel];
+    parameters.width = values[ReverbParameters::width];
+    parameters.freezeMode = values[ReverbParameters::freezeMode];
+
+    // ドライはリバーブの外で足すので、リバーブ側はウェットだけを出す
+    // （juce::Reverb と MultichannelReverb はドライレベルを 2 倍して使うので同じ利得にそろえる）
+    smoothedDryGain.setTargetValue(parameters.dryLevel * 2.0f);
+    parameters.dryLevel = 0.0f;
+
     reverb.setParameters(parameters);
+    multichannelReverb.setParameters(parameters);
+
+    ducker.setParameters(values[ReverbParameters::duckAmount], values[ReverbParameters::duckThreshold],
+                         values[ReverbParameters::duckAttack], values[ReverbParameters::duckRelease]);
+}
+
+juce::Reverb::Parameters ReverbEffect::getParameters() const
+{
+    juce::Reverb::Parameters parameters;
+    parameters.roomSize = values[ReverbParameters::roomSize];
+    parameters.damping = values[ReverbParameters::damping];
+    parameters.wetLevel = values[ReverbParameters::wetLevel];
+    parameters.dryLevel = values[ReverbParameters::dryLevel];
+    parameters.width = values[ReverbParameters::width];
+    parameters.freezeMode = values[ReverbParameters::freezeMode];
+    return parameters;
 }
 
 void ReverbEffect::saveToXml(juce::XmlElement& xml) const
 {
-    xml.setAttribute("RoomSize", parameters.roomSize);
-    xml.setAttribute("Damping", parameters.damping);
-    xml.setAttribute("WetLevel", parameters.wetLevel);
-    xml.setAttribute("DryLevel", parameters.dryLevel);
-    xml.setAttribute("Width", parameters.width);
-    xml.setAttribute("FreezeMode", parameters.freezeMode > 0.5f ? 1 : 0);
+    xml.setAttribute("RoomSize", values[ReverbParameters::roomSize]);
+    xml.setAttribute("Damping", values[ReverbParameters::damping]);
+    xml.setAttribute("WetLevel", values[ReverbParameters::wetLevel]);
+    xml.setAttribute("DryLevel", values[ReverbParameters::dryLevel]);
+    xml.setAttribute("Width", values[ReverbParameters::width]);
+    xml.setAttribute("FreezeMode", values[ReverbParameters::freezeMode] > 0.5f ? 1 : 0);
+    xml.setAttribute("DuckAmount", values[ReverbParameters::duckAmount]);
+    xml.setAttribute("DuckThreshold", values[ReverbParameters::duckThreshold]);
+    xml.setAttribute("DuckAttack", values[ReverbParameters::duckAttack]);
+    xml.setAttribute("DuckRelease", values[ReverbParameters::duckRelease]);
+    xml.setAttribute("DuckSidechain", values[ReverbParameters::duckSidechain] > 0.5f ? 1 : 0);
 }
 
 void ReverbEffect::loadFromXml(const juce::XmlElement& xml)
 {
-    parameters.roomSize = static_cast<float>(xml.getDoubleAttribute("RoomSize", parameters.roomSize));
-    parameters.damping = static_cast<float>(xml.getDoubleAttribute("Damping", parameters.damping));
-    parameters.wetLevel = static_cast<float>(xml.getDoubleAttribute("WetLevel", parameters.wetLevel));
-    parameters.dryLevel = static_cast<float>(xml.getDoubleAttribute("DryLevel", parameters.dryLevel));
-    parameters.width = static_cast<float>(xml.getDoubleAttribute("Width", parameters.width));
-    parameters.freezeMode = xml.getBoolAttribute("FreezeMode", parameters.freezeMode > 0.5f) ? 1.0f : 0.0f;
+    values[ReverbParameters::roomSize] = static_cast<float>(xml.getDoubleAttribute("RoomSize", values[ReverbParameters::roomSize]));
+    values[ReverbParameters::damping] = static_cast<float>(xml.getDoubleAttribute("Damping", values[ReverbParameters::damping]));
+    values[ReverbParameters::wetLevel] = static_cast<float>(xml.getDoubleAttribute("WetLevel", values[ReverbParameters::wetLevel]));
+    values[ReverbParameters::dryLevel] = static_cast<float>(xml.getDoubleAttribute("DryLevel", values[ReverbParameters::dryLevel]));
+    values[ReverbParameters::width] = static_cast<float>(xml.getDoubleAttribute("Width", values[ReverbParameters::width]));
+    values[ReverbParameters::freezeMode] = xml.getBoolAttribute("FreezeMode", values[ReverbParameters::freezeMode] > 0.5f) ? 1.0f : 0.0f;
+    values[ReverbParameters::duckAmount] = static_cast<float>(xml.getDoubleAttribute("DuckAmount", values[ReverbParameters::duckAmount]));
+    values[ReverbParameters::duckThreshold] = static_cast<float>(xml.getDoubleAttribute("DuckThreshold", values[ReverbParameters::duckThreshold]));
+    values[ReverbParameters::duckAttack] = static_cast<float>(xml.getDoubleAttribute("DuckAttack", values[ReverbParameters::duckAttack]));
+    values[ReverbParameters::duckRelease] = static_cast<float>(xml.getDoubleAttribute("DuckRelease", values[ReverbParameters::duckRelease]));
+    values[ReverbParameters::duckSidechain] = xml.getBoolAttribute("DuckSidechain", values[ReverbParameters::duckSidechain] > 0.5f) ? 1.0f : 0.0f;
     updateParameters();
 } 
\ No newline at end of file
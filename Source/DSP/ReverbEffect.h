@@ -2,12 +2,26 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "KrumpParameters.h"
+#include "HalfBandResampler.h"
+#include "MultichannelReverb.h"
+#include "ReverbDucker.h"
+#include "../../src/audio/kernels/DspKernels.h"
 
 /**
  * SP-404スタイルのリバーブエフェクト
  * - ルームサイズ
  * - ダンピング
- * - ウェット/ドライミックス
+ * - ウェット/ドライミックス。ドライはリバーブの外で足し、ウェットだけに掛けるゲインを挟めるようにする
+ * - ダッキング: サイドチェイン（またはドライ入力）のエンベロープでウェットを下げる（ReverbDucker）
+ * - パラメータは project_spec.yaml から生成した ReverbParameters のインデックスで平坦な配列に保持する
+ * - 低減レートモードではウェットだけをハーフバンドで間引いたレート（48kHz 前後）で処理し、
+ *   ドライは元のレートのまま補間の遅延分だけ遅らせて足す。高いサンプルレートでも負荷がほぼ一定になる
+ * - 出力バスのチャンネル構成に合わせて処理を切り替える
+ *   - モノ: 1チャンネルだけを処理し、2チャンネル目には触れない
+ *   - ステレオ: juce::Reverb のステレオ処理（width が効く）
+ *   - サラウンド (5.1 / 7.1.4 など): MultichannelReverb でチャンネルを SIMD のレーンにまとめて処理する。
+ *     LFE はリバーブに通さない。低減レートモードはモノ/ステレオだけで有効
  */
 class ReverbEffect
 {
@@ -15,10 +29,36 @@ public:
     ReverbEffect() = default;
     ~ReverbEffect();
 
-    void prepareToPlay(double sampleRate, int samplesPerBlock);
-    void processBlock(juce::AudioBuffer<float>& buffer);
+    enum class Kernel
+    {
+        mono,
+        stereo,
+        multichannel
+    };
+
+    // layout は出力バスのチャンネル構成。processBlock にはこのチャンネル数のバッファを渡す
+    void prepareToPlay(double sampleRate, int samplesPerBlock,
+                       const juce::AudioChannelSet& layout = juce::AudioChannelSet::stereo());
+    // sidechain はダッキングのキー（buffer と同じ長さ）。nullptr や空ならドライ入力をキーにする
+    void processBlock(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* sidechain = nullptr);
     void reset();
 
+    Kernel getKernel() const { return kernel; }
+
+    // 直前のブロックの終わりでウェットに掛けていたダッキングのゲイン（1 で下げていない）
+    float getDuckGain() const { return ducker.getCurrentGain(); }
+
+    // ウェットを低いレートで処理するか（次の prepareToPlay から有効。遅延が増える）
+    void setReducedRateWetPath(bool shouldUseReducedRate) { reducedRateRequested = shouldUseReducedRate; }
+    bool getReducedRateWetPath() const { return reducedRateRequested; }
+
+    // 低減レートモードで生じる遅延（ドライも同じだけ遅れる）。通常とサラウンドでは 0
+    int getLatencySamples() const { return resamplers[0].getLatencySamples(); }
+    double getInternalSampleRate() const { return internalSampleRate; }
+
+    // 低減レートモードで内部レートがこれを超えないよう間引く
+    static constexpr double maxInternalSampleRate = 50000.0;
+
     // Parameter setters
     void setRoomSize(float value);
     void setDamping(float value);
@@ -37,17 +77,63 @@ public:
     // エフェクト情報
     juce::String getName() const { return "Reverb"; }
     juce::String getCategory() const { return "Reverb"; }
-    int getNumParameters() const { return 5; }
+    int getNumParameters() const { return ReverbParameters::numParameters; }
+
+    // 全パラメータをまとめて更新する（値が変わったときだけリバーブ係数を再計算する）
+    using ParameterValues = std::array<float, ReverbParameters::numParameters>;
+    void setParameterValues(const ParameterValues& newValues);
 
     // プリセット関連
     void saveToXml(juce::XmlElement& xml) const;
     void loadFromXml(const juce::XmlElement& xml);
 
-    void setParameters(const juce::Reverb::Parameters& params) { reverb.setParameters(params); }
-    juce::Reverb::Parameters getParameters() const { return reverb.getParameters(); }
+    void setParameters(const juce::Reverb::Parameters& params)
+    {
+        values[ReverbParameters::roomSize] = params.roomSize;
+        values[ReverbParameters::damping] = params.damping;
+        values[ReverbParameters::wetLevel] = params.wetLevel;
+        values[ReverbParameters::dryLevel] = params.dryLevel;
+        values[ReverbParameters::width] = params.width;
+        values[ReverbParameters::freezeMode] = params.freezeMode;
+        updateParameters();
+    }
+    juce::Reverb::Parameters getParameters() const;
+
+    static constexpr ParameterValues getDefaultValues()
+    {
+        ParameterValues defaults {};
+        for (size_t i = 0; i < defaults.size(); ++i)
+            defaults[i] = ReverbParameters::descriptors[i].defaultValue;
+        return defaults;
+    }
 
 private:
-    juce::Reverb reverb;
-    juce::dsp::Reverb::Parameters parameters;
     void updateParameters();
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, const juce::AudioBuffer<float>* sidechain);
+    void processReducedRate(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    juce::Reverb reverb;
+    MultichannelReverb multichannelReverb;
+    Kernel kernel = Kernel::stereo;
+    ParameterValues values = getDefaultValues();
+    int numReverbChannels = 2;            // リバーブに通すチャンネル数（モノなら 1、サラウンドはレイアウトの数）
+
+    // ドライとダッキング（どのカーネルでもリバーブはウェットだけを出す）
+    ReverbDucker ducker;
+    juce::AudioBuffer<float> dryBuffer;   // リバーブに入る前のドライ
+    juce::HeapBlock<float> dryGains;
+    juce::HeapBlock<float> duckGains;
+    juce::SmoothedValue<float> smoothedDryGain;
+    const DspKernels* kernels = &DspKernels::getBaseline(); // ウェットとドライのミックス（prepare で選ぶ）
+
+    // 低減レートモード
+    bool reducedRateRequested = false;
+    double internalSampleRate = 44100.0;
+    int maxBlockSize = 512;
+    std::array<HalfBandResampler, 2> resamplers;
+    juce::AudioBuffer<float> lowBuffer;   // 間引いたウェット
+    juce::AudioBuffer<float> wetBuffer;   // 元のレートへ戻したウェット
+    juce::AudioBuffer<float> dryDelay;    // ドライの遅延（2のべき乗のリング）
+    int dryDelayMask = 0;
+    int dryDelayWrite = 0;
 }; 
\ No newline at end of file
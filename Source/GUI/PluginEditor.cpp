@@ -1,14 +1,15 @@
 #include "PluginEditor.h"
 #include "../Core/PluginProcessor.h"
+#include "../../src/gui/LookAndFeel/KrumpColours.h"
 
 // ===== CustomLookAndFeel 実装 =====
 CustomLookAndFeel::CustomLookAndFeel() {
-    setColour(juce::Slider::rotarySliderFillColourId, juce::Colour(0xffe53935)); // レッド
+    setColour(juce::Slider::rotarySliderFillColourId, KrumpColours::accent);
     setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colour(0xff222222)); // ダーク
-    setColour(juce::Slider::thumbColourId, juce::Colour(0xffe53935));
+    setColour(juce::Slider::thumbColourId, KrumpColours::accent);
     setColour(juce::Label::textColourId, juce::Colours::white);
     setColour(juce::Label::backgroundColourId, juce::Colour(0xff222222));
-    setColour(juce::Label::outlineColourId, juce::Colour(0xffe53935));
+    setColour(juce::Label::outlineColourId, KrumpColours::accent);
 }
 
 void CustomLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPosProportional,
@@ -38,7 +39,7 @@ void CustomLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int wi
     g.strokePath(valueArc, juce::PathStrokeType(4.0f));
     // ノブ
     float knobRadius = radius * 0.6f;
-    g.setColour(juce::Colour(0xffe53935));
+    g.setColour(KrumpColours::accent);
     g.fillEllipse(centreX - knobRadius, centreY - knobRadius, knobRadius * 2, knobRadius * 2);
     // インジケータ
     g.setColour(juce::Colours::white);
@@ -63,7 +64,10 @@ void CustomLookAndFeel::drawLabel(juce::Graphics& g, juce::Label& label) {
 
 // ===== PluginEditor =====
 KrumpVSTAudioProcessorEditor::KrumpVSTAudioProcessorEditor(KrumpVSTAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), inputMeter(p.inputMeter), outputMeter(p.outputMeter),
+      spectrumDisplay(p.spectrumAnalyzer), effectRack(p.effectChain),
+      presetManager(p.presetManager), presetBrowser(presetManager.getLibrary()),
+      morphPanel(p.presetMorpher, p.effectChain, presetManager.getLibrary(), p.morphCornerFiles)
 {
     setLookAndFeel(&customLnf);
     setSize(800, 600);
@@ -101,6 +105,7 @@ KrumpVSTAudioProcessorEditor::KrumpVSTAudioProcessorEditor(KrumpVSTAudioProcesso
     makeSlider(drySlider);        dryLabel.setText("Dry", juce::dontSendNotification);
     makeSlider(widthSlider);      widthLabel.setText("Width", juce::dontSendNotification);
     makeSlider(freezeSlider);     freezeLabel.setText("Freeze", juce::dontSendNotification);
+    makeSlider(duckSlider);       duckLabel.setText("Duck", juce::dontSendNotification);
 
     addAndMakeVisible(roomSizeSlider);   addAndMakeVisible(roomSizeLabel);
     addAndMakeVisible(dampingSlider);    addAndMakeVisible(dampingLabel);
@@ -108,13 +113,42 @@ KrumpVSTAudioProcessorEditor::KrumpVSTAudioProcessorEditor(KrumpVSTAudioProcesso
     addAndMakeVisible(drySlider);        addAndMakeVisible(dryLabel);
     addAndMakeVisible(widthSlider);      addAndMakeVisible(widthLabel);
     addAndMakeVisible(freezeSlider);     addAndMakeVisible(freezeLabel);
+    addAndMakeVisible(duckSlider);       addAndMakeVisible(duckLabel);
 
-    roomSizeAttach  = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "RoomSize",  roomSizeSlider);
-    dampingAttach   = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "Damping",   dampingSlider);
-    wetAttach       = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "Wet",       wetSlider);
-    dryAttach       = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "Dry",       drySlider);
-    widthAttach     = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "Width",     widthSlider);
-    freezeAttach    = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "Freeze",    freezeSlider);
+    roomSizeAttach  = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, KrumpVSTAudioProcessor::getParameterId(ReverbParameters::roomSize), roomSizeSlider);
+    dampingAttach   = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, KrumpVSTAudioProcessor::getParameterId(ReverbParameters::damping), dampingSlider);
+    wetAttach       = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, KrumpVSTAudioProcessor::getParameterId(ReverbParameters::wetLevel), wetSlider);
+    dryAttach       = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, KrumpVSTAudioProcessor::getParameterId(ReverbParameters::dryLevel), drySlider);
+    widthAttach     = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, KrumpVSTAudioProcessor::getParameterId(ReverbParameters::width), widthSlider);
+    freezeAttach    = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, KrumpVSTAudioProcessor::getParameterId(ReverbParameters::freezeMode), freezeSlider);
+    duckAttach      = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, KrumpVSTAudioProcessor::getParameterId(ReverbParameters::duckAmount), duckSlider);
+
+    reducedRateButton.setToggleState(audioProcessor.getReverbReducedRate(), juce::dontSendNotification);
+    reducedRateButton.setTooltip("Process the reverb tail at ~48 kHz (adds latency)");
+    reducedRateButton.onClick = [this] { audioProcessor.setReverbReducedRate(reducedRateButton.getToggleState()); };
+    addAndMakeVisible(reducedRateButton);
+
+    addAndMakeVisible(inputMeter);
+    addAndMakeVisible(outputMeter);
+    addAndMakeVisible(spectrumDisplay);
+    addAndMakeVisible(effectRack);
+
+    presetBrowser.onPresetChosen = [this](const juce::File& file) { presetManager.loadPreset(file); };
+    addAndMakeVisible(presetBrowser);
+    addAndMakeVisible(morphPanel);
+
+    // パッドのトリガーはロックフリーキュー経由でオーディオスレッドへ渡る
+    for (int i = 0; i < SamplerEngine::numPads; ++i)
+    {
+        auto& pad = padButtons[static_cast<size_t>(i)];
+        pad.setButtonText(juce::String(i + 1));
+        pad.setTriggeredOnMouseDown(true);
+        pad.setTooltip("Drop an audio file here to load it");
+        pad.onClick = [this, i] { audioProcessor.samplerEngine.triggerPad(i, 1.0f); };
+        addAndMakeVisible(pad);
+    }
+
+    setWantsKeyboardFocus(true);
 }
 
 KrumpVSTAudioProcessorEditor::~KrumpVSTAudioProcessorEditor()
@@ -129,10 +163,56 @@ void KrumpVSTAudioProcessorEditor::paint(juce::Graphics& g)
     g.drawFittedText("BUCK REVERB", getLocalBounds().removeFromTop(60), juce::Justification::centred, 1);
 }
 
+bool KrumpVSTAudioProcessorEditor::keyPressed(const juce::KeyPress& key)
+{
+    if (key.getKeyCode() != 'Z' || !key.getModifiers().isCommandDown())
+        return false;
+
+    if (key.getModifiers().isShiftDown())
+        audioProcessor.editHistory.redo();
+    else
+        audioProcessor.editHistory.undo();
+    return true;
+}
+
+bool KrumpVSTAudioProcessorEditor::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    if (files.size() != 1)
+        return false;
+
+    auto& formatManager = audioProcessor.samplerEngine.getFormatManager();
+    return formatManager.findFormatForFileExtension(juce::File(files[0]).getFileExtension()) != nullptr;
+}
+
+void KrumpVSTAudioProcessorEditor::filesDropped(const juce::StringArray& files, int x, int y)
+{
+    for (int i = 0; i < SamplerEngine::numPads; ++i)
+        if (padButtons[static_cast<size_t>(i)].getBounds().contains(x, y))
+            audioProcessor.samplerEngine.loadPad(i, juce::File(files[0]));
+}
+
 void KrumpVSTAudioProcessorEditor::resized()
 {
+    inputMeter.setBounds(getLocalBounds().removeFromLeft(40).reduced(10, 60));
+    outputMeter.setBounds(getLocalBounds().removeFromRight(40).reduced(10, 60));
+    reducedRateButton.setBounds(getLocalBounds().removeFromTop(60).removeFromRight(140).reduced(10, 15));
+
     auto area = getLocalBounds().reduced(40).removeFromTop(getHeight() - 80);
-    auto sliderW = area.getWidth() / 6;
+
+    // パッドは最下段に1列で並べる
+    auto padArea = area.removeFromBottom(area.getHeight() / 8).reduced(10, 0);
+    const int padWidth = padArea.getWidth() / SamplerEngine::numPads;
+    for (auto& pad : padButtons)
+        pad.setBounds(padArea.removeFromLeft(padWidth).reduced(2));
+
+    // 右の列: ラックの下にモーフィング
+    auto rackColumn = area.removeFromRight(area.getWidth() / 3).reduced(10, 0);
+    morphPanel.setBounds(rackColumn.removeFromBottom(110));
+    effectRack.setBounds(rackColumn.withTrimmedBottom(6));
+    auto lowerRow = area.removeFromBottom(area.getHeight() / 3);
+    presetBrowser.setBounds(lowerRow.removeFromRight(lowerRow.getWidth() / 3).reduced(10, 0));
+    spectrumDisplay.setBounds(lowerRow.reduced(10, 0));
+    auto sliderW = area.getWidth() / 7;
     auto sliderH = area.getHeight() - 30;
     roomSizeSlider.setBounds(area.removeFromLeft(sliderW).reduced(10, 20));
     roomSizeLabel.setBounds(roomSizeSlider.getX(), roomSizeSlider.getBottom(), sliderW, 20);
@@ -146,4 +226,6 @@ void KrumpVSTAudioProcessorEditor::resized()
     widthLabel.setBounds(widthSlider.getX(), widthSlider.getBottom(), sliderW, 20);
     freezeSlider.setBounds(area.removeFromLeft(sliderW).reduced(10, 20));
     freezeLabel.setBounds(freezeSlider.getX(), freezeSlider.getBottom(), sliderW, 20);
+    duckSlider.setBounds(area.removeFromLeft(sliderW).reduced(10, 20));
+    duckLabel.setBounds(duckSlider.getX(), duckSlider.getBottom(), sliderW, 20);
 }
\ No newline at end of file
@@ -2,6 +2,11 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../Core/PluginProcessor.h"
+#include "../../src/gui/components/LevelMeter.h"
+#include "../../src/gui/components/SpectrumDisplay.h"
+#include "../../src/gui/components/EffectRackView.h"
+#include "../../src/gui/components/PresetBrowser.h"
+#include "../../src/gui/components/MorphPanel.h"
 
 // ダーク＋レッドのモダンUI LookAndFeel
 class CustomLookAndFeel : public juce::LookAndFeel_V4 {
@@ -12,7 +17,8 @@ public:
     void drawLabel(juce::Graphics&, juce::Label&) override;
 };
 
-class KrumpVSTAudioProcessorEditor : public juce::AudioProcessorEditor
+class KrumpVSTAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                     public juce::FileDragAndDropTarget
 {
 public:
     KrumpVSTAudioProcessorEditor(KrumpVSTAudioProcessor&);
@@ -21,13 +27,34 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
 
+    // Cmd/Ctrl+Z でアンドゥ、Cmd/Ctrl+Shift+Z でリドゥ
+    bool keyPressed(const juce::KeyPress& key) override;
+
+    // パッドへドロップしたオーディオファイルを割り当てる
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
 private:
     KrumpVSTAudioProcessor& audioProcessor;
     juce::Font customFont;
     CustomLookAndFeel customLnf;
     // リバーブパラメータ用
-    juce::Slider roomSizeSlider, dampingSlider, wetSlider, drySlider, widthSlider, freezeSlider;
-    juce::Label roomSizeLabel, dampingLabel, wetLabel, dryLabel, widthLabel, freezeLabel;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> roomSizeAttach, dampingAttach, wetAttach, dryAttach, widthAttach, freezeAttach;
+    juce::Slider roomSizeSlider, dampingSlider, wetSlider, drySlider, widthSlider, freezeSlider, duckSlider;
+    juce::Label roomSizeLabel, dampingLabel, wetLabel, dryLabel, widthLabel, freezeLabel, duckLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> roomSizeAttach, dampingAttach, wetAttach, dryAttach, widthAttach, freezeAttach, duckAttach;
+    // ウェットの低減レート処理（高いサンプルレートでの負荷を抑える）
+    juce::ToggleButton reducedRateButton { "Eco Wet" };
+    // 入出力メーター（左右の余白に配置）
+    LevelMeter inputMeter, outputMeter;
+    SpectrumDisplay spectrumDisplay;
+    // エフェクトチェーンのラック（見えている分だけ EffectComponent を割り当てる）
+    EffectRackView effectRack;
+    // プリセットの保存先とライブラリ検索（プロセッサーが持つ）。ブラウザで選んだプリセットはチェーンへ読み込み、履歴に積まれる
+    PresetManager& presetManager;
+    PresetBrowser presetBrowser;
+    // ライブラリから選んだ2つか4つのプリセット間のモーフィング
+    MorphPanel morphPanel;
+    // サンプラーのパッド（押した瞬間に発音する。MIDIノート 36-51 と同じパッド）
+    std::array<juce::TextButton, SamplerEngine::numPads> padButtons;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KrumpVSTAudioProcessorEditor)
 };
\ No newline at end of file
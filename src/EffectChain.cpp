@@ -1,33 +1,199 @@
 #include "EffectChain.h"
-#include "audio/effects/DelayEffect.h"
-#include "audio/effects/FilterEffect.h"
-#include "audio/effects/DistortionEffect.h"
+#include "presets/PresetMorpher.h"
+#include "audio/modulation/ModulationMatrix.h"
+#include <algorithm>
 
-EffectChain::EffectChain() = default;
+EffectChain::EffectChain()
+{
+    effects.reserve(maxEffects);
+    retiredEffects.reserve(maxEffects);
+    connections.reserve(maxConnections);
+}
 
 void EffectChain::prepare(const juce::dsp::ProcessSpec& spec)
 {
+    // prepare 中はオーディオスレッドが止まっているので、保留中のエフェクトはすべて返却できる
+    releaseRetiredEffects(true);
+
+    // エフェクトと作業バスが一度に受け取るのはサブブロックまで（ホストのブロック長によらない）
     currentSpec = spec;
+    currentSpec.maximumBlockSize = static_cast<juce::uint32>(subBlocks.getMaximumBlockSize());
+    kernels = &DspKernels::getBest();
+
+    pool.prepare(currentSpec);
+    if (presetMorpher != nullptr)
+        presetMorpher->prepare(spec.sampleRate);
+    if (modulationMatrix != nullptr)
+        modulationMatrix->prepare(spec.sampleRate);
     for (auto& effect : effects)
     {
-        effect->prepare(spec);
+        effect->prepare(currentSpec);
+        effect->getOutputMeter().prepare(spec.sampleRate);
     }
+
+    layoutStateArena();
+
+    // グラフの作業バス（ホストのバス 0 以外）
+    busChannels = static_cast<int>(spec.numChannels);
+    busBuffer.setSize(busChannels * (maxBuses - 1), static_cast<int>(currentSpec.maximumBlockSize));
+    busBuffer.clear();
+
+    // レイテンシはサンプルレートで変わりうるので、補償遅延を作り直す（オーディオは止まっている）
+    publishProcessingOrder();
 }
 
-void EffectChain::process(juce::AudioBuffer<float>& buffer)
+void EffectChain::layoutStateArena()
 {
+    // prepare 直後のエフェクトはすべて自前の領域にいるので、古いアリーナはここで作り直せる
+    size_t totalBytes = 0;
+    for (const auto& effect : effects)
+        totalBytes += effect->getStateBytes();
+
+    stateArena.allocate(totalBytes);
+
+    size_t offset = 0;
     for (auto& effect : effects)
     {
-        effect->process(buffer);
+        if (effect->getStateBytes() == 0)
+            continue;
+
+        effect->moveStateTo(stateArena.getData() + offset);
+        offset += effect->getStateBytes();
     }
 }
 
+void EffectChain::process(juce::AudioBuffer<float>& buffer)
+{
+    // 新しい処理順序があれば受け取り、受け取った世代をメッセージスレッドへ知らせる
+    if ((sharedOrder.load(std::memory_order_relaxed) & newOrderFlag) != 0)
+    {
+        audioOrder = sharedOrder.exchange(audioOrder, std::memory_order_acq_rel) & orderIndexMask;
+        acknowledgedGeneration.store(orders[static_cast<size_t>(audioOrder)].generation, std::memory_order_release);
+    }
+
+    auto& order = orders[static_cast<size_t>(audioOrder)];
+    subBlocks.process(buffer, [this, &order](juce::AudioBuffer<float>& subBlock, int)
+    {
+        processSubBlock(order, subBlock);
+    });
+}
+
+void EffectChain::processSubBlock(ProcessingOrder& order, juce::AudioBuffer<float>& subBlock)
+{
+    // ホストのオートメーションで変わった値だけを反映し、モーフとモジュレーションはサブブロック単位で進める
+    if (parameterPool != nullptr)
+        parameterPool->applyChanges();
+
+    if (presetMorpher != nullptr)
+        presetMorpher->process(order.effects.data(), order.numEffects, subBlock.getNumSamples());
+
+    // モジュレーションはモーフの後（基準値が決まってから）。キーはチェーンの入力
+    if (modulationMatrix != nullptr)
+        modulationMatrix->process(order.effects.data(), order.numEffects, subBlock);
+
+    // コンパイル済みの手順をなぞるだけ。直列ならすべてバス 0（ホストのバッファ）上の process になる
+    using Type = RoutingSchedule::Step::Type;
+    const int numSamples = subBlock.getNumSamples();
+    const int numChannels = juce::jmin(subBlock.getNumChannels(), busChannels);
+
+    for (int s = 0; s < order.numSteps; ++s)
+    {
+        const auto& step = order.steps[static_cast<size_t>(s)];
+        if (step.delayLine >= 0)
+        {
+            processDelayedStep(order, step, subBlock, numChannels);
+            continue;
+        }
+
+        switch (step.type)
+        {
+            case Type::process:
+            {
+                auto& bus = step.destination == 0 ? subBlock : busView;
+                if (step.destination != 0)
+                    busView.setDataToReferTo(busBuffer.getArrayOfWritePointers() + (step.destination - 1) * busChannels,
+                                             numChannels, numSamples);
+
+                step.effect->process(bus);
+                step.effect->getOutputMeter().measureBlock(bus);
+                break;
+            }
+
+            case Type::copy:
+                for (int ch = 0; ch < numChannels; ++ch)
+                    kernels->copyWithGain(getBusChannel(subBlock, step.destination, ch),
+                                          getBusChannel(subBlock, step.source, ch), step.gain, numSamples);
+                break;
+
+            case Type::add:
+                for (int ch = 0; ch < numChannels; ++ch)
+                    kernels->addWithGain(getBusChannel(subBlock, step.destination, ch),
+                                         getBusChannel(subBlock, step.source, ch), step.gain, numSamples);
+                break;
+
+            case Type::scale:
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    auto* channel = getBusChannel(subBlock, step.destination, ch);
+                    kernels->copyWithGain(channel, channel, step.gain, numSamples);
+                }
+                break;
+
+            case Type::clear:
+                for (int ch = 0; ch < subBlock.getNumChannels(); ++ch)
+                    juce::FloatVectorOperations::clear(subBlock.getWritePointer(ch), numSamples);
+                break;
+        }
+    }
+}
+
+void EffectChain::processDelayedStep(ProcessingOrder& order, const Step& step, juce::AudioBuffer<float>& subBlock, int numChannels)
+{
+    // 遅延線へ書いてから delay サンプル前を読む。delay >= 1 なので source と destination が同じバスでもよい
+    using Type = RoutingSchedule::Step::Type;
+    const int numSamples = subBlock.getNumSamples();
+    const int mask = order.delayMask;
+    auto& writePosition = order.delayWritePositions[static_cast<size_t>(step.delayLine)];
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* ring = order.delayLines.getWritePointer(step.delayLine * busChannels + ch);
+        const auto* source = getBusChannel(subBlock, step.source, ch);
+        auto* destination = getBusChannel(subBlock, step.destination, ch);
+
+        int write = writePosition;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            ring[write] = source[i];
+            const float delayed = ring[(write - step.delay) & mask] * step.gain;
+            destination[i] = step.type == Type::add ? destination[i] + delayed : delayed;
+            write = (write + 1) & mask;
+        }
+    }
+
+    writePosition = (writePosition + numSamples) & mask;
+}
+
+float* EffectChain::getBusChannel(juce::AudioBuffer<float>& subBlock, int bus, int channel)
+{
+    return bus == 0 ? subBlock.getWritePointer(channel)
+                    : busBuffer.getWritePointer((bus - 1) * busChannels + channel);
+}
+
 void EffectChain::reset()
 {
+    // アリーナにいるエフェクトの状態は1回の memset で消える
+    stateArena.clear();
     for (auto& effect : effects)
     {
-        effect->reset();
+        if (effect->ownsStateMemory())
+            effect->reset();
+        else
+            effect->resetScalars();
     }
+
+    for (auto& order : orders)
+        order.delayLines.clear();
 }
 
 void EffectChain::addEffect(std::unique_ptr<Effect> effect)
@@ -35,15 +201,32 @@ void EffectChain::addEffect(std::unique_ptr<Effect> effect)
     if (effect)
     {
         effect->prepare(currentSpec);
-        effects.push_back(std::move(effect));
+        effect->getOutputMeter().prepare(currentSpec.sampleRate);
+        insertEffect(std::move(effect));
     }
 }
 
+Effect* EffectChain::addEffect(EffectTypeId typeId)
+{
+    if (getNumEffects() >= maxEffects)
+        return nullptr;
+
+    // プールの在庫は prepare 済みなので、そのまま追加できる
+    return insertEffect(pool.acquire(typeId));
+}
+
 void EffectChain::removeEffect(int index)
 {
     if (index >= 0 && index < effects.size())
     {
+        if (parameterPool != nullptr)
+            parameterPool->unbind(*effects[index]);
+
+        auto effect = std::move(effects[index]);
         effects.erase(effects.begin() + index);
+        publishProcessingOrder();
+        retireEffect(std::move(effect));
+        sendChangeMessage();
     }
 }
 
@@ -56,6 +239,8 @@ void EffectChain::moveEffect(int fromIndex, int toIndex)
         auto effect = std::move(effects[fromIndex]);
         effects.erase(effects.begin() + fromIndex);
         effects.insert(effects.begin() + toIndex, std::move(effect));
+        publishProcessingOrder();
+        sendChangeMessage();
     }
 }
 
@@ -68,11 +253,153 @@ Effect* EffectChain::getEffect(int index)
     return nullptr;
 }
 
+void EffectChain::setParameterPool(EffectParameterPool* newParameterPool)
+{
+    if (parameterPool != nullptr)
+        parameterPool->unbindAll();
+
+    parameterPool = newParameterPool;
+    if (parameterPool != nullptr)
+        for (auto& effect : effects)
+            parameterPool->bind(*effect);
+}
+
+bool EffectChain::isNode(juce::uint32 id) const
+{
+    if (id == inputNodeId || id == outputNodeId)
+        return true;
+
+    for (const auto& effect : effects)
+        if (effect->getInstanceId() == id)
+            return true;
+    return false;
+}
+
+bool EffectChain::addConnection(const Connection& connection)
+{
+    if (static_cast<int>(connections.size()) >= maxConnections
+        || connection.source == outputNodeId || connection.destination == inputNodeId
+        || connection.source == connection.destination
+        || !isNode(connection.source) || !isNode(connection.destination))
+        return false;
+
+    for (const auto& existing : connections)
+        if (existing.source == connection.source && existing.destination == connection.destination)
+            return false;
+
+    // 試しにコンパイルし、巡回や幅の超過があれば戻す
+    connections.push_back(connection);
+    if (!compileSchedule())
+    {
+        connections.pop_back();
+        return false;
+    }
+
+    publishProcessingOrder();
+    sendChangeMessage();
+    return true;
+}
+
+bool EffectChain::removeConnection(juce::uint32 source, juce::uint32 destination)
+{
+    for (auto it = connections.begin(); it != connections.end(); ++it)
+    {
+        if (it->source == source && it->destination == destination)
+        {
+            connections.erase(it);
+            publishProcessingOrder();
+            sendChangeMessage();
+            return true;
+        }
+    }
+    return false;
+}
+
+void EffectChain::clearConnections()
+{
+    if (connections.empty())
+        return;
+
+    connections.clear();
+    publishProcessingOrder();
+    sendChangeMessage();
+}
+
+bool EffectChain::compileSchedule()
+{
+    const int numNodes = getNumEffects();
+    const auto latencies = getEffectLatencies();
+    if (connections.empty())
+        return schedule.compile(numNodes, RoutingSchedule::makeSeries(numNodes), maxBuses, latencies);
+
+    // instanceId を並び順の添字へ置き換える（存在しないノードへの接続はコンパイル時に無視される）
+    auto toNode = [this](juce::uint32 id)
+    {
+        if (id == inputNodeId)
+            return RoutingSchedule::inputNode;
+        if (id == outputNodeId)
+            return RoutingSchedule::outputNode;
+
+        for (size_t i = 0; i < effects.size(); ++i)
+            if (effects[i]->getInstanceId() == id)
+                return static_cast<int>(i);
+        return maxEffects + 2;
+    };
+
+    std::vector<RoutingSchedule::Connection> indexed;
+    indexed.reserve(connections.size());
+    for (const auto& connection : connections)
+        indexed.push_back({ toNode(connection.source), toNode(connection.destination), connection.gain });
+
+    return schedule.compile(numNodes, indexed, maxBuses, latencies);
+}
+
 int EffectChain::getNumEffects() const
 {
     return static_cast<int>(effects.size());
 }
 
+size_t EffectChain::getStateBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& effect : effects)
+        bytes += effect->getStateBytes();
+    return bytes;
+}
+
+int EffectChain::getProcessingLatencySamples() const
+{
+    return orders[static_cast<size_t>(audioOrder)].latency;
+}
+
+bool EffectChain::isLatencyCompensationStale() const
+{
+    const auto& order = orders[static_cast<size_t>(audioOrder)];
+    for (int i = 0; i < order.numEffects; ++i)
+    {
+        const auto* effect = order.effects[static_cast<size_t>(i)];
+        if ((effect->getEnabled() ? effect->getLatencySamples() : 0) != order.latencies[static_cast<size_t>(i)])
+            return true;
+    }
+    return false;
+}
+
+void EffectChain::updateLatencyCompensation()
+{
+    if (getEffectLatencies() != publishedLatencies)
+        publishProcessingOrder();
+}
+
+std::vector<int> EffectChain::getEffectLatencies() const
+{
+    // 無効なエフェクトは素通しなので遅延しない
+    std::vector<int> latencies;
+    latencies.reserve(effects.size());
+    for (const auto& effect : effects)
+        latencies.push_back(effect->getEnabled() ? effect->getLatencySamples() : 0);
+    return latencies;
+}
+
 void EffectChain::saveToXml(juce::XmlElement& xml) const
 {
     for (size_t i = 0; i < effects.size(); ++i)
@@ -80,32 +407,366 @@ void EffectChain::saveToXml(juce::XmlElement& xml) const
         auto effectElement = xml.createNewChildElement("Effect");
         effectElement->setAttribute("Index", static_cast<int>(i));
         effectElement->setAttribute("Type", effects[i]->getName());
-        effects[i]->saveToXml(*effectElement);
+        effectElement->setAttribute("TypeId", static_cast<int>(effects[i]->getTypeId()));
+        if (effects[i]->getParameterSlot() >= 0)
+            effectElement->setAttribute("ParameterSlot", effects[i]->getParameterSlot());
+        saveEffectToXml(*effects[i], *effectElement);
+    }
+
+    // 接続はエフェクトの並び順の添字で保存する（-1 は入力、-2 は出力）
+    if (!connections.empty())
+    {
+        auto toIndex = [this](juce::uint32 id)
+        {
+            if (id == inputNodeId)
+                return RoutingSchedule::inputNode;
+            if (id == outputNodeId)
+                return RoutingSchedule::outputNode;
+
+            for (size_t i = 0; i < effects.size(); ++i)
+                if (effects[i]->getInstanceId() == id)
+                    return static_cast<int>(i);
+            return RoutingSchedule::inputNode;
+        };
+
+        auto* routingElement = xml.createNewChildElement("Routing");
+        for (const auto& connection : connections)
+        {
+            auto* connectionElement = routingElement->createNewChildElement("Connection");
+            connectionElement->setAttribute("Source", toIndex(connection.source));
+            connectionElement->setAttribute("Destination", toIndex(connection.destination));
+            connectionElement->setAttribute("Gain", connection.gain);
+        }
     }
 }
 
 void EffectChain::loadFromXml(const juce::XmlElement& xml)
 {
+    // 現在のエフェクトは新しい順序が受け取られた後にプールへ返却して再利用する
+    if (parameterPool != nullptr)
+        parameterPool->unbindAll();
+
+    auto previousEffects = std::move(effects);
     effects.clear();
-    
+
+    const auto& registry = EffectRegistry::getInstance();
+    juce::Array<int> preferredSlots;
+
     forEachXmlChildElementWithTagName(xml, effectElement, "Effect")
     {
-        const juce::String type = effectElement->getStringAttribute("Type");
-        std::unique_ptr<Effect> effect;
-        
-        // エフェクトの再作成
-        if (type == "Delay")
-            effect = std::make_unique<DelayEffect>();
-        else if (type == "Filter")
-            effect = std::make_unique<FilterEffect>();
-        else if (type == "Distortion")
-            effect = std::make_unique<DistortionEffect>();
-            
-        if (effect)
+        if (getNumEffects() >= maxEffects)
+            break;
+
+        // TypeId を優先し、古いプリセットは Type 文字列から解決する
+        auto typeId = static_cast<EffectTypeId>(effectElement->getIntAttribute("TypeId", 0));
+        if (!registry.isRegistered(typeId))
+            typeId = registry.findTypeId(effectElement->getStringAttribute("Type"));
+
+        if (auto effect = pool.acquire(typeId))
         {
             effect->loadFromXml(*effectElement);
-            effect->prepare(currentSpec);
+            effect->setInstanceId(nextInstanceId++);
+            preferredSlots.add(effectElement->getIntAttribute("ParameterSlot", -1));
             effects.push_back(std::move(effect));
         }
     }
-} 
\ No newline at end of file
+
+    if (parameterPool != nullptr)
+    {
+        // 保存時と同じスロットへ先に戻し、ホスト側のオートメーションの対応を保つ。
+        // スロットを持たない古いプリセットのエフェクトは残りの空きへ割り当てる
+        for (size_t i = 0; i < effects.size(); ++i)
+            if (preferredSlots[static_cast<int>(i)] >= 0)
+                parameterPool->bind(*effects[i], preferredSlots[static_cast<int>(i)]);
+
+        for (auto& effect : effects)
+            parameterPool->bind(*effect);
+    }
+
+    // 接続がないプリセットは直列
+    connections.clear();
+    if (auto* routingElement = xml.getChildByName("Routing"))
+    {
+        auto toId = [this](int index)
+        {
+            if (index == RoutingSchedule::inputNode)
+                return inputNodeId;
+            if (index == RoutingSchedule::outputNode)
+                return outputNodeId;
+            return juce::isPositiveAndBelow(index, getNumEffects()) ? effects[static_cast<size_t>(index)]->getInstanceId()
+                                                                  : inputNodeId;
+        };
+
+        forEachXmlChildElementWithTagName(*routingElement, connectionElement, "Connection")
+        {
+            if (static_cast<int>(connections.size()) >= maxConnections)
+                break;
+
+            connections.push_back({ toId(connectionElement->getIntAttribute("Source", RoutingSchedule::inputNode)),
+                                    toId(connectionElement->getIntAttribute("Destination", RoutingSchedule::outputNode)),
+                                    static_cast<float>(connectionElement->getDoubleAttribute("Gain", 1.0)) });
+        }
+    }
+
+    publishProcessingOrder();
+    for (auto& effect : previousEffects)
+        retireEffect(std::move(effect));
+    sendChangeMessage();
+}
+
+ChainSnapshot::Ptr EffectChain::createSnapshot(const ChainSnapshot* previous) const
+{
+    std::vector<EffectState::Ptr> states;
+    states.reserve(effects.size());
+
+    std::vector<float> values;
+    for (size_t i = 0; i < effects.size(); ++i)
+    {
+        auto& effect = *effects[i];
+
+        values.resize(static_cast<size_t>(effect.getNumParameters()));
+        for (int p = 0; p < effect.getNumParameters(); ++p)
+            values[static_cast<size_t>(p)] = getParameterValue(effect, p);
+
+        // 前のスナップショットに同じインスタンスの同じ状態があれば共有する
+        // （並べ替えだけなら同じ位置にあるとは限らないので、まず同じ位置、次に全体を探す）
+        EffectState::Ptr shared;
+        if (previous != nullptr)
+        {
+            const auto& previousStates = previous->effects;
+            auto matches = [&effect, &values](const EffectState::Ptr& state)
+            {
+                return state->instanceId == effect.getInstanceId()
+                    && state->parameterSlot == effect.getParameterSlot()
+                    && state->hasSameValues(effect.getEnabled(), values);
+            };
+
+            if (i < previousStates.size() && matches(previousStates[i]))
+                shared = previousStates[i];
+            else
+                for (const auto& state : previousStates)
+                    if (matches(state))
+                    {
+                        shared = state;
+                        break;
+                    }
+        }
+
+        if (shared == nullptr)
+            shared = new EffectState(effect.getTypeId(), effect.getInstanceId(), effect.getEnabled(),
+                                     effect.getParameterSlot(), values);
+
+        states.push_back(shared);
+    }
+
+    // 接続が前のスナップショットと同じならルーティングも共有する
+    std::vector<ConnectionState> routing;
+    routing.reserve(connections.size());
+    for (const auto& connection : connections)
+        routing.push_back({ connection.source, connection.destination, connection.gain });
+
+    RoutingState::Ptr sharedRouting;
+    if (previous != nullptr && previous->routing != nullptr && previous->routing->connections == routing)
+        sharedRouting = previous->routing;
+    else
+        sharedRouting = new RoutingState(std::move(routing));
+
+    return new ChainSnapshot(std::move(states), std::move(sharedRouting));
+}
+
+void EffectChain::restoreSnapshot(const ChainSnapshot& snapshot)
+{
+    // スナップショットに残っているインスタンスはそのまま再利用する（DSPの状態も保たれる）
+    std::vector<std::unique_ptr<Effect>> restored;
+    restored.reserve(maxEffects);
+
+    for (const auto& state : snapshot.effects)
+    {
+        std::unique_ptr<Effect> effect;
+        for (auto& current : effects)
+        {
+            if (current != nullptr && current->getInstanceId() == state->instanceId && current->getTypeId() == state->typeId)
+            {
+                effect = std::move(current);
+                break;
+            }
+        }
+        restored.push_back(std::move(effect));
+    }
+
+    // 使われなくなったインスタンスはスロットを空けてから新しい順序の受け取りを待つ
+    auto previousEffects = std::move(effects);
+    effects.clear();
+    for (auto& effect : previousEffects)
+        if (effect != nullptr && parameterPool != nullptr)
+            parameterPool->unbind(*effect);
+
+    for (size_t i = 0; i < restored.size(); ++i)
+    {
+        const auto& state = *snapshot.effects[i];
+        auto& effect = restored[i];
+
+        if (effect == nullptr)
+        {
+            // 削除されていたエフェクト: プールから取り出し、まだ処理されていないので直接設定する
+            effect = pool.acquire(state.typeId);
+            if (effect == nullptr)
+                continue;
+
+            effect->setInstanceId(state.instanceId);
+            effect->setEnabled(state.isEnabled);
+            for (size_t p = 0; p < state.parameters.size(); ++p)
+                effect->setParameter(static_cast<int>(p), state.parameters[p]);
+
+            if (parameterPool != nullptr)
+                parameterPool->bind(*effect, state.parameterSlot);
+        }
+        else
+        {
+            // 処理中のエフェクト: 変わった値だけをホストパラメータ経由でオーディオスレッドへ渡す
+            effect->setEnabled(state.isEnabled);
+            for (size_t p = 0; p < state.parameters.size(); ++p)
+            {
+                const int index = static_cast<int>(p);
+                if (getParameterValue(*effect, index) == state.parameters[p])
+                    continue;
+
+                if (parameterPool != nullptr)
+                    parameterPool->setParameterFromUi(*effect, index, state.parameters[p]);
+                else
+                    effect->setParameter(index, state.parameters[p]);
+            }
+        }
+
+        effects.push_back(std::move(effect));
+    }
+
+    // 接続を戻す。公開時にスケジュールをコンパイルし直す（取り出せなかったエフェクトへの接続はそこで外れる）
+    connections.clear();
+    if (snapshot.routing != nullptr)
+        for (const auto& connection : snapshot.routing->connections)
+            connections.push_back({ connection.source, connection.destination, connection.gain });
+
+    publishProcessingOrder();
+    for (auto& effect : previousEffects)
+        retireEffect(std::move(effect));
+}
+
+Effect* EffectChain::insertEffect(std::unique_ptr<Effect> effect)
+{
+    if (effect == nullptr || getNumEffects() >= maxEffects)
+        return nullptr;
+
+    auto* rawEffect = effect.get();
+    rawEffect->setInstanceId(nextInstanceId++);
+    if (parameterPool != nullptr)
+        parameterPool->bind(*rawEffect);
+
+    effects.push_back(std::move(effect));
+    publishProcessingOrder();
+    sendChangeMessage();
+    return rawEffect;
+}
+
+void EffectChain::retireEffect(std::unique_ptr<Effect> effect)
+{
+    if (effect == nullptr)
+        return;
+
+    // 直前に公開した順序にはもう含まれていないので、その世代が受け取られれば返却できる
+    retiredEffects.push_back({ std::move(effect), nextGeneration - 1 });
+    releaseRetiredEffects(false);
+}
+
+void EffectChain::publishProcessingOrder()
+{
+    // 外したエフェクトへの接続を消す（前後はつながない）
+    connections.erase(std::remove_if(connections.begin(), connections.end(), [this](const Connection& connection)
+    {
+        return !isNode(connection.source) || !isNode(connection.destination);
+    }), connections.end());
+
+    // 不正なグラフ（壊れたプリセットなど）は直列に戻す
+    if (!compileSchedule())
+    {
+        connections.clear();
+        compileSchedule();
+    }
+
+    auto& order = orders[static_cast<size_t>(backOrder)];
+    order.numEffects = juce::jmin(getNumEffects(), maxEffects);
+    for (int i = 0; i < order.numEffects; ++i)
+        order.effects[static_cast<size_t>(i)] = effects[static_cast<size_t>(i)].get();
+
+    publishedLatencies = getEffectLatencies();
+    for (int i = 0; i < order.numEffects; ++i)
+        order.latencies[static_cast<size_t>(i)] = publishedLatencies[static_cast<size_t>(i)];
+    order.latency = schedule.getLatencySamples();
+
+    // 補償遅延のある手順に遅延線を1本ずつ割り当てる
+    const auto& steps = schedule.getSteps();
+    order.numSteps = juce::jmin(static_cast<int>(steps.size()), maxSteps);
+    int numDelayLines = 0;
+    for (int i = 0; i < order.numSteps; ++i)
+    {
+        const auto& step = steps[static_cast<size_t>(i)];
+        order.steps[static_cast<size_t>(i)] = { step.type,
+                                                step.node >= 0 ? effects[static_cast<size_t>(step.node)].get() : nullptr,
+                                                step.source, step.destination, step.gain, step.delay,
+                                                step.delay > 0 ? numDelayLines++ : -1 };
+    }
+
+    // この順序はメッセージスレッドのものなので、ここで確保し直してよい
+    const int delayLength = numDelayLines > 0 ? juce::nextPowerOfTwo(schedule.getMaxDelay() + 1) : 0;
+    order.delayLines.setSize(numDelayLines * busChannels, delayLength, false, false, true);
+    order.delayLines.clear();
+    order.delayWritePositions.fill(0);
+    order.delayMask = juce::jmax(0, delayLength - 1);
+    order.generation = nextGeneration++;
+
+    backOrder = sharedOrder.exchange(backOrder | newOrderFlag, std::memory_order_acq_rel) & orderIndexMask;
+}
+
+void EffectChain::releaseRetiredEffects(bool audioIsStopped)
+{
+    const auto acknowledged = acknowledgedGeneration.load(std::memory_order_acquire);
+
+    for (auto it = retiredEffects.begin(); it != retiredEffects.end();)
+    {
+        if (audioIsStopped || it->generation <= acknowledged)
+        {
+            // アリーナは次の prepare で作り直されるので、プールで待つ間は自前の領域を持たせる
+            if (!it->effect->ownsStateMemory())
+                it->effect->moveStateToOwnedMemory();
+
+            pool.release(std::move(it->effect));
+            it = retiredEffects.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+float EffectChain::getParameterValue(Effect& effect, int parameterIndex) const
+{
+    const float value = parameterPool != nullptr ? parameterPool->getParameterValue(effect, parameterIndex)
+                                                 : effect.getParameter(parameterIndex);
+
+    // ブロック単位の変調は値を書き換えているので、基準値へ読み替える
+    if (modulationMatrix != nullptr)
+        return modulationMatrix->getBaseValue(effect, parameterIndex, value);
+
+    return value;
+}
+
+void EffectChain::saveEffectToXml(Effect& effect, juce::XmlElement& xml) const
+{
+    // 処理中のエフェクトは書き換えず、基準値（未反映の変更を含み、変調は除く）をそのまま書き出す
+    std::array<float, Effect::maxParameters> values {};
+    for (int p = 0; p < juce::jmin(effect.getNumParameters(), Effect::maxParameters); ++p)
+        values[static_cast<size_t>(p)] = getParameterValue(effect, p);
+
+    effect.saveValuesToXml(xml, values.data());
+}
@@ -3,28 +3,196 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include "audio/effects/Effect.h"
+#include "audio/effects/EffectPool.h"
+#include "audio/effects/EffectParameterPool.h"
+#include "audio/SubBlockScheduler.h"
+#include "audio/RoutingSchedule.h"
+#include "audio/kernels/DspKernels.h"
+#include "core/ChainSnapshot.h"
 
-class EffectChain
+class PresetMorpher;
+class ModulationMatrix;
+
+/**
+ * リバーブの前段に挿入されるエフェクトチェーン
+ * - 接続がなければ並び順の直列。接続（センド/パラレル/ミックス）を追加するとルーティンググラフとして処理する
+ * - 編集（追加/削除/並べ替え/ロード/履歴の復元）はメッセージスレッドで行い、
+ *   オーディオスレッドへは処理順序の配列をトリプルバッファでロックフリーに受け渡す
+ * - グラフは編集のたびにメッセージスレッドで RoutingSchedule へコンパイルし、(エフェクト, 入力バス, 出力バス) の
+ *   平坦な手順として渡す。オーディオスレッドは手順をなぞるだけでルーティングの判断をしない
+ * - コンパイル時に各エフェクトのレイテンシを渡し、並列経路の合流点に補償遅延を入れる。
+ *   遅延線は順序ごとにメッセージスレッドで確保するので、プリセットのロードで遅延が変わってもオーディオスレッドは確保しない
+ * - 外したエフェクトはオーディオスレッドが新しい順序を受け取るまで保持してからプールへ返す
+ * - 構造が変わると ChangeBroadcaster で通知する（編集履歴が購読する）
+ * - process はホストのブロックを固定長のサブブロックに分け、サブブロックごとにパラメータ・モーフ・モジュレーションを反映してから
+ *   全エフェクトへ通す。エフェクトの prepare にはサブブロック長を最大ブロック長として渡す
+ * - prepare でチェーン内のエフェクトの状態メモリを合計し、1つのアリーナに処理順に並べて割り当てる。
+ *   次の prepare までに追加されたエフェクトは自前の1ブロックを使い、外れたエフェクトは自前の領域へ戻ってからプールへ返る
+ */
+class EffectChain : public juce::ChangeBroadcaster
 {
 public:
     EffectChain();
-    
+    ~EffectChain() override = default;
+
     void prepare(const juce::dsp::ProcessSpec& spec);
     void process(juce::AudioBuffer<float>& buffer);
     void reset();
 
+    // ===== メッセージスレッド =====
     void addEffect(std::unique_ptr<Effect> effect);
+    Effect* addEffect(EffectTypeId typeId);
     void removeEffect(int index);
     void moveEffect(int fromIndex, int toIndex);
-    
+
     Effect* getEffect(int index);
     int getNumEffects() const;
 
+    // ===== ルーティング（メッセージスレッド） =====
+    // ノードはエフェクトの instanceId と、チェーンの入力 (inputNodeId) / 出力 (outputNodeId)。
+    // 接続があるときは、入力から出力までの経路上にないエフェクトは処理されない
+    static constexpr juce::uint32 inputNodeId = 0;
+    static constexpr juce::uint32 outputNodeId = 0xffffffff;
+
+    struct Connection
+    {
+        juce::uint32 source = inputNodeId;
+        juce::uint32 destination = outputNodeId;
+        float gain = 1.0f;
+    };
+
+    // 巡回・重複・存在しないノード・幅が maxBuses を超える場合は追加せずに false を返す
+    bool addConnection(const Connection& connection);
+    bool removeConnection(juce::uint32 source, juce::uint32 destination);
+    void clearConnections();
+    const std::vector<Connection>& getConnections() const { return connections; }
+
+    // 最後に公開した順序の入力から出力までのレイテンシ（最長経路。直列なら有効なエフェクトの和）
+    int getLatencySamples() const { return schedule.getLatencySamples(); }
+
+    // エフェクトのレイテンシ（モード切り替えや有効/無効）が公開時から変わっていれば、補償をやり直して公開する
+    void updateLatencyCompensation();
+
+    // オーディオスレッド用: 現在処理している順序のレイテンシと、その補償が古くなっているか
+    int getProcessingLatencySamples() const;
+    bool isLatencyCompensationStale() const;
+
+    // チェーン内のエフェクトの状態メモリの合計（バイト）と、そのうち prepare で確保したアリーナの大きさ
+    size_t getStateBytes() const;
+    size_t getArenaBytes() const { return stateArena.getSize(); }
+
     // XML関連
     void saveToXml(juce::XmlElement& xml) const;
     void loadFromXml(const juce::XmlElement& xml);
 
+    // 編集履歴用のスナップショット。previous と変わらないエフェクトの状態は共有する
+    ChainSnapshot::Ptr createSnapshot(const ChainSnapshot* previous) const;
+
+    // スナップショットの状態へ戻す。残っているインスタンスは再利用し、XMLは経由しない
+    void restoreSnapshot(const ChainSnapshot& snapshot);
+
+    EffectPool& getEffectPool() { return pool; }
+
+    // 追加したエフェクトをホストのパラメータスロットへ結び付ける（nullptr なら公開しない）
+    void setParameterPool(EffectParameterPool* newParameterPool);
+    EffectParameterPool* getParameterPool() const { return parameterPool; }
+
+    // プリセット間のモーフィング。ホストのオートメーションを反映した後に処理順序のエフェクトへ値を渡す
+    void setPresetMorpher(PresetMorpher* newPresetMorpher) { presetMorpher = newPresetMorpher; }
+
+    // LFO などによるパラメータの変調。モーフの後に処理順序のエフェクトへオフセットを渡す
+    void setModulationMatrix(ModulationMatrix* newModulationMatrix) { modulationMatrix = newModulationMatrix; }
+
+    // 内部のサブブロック長（次の prepare から有効）。後段のリバーブなども同じ区切りで処理する
+    void setSubBlockSize(int newSubBlockSize) { subBlocks.setSubBlockSize(newSubBlockSize); }
+    const SubBlockScheduler& getSubBlockScheduler() const { return subBlocks; }
+
+    static constexpr int maxEffects = 32;
+    static constexpr int maxConnections = 64;
+    static constexpr int maxBuses = 8; // ホストのバッファ + 作業バッファ 7 本
+
 private:
+    // オーディオスレッドが処理する順序（固定長なので受け渡しでヒープ確保をしない）
+    struct Step
+    {
+        RoutingSchedule::Step::Type type = RoutingSchedule::Step::Type::clear;
+        Effect* effect = nullptr;
+        int source = 0;
+        int destination = 0;
+        float gain = 1.0f;
+        int delay = 0;
+        int delayLine = -1; // 補償遅延がなければ -1
+    };
+
+    static constexpr int maxSteps = maxEffects + maxConnections + 1;
+
+    struct ProcessingOrder
+    {
+        std::array<Effect*, maxEffects> effects {};
+        int numEffects = 0;
+        std::array<Step, maxSteps> steps {};
+        int numSteps = 0;
+        juce::uint32 generation = 0;
+
+        // 補償に使ったレイテンシ。遅延線 l のチャンネル c は delayLines の l * busChannels + c
+        std::array<int, maxEffects> latencies {};
+        int latency = 0;
+        juce::AudioBuffer<float> delayLines;
+        std::array<int, maxSteps> delayWritePositions {};
+        int delayMask = 0;
+    };
+
+    struct RetiredEffect
+    {
+        std::unique_ptr<Effect> effect;
+        juce::uint32 generation = 0; // この世代以降の順序には含まれない
+    };
+
+    Effect* insertEffect(std::unique_ptr<Effect> effect);
+    void retireEffect(std::unique_ptr<Effect> effect);
+    void publishProcessingOrder();
+    void releaseRetiredEffects(bool audioIsStopped);
+    // 保存と編集履歴が記録する値（ホストの値。変調中のパラメータは変調前の基準値）
+    float getParameterValue(Effect& effect, int parameterIndex) const;
+    void saveEffectToXml(Effect& effect, juce::XmlElement& xml) const;
+    void processSubBlock(ProcessingOrder& order, juce::AudioBuffer<float>& subBlock);
+    void layoutStateArena();
+    bool compileSchedule();
+    std::vector<int> getEffectLatencies() const;
+    void processDelayedStep(ProcessingOrder& order, const Step& step, juce::AudioBuffer<float>& subBlock, int numChannels);
+    float* getBusChannel(juce::AudioBuffer<float>& subBlock, int bus, int channel);
+    bool isNode(juce::uint32 id) const;
+
+    // effects より先に破棄されないよう先に宣言する
+    EffectPool pool;
     std::vector<std::unique_ptr<Effect>> effects;
-    juce::dsp::ProcessSpec currentSpec;
-}; 
\ No newline at end of file
+    std::vector<RetiredEffect> retiredEffects;
+    DspArena stateArena;
+    std::vector<Connection> connections;
+    RoutingSchedule schedule;           // メッセージスレッド専用
+    std::vector<int> publishedLatencies; // 最後に公開した順序の補償に使ったレイテンシ
+
+    // 作業バス（バス 1 以降）。バス b のチャンネル c は (b - 1) * busChannels + c
+    juce::AudioBuffer<float> busBuffer;
+    juce::AudioBuffer<float> busView;   // オーディオスレッド専用
+    int busChannels = 0;
+    const DspKernels* kernels = &DspKernels::getBaseline(); // バス間のミックス（prepare で CPU に合わせて選ぶ）
+    juce::dsp::ProcessSpec currentSpec { 44100.0, 512, 2 };
+    EffectParameterPool* parameterPool = nullptr;
+    PresetMorpher* presetMorpher = nullptr;
+    ModulationMatrix* modulationMatrix = nullptr;
+    SubBlockScheduler subBlocks;
+    juce::uint32 nextInstanceId = 1;
+
+    // トリプルバッファ: sharedOrder の下位ビットが添字、newOrderFlag が未取得の順序があることを示す
+    static constexpr int newOrderFlag = 4;
+    static constexpr int orderIndexMask = 3;
+    std::array<ProcessingOrder, 3> orders;
+    std::atomic<int> sharedOrder { 1 };
+    int audioOrder = 0;  // オーディオスレッド専用
+    int backOrder = 2;   // メッセージスレッド専用
+    juce::uint32 nextGeneration = 1;
+    std::atomic<juce::uint32> acknowledgedGeneration { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectChain)
+};
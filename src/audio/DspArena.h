@@ -0,0 +1,85 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * DSPの状態メモリ（ディレイライン、フィルターの状態、ブロック単位の作業領域）を切り出す連続領域
+ * - 先頭と各領域はキャッシュライン (alignment) に揃える
+ * - 配置は Allocator で2回行う。ベースなしの Allocator は大きさを数えるだけで nullptr を返し、
+ *   同じ手順をベースありで繰り返すと実際のポインタが得られる
+ * - 確保した領域は 0 で埋まっている。clear() で全体を一度に 0 へ戻せる
+ */
+class DspArena
+{
+public:
+    static constexpr size_t alignment = 64;
+
+    static constexpr size_t alignUp(size_t bytes)
+    {
+        return (bytes + alignment - 1) & ~(alignment - 1);
+    }
+
+    class Allocator
+    {
+    public:
+        Allocator() = default;
+        explicit Allocator(char* baseToUse) : base(baseToUse) {}
+
+        // count 個の T を切り出す（計測中は nullptr）
+        template <typename T>
+        T* allocate(int count)
+        {
+            offset = alignUp(offset);
+            T* result = base != nullptr ? reinterpret_cast<T*>(base + offset) : nullptr;
+            offset += sizeof(T) * static_cast<size_t>(juce::jmax(0, count));
+            return result;
+        }
+
+        size_t getBytesUsed() const { return alignUp(offset); }
+        bool isMeasuring() const { return base == nullptr; }
+
+    private:
+        char* base = nullptr;
+        size_t offset = 0;
+    };
+
+    DspArena() = default;
+
+    // ちょうど numBytes（alignment の倍数に切り上げ）を 0 で確保する。メッセージスレッドか、オーディオ停止中に呼ぶこと
+    void allocate(size_t numBytes)
+    {
+        size = alignUp(numBytes);
+        if (size == 0)
+        {
+            free();
+            return;
+        }
+
+        storage.calloc(size + alignment);
+        const auto address = reinterpret_cast<juce::pointer_sized_uint>(storage.get());
+        data = storage.get() + (alignUp(static_cast<size_t>(address)) - static_cast<size_t>(address));
+    }
+
+    void free()
+    {
+        storage.free();
+        data = nullptr;
+        size = 0;
+    }
+
+    void clear()
+    {
+        if (data != nullptr)
+            std::memset(data, 0, size);
+    }
+
+    char* getData() const { return data; }
+    size_t getSize() const { return size; }
+
+private:
+    juce::HeapBlock<char> storage;
+    char* data = nullptr;
+    size_t size = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspArena)
+};
@@ -0,0 +1,258 @@
+#include "RoutingSchedule.h"
+#include <algorithm>
+
+std::vector<RoutingSchedule::Connection> RoutingSchedule::makeSeries(int numNodes)
+{
+    std::vector<Connection> series;
+    int previous = inputNode;
+    for (int node = 0; node < numNodes; ++node)
+    {
+        series.push_back({ previous, node, 1.0f });
+        previous = node;
+    }
+    series.push_back({ previous, outputNode, 1.0f });
+    return series;
+}
+
+bool RoutingSchedule::compile(int numNodes, const std::vector<Connection>& connections, int maxBuses,
+                              const std::vector<int>& latencies)
+{
+    steps.clear();
+    executionOrder.clear();
+    numBuses = 1;
+    latency = 0;
+    maxDelay = 0;
+
+    // 内部では入力を numNodes、出力を numNodes + 1 として扱う
+    const int input = numNodes;
+    const int output = numNodes + 1;
+    const int total = numNodes + 2;
+    auto toInternal = [input, output](int node)
+    {
+        return node == inputNode ? input : (node == outputNode ? output : node);
+    };
+
+    auto fail = [this]
+    {
+        steps.clear();
+        executionOrder.clear();
+        numBuses = 1;
+        latency = 0;
+        maxDelay = 0;
+        return false;
+    };
+
+    struct Edge
+    {
+        int source;
+        int destination;
+        float gain;
+    };
+
+    // 範囲外のノードへの接続（削除されたエフェクトなど）は無視する
+    std::vector<Edge> edges;
+    std::vector<std::vector<int>> outgoing(static_cast<size_t>(total));
+    std::vector<int> inDegree(static_cast<size_t>(total), 0);
+    for (const auto& connection : connections)
+    {
+        const int source = toInternal(connection.source);
+        const int destination = toInternal(connection.destination);
+        if (!juce::isPositiveAndBelow(source, total) || !juce::isPositiveAndBelow(destination, total)
+            || source == output || destination == input)
+            continue;
+
+        if (source == destination)
+            return fail();
+
+        outgoing[static_cast<size_t>(source)].push_back(static_cast<int>(edges.size()));
+        ++inDegree[static_cast<size_t>(destination)];
+        edges.push_back({ source, destination, connection.gain });
+    }
+
+    // トポロジカル順（準備のできたノードのうち添字の小さいもの、つまり並び順を優先する）。残りがあれば巡回
+    std::vector<int> order;
+    std::vector<int> ready;
+    for (int node = 0; node < total; ++node)
+        if (inDegree[static_cast<size_t>(node)] == 0)
+            ready.push_back(node);
+
+    while (!ready.empty())
+    {
+        auto next = std::min_element(ready.begin(), ready.end());
+        const int node = *next;
+        ready.erase(next);
+        order.push_back(node);
+
+        for (int e : outgoing[static_cast<size_t>(node)])
+            if (--inDegree[static_cast<size_t>(edges[static_cast<size_t>(e)].destination)] == 0)
+                ready.push_back(edges[static_cast<size_t>(e)].destination);
+    }
+
+    if (static_cast<int>(order.size()) != total)
+        return fail();
+
+    // 入力から届き、かつ出力へ届くノードだけを実行する
+    std::vector<char> fromInput(static_cast<size_t>(total), 0);
+    std::vector<char> toOutput(static_cast<size_t>(total), 0);
+    fromInput[static_cast<size_t>(input)] = 1;
+    toOutput[static_cast<size_t>(output)] = 1;
+    for (int node : order)
+        if (fromInput[static_cast<size_t>(node)] != 0)
+            for (int e : outgoing[static_cast<size_t>(node)])
+                fromInput[static_cast<size_t>(edges[static_cast<size_t>(e)].destination)] = 1;
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+        for (int e : outgoing[static_cast<size_t>(*it)])
+            if (toOutput[static_cast<size_t>(edges[static_cast<size_t>(e)].destination)] != 0)
+                toOutput[static_cast<size_t>(*it)] = 1;
+
+    auto isActive = [&fromInput, &toOutput](int node)
+    {
+        return fromInput[static_cast<size_t>(node)] != 0 && toOutput[static_cast<size_t>(node)] != 0;
+    };
+
+    if (!isActive(output))
+    {
+        // 入力から出力への経路がない: 無音
+        steps.push_back({ Step::Type::clear, -1, 0, 0, 1.0f });
+        return true;
+    }
+
+    // 実行位置と、各ノードの出力を最後に読む位置
+    std::vector<int> position(static_cast<size_t>(total), -1);
+    std::vector<int> activeOrder;
+    for (int node : order)
+        if (isActive(node))
+        {
+            position[static_cast<size_t>(node)] = static_cast<int>(activeOrder.size());
+            activeOrder.push_back(node);
+        }
+
+    std::vector<int> lastUse(static_cast<size_t>(total), -1);
+    std::vector<std::vector<int>> incoming(static_cast<size_t>(total));
+    for (int e = 0; e < static_cast<int>(edges.size()); ++e)
+    {
+        const auto& edge = edges[static_cast<size_t>(e)];
+        if (!isActive(edge.source) || !isActive(edge.destination))
+            continue;
+
+        incoming[static_cast<size_t>(edge.destination)].push_back(e);
+        lastUse[static_cast<size_t>(edge.source)] = juce::jmax(lastUse[static_cast<size_t>(edge.source)],
+                                                               position[static_cast<size_t>(edge.destination)]);
+    }
+
+    // 各ノードへ入力がそろう時刻と、出力が出る時刻。合流点では遅い入力に揃える
+    auto nodeLatency = [&latencies, numNodes](int node)
+    {
+        return node < numNodes && node < static_cast<int>(latencies.size())
+                   ? juce::jmax(0, latencies[static_cast<size_t>(node)]) : 0;
+    };
+
+    std::vector<int> arrival(static_cast<size_t>(total), 0);
+    std::vector<int> departure(static_cast<size_t>(total), 0);
+    for (int node : activeOrder)
+    {
+        for (int e : incoming[static_cast<size_t>(node)])
+            arrival[static_cast<size_t>(node)] = juce::jmax(arrival[static_cast<size_t>(node)],
+                                                            departure[static_cast<size_t>(edges[static_cast<size_t>(e)].source)]);
+        departure[static_cast<size_t>(node)] = arrival[static_cast<size_t>(node)] + nodeLatency(node);
+    }
+
+    latency = arrival[static_cast<size_t>(output)];
+    auto delayOf = [&](int e)
+    {
+        const auto& edge = edges[static_cast<size_t>(e)];
+        const int delay = arrival[static_cast<size_t>(edge.destination)] - departure[static_cast<size_t>(edge.source)];
+        maxDelay = juce::jmax(maxDelay, delay);
+        return delay;
+    };
+
+    std::vector<int> busOf(static_cast<size_t>(total), -1);
+    std::vector<char> busInUse(static_cast<size_t>(juce::jmax(1, maxBuses)), 0);
+    busOf[static_cast<size_t>(input)] = 0;
+    busInUse[0] = 1;
+
+    auto allocateBus = [this, &busInUse]
+    {
+        for (int bus = 0; bus < static_cast<int>(busInUse.size()); ++bus)
+            if (busInUse[static_cast<size_t>(bus)] == 0)
+            {
+                busInUse[static_cast<size_t>(bus)] = 1;
+                numBuses = juce::jmax(numBuses, bus + 1);
+                return bus;
+            }
+        return -1;
+    };
+
+    for (int node : activeOrder)
+    {
+        if (node == input)
+            continue;
+
+        const int here = position[static_cast<size_t>(node)];
+        const auto& inputs = incoming[static_cast<size_t>(node)];
+
+        // その場で使える入力: 出力ノードはバス 0 にある入力、それ以外はここが最後の利用になる入力
+        int inPlace = -1;
+        for (int e : inputs)
+        {
+            const int source = edges[static_cast<size_t>(e)].source;
+            const bool usable = node == output ? busOf[static_cast<size_t>(source)] == 0
+                                               : lastUse[static_cast<size_t>(source)] == here;
+            if (usable)
+            {
+                inPlace = e;
+                break;
+            }
+        }
+
+        int target = -1;
+        if (inPlace >= 0)
+        {
+            target = busOf[static_cast<size_t>(edges[static_cast<size_t>(inPlace)].source)];
+            const int delay = delayOf(inPlace);
+            if (edges[static_cast<size_t>(inPlace)].gain != 1.0f || delay > 0)
+                steps.push_back({ Step::Type::scale, -1, target, target, edges[static_cast<size_t>(inPlace)].gain, delay });
+        }
+        else if (node == output)
+        {
+            target = 0;
+            busInUse[0] = 1;
+        }
+        else
+        {
+            target = allocateBus();
+            if (target < 0)
+                return fail();
+        }
+
+        bool written = inPlace >= 0;
+        for (int e : inputs)
+        {
+            if (e == inPlace)
+                continue;
+
+            const auto& edge = edges[static_cast<size_t>(e)];
+            steps.push_back({ written ? Step::Type::add : Step::Type::copy, -1,
+                              busOf[static_cast<size_t>(edge.source)], target, edge.gain, delayOf(e) });
+            written = true;
+        }
+
+        if (node != output)
+        {
+            steps.push_back({ Step::Type::process, node, target, target, 1.0f });
+            executionOrder.push_back(node);
+        }
+
+        busOf[static_cast<size_t>(node)] = target;
+
+        // ここで最後に読まれた出力のバスを空ける
+        for (int e : inputs)
+        {
+            const int bus = busOf[static_cast<size_t>(edges[static_cast<size_t>(e)].source)];
+            if (lastUse[static_cast<size_t>(edges[static_cast<size_t>(e)].source)] == here && bus != target)
+                busInUse[static_cast<size_t>(bus)] = 0;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/**
+ * エフェクトのルーティンググラフを平坦な実行手順へコンパイルする（メッセージスレッド専用）
+ * - ノードはエフェクトの並び順の添字と、チェーンの入力 (inputNode) / 出力 (outputNode)
+ * - 接続はゲイン付き。複数の入力を持つノードはそれらの和を処理する（センド/パラレル/ミックス）
+ * - 入力から届き、出力へ届くノードだけを実行する。巡回があればコンパイルは失敗する
+ * - バッファは生存区間で割り当てる。ノードの出力は最後の利用者が処理されるまでだけ生き、
+ *   最後の利用者はそのバッファをその場で使うので、必要なバッファ数はグラフの最大幅で済む
+ * - バス 0 はホストのバッファ。入力ノードの出力はバス 0 にあり、出力ノードの結果もバス 0 に置く
+ * - ノードのレイテンシを渡すと遅延補償もする。合流点には最も遅い入力に揃えるための遅延を
+ *   接続ごとに付け（copy/add/scale の delay）、出力までの最長経路の遅延を getLatencySamples() で返す
+ */
+class RoutingSchedule
+{
+public:
+    static constexpr int inputNode = -1;
+    static constexpr int outputNode = -2;
+
+    struct Connection
+    {
+        int source = inputNode;
+        int destination = outputNode;
+        float gain = 1.0f;
+    };
+
+    struct Step
+    {
+        enum class Type : std::uint8_t
+        {
+            clear,    // destination = 0
+            copy,     // destination = delay(source) * gain
+            add,      // destination += delay(source) * gain
+            scale,    // destination = delay(destination) * gain
+            process   // node のエフェクトで destination をその場で処理する
+        };
+
+        Type type = Type::clear;
+        int node = -1;
+        int source = 0;
+        int destination = 0;
+        float gain = 1.0f;
+        int delay = 0; // 遅延補償のサンプル数（copy/add/scale のみ）
+    };
+
+    RoutingSchedule() = default;
+
+    // numNodes 個のノードと接続から手順を作る。巡回や maxBuses を超える幅の場合は false（内容は空になる）。
+    // latencies はノードごとのレイテンシ（足りない分は 0）
+    bool compile(int numNodes, const std::vector<Connection>& connections, int maxBuses,
+                 const std::vector<int>& latencies = {});
+
+    // 接続なしの直列（入力 → 0 → 1 → ... → 出力）
+    static std::vector<Connection> makeSeries(int numNodes);
+
+    const std::vector<Step>& getSteps() const { return steps; }
+    int getNumBuses() const { return numBuses; }
+
+    // 入力から出力までの最長経路のレイテンシと、補償遅延のうち最長のもの
+    int getLatencySamples() const { return latency; }
+    int getMaxDelay() const { return maxDelay; }
+
+    // 実行されるノードの順序（トポロジカル順、入出力を除く）
+    const std::vector<int>& getExecutionOrder() const { return executionOrder; }
+
+private:
+    std::vector<Step> steps;
+    std::vector<int> executionOrder;
+    int numBuses = 1;
+    int latency = 0;
+    int maxDelay = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RoutingSchedule)
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * ホストのブロックを固定長のサブブロックに分けて処理する
+ * - ホストのブロック長（1 サンプルからオフラインレンダリングの 8192 以上まで）に関係なく、
+ *   各段は最大 getSubBlockSize() サンプルずつ呼ばれる。端数は最後のサブブロックが受け持つ
+ * - 1つのサブブロックをすべての段に通してから次へ進むので、作業データがL1に収まり、
+ *   パラメータやモジュレーションの更新はサブブロックの境界で反映される
+ * - サブブロックはホストのバッファを参照する AudioBuffer で、コピーもヒープ確保もしない
+ */
+class SubBlockScheduler
+{
+public:
+    static constexpr int minSubBlockSize = 32;
+    static constexpr int maxSubBlockSize = 128;
+    static constexpr int defaultSubBlockSize = 64;
+
+    SubBlockScheduler() = default;
+    explicit SubBlockScheduler(int newSubBlockSize) { setSubBlockSize(newSubBlockSize); }
+
+    // オーディオを止めている間に呼ぶこと（段の prepare に渡す最大ブロック長が変わる）
+    void setSubBlockSize(int newSubBlockSize)
+    {
+        subBlockSize = juce::jlimit(minSubBlockSize, maxSubBlockSize, newSubBlockSize);
+    }
+
+    int getSubBlockSize() const { return subBlockSize; }
+
+    // 段の prepare に渡す最大ブロック長。ホストは prepare で伝えたより長いブロックを渡すことがあるので、
+    // ホストのブロック長では縮めない（process はいつでもサブブロック長まで切り出す）
+    int getMaximumBlockSize() const { return subBlockSize; }
+
+    // callback(juce::AudioBuffer<float>& subBlock, int startSample) をサブブロックごとに呼ぶ
+    template <typename Callback>
+    void process(juce::AudioBuffer<float>& buffer, Callback&& callback) const
+    {
+        const int numSamples = buffer.getNumSamples();
+        const int numChannels = buffer.getNumChannels();
+        auto* const* channels = buffer.getArrayOfWritePointers();
+
+        for (int start = 0; start < numSamples; start += subBlockSize)
+        {
+            juce::AudioBuffer<float> subBlock(channels, numChannels, start, juce::jmin(subBlockSize, numSamples - start));
+            callback(subBlock, start);
+        }
+    }
+
+private:
+    int subBlockSize = defaultSubBlockSize;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SubBlockScheduler)
+};
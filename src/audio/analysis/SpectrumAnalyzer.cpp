@@ -0,0 +1,199 @@
+#include "SpectrumAnalyzer.h"
+
+namespace
+{
+    // スムージング: 上昇は即座に追従し、下降はゆっくり落とす
+    constexpr float releaseCoefficient = 0.2f;
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+    : juce::Thread("Krump Spectrum Analyzer")
+{
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(windowTable.data(), fftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+
+    for (auto& tap : taps)
+        tap.smoothedDb.fill(minimumDb);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    stopThread(1000);
+}
+
+void SpectrumAnalyzer::prepare(double sampleRate)
+{
+    currentSampleRate.store(sampleRate);
+}
+
+void SpectrumAnalyzer::pushSamples(Tap tap, const juce::AudioBuffer<float>& buffer)
+{
+    // エディターが閉じていれば何もしない
+    if (!active.load(std::memory_order_relaxed))
+        return;
+
+    auto& state = taps[static_cast<size_t>(tap)];
+    const int numChannels = juce::jmin(2, buffer.getNumChannels());
+    if (numChannels == 0)
+        return;
+
+    // 解析が追いつかずFIFOが一杯なら、入りきらない分は捨てる
+    int start1, size1, start2, size2;
+    state.fifo.prepareToWrite(buffer.getNumSamples(), start1, size1, start2, size2);
+
+    auto copyRegion = [&](int destStart, int sourceStart, int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        auto* dest = state.fifoBuffer.data() + destStart;
+
+        if (numChannels == 1)
+        {
+            juce::FloatVectorOperations::copy(dest, buffer.getReadPointer(0, sourceStart), numSamples);
+        }
+        else
+        {
+            juce::FloatVectorOperations::copyWithMultiply(dest, buffer.getReadPointer(0, sourceStart), 0.5f, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(dest, buffer.getReadPointer(1, sourceStart), 0.5f, numSamples);
+        }
+    };
+
+    copyRegion(start1, 0, size1);
+    copyRegion(start2, size1, size2);
+    state.fifo.finishedWrite(size1 + size2);
+}
+
+void SpectrumAnalyzer::addClient()
+{
+    if (++numClients == 1)
+    {
+        active.store(true);
+        startThread();
+    }
+}
+
+void SpectrumAnalyzer::removeClient()
+{
+    if (numClients > 0 && --numClients == 0)
+    {
+        active.store(false);
+        stopThread(1000);
+    }
+}
+
+bool SpectrumAnalyzer::updatePath(Tap tap)
+{
+    auto& state = taps[static_cast<size_t>(tap)];
+
+    if ((state.readyIndex.load(std::memory_order_acquire) & newPathFlag) == 0)
+        return false;
+
+    state.readIndex = state.readyIndex.exchange(state.readIndex, std::memory_order_acq_rel) & ~newPathFlag;
+    return true;
+}
+
+void SpectrumAnalyzer::run()
+{
+    // 停止中に溜まった古いサンプルは捨てて、表示をリセットする
+    for (auto& tap : taps)
+    {
+        tap.fifo.finishedRead(tap.fifo.getNumReady());
+        tap.window.fill(0.0f);
+        tap.smoothedDb.fill(minimumDb);
+    }
+
+    while (!threadShouldExit())
+    {
+        for (int i = 0; i < numTaps; ++i)
+        {
+            auto& tap = taps[static_cast<size_t>(i)];
+            bool analysed = false;
+
+            while (tap.fifo.getNumReady() >= hopSize)
+            {
+                // 窓をホップ分ずらし、新しいサンプルを末尾へ読み込む
+                std::copy(tap.window.begin() + hopSize, tap.window.end(), tap.window.begin());
+
+                int start1, size1, start2, size2;
+                tap.fifo.prepareToRead(hopSize, start1, size1, start2, size2);
+                auto* dest = tap.window.data() + fftSize - hopSize;
+                std::copy_n(tap.fifoBuffer.data() + start1, size1, dest);
+                std::copy_n(tap.fifoBuffer.data() + start2, size2, dest + size1);
+                tap.fifo.finishedRead(size1 + size2);
+
+                analyse(i);
+                analysed = true;
+            }
+
+            if (analysed)
+                publishPath(i);
+        }
+
+        wait(10);
+    }
+}
+
+void SpectrumAnalyzer::analyse(int tapIndex)
+{
+    auto& tap = taps[static_cast<size_t>(tapIndex)];
+    const double sampleRate = currentSampleRate.load();
+
+    // 表示点ごとのFFTビン範囲（対数周波数）。サンプルレートが変わったときだけ作り直す
+    if (sampleRate != binEdgesSampleRate)
+    {
+        const double nyquist = sampleRate * 0.5;
+        const double ratio = nyquist / minimumFrequency;
+
+        for (int i = 0; i <= numDisplayPoints; ++i)
+        {
+            const double frequency = minimumFrequency * std::pow(ratio, static_cast<double>(i) / numDisplayPoints);
+            binEdges[static_cast<size_t>(i)] = juce::jlimit(1, fftSize / 2, static_cast<int>(frequency * fftSize / sampleRate));
+        }
+
+        binEdgesSampleRate = sampleRate;
+    }
+
+    std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+    juce::FloatVectorOperations::multiply(fftBuffer.data(), tap.window.data(), windowTable.data(), fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftBuffer.data(), true);
+
+    // ハン窓のコヒーレントゲイン (N / 2) と片側スペクトルの 2 倍を補正し、正弦波の振幅を 0dB 基準にする
+    const float magnitudeScale = 4.0f / static_cast<float>(fftSize);
+
+    for (int i = 0; i < numDisplayPoints; ++i)
+    {
+        const int first = binEdges[static_cast<size_t>(i)];
+        const int last = juce::jmax(first + 1, binEdges[static_cast<size_t>(i + 1)]);
+
+        float magnitude = 0.0f;
+        for (int bin = first; bin < last && bin <= fftSize / 2; ++bin)
+            magnitude = juce::jmax(magnitude, fftBuffer[static_cast<size_t>(bin)]);
+
+        const float db = juce::Decibels::gainToDecibels(magnitude * magnitudeScale, minimumDb);
+        auto& smoothed = tap.smoothedDb[static_cast<size_t>(i)];
+        smoothed = db > smoothed ? db : smoothed + (db - smoothed) * releaseCoefficient;
+    }
+}
+
+void SpectrumAnalyzer::publishPath(int tapIndex)
+{
+    auto& tap = taps[static_cast<size_t>(tapIndex)];
+    auto& path = tap.paths[static_cast<size_t>(tap.writeIndex)];
+
+    // clear() は確保済みの領域を残すので、2回目以降はメモリ確保が起きない
+    path.clear();
+
+    for (int i = 0; i < numDisplayPoints; ++i)
+    {
+        const float x = static_cast<float>(i) / (numDisplayPoints - 1);
+        const float y = juce::jlimit(0.0f, 1.0f, (maximumDb - tap.smoothedDb[static_cast<size_t>(i)]) / (maximumDb - minimumDb));
+
+        if (i == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+
+    tap.writeIndex = tap.readyIndex.exchange(tap.writeIndex | newPathFlag, std::memory_order_acq_rel) & ~newPathFlag;
+}
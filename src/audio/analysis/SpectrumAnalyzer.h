@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <juce_graphics/juce_graphics.h>
+#include <array>
+#include <atomic>
+
+/**
+ * エディター用のスペクトラムアナライザー
+ * - オーディオスレッドはタップごとのロックフリーFIFOへサンプルをコピーするだけ
+ * - 窓掛けFFT、スムージング、対数周波数へのビン割り当て、描画パスの生成はバックグラウンドスレッドで行う
+ * - 生成したパスはトリプルバッファでGUIへ渡す（ロックなし）
+ * - 表示しているエディターがなければスレッドは止まり、オーディオスレッドは atomic を1回読むだけ
+ */
+class SpectrumAnalyzer : private juce::Thread
+{
+public:
+    enum Tap
+    {
+        preFilter = 0,  // エフェクトチェーンの入力
+        postReverb,     // 最終出力
+        numTaps
+    };
+
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+    static constexpr int numDisplayPoints = 256;
+    static constexpr int fifoSize = 16384;
+    static constexpr float minimumFrequency = 20.0f;
+    static constexpr float minimumDb = -90.0f;
+    static constexpr float maximumDb = 6.0f;
+
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer() override;
+
+    void prepare(double sampleRate);
+
+    // ===== オーディオスレッド =====
+    void pushSamples(Tap tap, const juce::AudioBuffer<float>& buffer);
+
+    // ===== メッセージスレッド =====
+    // 表示するコンポーネントが登録されている間だけ解析スレッドを動かす
+    void addClient();
+    void removeClient();
+
+    // 新しいパスがあれば取り込んで true を返す
+    bool updatePath(Tap tap);
+
+    // x, y とも 0〜1 に正規化したパス（y = 0 が maximumDb）
+    const juce::Path& getPath(Tap tap) const { return taps[static_cast<size_t>(tap)].paths[static_cast<size_t>(taps[static_cast<size_t>(tap)].readIndex)]; }
+
+private:
+    void run() override;
+    void analyse(int tapIndex);
+    void publishPath(int tapIndex);
+
+    struct TapState
+    {
+        // オーディオスレッド → 解析スレッド
+        juce::AbstractFifo fifo { fifoSize };
+        std::array<float, fifoSize> fifoBuffer {};
+
+        // 解析スレッド専用
+        std::array<float, fftSize> window {};             // 直近 fftSize サンプル
+        std::array<float, numDisplayPoints> smoothedDb {};
+
+        // 解析スレッド → GUI（トリプルバッファ）
+        std::array<juce::Path, 3> paths;
+        std::atomic<int> readyIndex { 1 };  // 最新のパスの位置。newPathFlag が立っていれば未読
+        int writeIndex = 0;                 // 解析スレッド専用
+        int readIndex = 2;                  // メッセージスレッド専用
+    };
+
+    static constexpr int newPathFlag = 4;
+
+    std::array<TapState, numTaps> taps;
+    std::atomic<bool> active { false };
+    std::atomic<double> currentSampleRate { 44100.0 };
+    int numClients = 0;
+
+    // 解析スレッド専用の作業領域
+    juce::dsp::FFT fft { fftOrder };
+    std::array<float, fftSize> windowTable {};
+    std::array<float, fftSize * 2> fftBuffer {};
+    std::array<int, numDisplayPoints + 1> binEdges {};
+    double binEdgesSampleRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
+};
@@ -0,0 +1,238 @@
+#include "DelayEffect.h"
+#include "EffectRegistry.h"
+
+KRUMP_REGISTER_EFFECT(DelayEffect, EffectTypeId::delay, "Delay")
+
+DelayEffect::DelayEffect()
+{
+    smoothedDelay.setCurrentAndTargetValue(msToSamples(delayTimeMs));
+    smoothedFeedback.setCurrentAndTargetValue(feedback);
+    smoothedMix.setCurrentAndTargetValue(mix);
+}
+
+void DelayEffect::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = static_cast<float>(spec.sampleRate);
+    blockSize = juce::jmax(1, static_cast<int>(spec.maximumBlockSize));
+    numChannels = static_cast<int>(spec.numChannels);
+
+    // 最大ディレイ + 補間タップ分を2のべき乗に切り上げる
+    const int maxDelaySamples = static_cast<int>(std::ceil(maxDelayMs * 0.001f * sampleRate)) + 4;
+    ringSize = juce::nextPowerOfTwo(maxDelaySamples);
+    ringMask = ringSize - 1;
+
+    allocateState();
+
+    smoothedDelay.reset(spec.sampleRate, 0.05);
+    smoothedFeedback.reset(spec.sampleRate, 0.02);
+    smoothedMix.reset(spec.sampleRate, 0.02);
+    reset();
+}
+
+void DelayEffect::layoutState(DspArena::Allocator& allocator)
+{
+    ringBuffer = allocator.allocate<float>(ringSize * juce::jmax(1, numChannels));
+    delayTimes = allocator.allocate<float>(blockSize);
+    feedbackGains = allocator.allocate<float>(blockSize);
+    mixGains = allocator.allocate<float>(blockSize);
+    taps = allocator.allocate<float>(blockSize);
+    allpassStates = allocator.allocate<float>(juce::jmax(1, numChannels));
+}
+
+void DelayEffect::process(juce::AudioBuffer<float>& buffer)
+{
+    if (!isEnabled || ringSize == 0)
+        return;
+
+    smoothedDelay.setTargetValue(msToSamples(delayTimeMs));
+    smoothedFeedback.setTargetValue(feedback);
+    smoothedMix.setTargetValue(mix);
+
+    // ホストのブロックが prepare 時より大きい場合に備えて分割する
+    const int numSamples = buffer.getNumSamples();
+    for (int start = 0; start < numSamples; start += blockSize)
+        processChunk(buffer, start, juce::jmin(blockSize, numSamples - start));
+}
+
+void DelayEffect::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // スムージング済みの値はチャンネル間で共有する
+    for (int i = 0; i < numSamples; ++i)
+    {
+        delayTimes[i] = smoothedDelay.getNextValue();
+        feedbackGains[i] = smoothedFeedback.getNextValue();
+        mixGains[i] = smoothedMix.getNextValue();
+    }
+
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+    for (int offset = 0; offset < numSamples;)
+    {
+        // スムージングは単調なランプなので、区間の最小ディレイは両端のどちらか。
+        // 最も新しいタップ (ディレイ - 1) がこの区間で書き込む位置に届かない長さだけ進める
+        const float minDelay = juce::jmin(delayTimes[offset], delayTimes[numSamples - 1]);
+        const int length = juce::jmin(numSamples - offset, juce::jmax(1, static_cast<int>(minDelay) - 1));
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            float* ring = ringBuffer + static_cast<size_t>(ch) * static_cast<size_t>(ringSize);
+            float* data = buffer.getWritePointer(ch, startSample + offset);
+
+            readTaps(ring, delayTimes + offset, taps, length, ch);
+
+            const float* fb = feedbackGains + offset;
+            for (int i = 0; i < length; ++i)
+                ring[(writeIndex + i) & ringMask] = data[i] + fb[i] * taps[i];
+
+            const float* wet = mixGains + offset;
+            for (int i = 0; i < length; ++i)
+                data[i] += wet[i] * (taps[i] - data[i]);
+        }
+
+        writeIndex = (writeIndex + length) & ringMask;
+        offset += length;
+    }
+}
+
+void DelayEffect::readTaps(const float* ring, const float* delays, float* dest, int numSamples, int channel)
+{
+    // インデックスはすべてマスクで折り返す（負の値も2の補数でそのまま正しく折り返る）
+    switch (interpolation)
+    {
+        case Interpolation::linear:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int delayInt = static_cast<int>(delays[i]);
+                const float frac = delays[i] - static_cast<float>(delayInt);
+                const int index = writeIndex + i - delayInt;
+
+                const float x0 = ring[index & ringMask];
+                const float x1 = ring[(index - 1) & ringMask];
+                dest[i] = x0 + frac * (x1 - x0);
+            }
+            break;
+
+        case Interpolation::lagrange:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int delayInt = static_cast<int>(delays[i]);
+                const float f = delays[i] - static_cast<float>(delayInt);
+                const int index = writeIndex + i - delayInt;
+
+                // ディレイ (delayInt - 1) 〜 (delayInt + 2) の4点ラグランジュ補間
+                const float xm1 = ring[(index + 1) & ringMask];
+                const float x0 = ring[index & ringMask];
+                const float x1 = ring[(index - 1) & ringMask];
+                const float x2 = ring[(index - 2) & ringMask];
+
+                const float fp1 = f + 1.0f;
+                const float fm1 = f - 1.0f;
+                const float fm2 = f - 2.0f;
+
+                dest[i] = xm1 * (-f * fm1 * fm2 * (1.0f / 6.0f))
+                        + x0 * (fp1 * fm1 * fm2 * 0.5f)
+                        + x1 * (-fp1 * f * fm2 * 0.5f)
+                        + x2 * (fp1 * f * fm1 * (1.0f / 6.0f));
+            }
+            break;
+
+        case Interpolation::allpass:
+        {
+            // 1次ティラン・オールパス。係数が -1 に近づかないよう端数を [0.618, 1.618) に保つ
+            float state = allpassStates[channel];
+            for (int i = 0; i < numSamples; ++i)
+            {
+                int delayInt = static_cast<int>(delays[i]);
+                float frac = delays[i] - static_cast<float>(delayInt);
+                if (frac < 0.618f)
+                {
+                    --delayInt;
+                    frac += 1.0f;
+                }
+
+                const float a = (1.0f - frac) / (1.0f + frac);
+                const int index = writeIndex + i - delayInt;
+
+                state = a * ring[index & ringMask] + ring[(index - 1) & ringMask] - a * state;
+                dest[i] = state;
+            }
+            allpassStates[channel] = state;
+            break;
+        }
+    }
+}
+
+void DelayEffect::resetScalars()
+{
+    writeIndex = 0;
+    smoothedDelay.setCurrentAndTargetValue(msToSamples(delayTimeMs));
+    smoothedFeedback.setCurrentAndTargetValue(feedback);
+    smoothedMix.setCurrentAndTargetValue(mix);
+}
+
+float DelayEffect::msToSamples(float ms) const
+{
+    const float maxSamples = ringSize > 0 ? static_cast<float>(ringSize - 4)
+                                          : maxDelayMs * 0.001f * sampleRate;
+    return juce::jlimit(minDelaySamples, juce::jmax(minDelaySamples, maxSamples), ms * 0.001f * sampleRate);
+}
+
+juce::StringArray DelayEffect::getParameterNames() const
+{
+    return {"Time", "Feedback", "Mix", "Interpolation"};
+}
+
+juce::StringArray DelayEffect::getParameterLabels() const
+{
+    return {"ms", "%", "%", ""};
+}
+
+juce::Array<float> DelayEffect::getParameterRanges() const
+{
+    return {
+        1.0f, maxDelayMs, 250.0f,  // Time: 1ms - 2000ms
+        0.0f, 0.95f, 0.4f,         // Feedback: 0 - 0.95
+        0.0f, 1.0f, 0.5f,          // Mix: 0 - 1
+        0.0f, 2.0f, 0.0f           // Interpolation: Linear / Lagrange / Allpass
+    };
+}
+
+void DelayEffect::setParameter(int parameterIndex, float value)
+{
+    switch (parameterIndex)
+    {
+        case 0: delayTimeMs = juce::jlimit(1.0f, maxDelayMs, value); break;
+        case 1: feedback = juce::jlimit(0.0f, 0.95f, value); break;
+        case 2: mix = juce::jlimit(0.0f, 1.0f, value); break;
+        case 3: interpolation = static_cast<Interpolation>(juce::jlimit(0, 2, juce::roundToInt(value))); break;
+        default: break;
+    }
+}
+
+float DelayEffect::getParameter(int parameterIndex) const
+{
+    switch (parameterIndex)
+    {
+        case 0: return delayTimeMs;
+        case 1: return feedback;
+        case 2: return mix;
+        case 3: return static_cast<float>(interpolation);
+        default: return 0.0f;
+    }
+}
+
+void DelayEffect::saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const
+{
+    xml.setAttribute("Time", parameterValues[0]);
+    xml.setAttribute("Feedback", parameterValues[1]);
+    xml.setAttribute("Mix", parameterValues[2]);
+    xml.setAttribute("Interpolation", juce::roundToInt(parameterValues[3]));
+}
+
+void DelayEffect::loadFromXml(const juce::XmlElement& xml)
+{
+    setParameter(0, static_cast<float>(xml.getDoubleAttribute("Time", delayTimeMs)));
+    setParameter(1, static_cast<float>(xml.getDoubleAttribute("Feedback", feedback)));
+    setParameter(2, static_cast<float>(xml.getDoubleAttribute("Mix", mix)));
+    setParameter(3, static_cast<float>(xml.getIntAttribute("Interpolation", static_cast<int>(interpolation))));
+}
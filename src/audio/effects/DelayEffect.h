@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Effect.h"
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * ディレイエフェクト
+ * - 全チャンネル分を1本の連続した2のべき乗リングバッファに確保し、マスクでラップする
+ * - ディレイタイムはスムージングされ、分数ディレイを補間して読み出す（リニア/ラグランジュ/オールパス）
+ * - 読み出しと書き込みはブロック単位で行い、サンプルごとのラップ判定は行わない
+ */
+class DelayEffect : public Effect
+{
+public:
+    enum class Interpolation
+    {
+        linear = 0,
+        lagrange,
+        allpass
+    };
+
+    DelayEffect();
+    ~DelayEffect() override = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    void process(juce::AudioBuffer<float>& buffer) override;
+    void resetScalars() override;
+
+    // パラメータ関連
+    juce::StringArray getParameterNames() const override;
+    juce::StringArray getParameterLabels() const override;
+    juce::Array<float> getParameterRanges() const override;
+    void setParameter(int parameterIndex, float value) override;
+    float getParameter(int parameterIndex) const override;
+
+    // エフェクト情報
+    juce::String getName() const override { return "Delay"; }
+    juce::String getCategory() const override { return "Delay"; }
+    EffectTypeId getTypeId() const override { return EffectTypeId::delay; }
+    int getNumParameters() const override { return 4; }
+
+    // プリセット関連
+    void saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const override;
+    void loadFromXml(const juce::XmlElement& xml) override;
+
+    static constexpr float maxDelayMs = 2000.0f;
+
+protected:
+    void layoutState(DspArena::Allocator& allocator) override;
+
+private:
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void readTaps(const float* ring, const float* delays, float* dest, int numSamples, int channel);
+    float msToSamples(float ms) const;
+
+    float delayTimeMs = 250.0f;  // ディレイタイム (1ms - 2000ms)
+    float feedback = 0.4f;       // フィードバック (0.0 - 0.95)
+    float mix = 0.5f;            // ウェット/ドライ (0.0 - 1.0)
+    Interpolation interpolation = Interpolation::linear;
+
+    // リングバッファ: チャンネル c は [c * ringSize, (c + 1) * ringSize) を使う（以下の配列は状態メモリから切り出す）
+    float* ringBuffer = nullptr;
+    int ringSize = 0;
+    int ringMask = 0;
+    int writeIndex = 0;
+    int numChannels = 0;
+
+    // ブロック単位の作業領域
+    float* delayTimes = nullptr;
+    float* feedbackGains = nullptr;
+    float* mixGains = nullptr;
+    float* taps = nullptr;
+    float* allpassStates = nullptr;
+
+    juce::SmoothedValue<float> smoothedDelay;
+    juce::SmoothedValue<float> smoothedFeedback;
+    juce::SmoothedValue<float> smoothedMix;
+
+    // ラグランジュ補間が未来側のタップを読まないための最小ディレイ
+    static constexpr float minDelaySamples = 4.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DelayEffect)
+};
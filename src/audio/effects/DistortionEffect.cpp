@@ -0,0 +1,470 @@
+#include "DistortionEffect.h"
+#include "EffectRegistry.h"
+
+KRUMP_REGISTER_EFFECT(DistortionEffect, EffectTypeId::distortion, "Distortion")
+
+namespace
+{
+    // 差分の分母がこれより小さい場合は中点評価にフォールバックする
+    constexpr double illConditionedTolerance = 1.0e-5;
+
+    /**
+     * f', f, F1, F2 をノードに持つエルミート補間テーブル
+     * 各レベルは1つ下のレベルを傾きとして使うので、F2 の差分から得られる F1 と矛盾しない。
+     * f は3次、F1 と F2 はさらに2つ下のレベルを曲率として使う5次
+     * （3次だと2階微分がノードで跳び、補間誤差も 2 次 ADAA の差分で増幅されて出力が段になる）。
+     * 範囲外は f を一定値として延長する（tanh のように飽和するシェイパー向け）
+     */
+    class HermiteTable
+    {
+    public:
+        template <typename Derivative, typename Function, typename FirstIntegral, typename SecondIntegral>
+        HermiteTable(double rangeToUse, int pointsPerUnit,
+                     Derivative&& derivative, Function&& function,
+                     FirstIntegral&& firstIntegral, SecondIntegral&& secondIntegral)
+            : range(rangeToUse),
+              step(1.0 / pointsPerUnit),
+              invStep(static_cast<double>(pointsPerUnit)),
+              numPoints(static_cast<int>(2.0 * rangeToUse * pointsPerUnit) + 1)
+        {
+            for (auto& level : levels)
+                level.resize(static_cast<size_t>(numPoints));
+
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const double x = -range + i * step;
+                levels[0][static_cast<size_t>(i)] = derivative(x);
+                levels[1][static_cast<size_t>(i)] = function(x);
+                levels[2][static_cast<size_t>(i)] = firstIntegral(x);
+                levels[3][static_cast<size_t>(i)] = secondIntegral(x);
+            }
+        }
+
+        template <int level>
+        void evaluate(const double* x, double* dest, int numSamples) const
+        {
+            const double* values = levels[level + 1].data();
+            const double* slopes = levels[level].data();
+            const double* f = levels[1].data();
+            const double* f1 = levels[2].data();
+            const int last = numPoints - 1;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const double clamped = juce::jlimit(-range, range, x[i]);
+                const double excess = x[i] - clamped;
+
+                const double position = (clamped + range) * invStep;
+                const int k = juce::jmin(static_cast<int>(position), last - 1);
+                const double t = position - k;
+                const double oneMinusT = 1.0 - t;
+
+                double result = 0.0;
+                if constexpr (level >= 1)
+                {
+                    // 5次: 値・傾き・曲率を合わせ、2階微分までノードで連続にする
+                    const double* curvatures = levels[level - 1].data();
+                    const double t3 = t * t * t;
+                    const double h0 = 1.0 - t3 * (10.0 - t * (15.0 - 6.0 * t));
+                    const double h1 = t - t3 * (6.0 - t * (8.0 - 3.0 * t));
+                    const double h2 = 0.5 * t * t - t3 * (1.5 - t * (1.5 - 0.5 * t));
+                    const double h3 = t3 * (0.5 - t * (1.0 - 0.5 * t));
+                    const double h4 = -t3 * (4.0 - t * (7.0 - 3.0 * t));
+                    const double h5 = t3 * (10.0 - t * (15.0 - 6.0 * t));
+
+                    result = h0 * values[k] + h5 * values[k + 1]
+                           + step * (h1 * slopes[k] + h4 * slopes[k + 1])
+                           + step * step * (h2 * curvatures[k] + h3 * curvatures[k + 1]);
+                }
+                else
+                {
+                    const double h00 = (1.0 + 2.0 * t) * oneMinusT * oneMinusT;
+                    const double h10 = t * oneMinusT * oneMinusT;
+                    const double h01 = t * t * (3.0 - 2.0 * t);
+                    const double h11 = t * t * (t - 1.0);
+
+                    result = h00 * values[k] + h01 * values[k + 1]
+                           + step * (h10 * slopes[k] + h11 * slopes[k + 1]);
+                }
+
+                // 範囲外: f を端点の値で一定とみなして積分を延長する
+                const int edge = excess > 0.0 ? last : 0;
+                if constexpr (level >= 1)
+                    result += (level == 1 ? f[edge] : f1[edge]) * excess;
+                if constexpr (level == 2)
+                    result += 0.5 * f[edge] * excess * excess;
+
+                dest[i] = result;
+            }
+        }
+
+    private:
+        double range, step, invStep;
+        int numPoints;
+        std::array<std::vector<double>, 4> levels; // f', f, F1, F2
+    };
+
+    double logCosh(double x)
+    {
+        const double ax = std::abs(x);
+        return ax + std::log1p(std::exp(-2.0 * ax)) - std::log(2.0);
+    }
+
+    // tanh: F1 = log cosh、F2 は閉じた形がない（二重対数）ので構築時に数値積分する
+    const HermiteTable& getTanhTable()
+    {
+        static const HermiteTable table(10.0, 32,
+            [](double x) { const double t = std::tanh(x); return 1.0 - t * t; },
+            [](double x) { return std::tanh(x); },
+            [](double x) { return logCosh(x); },
+            [](double x)
+            {
+                // 0 から |x| までを 1/32 ごとの区間に分け、5点のガウス・ルジャンドル則で積分する（F2 は奇関数）。
+                // 節点の F2 が f, F1 と合っていないと、5次補間の曲率がずれて2次 ADAA の出力が段になる
+                constexpr double nodes[] = { 0.0, 0.5384693101056831, -0.5384693101056831, 0.9061798459386640, -0.9061798459386640 };
+                constexpr double weights[] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+                const double ax = std::abs(x);
+                const int numCells = juce::jmax(1, static_cast<int>(std::ceil(ax * 32.0)));
+                const double halfWidth = 0.5 * ax / numCells;
+
+                double sum = 0.0;
+                for (int cell = 0; cell < numCells; ++cell)
+                {
+                    const double centre = (2 * cell + 1) * halfWidth;
+                    for (int i = 0; i < 5; ++i)
+                        sum += weights[i] * logCosh(centre + halfWidth * nodes[i]);
+                }
+                return std::copysign(sum * halfWidth, x);
+            });
+        return table;
+    }
+
+    // フォールドバック: f = sin(πx/2)。f と F1 は周期 4 なので1周期分だけを持ち、引数を折り返して引く
+    // （F2 = (x - sin(ax)/a)/a は周期ごとに 4/a ずつ増えるので、折り返した周期の数だけ足す）
+    constexpr double foldbackPeriod = 4.0;
+    constexpr double foldbackSlope = 1.0 / juce::MathConstants<double>::halfPi;
+
+    const HermiteTable& getFoldbackTable()
+    {
+        constexpr double a = juce::MathConstants<double>::halfPi;
+        static const HermiteTable table(0.5 * foldbackPeriod, 64,
+            [a](double x) { return a * std::cos(a * x); },
+            [a](double x) { return std::sin(a * x); },
+            [a](double x) { return (1.0 - std::cos(a * x)) / a; },
+            [a](double x) { return (x - std::sin(a * x) / a) / a; });
+        return table;
+    }
+
+    // x = foldbackPeriod * k + r（-2 <= r < 2）の k
+    double foldbackCycles(double x)
+    {
+        return std::floor(x / foldbackPeriod + 0.5);
+    }
+}
+
+DistortionEffect::DistortionEffect()
+{
+    // テーブルはすべてのインスタンスで共有し、オーディオスレッドで構築されないようここで用意する
+    getTanhTable();
+    getFoldbackTable();
+
+    setParameter(4, bitDepth);
+    smoothedDrive.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(driveDb));
+    smoothedMix.setCurrentAndTargetValue(mix);
+}
+
+void DistortionEffect::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = static_cast<float>(spec.sampleRate);
+    blockSize = juce::jmax(1, static_cast<int>(spec.maximumBlockSize));
+    numChannels = static_cast<int>(spec.numChannels);
+
+    allocateState();
+
+    smoothedDrive.reset(spec.sampleRate, 0.02);
+    smoothedMix.reset(spec.sampleRate, 0.02);
+    reset();
+}
+
+void DistortionEffect::layoutState(DspArena::Allocator& allocator)
+{
+    // 先頭2要素は直前ブロックの入力履歴用
+    const int scratchSize = blockSize + 2;
+    input = allocator.allocate<double>(scratchSize);
+    output = allocator.allocate<double>(scratchSize);
+    scratchA = allocator.allocate<double>(scratchSize);
+    scratchB = allocator.allocate<double>(scratchSize);
+    history = allocator.allocate<double>(juce::jmax(1, numChannels) * 2);
+    driveGains = allocator.allocate<float>(blockSize);
+    mixGains = allocator.allocate<float>(blockSize);
+}
+
+void DistortionEffect::process(juce::AudioBuffer<float>& buffer)
+{
+    if (!isEnabled || numChannels == 0)
+        return;
+
+    smoothedDrive.setTargetValue(juce::Decibels::decibelsToGain(driveDb));
+    smoothedMix.setTargetValue(mix);
+
+    const int numSamples = buffer.getNumSamples();
+    for (int start = 0; start < numSamples; start += blockSize)
+        processChunk(buffer, start, juce::jmin(blockSize, numSamples - start));
+}
+
+void DistortionEffect::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        driveGains[i] = smoothedDrive.getNextValue();
+        mixGains[i] = smoothedMix.getNextValue();
+    }
+
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* data = buffer.getWritePointer(ch, startSample);
+        double* x = input + 2;
+        double* channelHistory = history + ch * 2;
+
+        x[-2] = channelHistory[0];
+        x[-1] = channelHistory[1];
+        for (int i = 0; i < numSamples; ++i)
+            x[i] = static_cast<double>(data[i] * driveGains[i]);
+
+        switch (antialiasingOrder)
+        {
+            case 1:  shapeFirstOrder(x, output, numSamples); break;
+            case 2:  shapeSecondOrder(x, output, numSamples); break;
+            default: evaluate(x, output, numSamples, 0); break;
+        }
+
+        channelHistory[0] = x[numSamples - 2];
+        channelHistory[1] = x[numSamples - 1];
+
+        for (int i = 0; i < numSamples; ++i)
+            data[i] += mixGains[i] * (static_cast<float>(output[i]) - data[i]);
+    }
+}
+
+void DistortionEffect::shapeFirstOrder(double* x, double* dest, int numSamples)
+{
+    // y[n] = (F1(x[n]) - F1(x[n-1])) / (x[n] - x[n-1])
+    double* antiderivative = scratchA;
+    evaluate(x - 1, antiderivative, numSamples + 1, 1);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double delta = x[i] - x[i - 1];
+        const double safeDelta = std::abs(delta) < illConditionedTolerance ? 1.0 : delta;
+        dest[i] = (antiderivative[i + 1] - antiderivative[i]) / safeDelta;
+    }
+
+    // 差分が小さすぎるサンプルだけ中点の f で置き換える（通常はごく少数）
+    for (int i = 0; i < numSamples; ++i)
+        if (std::abs(x[i] - x[i - 1]) < illConditionedTolerance)
+            dest[i] = evaluateSingle(0.5 * (x[i] + x[i - 1]), 0);
+}
+
+void DistortionEffect::shapeSecondOrder(double* x, double* dest, int numSamples)
+{
+    // X[k] = x[k - 2], G[k] = F2(X[k])
+    const double* X = x - 2;
+    double* G = scratchA;
+    double* D = scratchB;
+    evaluate(X, G, numSamples + 2, 2);
+
+    // D[k] = (G[k+1] - G[k]) / (X[k+1] - X[k])  (1次差分)
+    for (int k = 0; k <= numSamples; ++k)
+    {
+        const double delta = X[k + 1] - X[k];
+        const double safeDelta = std::abs(delta) < illConditionedTolerance ? 1.0 : delta;
+        D[k] = (G[k + 1] - G[k]) / safeDelta;
+    }
+    for (int k = 0; k <= numSamples; ++k)
+        if (std::abs(X[k + 1] - X[k]) < illConditionedTolerance)
+            D[k] = evaluateSingle(0.5 * (X[k + 1] + X[k]), 1);
+
+    // y[n] = 2 (D[n] - D[n-1]) / (x[n] - x[n-2])
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double delta = X[i + 2] - X[i];
+        const double safeDelta = std::abs(delta) < illConditionedTolerance ? 1.0 : delta;
+        dest[i] = 2.0 * (D[i + 1] - D[i]) / safeDelta;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (std::abs(X[i + 2] - X[i]) >= illConditionedTolerance)
+            continue;
+
+        const double xBar = 0.5 * (X[i + 2] + X[i]);
+        const double delta = xBar - X[i + 1];
+
+        if (std::abs(delta) < illConditionedTolerance)
+            dest[i] = evaluateSingle(0.5 * (xBar + X[i + 1]), 0);
+        else
+            dest[i] = (2.0 / delta) * (evaluateSingle(xBar, 1) + (G[i + 1] - evaluateSingle(xBar, 2)) / delta);
+    }
+}
+
+double DistortionEffect::evaluateSingle(double x, int level) const
+{
+    double result = 0.0;
+    evaluate(&x, &result, 1, level);
+    return result;
+}
+
+void DistortionEffect::evaluate(const double* x, double* dest, int numSamples, int level) const
+{
+    switch (shape)
+    {
+        case Shape::tanh:
+        {
+            const auto& table = getTanhTable();
+            switch (level)
+            {
+                case 0:  table.evaluate<0>(x, dest, numSamples); break;
+                case 1:  table.evaluate<1>(x, dest, numSamples); break;
+                default: table.evaluate<2>(x, dest, numSamples); break;
+            }
+            break;
+        }
+
+        case Shape::foldback:
+        {
+            // 折り返した引数を dest に置いてその場で評価する（テーブルは x[i] を読んでから dest[i] を書く）
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = x[i] - foldbackPeriod * foldbackCycles(x[i]);
+
+            const auto& table = getFoldbackTable();
+            switch (level)
+            {
+                case 0:  table.evaluate<0>(dest, dest, numSamples); break;
+                case 1:  table.evaluate<1>(dest, dest, numSamples); break;
+                default:
+                    table.evaluate<2>(dest, dest, numSamples);
+                    for (int i = 0; i < numSamples; ++i)
+                        dest[i] += foldbackPeriod * foldbackSlope * foldbackCycles(x[i]);
+                    break;
+            }
+            break;
+        }
+
+        case Shape::softClip:
+        {
+            // f = 1.5 (c - c^3 / 3), c = clamp(x)。|x| > 1 では f を一定として積分を延長する
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const double c = juce::jlimit(-1.0, 1.0, x[i]);
+                const double e = x[i] - c;
+                const double c2 = c * c;
+
+                const double f = 1.5 * c * (1.0 - c2 * (1.0 / 3.0));
+                const double f1 = 1.5 * c2 * (0.5 - c2 * (1.0 / 12.0));
+                const double f2 = 1.5 * c2 * c * (1.0 / 6.0 - c2 * (1.0 / 60.0));
+
+                dest[i] = level == 0 ? f
+                        : level == 1 ? f1 + f * e
+                                     : f2 + f1 * e + 0.5 * f * e * e;
+            }
+            break;
+        }
+
+        case Shape::bitCrush:
+        {
+            // 階段関数 q = round(x L) / L の原始関数は各段で閉じた形になる:
+            // F1 = q x - q^2 / 2、F2 = q x^2 / 2 - q^2 x / 2 + q^3 / 6 - q / (24 L^2)
+            const double levels = quantizationLevels;
+            const double invLevels = 1.0 / levels;
+            const double f2Offset = invLevels * invLevels * (1.0 / 24.0);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const double c = juce::jlimit(-1.0, 1.0, x[i]);
+                const double q = std::floor(c * levels + 0.5) * invLevels;
+                const double v = x[i];
+
+                dest[i] = level == 0 ? q
+                        : level == 1 ? q * v - 0.5 * q * q
+                                     : q * (0.5 * v * v - 0.5 * q * v + q * q * (1.0 / 6.0) - f2Offset);
+            }
+            break;
+        }
+    }
+}
+
+void DistortionEffect::resetScalars()
+{
+    smoothedDrive.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(driveDb));
+    smoothedMix.setCurrentAndTargetValue(mix);
+}
+
+juce::StringArray DistortionEffect::getParameterNames() const
+{
+    return {"Drive", "Mix", "Shape", "Antialiasing", "Bits"};
+}
+
+juce::StringArray DistortionEffect::getParameterLabels() const
+{
+    return {"dB", "%", "", "", "bit"};
+}
+
+juce::Array<float> DistortionEffect::getParameterRanges() const
+{
+    return {
+        0.0f, 36.0f, 12.0f,  // Drive: 0dB - 36dB
+        0.0f, 1.0f, 1.0f,    // Mix: 0 - 1
+        0.0f, 3.0f, 0.0f,    // Shape: Tanh / Soft Clip / Foldback / Bit Crush
+        0.0f, 2.0f, 1.0f,    // Antialiasing: Off / 1st order / 2nd order
+        2.0f, 16.0f, 8.0f    // Bits: 2 - 16
+    };
+}
+
+void DistortionEffect::setParameter(int parameterIndex, float value)
+{
+    switch (parameterIndex)
+    {
+        case 0: driveDb = juce::jlimit(0.0f, 36.0f, value); break;
+        case 1: mix = juce::jlimit(0.0f, 1.0f, value); break;
+        case 2: shape = static_cast<Shape>(juce::jlimit(0, 3, juce::roundToInt(value))); break;
+        case 3: antialiasingOrder = juce::jlimit(0, 2, juce::roundToInt(value)); break;
+        case 4:
+            bitDepth = juce::jlimit(2.0f, 16.0f, value);
+            quantizationLevels = std::exp2(static_cast<double>(bitDepth) - 1.0);
+            break;
+        default: break;
+    }
+}
+
+float DistortionEffect::getParameter(int parameterIndex) const
+{
+    switch (parameterIndex)
+    {
+        case 0: return driveDb;
+        case 1: return mix;
+        case 2: return static_cast<float>(shape);
+        case 3: return static_cast<float>(antialiasingOrder);
+        case 4: return bitDepth;
+        default: return 0.0f;
+    }
+}
+
+void DistortionEffect::saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const
+{
+    xml.setAttribute("Drive", parameterValues[0]);
+    xml.setAttribute("Mix", parameterValues[1]);
+    xml.setAttribute("Shape", juce::roundToInt(parameterValues[2]));
+    xml.setAttribute("Antialiasing", juce::roundToInt(parameterValues[3]));
+    xml.setAttribute("Bits", parameterValues[4]);
+}
+
+void DistortionEffect::loadFromXml(const juce::XmlElement& xml)
+{
+    setParameter(0, static_cast<float>(xml.getDoubleAttribute("Drive", driveDb)));
+    setParameter(1, static_cast<float>(xml.getDoubleAttribute("Mix", mix)));
+    setParameter(2, static_cast<float>(xml.getIntAttribute("Shape", static_cast<int>(shape))));
+    setParameter(3, static_cast<float>(xml.getIntAttribute("Antialiasing", antialiasingOrder)));
+    setParameter(4, static_cast<float>(xml.getDoubleAttribute("Bits", bitDepth)));
+}
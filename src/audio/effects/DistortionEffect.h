@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Effect.h"
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * ディストーション（ドライブ/サチュレーション）エフェクト
+ * - シェイプ: tanh / ソフトクリップ / フォールドバック / SP-404風ビットリダクション
+ * - オーバーサンプリングの代わりに1次/2次のアンチデリバティブ・アンチエイリアシング (ADAA) を使う
+ * - シェイパーはブロック単位で多項式/エルミート補間テーブルを評価し、サンプルごとの std::tanh は使わない
+ * - フォールドバックは引数を周期で折り返すので、ドライブと入力の大きさに関係なく折り返し続ける
+ */
+class DistortionEffect : public Effect
+{
+public:
+    enum class Shape
+    {
+        tanh = 0,
+        softClip,
+        foldback,
+        bitCrush
+    };
+
+    DistortionEffect();
+    ~DistortionEffect() override = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    void process(juce::AudioBuffer<float>& buffer) override;
+    void resetScalars() override;
+
+    // パラメータ関連
+    juce::StringArray getParameterNames() const override;
+    juce::StringArray getParameterLabels() const override;
+    juce::Array<float> getParameterRanges() const override;
+    void setParameter(int parameterIndex, float value) override;
+    float getParameter(int parameterIndex) const override;
+
+    // エフェクト情報
+    juce::String getName() const override { return "Distortion"; }
+    juce::String getCategory() const override { return "Distortion"; }
+    EffectTypeId getTypeId() const override { return EffectTypeId::distortion; }
+    int getNumParameters() const override { return 5; }
+
+    // プリセット関連
+    void saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const override;
+    void loadFromXml(const juce::XmlElement& xml) override;
+
+    // 現在のシェイプをブロック単位で評価する: level 0 = f, 1 = F1 (1次原始関数), 2 = F2
+    // （x と dest は同じ配列でもよい）
+    void evaluate(const double* x, double* dest, int numSamples, int level) const;
+
+protected:
+    void layoutState(DspArena::Allocator& allocator) override;
+
+private:
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    // x は x[-2], x[-1] に直前の入力を置ける領域を持つこと
+    void shapeFirstOrder(double* x, double* dest, int numSamples);
+    void shapeSecondOrder(double* x, double* dest, int numSamples);
+    double evaluateSingle(double x, int level) const;
+
+    float driveDb = 12.0f;    // ドライブ (0dB - 36dB)
+    float mix = 1.0f;         // ウェット/ドライ (0.0 - 1.0)
+    Shape shape = Shape::tanh;
+    int antialiasingOrder = 1; // 0 = なし, 1 = 1次ADAA, 2 = 2次ADAA
+    float bitDepth = 8.0f;    // ビットリダクション時の量子化ビット数 (2 - 16)
+
+    int numChannels = 0;
+    double quantizationLevels = 128.0; // 2^(bitDepth - 1)
+
+    // 作業領域（状態メモリから切り出す）。ADAAの差分は桁落ちしやすいので double で計算する
+    double* input = nullptr;
+    double* output = nullptr;
+    double* scratchA = nullptr;
+    double* scratchB = nullptr;
+    double* history = nullptr;  // チャンネルごとに直前2サンプルの入力
+    float* driveGains = nullptr;
+    float* mixGains = nullptr;
+
+    juce::SmoothedValue<float> smoothedDrive;
+    juce::SmoothedValue<float> smoothedMix;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DistortionEffect)
+};
@@ -2,26 +2,94 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "../metering/LevelMeterSource.h"
+#include "../DspArena.h"
+#include <array>
+
+/**
+ * エフェクト種別のコンパクトな識別子
+ * プリセットXMLの "TypeId" 属性として保存されるため、既存の値は変更しないこと
+ */
+enum class EffectTypeId : std::uint8_t
+{
+    none = 0,
+    filter,
+    delay,
+    distortion,
+    pitchShift,
+    limiter,
+    equalizer,
+    numTypes
+};
 
 /**
  * エフェクトの基本クラス
  * すべてのエフェクトはこのクラスを継承して実装します
+ * - DSPの状態メモリは layoutState で DspArena::Allocator から切り出す。prepare の最後に allocateState() を呼ぶと
+ *   自前の1ブロックに配置され、EffectChain はそれを自分のアリーナ内の領域へ移す（moveStateTo）
  */
 class Effect
 {
 public:
+    // 1つのエフェクトが持てるパラメータの上限（8バンドEQの32個）
+    static constexpr int maxParameters = 32;
+
     Effect() = default;
     virtual ~Effect() = default;
 
     // オーディオ処理関連
     virtual void prepare(const juce::dsp::ProcessSpec& spec) = 0;
     virtual void process(juce::AudioBuffer<float>& buffer) = 0;
-    virtual void reset() = 0;
+
+    // 状態メモリを 0 にしてから resetScalars() を呼ぶ
+    virtual void reset()
+    {
+        clearStateMemory();
+        resetScalars();
+    }
+
+    // 状態メモリ以外（書き込み位置、スムージングなど）を初期化する。状態メモリがまとめて 0 にされた後にも呼ばれる
+    virtual void resetScalars() {}
+
+    // ===== DSPの状態メモリ =====
+    // このインスタンスの状態メモリの大きさ（バイト、DspArena::alignment の倍数）
+    size_t getStateBytes() const { return stateBytes; }
+
+    // 状態メモリを region（DspArena::alignment に揃え、getStateBytes() 以上）へ移す。内容は引き継がず 0 から始める。
+    // オーディオスレッドがこのエフェクトを処理していない間に呼ぶこと
+    void moveStateTo(char* region)
+    {
+        bindState(region);
+        ownedState.free();
+    }
+
+    // 自前の領域へ戻す（チェーンのアリーナから外れるとき）
+    void moveStateToOwnedMemory()
+    {
+        ownedState.allocate(stateBytes);
+        bindState(ownedState.getData());
+    }
+
+    bool ownsStateMemory() const { return stateRegion == ownedState.getData(); }
+
+    // 処理によって生じる遅延（サンプル数）。ホストへのレイテンシ報告に使う
+    virtual int getLatencySamples() const { return 0; }
 
     // エフェクトの有効/無効
     void setEnabled(bool shouldBeEnabled) { isEnabled = shouldBeEnabled; }
     bool getEnabled() const { return isEnabled; }
 
+    // 出力レベルのメーター（EffectChain が処理後に計測し、EffectComponent が表示する）
+    LevelMeterSource& getOutputMeter() { return outputMeter; }
+
+    // ホストへ公開しているパラメータスロット（EffectParameterPool が割り当てる。未割り当ては -1）
+    void setParameterSlot(int newSlot) { parameterSlot = newSlot; }
+    int getParameterSlot() const { return parameterSlot; }
+
+    // チェーン内のインスタンス識別子（編集履歴のスナップショットが同じインスタンスを指すために使う）
+    void setInstanceId(juce::uint32 newId) { instanceId = newId; }
+    juce::uint32 getInstanceId() const { return instanceId; }
+
     // パラメータ関連
     virtual juce::StringArray getParameterNames() const = 0;
     virtual juce::StringArray getParameterLabels() const = 0;  // dB, Hz, ms など
@@ -29,21 +97,89 @@ public:
     virtual void setParameter(int parameterIndex, float value) = 0;
     virtual float getParameter(int parameterIndex) const = 0;
 
+    // ===== モジュレーション（ModulationMatrix） =====
+    // サンプル単位の変調を受け付けるパラメータか。受け付けないパラメータはサブブロックごとに setParameter で動かされる
+    virtual bool supportsSampleModulation(int parameterIndex) const
+    {
+        juce::ignoreUnused(parameterIndex);
+        return false;
+    }
+
+    // 次の process 1回だけ parameterIndex に掛けるサンプルごとのオフセット（値域に対する割合、-1〜1）。
+    // offsets はそのブロックの長さだけあり、process が終わったら参照しないこと。値への写し方はエフェクトが決める
+    virtual void setSampleModulation(int parameterIndex, const float* offsets)
+    {
+        juce::ignoreUnused(parameterIndex, offsets);
+    }
+
     // エフェクトの識別情報
     virtual juce::String getName() const = 0;
     virtual juce::String getCategory() const = 0;
+    virtual EffectTypeId getTypeId() const = 0;
     virtual int getNumParameters() const = 0;
 
+    // 同じ並びを繰り返すパラメータ（EQのバンドなど）の1組の数。0 なら組に分けない。
+    // エディターは組を切り替えて1組ずつ表示する
+    virtual int getParameterGroupSize() const { return 0; }
+
     // プリセット関連
-    virtual void saveToXml(juce::XmlElement& xml) const = 0;
+    // 現在の値を保存する
+    void saveToXml(juce::XmlElement& xml) const
+    {
+        jassert(getNumParameters() <= maxParameters);
+        std::array<float, maxParameters> values {};
+        for (int p = 0; p < juce::jmin(getNumParameters(), maxParameters); ++p)
+            values[static_cast<size_t>(p)] = getParameter(p);
+
+        saveValuesToXml(xml, values.data());
+    }
+
+    // parameterValues（パラメータのインデックス順）を保存する。変調中のエフェクトを書き換えずに基準値を記録するときに使う
+    virtual void saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const = 0;
     virtual void loadFromXml(const juce::XmlElement& xml) = 0;
 
     bool isEnabled = true;
 
 protected:
+    // 状態メモリを要求する。計測（ポインタは nullptr）と切り出しの2回呼ばれる
+    virtual void layoutState(DspArena::Allocator& allocator) { juce::ignoreUnused(allocator); }
+
+    // layoutState で計測し、自前の1ブロックへ配置する。prepare で大きさが決まった後に呼ぶこと
+    void allocateState()
+    {
+        DspArena::Allocator measure;
+        layoutState(measure);
+        stateBytes = measure.getBytesUsed();
+
+        ownedState.allocate(stateBytes);
+        bindState(ownedState.getData());
+    }
+
+    void clearStateMemory()
+    {
+        if (stateRegion != nullptr)
+            std::memset(stateRegion, 0, stateBytes);
+    }
+
     float sampleRate = 44100.0f;
     int blockSize = 512;
 
 private:
+    void bindState(char* region)
+    {
+        DspArena::Allocator allocator(region);
+        layoutState(allocator);
+        stateRegion = region;
+        clearStateMemory();
+    }
+
+    DspArena ownedState;
+    char* stateRegion = nullptr;
+    size_t stateBytes = 0;
+
+    LevelMeterSource outputMeter;
+    int parameterSlot = -1;
+    juce::uint32 instanceId = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Effect)
 }; 
\ No newline at end of file
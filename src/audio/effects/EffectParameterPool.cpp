@@ -0,0 +1,309 @@
+#include "EffectParameterPool.h"
+
+/**
+ * プールの1要素に対応するホストパラメータ
+ * - 値域は常に 0〜1（正規化値）で、実際の値域への変換はバインド中のエフェクトの範囲で行う
+ * - valueChanged はホストのオートメーションによりオーディオスレッドから呼ばれることもあるため、
+ *   atomic への書き込みとビットの設定だけを行う
+ */
+class EffectParameterPool::SlotParameter : public juce::AudioParameterFloat
+{
+public:
+    SlotParameter(EffectParameterPool& ownerPool, int slotIndex, int parameterIndex)
+        : juce::AudioParameterFloat(EffectParameterPool::getParameterId(slotIndex, parameterIndex),
+                                    getDefaultName(slotIndex, parameterIndex),
+                                    juce::NormalisableRange<float>(0.0f, 1.0f),
+                                    0.0f),
+          owner(ownerPool),
+          slot(slotIndex),
+          index(parameterIndex)
+    {
+    }
+
+    juce::String getName(int maximumStringLength) const override
+    {
+        auto* effect = owner.boundEffects[static_cast<size_t>(slot)].load();
+        if (effect == nullptr || index >= owner.boundParameterCounts[static_cast<size_t>(slot)])
+            return getDefaultName(slot, index).substring(0, maximumStringLength);
+
+        const int parameterIndex = owner.firstParameters[static_cast<size_t>(slot)] + index;
+        const auto name = juce::String(slot + 1).paddedLeft('0', 2) + " "
+                        + effect->getName() + " " + effect->getParameterNames()[parameterIndex];
+        return name.substring(0, maximumStringLength);
+    }
+
+    juce::String getText(float normalisedValue, int maximumStringLength) const override
+    {
+        auto* effect = owner.boundEffects[static_cast<size_t>(slot)].load();
+        if (effect == nullptr || index >= owner.boundParameterCounts[static_cast<size_t>(slot)])
+            return "-";
+
+        const auto& range = owner.ranges[static_cast<size_t>(slot * parametersPerSlot + index)];
+        const auto value = range.minimum + normalisedValue * (range.maximum - range.minimum);
+        const int parameterIndex = owner.firstParameters[static_cast<size_t>(slot)] + index;
+        const auto text = juce::String(value, 2) + " " + effect->getParameterLabels()[parameterIndex];
+        return text.trimEnd().substring(0, maximumStringLength);
+    }
+
+private:
+    void valueChanged(float newValue) override
+    {
+        owner.hostValueChanged(slot * parametersPerSlot + index, newValue);
+    }
+
+    static juce::String getDefaultName(int slotIndex, int parameterIndex)
+    {
+        return "FX " + juce::String(slotIndex + 1).paddedLeft('0', 2) + " Param " + juce::String(parameterIndex + 1);
+    }
+
+    EffectParameterPool& owner;
+    const int slot;
+    const int index;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SlotParameter)
+};
+
+void EffectParameterPool::addParametersTo(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        const auto slotName = juce::String(slot + 1).paddedLeft('0', 2);
+        auto group = std::make_unique<juce::AudioProcessorParameterGroup>("fx" + slotName, "FX " + slotName, "|");
+
+        for (int p = 0; p < parametersPerSlot; ++p)
+        {
+            auto parameter = std::make_unique<SlotParameter>(*this, slot, p);
+            parameters[static_cast<size_t>(slot * parametersPerSlot + p)] = parameter.get();
+            group->addChild(std::move(parameter));
+        }
+
+        layout.add(std::move(group));
+    }
+}
+
+int EffectParameterPool::bind(Effect& effect, int preferredSlot)
+{
+    if (effect.getParameterSlot() >= 0)
+        return effect.getParameterSlot();
+
+    int slot = -1;
+    if (juce::isPositiveAndBelow(preferredSlot, numSlots) && boundEffects[static_cast<size_t>(preferredSlot)].load() == nullptr)
+    {
+        slot = preferredSlot;
+    }
+    else
+    {
+        for (int i = 0; i < numSlots; ++i)
+        {
+            if (boundEffects[static_cast<size_t>(i)].load() == nullptr)
+            {
+                slot = i;
+                break;
+            }
+        }
+    }
+
+    // 空きがなければオートメーション対象外としてチェーンには残す
+    if (slot < 0)
+        return -1;
+
+    assignSlot(slot, effect, 0);
+    return slot;
+}
+
+void EffectParameterPool::setFirstParameter(Effect& effect, int firstParameterIndex)
+{
+    const int slot = effect.getParameterSlot();
+    if (!juce::isPositiveAndBelow(slot, numSlots))
+        return;
+
+    const int first = juce::jlimit(0, juce::jmax(0, effect.getNumParameters() - 1), firstParameterIndex);
+    if (first == firstParameters[static_cast<size_t>(slot)])
+        return;
+
+    // 値域はバインド中に書き換えない約束なので、いったんオーディオスレッドから外してから割り当て直す
+    boundEffects[static_cast<size_t>(slot)].store(nullptr);
+    assignSlot(slot, effect, first);
+}
+
+void EffectParameterPool::unbind(Effect& effect)
+{
+    const int slot = effect.getParameterSlot();
+    if (!juce::isPositiveAndBelow(slot, numSlots))
+        return;
+
+    boundEffects[static_cast<size_t>(slot)].store(nullptr);
+    dirtyMasks[static_cast<size_t>(slot)].store(0);
+    boundParameterCounts[static_cast<size_t>(slot)] = 0;
+    firstParameters[static_cast<size_t>(slot)] = 0;
+    effect.setParameterSlot(-1);
+
+    notifyHostOfNameChange();
+}
+
+void EffectParameterPool::unbindAll()
+{
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        if (auto* effect = boundEffects[static_cast<size_t>(slot)].exchange(nullptr))
+            effect->setParameterSlot(-1);
+
+        dirtyMasks[static_cast<size_t>(slot)].store(0);
+        boundParameterCounts[static_cast<size_t>(slot)] = 0;
+        firstParameters[static_cast<size_t>(slot)] = 0;
+    }
+
+    notifyHostOfNameChange();
+}
+
+void EffectParameterPool::setParameterFromUi(Effect& effect, int parameterIndex, float value)
+{
+    // スロットがない（プールが満杯）エフェクトや、スロットに割り当てていないパラメータは従来どおり直接設定する
+    const int flatIndex = getFlatIndex(effect, parameterIndex);
+    auto* parameter = flatIndex >= 0 ? parameters[static_cast<size_t>(flatIndex)] : nullptr;
+    if (parameter == nullptr)
+    {
+        effect.setParameter(parameterIndex, value);
+        return;
+    }
+
+    const auto& range = ranges[static_cast<size_t>(flatIndex)];
+    const auto span = range.maximum - range.minimum;
+    const auto normalised = span > 0.0f ? juce::jlimit(0.0f, 1.0f, (value - range.minimum) / span) : 0.0f;
+    parameter->setValueNotifyingHost(normalised);
+}
+
+void EffectParameterPool::beginGesture(Effect& effect, int parameterIndex)
+{
+    if (auto* parameter = getParameter(effect, parameterIndex))
+        parameter->beginChangeGesture();
+}
+
+void EffectParameterPool::endGesture(Effect& effect, int parameterIndex)
+{
+    if (auto* parameter = getParameter(effect, parameterIndex))
+        parameter->endChangeGesture();
+}
+
+float EffectParameterPool::getParameterValue(const Effect& effect, int parameterIndex) const
+{
+    const int flatIndex = getFlatIndex(effect, parameterIndex);
+    if (flatIndex < 0)
+        return effect.getParameter(parameterIndex);
+
+    const auto& range = ranges[static_cast<size_t>(flatIndex)];
+    return range.minimum + values[static_cast<size_t>(flatIndex)].load(std::memory_order_relaxed) * (range.maximum - range.minimum);
+}
+
+void EffectParameterPool::applyChanges()
+{
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        auto& mask = dirtyMasks[static_cast<size_t>(slot)];
+        if (mask.load(std::memory_order_relaxed) == 0)
+            continue;
+
+        auto* effect = boundEffects[static_cast<size_t>(slot)].load(std::memory_order_acquire);
+        auto bits = mask.exchange(0, std::memory_order_acquire);
+        if (effect == nullptr)
+            continue;
+
+        const int count = boundParameterCounts[static_cast<size_t>(slot)];
+        const int first = firstParameters[static_cast<size_t>(slot)];
+        for (int p = 0; bits != 0 && p < count; ++p, bits >>= 1)
+        {
+            if ((bits & 1u) == 0)
+                continue;
+
+            const int flatIndex = slot * parametersPerSlot + p;
+            const auto& range = ranges[static_cast<size_t>(flatIndex)];
+            const auto normalised = values[static_cast<size_t>(flatIndex)].load(std::memory_order_relaxed);
+            effect->setParameter(first + p, range.minimum + normalised * (range.maximum - range.minimum));
+        }
+    }
+}
+
+float EffectParameterPool::getNormalisedValue(int slot, int parameterIndex) const
+{
+    if (!juce::isPositiveAndBelow(slot, numSlots) || !juce::isPositiveAndBelow(parameterIndex, parametersPerSlot))
+        return 0.0f;
+
+    return values[static_cast<size_t>(slot * parametersPerSlot + parameterIndex)].load(std::memory_order_relaxed);
+}
+
+juce::String EffectParameterPool::getParameterId(int slot, int parameterIndex)
+{
+    return "fx" + juce::String(slot + 1).paddedLeft('0', 2) + "_p" + juce::String(parameterIndex + 1);
+}
+
+void EffectParameterPool::hostValueChanged(int flatIndex, float newValue)
+{
+    values[static_cast<size_t>(flatIndex)].store(newValue, std::memory_order_relaxed);
+    dirtyMasks[static_cast<size_t>(flatIndex / parametersPerSlot)]
+        .fetch_or(1u << (flatIndex % parametersPerSlot), std::memory_order_release);
+}
+
+void EffectParameterPool::assignSlot(int slot, Effect& effect, int firstParameterIndex)
+{
+    const auto parameterRanges = effect.getParameterRanges();
+    const int count = juce::jlimit(0, parametersPerSlot, effect.getNumParameters() - firstParameterIndex);
+    for (int p = 0; p < parametersPerSlot; ++p)
+    {
+        const int parameterIndex = firstParameterIndex + p;
+        auto& range = ranges[static_cast<size_t>(slot * parametersPerSlot + p)];
+        range = p < count ? Range { parameterRanges[parameterIndex * 3], parameterRanges[parameterIndex * 3 + 1] } : Range {};
+    }
+    boundParameterCounts[static_cast<size_t>(slot)] = count;
+    firstParameters[static_cast<size_t>(slot)] = firstParameterIndex;
+
+    effect.setParameterSlot(slot);
+    publishEffectValues(slot, effect);
+    dirtyMasks[static_cast<size_t>(slot)].store(0);
+    boundEffects[static_cast<size_t>(slot)].store(&effect);
+
+    notifyHostOfNameChange();
+}
+
+void EffectParameterPool::publishEffectValues(int slot, Effect& effect)
+{
+    // エフェクトの現在値をホストパラメータへ反映する（ロードしたプリセットの値がそのままオートメーションの初期値になる）
+    const int first = firstParameters[static_cast<size_t>(slot)];
+    for (int p = 0; p < boundParameterCounts[static_cast<size_t>(slot)]; ++p)
+    {
+        const int flatIndex = slot * parametersPerSlot + p;
+        const auto& range = ranges[static_cast<size_t>(flatIndex)];
+        const auto span = range.maximum - range.minimum;
+        const auto normalised = span > 0.0f ? juce::jlimit(0.0f, 1.0f, (effect.getParameter(first + p) - range.minimum) / span) : 0.0f;
+
+        if (auto* parameter = parameters[static_cast<size_t>(flatIndex)])
+            parameter->setValueNotifyingHost(normalised);
+        else
+            values[static_cast<size_t>(flatIndex)].store(normalised, std::memory_order_relaxed);
+    }
+}
+
+int EffectParameterPool::getFlatIndex(const Effect& effect, int parameterIndex) const
+{
+    // スロットに割り当てていないパラメータは -1
+    const int slot = effect.getParameterSlot();
+    if (!juce::isPositiveAndBelow(slot, numSlots))
+        return -1;
+
+    const int slotParameter = parameterIndex - firstParameters[static_cast<size_t>(slot)];
+    if (!juce::isPositiveAndBelow(slotParameter, boundParameterCounts[static_cast<size_t>(slot)]))
+        return -1;
+
+    return slot * parametersPerSlot + slotParameter;
+}
+
+EffectParameterPool::SlotParameter* EffectParameterPool::getParameter(Effect& effect, int parameterIndex) const
+{
+    const int flatIndex = getFlatIndex(effect, parameterIndex);
+    return flatIndex >= 0 ? parameters[static_cast<size_t>(flatIndex)] : nullptr;
+}
+
+void EffectParameterPool::notifyHostOfNameChange()
+{
+    if (processor != nullptr)
+        processor->updateHostDisplay(juce::AudioProcessor::ChangeDetails().withParameterInfoChanged(true));
+}
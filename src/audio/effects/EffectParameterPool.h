@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Effect.h"
+#include <array>
+#include <atomic>
+
+/**
+ * チェーン内エフェクトのパラメータをホストに公開する固定長パラメータプール
+ * - numSlots × parametersPerSlot 個のホストパラメータを起動時に確保し、IDは固定（"fx01_p1" など）
+ * - エフェクトは追加時に空きスロットへ動的に結び付き、並べ替えてもスロット（=オートメーション）は変わらない
+ * - 値は正規化済み (0〜1) の atomic float の平坦な配列に置き、変更はスロットごとのビットマスクで通知する
+ * - オーディオスレッドは変更があったパラメータだけをエフェクトへ反映するので、コストはチェーン長に比例しない
+ * - スロットの幅は狭く保つ（ホストのパラメータ数を増やさない）。それより多いエフェクト（8バンドEQなど）は
+ *   エディターで選んだ組（バンド）をスロットの先頭に割り当て直し、その組をオートメーションできるようにする
+ */
+class EffectParameterPool
+{
+public:
+    static constexpr int numSlots = 16;
+    static constexpr int parametersPerSlot = 8;
+    static constexpr int numParameters = numSlots * parametersPerSlot;
+
+    // 変更通知はスロットごとに1つの32ビットマスク
+    static_assert(parametersPerSlot <= 32, "dirty mask holds one bit per slot parameter");
+
+    EffectParameterPool() = default;
+
+    // APVTSのレイアウトにスロットのパラメータを追加する（プロセッサーの構築時に1回だけ）
+    void addParametersTo(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
+
+    // パラメータ名の変更をホストへ通知するために使う
+    void setProcessor(juce::AudioProcessor* processorToNotify) { processor = processorToNotify; }
+
+    // ===== メッセージスレッド =====
+    // 空きスロットへ結び付ける（preferredSlot が空いていればそこを使う）。空きがなければ -1
+    int bind(Effect& effect, int preferredSlot = -1);
+    void unbind(Effect& effect);
+    void unbindAll();
+
+    // スロットの先頭に割り当てるエフェクトのパラメータを変える（EQ でエディターが選んだバンドなど）。
+    // 割り当てから外れたパラメータは、スロットがないときと同じく直接エフェクトへ設定される
+    void setFirstParameter(Effect& effect, int firstParameterIndex);
+
+    // UIからの変更。結び付いていればホストへ通知し、オーディオスレッド経由でエフェクトへ反映する
+    void setParameterFromUi(Effect& effect, int parameterIndex, float value);
+    void beginGesture(Effect& effect, int parameterIndex);
+    void endGesture(Effect& effect, int parameterIndex);
+
+    // ホスト側の値（結び付いていなければエフェクトの現在値）。オーディオスレッドが未反映の変更も含む
+    float getParameterValue(const Effect& effect, int parameterIndex) const;
+
+    // ===== オーディオスレッド =====
+    // 変更されたパラメータだけを結び付いているエフェクトへ反映する
+    void applyChanges();
+
+    // ===== 任意のスレッド =====
+    float getNormalisedValue(int slot, int parameterIndex) const;
+    static juce::String getParameterId(int slot, int parameterIndex);
+
+private:
+    class SlotParameter;
+
+    void hostValueChanged(int flatIndex, float newValue);
+    void assignSlot(int slot, Effect& effect, int firstParameterIndex);
+    void publishEffectValues(int slot, Effect& effect);
+    int getFlatIndex(const Effect& effect, int parameterIndex) const;
+    SlotParameter* getParameter(Effect& effect, int parameterIndex) const;
+    void notifyHostOfNameChange();
+
+    struct Range
+    {
+        float minimum = 0.0f;
+        float maximum = 1.0f;
+    };
+
+    // オーディオスレッドが読む平坦な配列
+    std::array<std::atomic<float>, numParameters> values {};
+    std::array<std::atomic<juce::uint32>, numSlots> dirtyMasks {};
+    std::array<std::atomic<Effect*>, numSlots> boundEffects {};
+
+    // バインド時に確定する値域。バインド中は書き換えないのでオーディオスレッドから読める
+    std::array<Range, numParameters> ranges {};
+    std::array<int, numSlots> boundParameterCounts {};
+    std::array<int, numSlots> firstParameters {}; // スロットの先頭に対応するエフェクトのパラメータ
+
+    // メッセージスレッド専用
+    std::array<SlotParameter*, numParameters> parameters {};
+    juce::AudioProcessor* processor = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectParameterPool)
+};
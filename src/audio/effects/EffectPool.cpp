@@ -0,0 +1,118 @@
+#include "EffectPool.h"
+
+EffectPool::EffectPool(int instancesPerType)
+{
+    EffectRegistry::getInstance().forEachType([this, instancesPerType](EffectTypeId typeId)
+    {
+        reserve(typeId, instancesPerType);
+    });
+}
+
+void EffectPool::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    currentSpec = spec;
+    isPrepared = true;
+
+    for (auto& instances : available)
+        for (auto& effect : instances)
+        {
+            effect->prepare(spec);
+            effect->getOutputMeter().prepare(spec.sampleRate);
+        }
+}
+
+void EffectPool::reserve(EffectTypeId typeId, int count)
+{
+    auto& instances = available[static_cast<size_t>(typeId)];
+
+    // release() で返却される分も含めて再確保が起きないよう余裕を持たせる
+    instances.reserve(static_cast<size_t>(count) * 2);
+
+    while (static_cast<int>(instances.size()) < count)
+    {
+        auto effect = createPrepared(typeId);
+        if (effect == nullptr)
+            return;
+        instances.push_back(std::move(effect));
+    }
+}
+
+std::unique_ptr<Effect> EffectPool::acquire(EffectTypeId typeId)
+{
+    if (!EffectRegistry::getInstance().isRegistered(typeId))
+        return nullptr;
+
+    auto& instances = available[static_cast<size_t>(typeId)];
+
+    if (instances.empty())
+    {
+        // 在庫切れ: ここだけはヒープ確保と prepare() が発生する
+        return createPrepared(typeId);
+    }
+
+    auto effect = std::move(instances.back());
+    instances.pop_back();
+
+    // 前回使用時の状態を残さない
+    restoreDefaultParameters(*effect);
+    effect->reset();
+    effect->getOutputMeter().reset();
+    effect->setEnabled(true);
+    return effect;
+}
+
+void EffectPool::release(std::unique_ptr<Effect> effect)
+{
+    if (effect == nullptr)
+        return;
+
+    const auto index = static_cast<size_t>(effect->getTypeId());
+    if (index == 0 || index >= available.size())
+        return;
+
+    available[index].push_back(std::move(effect));
+}
+
+int EffectPool::getNumAvailable(EffectTypeId typeId) const
+{
+    return static_cast<int>(available[static_cast<size_t>(typeId)].size());
+}
+
+std::unique_ptr<Effect> EffectPool::createPrepared(EffectTypeId typeId)
+{
+    auto effect = EffectRegistry::getInstance().create(typeId);
+    if (effect == nullptr)
+        return nullptr;
+
+    // 在庫切れで作ったインスタンスも、返却後は同じ既定値へ戻せるようにする
+    cacheDefaultParameters(*effect);
+
+    if (isPrepared)
+    {
+        effect->prepare(currentSpec);
+        effect->getOutputMeter().prepare(currentSpec.sampleRate);
+    }
+    return effect;
+}
+
+void EffectPool::cacheDefaultParameters(const Effect& effect)
+{
+    auto& defaults = defaultParameters[static_cast<size_t>(effect.getTypeId())];
+    if (!defaults.empty())
+        return;
+
+    // getParameterRanges() は (min, max, default) の3つ組
+    const auto ranges = effect.getParameterRanges();
+    for (int i = 0; i < effect.getNumParameters(); ++i)
+    {
+        const int defaultIndex = i * 3 + 2;
+        defaults.push_back(defaultIndex < ranges.size() ? ranges[defaultIndex] : effect.getParameter(i));
+    }
+}
+
+void EffectPool::restoreDefaultParameters(Effect& effect) const
+{
+    const auto& defaults = defaultParameters[static_cast<size_t>(effect.getTypeId())];
+    for (size_t i = 0; i < defaults.size(); ++i)
+        effect.setParameter(static_cast<int>(i), defaults[i]);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "EffectRegistry.h"
+#include <vector>
+
+/**
+ * プラグインインスタンスごとのエフェクトインスタンスプール
+ * - 構築と prepare() を済ませたエフェクトを種別ごとに保持する
+ * - チェーンの再構築（プリセット切り替え）はここから取り出し、ここへ返却する
+ * - 在庫があれば acquire() はヒープ確保もバッファ確保も行わない
+ */
+class EffectPool
+{
+public:
+    explicit EffectPool(int instancesPerType = defaultInstancesPerType);
+    ~EffectPool() = default;
+
+    // 保持しているすべてのインスタンスを新しい仕様で準備し直す
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    // 指定種別の在庫を少なくとも count 個にする（メッセージスレッドから呼ぶこと）
+    void reserve(EffectTypeId typeId, int count);
+
+    // 在庫から取り出す。在庫切れの場合のみ新規作成する
+    std::unique_ptr<Effect> acquire(EffectTypeId typeId);
+
+    // 使い終わったエフェクトを返却する
+    void release(std::unique_ptr<Effect> effect);
+
+    int getNumAvailable(EffectTypeId typeId) const;
+
+    static constexpr int defaultInstancesPerType = 4;
+
+private:
+    // 作成した種別の既定値もここで記録する（reserve と在庫切れの acquire の両方を通る）
+    std::unique_ptr<Effect> createPrepared(EffectTypeId typeId);
+    void cacheDefaultParameters(const Effect& effect);
+    void restoreDefaultParameters(Effect& effect) const;
+
+    template <typename T>
+    using PerType = std::array<T, static_cast<size_t>(EffectRegistry::maxTypes)>;
+
+    PerType<std::vector<std::unique_ptr<Effect>>> available;
+    PerType<std::vector<float>> defaultParameters;
+    juce::dsp::ProcessSpec currentSpec { 44100.0, 512, 2 };
+    bool isPrepared = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectPool)
+};
@@ -0,0 +1,63 @@
+#include "EffectRegistry.h"
+#include "KrumpBuiltInEffects.h"
+
+// 静的ライブラリから組み込みエフェクトの登録オブジェクトを確実にリンクさせる
+// (アンカーはグローバル名前空間で宣言されるため無名名前空間には置かないこと)。
+// 一覧はビルド時に KRUMP_REGISTER_EFFECT を書いた .cpp から生成する（tools/generate_effect_anchors.py）
+static void linkBuiltInEffects()
+{
+    KRUMP_LINK_BUILT_IN_EFFECTS()
+}
+
+EffectRegistry& EffectRegistry::getInstance()
+{
+    static EffectRegistry instance;
+    static const bool builtInsLinked = (linkBuiltInEffects(), true);
+    juce::ignoreUnused(builtInsLinked);
+    return instance;
+}
+
+void EffectRegistry::registerType(EffectTypeId typeId, const char* typeName, FactoryFunction factory)
+{
+    const auto index = static_cast<int>(typeId);
+    jassert(index > 0 && index < maxTypes);
+    jassert(entries[static_cast<size_t>(index)].factory == nullptr); // 同じIDの二重登録
+
+    if (index <= 0 || index >= maxTypes)
+        return;
+
+    entries[static_cast<size_t>(index)] = { typeName, factory };
+}
+
+std::unique_ptr<Effect> EffectRegistry::create(EffectTypeId typeId) const
+{
+    if (!isRegistered(typeId))
+        return nullptr;
+
+    return entries[static_cast<size_t>(typeId)].factory();
+}
+
+bool EffectRegistry::isRegistered(EffectTypeId typeId) const
+{
+    const auto index = static_cast<int>(typeId);
+    return index > 0 && index < maxTypes && entries[static_cast<size_t>(index)].factory != nullptr;
+}
+
+EffectTypeId EffectRegistry::findTypeId(const juce::String& typeName) const
+{
+    for (int i = 1; i < maxTypes; ++i)
+    {
+        const auto& entry = entries[static_cast<size_t>(i)];
+        if (entry.factory != nullptr && typeName == entry.name)
+            return static_cast<EffectTypeId>(i);
+    }
+    return EffectTypeId::none;
+}
+
+juce::String EffectRegistry::getTypeName(EffectTypeId typeId) const
+{
+    if (!isRegistered(typeId))
+        return {};
+
+    return entries[static_cast<size_t>(typeId)].name;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Effect.h"
+#include <array>
+
+/**
+ * エフェクトのファクトリレジストリ
+ * - 各エフェクトは自身の .cpp で KRUMP_REGISTER_EFFECT を使って登録する
+ * - EffectTypeId をキーにした固定長テーブルなので検索は配列アクセスのみ
+ */
+class EffectRegistry
+{
+public:
+    using FactoryFunction = std::unique_ptr<Effect> (*)();
+
+    static constexpr int maxTypes = static_cast<int>(EffectTypeId::numTypes);
+
+    static EffectRegistry& getInstance();
+
+    void registerType(EffectTypeId typeId, const char* typeName, FactoryFunction factory);
+
+    std::unique_ptr<Effect> create(EffectTypeId typeId) const;
+    bool isRegistered(EffectTypeId typeId) const;
+
+    // プリセットXMLの "Type" 文字列との相互変換
+    EffectTypeId findTypeId(const juce::String& typeName) const;
+    juce::String getTypeName(EffectTypeId typeId) const;
+
+    // 登録済みの種別を列挙する
+    template <typename Callback>
+    void forEachType(Callback&& callback) const
+    {
+        for (int i = 1; i < maxTypes; ++i)
+            if (entries[static_cast<size_t>(i)].factory != nullptr)
+                callback(static_cast<EffectTypeId>(i));
+    }
+
+    // 静的初期化時に登録を行うヘルパー
+    struct Registrar
+    {
+        Registrar(EffectTypeId typeId, const char* typeName, FactoryFunction factory)
+        {
+            EffectRegistry::getInstance().registerType(typeId, typeName, factory);
+        }
+    };
+
+private:
+    EffectRegistry() = default;
+
+    struct Entry
+    {
+        const char* name = nullptr;
+        FactoryFunction factory = nullptr;
+    };
+
+    std::array<Entry, static_cast<size_t>(maxTypes)> entries {};
+
+    JUCE_DECLARE_NON_COPYABLE(EffectRegistry)
+};
+
+/**
+ * エフェクトの .cpp に置く登録マクロ
+ * プラグイン本体は静的ライブラリとしてリンクされるため、登録オブジェクトが
+ * リンカに捨てられないよう EffectRegistry.cpp から KRUMP_LINK_EFFECT でアンカーを参照する。
+ * 参照の一覧はビルド時にこのマクロを書いた .cpp から生成するので、エフェクトを追加しても手で書き足す必要はない
+ */
+#define KRUMP_REGISTER_EFFECT(EffectClass, typeId, typeName)                                          \
+    void krumpEffectLinkAnchor_##EffectClass();                                                       \
+    void krumpEffectLinkAnchor_##EffectClass() {}                                                     \
+    static const EffectRegistry::Registrar effectRegistrar_##EffectClass                              \
+    {                                                                                                 \
+        typeId, typeName, []() -> std::unique_ptr<Effect> { return std::make_unique<EffectClass>(); } \
+    };
+
+#define KRUMP_LINK_EFFECT(EffectClass)                         \
+    {                                                          \
+        extern void krumpEffectLinkAnchor_##EffectClass();     \
+        krumpEffectLinkAnchor_##EffectClass();                 \
+    }
@@ -0,0 +1,340 @@
+#include "EqualizerEffect.h"
+#include "EffectRegistry.h"
+
+KRUMP_REGISTER_EFFECT(EqualizerEffect, EffectTypeId::equalizer, "EQ")
+
+namespace
+{
+    // 初期状態: 両端がシェルフ、間がピーク（すべて 0dB なので処理されない）
+    constexpr float defaultFrequencies[] = { 80.0f, 200.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f, 12000.0f };
+
+    // ゲインがこれより小さいピーク/シェルフは素通しとみなす
+    constexpr float flatGainDb = 0.001f;
+
+    bool usesGain(EqualizerEffect::BandType type)
+    {
+        return type == EqualizerEffect::BandType::peak
+            || type == EqualizerEffect::BandType::lowShelf
+            || type == EqualizerEffect::BandType::highShelf;
+    }
+}
+
+EqualizerEffect::EqualizerEffect()
+{
+    for (int b = 0; b < numBands; ++b)
+    {
+        auto& band = bands[static_cast<size_t>(b)];
+        band.type = b == 0 ? BandType::lowShelf : (b == numBands - 1 ? BandType::highShelf : BandType::peak);
+        band.frequency = defaultFrequencies[b];
+    }
+
+    resetScalars();
+}
+
+void EqualizerEffect::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = static_cast<float>(spec.sampleRate);
+    blockSize = juce::jmax(1, static_cast<int>(spec.maximumBlockSize));
+    numChannels = juce::jmax(1, static_cast<int>(spec.numChannels));
+    numGroups = (numChannels + lanes - 1) / lanes;
+
+    for (auto& band : bands)
+        for (auto* smoother : { &band.logFrequency, &band.gain, &band.quality })
+            smoother->reset(spec.sampleRate, 0.02);
+
+    allocateState();
+    reset();
+}
+
+void EqualizerEffect::layoutState(DspArena::Allocator& allocator)
+{
+    states = allocator.allocate<Vector>(numBands * numGroups * 2);
+    frames = allocator.allocate<Vector>(updateInterval);
+}
+
+void EqualizerEffect::resetScalars()
+{
+    for (auto& band : bands)
+    {
+        band.activeType = band.type;
+        band.logFrequency.setCurrentAndTargetValue(std::log2(band.frequency));
+        band.gain.setCurrentAndTargetValue(band.gainDb);
+        band.quality.setCurrentAndTargetValue(band.q);
+        band.coefficients = calculateCoefficients(band.type, band.frequency, band.gainDb, band.q);
+        band.isActive = band.type != BandType::off && !(usesGain(band.type) && std::abs(band.gainDb) < flatGainDb);
+    }
+}
+
+int EqualizerEffect::getNumActiveBands() const
+{
+    int count = 0;
+    for (const auto& band : bands)
+        if (band.isActive)
+            ++count;
+    return count;
+}
+
+void EqualizerEffect::process(juce::AudioBuffer<float>& buffer)
+{
+    if (!isEnabled || states == nullptr)
+        return;
+
+    for (auto& band : bands)
+    {
+        band.logFrequency.setTargetValue(std::log2(band.frequency));
+        band.gain.setTargetValue(band.gainDb);
+        band.quality.setTargetValue(band.q);
+    }
+
+    const int numSamples = buffer.getNumSamples();
+    for (int start = 0; start < numSamples; start += updateInterval)
+        processChunk(buffer, start, juce::jmin(updateInterval, numSamples - start));
+}
+
+void EqualizerEffect::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // 係数は値が動いているバンドだけ計算し直す（チャンクの終わりの値を使う）
+    for (int b = 0; b < numBands; ++b)
+        updateBand(b, numSamples);
+
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+        const int firstChannel = g * lanes;
+        if (firstChannel >= channels)
+            break;
+
+        // チャンネルをレーンへ並べ替える（空きレーンは 0）
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const int ch = firstChannel + lane;
+            const float* source = ch < channels ? buffer.getReadPointer(ch, startSample) : nullptr;
+            for (int i = 0; i < numSamples; ++i)
+                frames[i].set(static_cast<size_t>(lane), source != nullptr ? source[i] : 0.0f);
+        }
+
+        for (int b = 0; b < numBands; ++b)
+        {
+            const auto& band = bands[static_cast<size_t>(b)];
+            if (!band.isActive)
+                continue;
+
+            const Vector b0 = Vector::expand(band.coefficients.b0);
+            const Vector b1 = Vector::expand(band.coefficients.b1);
+            const Vector b2 = Vector::expand(band.coefficients.b2);
+            const Vector a1 = Vector::expand(band.coefficients.a1);
+            const Vector a2 = Vector::expand(band.coefficients.a2);
+
+            Vector* state = states + (b * numGroups + g) * 2;
+            Vector s1 = state[0];
+            Vector s2 = state[1];
+
+            // 転置直接形 II: y = b0 x + s1, s1 = b1 x - a1 y + s2, s2 = b2 x - a2 y
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const Vector x = frames[i];
+                const Vector y = b0 * x + s1;
+                s1 = b1 * x - a1 * y + s2;
+                s2 = b2 * x - a2 * y;
+                frames[i] = y;
+            }
+
+            state[0] = s1;
+            state[1] = s2;
+        }
+
+        // レーンからチャンネルへ戻す
+        for (int lane = 0; lane < lanes && firstChannel + lane < channels; ++lane)
+        {
+            float* destination = buffer.getWritePointer(firstChannel + lane, startSample);
+            for (int i = 0; i < numSamples; ++i)
+                destination[i] = frames[i].get(static_cast<size_t>(lane));
+        }
+    }
+}
+
+void EqualizerEffect::updateBand(int bandIndex, int numSamples)
+{
+    auto& band = bands[static_cast<size_t>(bandIndex)];
+    const bool typeChanged = band.type != band.activeType;
+    const bool isSmoothing = band.logFrequency.isSmoothing() || band.gain.isSmoothing() || band.quality.isSmoothing();
+    if (!typeChanged && !isSmoothing)
+        return;
+
+    band.activeType = band.type;
+    const float frequency = std::exp2(band.logFrequency.skip(numSamples));
+    const float gainDb = band.gain.skip(numSamples);
+    const float q = band.quality.skip(numSamples);
+    band.coefficients = calculateCoefficients(band.activeType, frequency, gainDb, q);
+
+    // 止まっていたバンドは古い状態から始めないよう消しておく
+    const bool wasActive = band.isActive;
+    band.isActive = band.activeType != BandType::off && !(usesGain(band.activeType) && std::abs(gainDb) < flatGainDb);
+    if (band.isActive && !wasActive)
+        for (int g = 0; g < numGroups; ++g)
+        {
+            Vector* state = states + (bandIndex * numGroups + g) * 2;
+            state[0] = Vector::expand(0.0f);
+            state[1] = Vector::expand(0.0f);
+        }
+}
+
+EqualizerEffect::Coefficients EqualizerEffect::calculateCoefficients(BandType type, float frequency, float gainDb, float q) const
+{
+    // RBJ Audio EQ Cookbook。a0 で正規化する
+    const double w0 = juce::MathConstants<double>::twoPi * juce::jlimit(10.0, 0.49 * sampleRate, static_cast<double>(frequency)) / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * juce::jmax(0.05, static_cast<double>(q)));
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double twoSqrtAAlpha = 2.0 * std::sqrt(A) * alpha;
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+    switch (type)
+    {
+        case BandType::peak:
+            b0 = 1.0 + alpha * A;
+            b1 = -2.0 * cosW0;
+            b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha / A;
+            break;
+
+        case BandType::lowShelf:
+            b0 = A * ((A + 1.0) - (A - 1.0) * cosW0 + twoSqrtAAlpha);
+            b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosW0);
+            b2 = A * ((A + 1.0) - (A - 1.0) * cosW0 - twoSqrtAAlpha);
+            a0 = (A + 1.0) + (A - 1.0) * cosW0 + twoSqrtAAlpha;
+            a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosW0);
+            a2 = (A + 1.0) + (A - 1.0) * cosW0 - twoSqrtAAlpha;
+            break;
+
+        case BandType::highShelf:
+            b0 = A * ((A + 1.0) + (A - 1.0) * cosW0 + twoSqrtAAlpha);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW0);
+            b2 = A * ((A + 1.0) + (A - 1.0) * cosW0 - twoSqrtAAlpha);
+            a0 = (A + 1.0) - (A - 1.0) * cosW0 + twoSqrtAAlpha;
+            a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosW0);
+            a2 = (A + 1.0) - (A - 1.0) * cosW0 - twoSqrtAAlpha;
+            break;
+
+        case BandType::highPass:
+            b0 = (1.0 + cosW0) * 0.5;
+            b1 = -(1.0 + cosW0);
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha;
+            break;
+
+        case BandType::lowPass:
+            b0 = (1.0 - cosW0) * 0.5;
+            b1 = 1.0 - cosW0;
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha;
+            break;
+
+        case BandType::off:
+        default:
+            break;
+    }
+
+    return { static_cast<float>(b0 / a0), static_cast<float>(b1 / a0), static_cast<float>(b2 / a0),
+             static_cast<float>(a1 / a0), static_cast<float>(a2 / a0) };
+}
+
+juce::StringArray EqualizerEffect::getParameterNames() const
+{
+    juce::StringArray names;
+    for (int b = 1; b <= numBands; ++b)
+        for (const char* name : { " Type", " Freq", " Gain", " Q" })
+            names.add(juce::String(b) + name);
+    return names;
+}
+
+juce::StringArray EqualizerEffect::getParameterLabels() const
+{
+    juce::StringArray labels;
+    for (int b = 0; b < numBands; ++b)
+        for (const char* label : { "", "Hz", "dB", "" })
+            labels.add(label);
+    return labels;
+}
+
+juce::Array<float> EqualizerEffect::getParameterRanges() const
+{
+    juce::Array<float> ranges;
+    for (int b = 0; b < numBands; ++b)
+    {
+        const float defaultType = b == 0 ? 2.0f : (b == numBands - 1 ? 3.0f : 1.0f);
+        ranges.addArray({
+            0.0f, 5.0f, defaultType,               // Type: Off / Peak / Low Shelf / High Shelf / High Pass / Low Pass
+            20.0f, 20000.0f, defaultFrequencies[b], // Freq: 20Hz - 20kHz
+            -18.0f, 18.0f, 0.0f,                   // Gain: -18dB - +18dB
+            0.1f, 10.0f, 0.707f                    // Q: 0.1 - 10
+        });
+    }
+    return ranges;
+}
+
+void EqualizerEffect::setParameter(int parameterIndex, float value)
+{
+    if (!juce::isPositiveAndBelow(parameterIndex, getNumParameters()))
+        return;
+
+    auto& band = bands[static_cast<size_t>(parameterIndex / parametersPerBand)];
+    switch (parameterIndex % parametersPerBand)
+    {
+        case 0: band.type = static_cast<BandType>(juce::jlimit(0, 5, juce::roundToInt(value))); break;
+        case 1: band.frequency = juce::jlimit(20.0f, 20000.0f, value); break;
+        case 2: band.gainDb = juce::jlimit(-18.0f, 18.0f, value); break;
+        case 3: band.q = juce::jlimit(0.1f, 10.0f, value); break;
+        default: break;
+    }
+}
+
+float EqualizerEffect::getParameter(int parameterIndex) const
+{
+    if (!juce::isPositiveAndBelow(parameterIndex, getNumParameters()))
+        return 0.0f;
+
+    const auto& band = bands[static_cast<size_t>(parameterIndex / parametersPerBand)];
+    switch (parameterIndex % parametersPerBand)
+    {
+        case 0: return static_cast<float>(band.type);
+        case 1: return band.frequency;
+        case 2: return band.gainDb;
+        case 3: return band.q;
+        default: return 0.0f;
+    }
+}
+
+void EqualizerEffect::saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const
+{
+    for (int b = 0; b < numBands; ++b)
+    {
+        const float* band = parameterValues + b * parametersPerBand;
+        const juce::String prefix = "Band" + juce::String(b + 1);
+        xml.setAttribute(prefix + "Type", juce::roundToInt(band[0]));
+        xml.setAttribute(prefix + "Freq", band[1]);
+        xml.setAttribute(prefix + "Gain", band[2]);
+        xml.setAttribute(prefix + "Q", band[3]);
+    }
+}
+
+void EqualizerEffect::loadFromXml(const juce::XmlElement& xml)
+{
+    for (int b = 0; b < numBands; ++b)
+    {
+        const auto& band = bands[static_cast<size_t>(b)];
+        const juce::String prefix = "Band" + juce::String(b + 1);
+        const int first = b * parametersPerBand;
+        setParameter(first, static_cast<float>(xml.getIntAttribute(prefix + "Type", static_cast<int>(band.type))));
+        setParameter(first + 1, static_cast<float>(xml.getDoubleAttribute(prefix + "Freq", band.frequency)));
+        setParameter(first + 2, static_cast<float>(xml.getDoubleAttribute(prefix + "Gain", band.gainDb)));
+        setParameter(first + 3, static_cast<float>(xml.getDoubleAttribute(prefix + "Q", band.q)));
+    }
+}
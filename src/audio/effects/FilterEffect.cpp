@@ -1,36 +1,84 @@
 #include "FilterEffect.h"
+#include "EffectRegistry.h"
+
+KRUMP_REGISTER_EFFECT(FilterEffect, EffectTypeId::filter, "Filter")
 
 FilterEffect::FilterEffect()
 {
-    filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
     updateFilterParameters();
 }
 
 void FilterEffect::prepare(const juce::dsp::ProcessSpec& spec)
 {
-    filter.prepare(spec);
+    sampleRate = static_cast<float>(spec.sampleRate);
+    blockSize = juce::jmax(1, static_cast<int>(spec.maximumBlockSize));
+    numChannels = static_cast<int>(spec.numChannels);
+    kernels = &DspKernels::getBest();
+
+    allocateState();
     updateFilterParameters();
+    reset();
+}
+
+void FilterEffect::layoutState(DspArena::Allocator& allocator)
+{
+    integratorStates = allocator.allocate<float>(juce::jmax(1, numChannels) * 2);
+    modulatedG = allocator.allocate<float>(blockSize);
+    modulatedH = allocator.allocate<float>(blockSize);
 }
 
 void FilterEffect::process(juce::AudioBuffer<float>& buffer)
 {
-    if (!isEnabled)
+    const float* modulation = cutoffModulation;
+    cutoffModulation = nullptr;
+
+    if (!isEnabled || integratorStates == nullptr)
         return;
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    filter.process(context);
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+
+    // 変調があれば係数をサンプルごとに求めておき、全チャンネルで共有する。
+    // チャンネルはレーンに並べて同時に進める
+    auto* const* channelData = buffer.getArrayOfWritePointers();
+    if (modulation != nullptr && numSamples <= blockSize)
+    {
+        computeModulatedCoefficients(modulation, numSamples);
+        kernels->stateVariableLowpass(channelData, channels, numSamples, integratorStates, modulatedG, modulatedH, 1, R2);
+    }
+    else
+    {
+        kernels->stateVariableLowpass(channelData, channels, numSamples, integratorStates, &g, &h, 0, R2);
+    }
+}
+
+void FilterEffect::setSampleModulation(int parameterIndex, const float* offsets)
+{
+    if (parameterIndex == 0)
+        cutoffModulation = offsets;
 }
 
-void FilterEffect::reset()
+void FilterEffect::computeModulatedCoefficients(const float* offsets, int numSamples)
 {
-    filter.reset();
+    const float maxFrequency = sampleRate * 0.49f;
+    const float piOverRate = juce::MathConstants<float>::pi / sampleRate;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float frequency = juce::jlimit(20.0f, maxFrequency, cutoff * std::exp2(offsets[i] * modulationOctaves));
+        const float gi = std::tan(piOverRate * frequency);
+        modulatedG[i] = gi;
+        modulatedH[i] = 1.0f / (1.0f + R2 * gi + gi * gi);
+    }
 }
 
 void FilterEffect::updateFilterParameters()
 {
-    filter.setCutoffFrequency(cutoff);
-    filter.setResonance(resonance);
+    // カットオフはナイキストの手前で止める
+    const float frequency = juce::jlimit(20.0f, sampleRate * 0.49f, cutoff);
+    g = static_cast<float>(std::tan(juce::MathConstants<double>::pi * frequency / sampleRate));
+    R2 = 1.0f / juce::jmax(0.01f, resonance);
+    h = 1.0f / (1.0f + R2 * g + g * g);
 }
 
 juce::StringArray FilterEffect::getParameterNames() const
@@ -77,10 +125,10 @@ float FilterEffect::getParameter(int parameterIndex) const
     }
 }
 
-void FilterEffect::saveToXml(juce::XmlElement& xml) const
+void FilterEffect::saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const
 {
-    xml.setAttribute("Cutoff", cutoff);
-    xml.setAttribute("Resonance", resonance);
+    xml.setAttribute("Cutoff", parameterValues[0]);
+    xml.setAttribute("Resonance", parameterValues[1]);
 }
 
 void FilterEffect::loadFromXml(const juce::XmlElement& xml)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Effect.h"
+#include "../kernels/DspKernels.h"
 #include <juce_dsp/juce_dsp.h>
 
 /**
@@ -8,6 +9,10 @@
  * - ローパス
  * - ハイパス
  * - バンドパス
+ * - TPT（台形積分）の状態変数フィルター。チャンネルごとの積分器の状態は状態メモリから切り出す
+ * - 処理は DspKernels::stateVariableLowpass（prepare で CPU に合わせて選ぶ）。チャンネルをレーンに並べて同時に進める
+ * - カットオフはサンプル単位の変調を受け付ける。オフセットは値域（約10オクターブ）に対する割合としてオクターブで掛け、
+ *   係数をサンプルごとに計算し直す（変調がないブロックはこれまでどおり固定の係数）
  */
 class FilterEffect : public Effect
 {
@@ -17,7 +22,6 @@ public:
 
     void prepare(const juce::dsp::ProcessSpec& spec) override;
     void process(juce::AudioBuffer<float>& buffer) override;
-    void reset() override;
 
     // パラメータ関連
     juce::StringArray getParameterNames() const override;
@@ -25,22 +29,42 @@ public:
     juce::Array<float> getParameterRanges() const override;
     void setParameter(int parameterIndex, float value) override;
     float getParameter(int parameterIndex) const override;
+    bool supportsSampleModulation(int parameterIndex) const override { return parameterIndex == 0; }
+    void setSampleModulation(int parameterIndex, const float* offsets) override;
 
     // エフェクト情報
     juce::String getName() const override { return "Filter"; }
     juce::String getCategory() const override { return "Filter"; }
+    EffectTypeId getTypeId() const override { return EffectTypeId::filter; }
     int getNumParameters() const override { return 2; }
 
     // プリセット関連
-    void saveToXml(juce::XmlElement& xml) const override;
+    void saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const override;
     void loadFromXml(const juce::XmlElement& xml) override;
 
+protected:
+    void layoutState(DspArena::Allocator& allocator) override;
+
 private:
     float cutoff = 1000.0f;  // カットオフ周波数 (20Hz - 20kHz)
     float resonance = 0.7f;  // レゾナンス (0.1 - 8.0)
 
-    juce::dsp::StateVariableTPTFilter<float> filter;
+    // juce::dsp::StateVariableTPTFilter と同じ係数（ローパス出力）
+    float g = 0.0f;
+    float R2 = 0.0f;
+    float h = 0.0f;
+    int numChannels = 0;
+    float* integratorStates = nullptr; // チャンネルごとに s1, s2
+    const DspKernels* kernels = &DspKernels::getBaseline();
+
+    // カットオフの変調（次の process だけ有効）と、サンプルごとの係数の作業領域
+    static constexpr float modulationOctaves = 10.0f;
+    const float* cutoffModulation = nullptr;
+    float* modulatedG = nullptr;
+    float* modulatedH = nullptr;
+
     void updateFilterParameters();
+    void computeModulatedCoefficients(const float* offsets, int numSamples);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilterEffect)
 }; 
\ No newline at end of file
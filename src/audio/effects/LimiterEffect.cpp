@@ -0,0 +1,274 @@
+#include "LimiterEffect.h"
+#include "EffectRegistry.h"
+
+KRUMP_REGISTER_EFFECT(LimiterEffect, EffectTypeId::limiter, "Limiter")
+
+LimiterEffect::LimiterEffect()
+{
+    // ハン窓をかけた sinc のプロトタイプ（48 タップ、中心 24）をフェーズに分ける。
+    // フェーズ p はサンプル n - detectorDelay + p / 4 の値を補間し、フェーズ 0 は元のサンプルそのもの
+    constexpr int numTaps = oversamplingFactor * tapsPerPhase;
+    constexpr int centre = numTaps / 2;
+
+    for (int p = 0; p < oversamplingFactor; ++p)
+    {
+        float sum = 0.0f;
+        for (int j = 0; j < tapsPerPhase; ++j)
+        {
+            const int i = j * oversamplingFactor + p;
+            const float t = static_cast<float>(i - centre) / oversamplingFactor;
+            const float sinc = i == centre ? 1.0f
+                                           : std::sin(juce::MathConstants<float>::pi * t) / (juce::MathConstants<float>::pi * t);
+            const float window = 0.5f + 0.5f * std::cos(juce::MathConstants<float>::pi * static_cast<float>(i - centre) / (centre + 1));
+
+            coefficients[static_cast<size_t>(p)][static_cast<size_t>(j)] = sinc * window;
+            sum += sinc * window;
+        }
+
+        for (auto& c : coefficients[static_cast<size_t>(p)])
+            c /= sum;
+    }
+}
+
+void LimiterEffect::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = static_cast<float>(spec.sampleRate);
+    blockSize = juce::jmax(1, static_cast<int>(spec.maximumBlockSize));
+    numChannels = juce::jmax(1, static_cast<int>(spec.numChannels));
+
+    maxLookaheadSamples = juce::jmax(1, static_cast<int>(std::ceil(maxLookaheadMs * 0.001 * spec.sampleRate)));
+    historySize = juce::nextPowerOfTwo(maxLookaheadSamples + 2);
+    delaySize = juce::nextPowerOfTwo(maxLookaheadSamples + detectorDelay + blockSize + 1);
+
+    allocateState();
+    reset();
+}
+
+void LimiterEffect::layoutState(DspArena::Allocator& allocator)
+{
+    firHistory = allocator.allocate<float>(numChannels * (tapsPerPhase - 1));
+    firInput = allocator.allocate<float>(blockSize + tapsPerPhase - 1);
+    peaks = allocator.allocate<float>(blockSize);
+    delayLines = allocator.allocate<float>(numChannels * delaySize);
+    minimumPositions = allocator.allocate<juce::uint32>(historySize);
+    minimumValues = allocator.allocate<float>(historySize);
+    averageRing = allocator.allocate<float>(historySize);
+}
+
+void LimiterEffect::resetScalars()
+{
+    lookaheadSamples = getLookaheadSamples();
+    position = 0;
+    dequeHead = 0;
+    dequeTail = 0;
+    delayWriteIndex = 0;
+    averageIndex = 0;
+    averageSum = 0.0;
+    releasedGain = 1.0f;
+    gainReductionDb.store(0.0f, std::memory_order_relaxed);
+}
+
+int LimiterEffect::getLookaheadSamples() const
+{
+    return juce::jlimit(1, maxLookaheadSamples, juce::roundToInt(lookaheadMs * 0.001f * sampleRate));
+}
+
+int LimiterEffect::getLatencySamples() const
+{
+    return getLookaheadSamples() + detectorDelay;
+}
+
+void LimiterEffect::process(juce::AudioBuffer<float>& buffer)
+{
+    if (!isEnabled || delayLines == nullptr)
+        return;
+
+    // 先読みが変わったら検出の窓を作り直す（ディレイの読み出し位置も変わるので一度だけ不連続になる）
+    if (getLookaheadSamples() != lookaheadSamples)
+    {
+        lookaheadSamples = getLookaheadSamples();
+        dequeHead = 0;
+        dequeTail = 0;
+        averageIndex = 0;
+        averageSum = 0.0;
+        juce::FloatVectorOperations::clear(averageRing, historySize);
+    }
+
+    releaseCoefficient = std::exp(-1.0f / (releaseMs * 0.001f * sampleRate));
+
+    const int numSamples = buffer.getNumSamples();
+    for (int start = 0; start < numSamples; start += blockSize)
+        processChunk(buffer, start, juce::jmin(blockSize, numSamples - start));
+}
+
+void LimiterEffect::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+    detectPeaks(buffer, startSample, numSamples, channels);
+    computeGains(numSamples);
+
+    // オーディオを先読み + 補間の遅延だけ遅らせ、ブロック分のゲインをまとめて掛ける
+    const int latency = lookaheadSamples + detectorDelay;
+    const int mask = delaySize - 1;
+    const int readIndex = (delayWriteIndex - latency) & mask;
+    const int firstWrite = juce::jmin(numSamples, delaySize - delayWriteIndex);
+    const int firstRead = juce::jmin(numSamples, delaySize - readIndex);
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* ring = delayLines + static_cast<size_t>(ch * delaySize);
+        float* data = buffer.getWritePointer(ch, startSample);
+
+        juce::FloatVectorOperations::copy(ring + delayWriteIndex, data, firstWrite);
+        juce::FloatVectorOperations::copy(ring, data + firstWrite, numSamples - firstWrite);
+
+        juce::FloatVectorOperations::copy(data, ring + readIndex, firstRead);
+        juce::FloatVectorOperations::copy(data + firstRead, ring, numSamples - firstRead);
+
+        juce::FloatVectorOperations::multiply(data, peaks, numSamples);
+    }
+
+    delayWriteIndex = (delayWriteIndex + numSamples) & mask;
+}
+
+void LimiterEffect::detectPeaks(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples, int channels)
+{
+    constexpr int historyLength = tapsPerPhase - 1;
+    juce::FloatVectorOperations::clear(peaks, numSamples);
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* history = firHistory + ch * historyLength;
+        juce::FloatVectorOperations::copy(firInput, history, historyLength);
+        juce::FloatVectorOperations::copy(firInput + historyLength, buffer.getReadPointer(ch, startSample), numSamples);
+
+        if (truePeak)
+        {
+            // x[k] は firInput[i + historyLength - k]（k = 0 が最新）
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float* x = firInput + i;
+                float peak = peaks[i];
+                for (const auto& phase : coefficients)
+                {
+                    float sum = 0.0f;
+                    for (int k = 0; k < tapsPerPhase; ++k)
+                        sum += phase[static_cast<size_t>(k)] * x[historyLength - k];
+                    peak = juce::jmax(peak, std::abs(sum));
+                }
+                peaks[i] = peak;
+            }
+        }
+        else
+        {
+            // フェーズ 0 と同じ位置のサンプルピーク（レイテンシを揃える）
+            const float* x = firInput + historyLength - detectorDelay;
+            for (int i = 0; i < numSamples; ++i)
+                peaks[i] = juce::jmax(peaks[i], std::abs(x[i]));
+        }
+
+        juce::FloatVectorOperations::copy(history, firInput + numSamples, historyLength);
+    }
+}
+
+void LimiterEffect::computeGains(int numSamples)
+{
+    const float ceiling = juce::Decibels::decibelsToGain(ceilingDb);
+    const int mask = historySize - 1;
+    const int window = lookaheadSamples + 1;
+    const double invWindow = 1.0 / window;
+    float minimumGain = 1.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float required = peaks[i] > ceiling ? ceiling / peaks[i] : 1.0f;
+
+        // 単調デック: 後ろから required 以上の値を捨ててから積む。先頭が窓の最小値
+        while (dequeTail != dequeHead && minimumValues[(dequeTail - 1) & mask] >= required)
+            dequeTail = (dequeTail - 1) & mask;
+        minimumPositions[dequeTail] = position;
+        minimumValues[dequeTail] = required;
+        dequeTail = (dequeTail + 1) & mask;
+
+        if (position - minimumPositions[dequeHead] > static_cast<juce::uint32>(lookaheadSamples))
+            dequeHead = (dequeHead + 1) & mask;
+
+        // 下げるのは即座に、戻すのはリリースで
+        const float held = minimumValues[dequeHead];
+        releasedGain = held < releasedGain ? held : held + (releasedGain - held) * releaseCoefficient;
+
+        // 先読みと同じ長さの移動平均（リダクション量で持つ）
+        const float reduction = 1.0f - releasedGain;
+        averageSum += static_cast<double>(reduction - averageRing[averageIndex]);
+        averageRing[averageIndex] = reduction;
+        if (++averageIndex >= window)
+            averageIndex = 0;
+
+        const float gain = juce::jmin(1.0f, static_cast<float>(1.0 - averageSum * invWindow));
+        peaks[i] = gain;
+        minimumGain = juce::jmin(minimumGain, gain);
+        ++position;
+    }
+
+    gainReductionDb.store(juce::Decibels::gainToDecibels(minimumGain, -60.0f), std::memory_order_relaxed);
+}
+
+juce::StringArray LimiterEffect::getParameterNames() const
+{
+    return {"Ceiling", "Lookahead", "Release", "True Peak"};
+}
+
+juce::StringArray LimiterEffect::getParameterLabels() const
+{
+    return {"dBTP", "ms", "ms", ""};
+}
+
+juce::Array<float> LimiterEffect::getParameterRanges() const
+{
+    return {
+        -12.0f, 0.0f, -1.0f,    // Ceiling: -12dB - 0dB
+        0.5f, 10.0f, 5.0f,      // Lookahead: 0.5ms - 10ms
+        10.0f, 1000.0f, 100.0f, // Release: 10ms - 1000ms
+        0.0f, 1.0f, 1.0f        // True Peak: Off / On
+    };
+}
+
+void LimiterEffect::setParameter(int parameterIndex, float value)
+{
+    switch (parameterIndex)
+    {
+        case 0: ceilingDb = juce::jlimit(-12.0f, 0.0f, value); break;
+        case 1: lookaheadMs = juce::jlimit(0.5f, maxLookaheadMs, value); break;
+        case 2: releaseMs = juce::jlimit(10.0f, 1000.0f, value); break;
+        case 3: truePeak = value >= 0.5f; break;
+        default: break;
+    }
+}
+
+float LimiterEffect::getParameter(int parameterIndex) const
+{
+    switch (parameterIndex)
+    {
+        case 0: return ceilingDb;
+        case 1: return lookaheadMs;
+        case 2: return releaseMs;
+        case 3: return truePeak ? 1.0f : 0.0f;
+        default: return 0.0f;
+    }
+}
+
+void LimiterEffect::saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const
+{
+    xml.setAttribute("Ceiling", parameterValues[0]);
+    xml.setAttribute("Lookahead", parameterValues[1]);
+    xml.setAttribute("Release", parameterValues[2]);
+    xml.setAttribute("TruePeak", parameterValues[3] >= 0.5f);
+}
+
+void LimiterEffect::loadFromXml(const juce::XmlElement& xml)
+{
+    setParameter(0, static_cast<float>(xml.getDoubleAttribute("Ceiling", ceilingDb)));
+    setParameter(1, static_cast<float>(xml.getDoubleAttribute("Lookahead", lookaheadMs)));
+    setParameter(2, static_cast<float>(xml.getDoubleAttribute("Release", releaseMs)));
+    setParameter(3, xml.getBoolAttribute("TruePeak", truePeak) ? 1.0f : 0.0f);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Effect.h"
+#include <array>
+
+/**
+ * 先読み付きのトゥルーピーク・リミッター（チェーンの最後に置く想定）
+ * - 検出は4倍オーバーサンプリングのポリフェーズFIR（BS.1770 と同じ 48 タップ）で、サンプル間のピークも拾う
+ * - 必要なゲインの先読み区間での最小値を単調デックのスライディング最小で求めるので、
+ *   1サンプルあたりの計算量は先読みの長さによらない（償却 O(1)）
+ * - 最小値をリリースで戻し、先読みと同じ長さの移動平均で滑らかにする。平均の窓は先読み区間に収まるので、
+ *   ピークがオーディオに届く時点でゲインは必ず目標以下になっている
+ * - ゲインはブロック単位で求め、全チャンネルへ FloatVectorOperations でまとめて掛ける（チャンネル間はリンク）
+ * - レイテンシは先読み + 補間フィルターの遅延。先読みを変えるとレイテンシも変わる
+ */
+class LimiterEffect : public Effect
+{
+public:
+    static constexpr int oversamplingFactor = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int detectorDelay = tapsPerPhase / 2; // 補間フィルターの遅延（元のレートのサンプル数）
+    static constexpr float maxLookaheadMs = 10.0f;
+
+    LimiterEffect();
+    ~LimiterEffect() override = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    void process(juce::AudioBuffer<float>& buffer) override;
+    void resetScalars() override;
+    int getLatencySamples() const override;
+
+    // パラメータ関連
+    juce::StringArray getParameterNames() const override;
+    juce::StringArray getParameterLabels() const override;
+    juce::Array<float> getParameterRanges() const override;
+    void setParameter(int parameterIndex, float value) override;
+    float getParameter(int parameterIndex) const override;
+
+    // エフェクト情報
+    juce::String getName() const override { return "Limiter"; }
+    juce::String getCategory() const override { return "Dynamics"; }
+    EffectTypeId getTypeId() const override { return EffectTypeId::limiter; }
+    int getNumParameters() const override { return 4; }
+
+    // プリセット関連
+    void saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const override;
+    void loadFromXml(const juce::XmlElement& xml) override;
+
+    // 直近のブロックで最も深くかかったゲインリダクション（dB、0 以下。メーター表示用）
+    float getGainReductionDb() const { return gainReductionDb.load(std::memory_order_relaxed); }
+
+protected:
+    void layoutState(DspArena::Allocator& allocator) override;
+
+private:
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void detectPeaks(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples, int channels);
+    void computeGains(int numSamples);
+    int getLookaheadSamples() const;
+
+    float ceilingDb = -1.0f;   // 天井 (-12dB - 0dB、トゥルーピーク)
+    float lookaheadMs = 5.0f;  // 先読み (0.5ms - 10ms)
+    float releaseMs = 100.0f;  // リリース (10ms - 1000ms)
+    bool truePeak = true;      // オフならサンプルピークで検出する（レイテンシは同じ）
+
+    int numChannels = 0;
+    int lookaheadSamples = 0;  // 処理中の先読み。変わったら検出の状態を作り直す
+    int maxLookaheadSamples = 1;
+    int historySize = 0;       // 先読みの最大長 + 2 以上の2のべき乗
+    int delaySize = 0;
+    std::atomic<float> gainReductionDb { 0.0f };
+
+    // 補間フィルターの係数: coefficients[phase][tap]（各フェーズの和は1）
+    std::array<std::array<float, tapsPerPhase>, oversamplingFactor> coefficients {};
+
+    // 作業領域と状態（状態メモリから切り出す）
+    float* firHistory = nullptr;    // チャンネルごとに直前 tapsPerPhase - 1 サンプル
+    float* firInput = nullptr;      // 履歴 + ブロック
+    float* peaks = nullptr;         // ブロック内の各サンプルのピーク → 掛けるゲイン
+    float* delayLines = nullptr;    // チャンネルごとの delaySize のリング
+    juce::uint32* minimumPositions = nullptr; // 単調デック（位置と値、目標ゲインの昇順）
+    float* minimumValues = nullptr;
+    float* averageRing = nullptr;   // 移動平均の窓（1 - ゲイン を持つので 0 で初期化できる）
+
+    // スカラーの状態
+    juce::uint32 position = 0;
+    int dequeHead = 0;
+    int dequeTail = 0;
+    int delayWriteIndex = 0;
+    int averageIndex = 0;
+    double averageSum = 0.0;
+    float releasedGain = 1.0f;
+    float releaseCoefficient = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LimiterEffect)
+};
@@ -0,0 +1,352 @@
+#include "PitchShiftEffect.h"
+#include "EffectRegistry.h"
+
+KRUMP_REGISTER_EFFECT(PitchShiftEffect, EffectTypeId::pitchShift, "Pitch")
+
+PitchShiftEffect::PitchShiftEffect()
+{
+    // グラニュラー用の sin^2 窓。位相が半周期ずれた2つのヘッドの和は常に1になる
+    grainWindow.allocate(windowTableSize, true);
+    for (int i = 0; i < windowTableSize; ++i)
+    {
+        const float s = std::sin(juce::MathConstants<float>::pi * static_cast<float>(i) / windowTableSize);
+        grainWindow[i] = s * s;
+    }
+
+    smoothedMix.setCurrentAndTargetValue(mix);
+}
+
+void PitchShiftEffect::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = static_cast<float>(spec.sampleRate);
+    blockSize = juce::jmax(1, static_cast<int>(spec.maximumBlockSize));
+    numChannels = juce::jmax(1, static_cast<int>(spec.numChannels));
+
+    // ===== グラニュラー: 20ms のグレイン =====
+    grainSamples = 2 * juce::jmax(16, juce::roundToInt(0.01 * spec.sampleRate));
+    grainRingSize = juce::nextPowerOfTwo(grainSamples + blockSize + 4);
+    grainRingMask = grainRingSize - 1;
+
+    // ===== フェーズボコーダー: 48kHz で 2048 点、サンプルレートに合わせて倍々にする =====
+    const int order = juce::jlimit(11, 13, 11 + juce::roundToInt(std::log2(juce::jmax(1.0, spec.sampleRate / 48000.0))));
+    fft = std::make_unique<juce::dsp::FFT>(order);
+    fftSize = fft->getSize();
+    hopSize = fftSize / overlapFactor;
+
+    analysisWindow.allocate(static_cast<size_t>(fftSize), true);
+    allocateState();
+
+    // 周期的ハン窓。分析と合成の両方で掛けるので、オーバーラップ後の w^2 の和で正規化する
+    float windowPowerSum = 0.0f;
+    for (int i = 0; i < fftSize; ++i)
+    {
+        analysisWindow[i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * static_cast<float>(i) / fftSize);
+        windowPowerSum += analysisWindow[i] * analysisWindow[i];
+    }
+    const float synthesisGain = static_cast<float>(hopSize) / windowPowerSum;
+    for (int i = 0; i < fftSize; ++i)
+        analysisWindow[i] *= std::sqrt(synthesisGain);
+
+    smoothedMix.reset(spec.sampleRate, 0.02);
+    reset();
+}
+
+void PitchShiftEffect::layoutState(DspArena::Allocator& allocator)
+{
+    grainRing = allocator.allocate<float>(grainRingSize * numChannels);
+    tapDelays = allocator.allocate<float>(blockSize * 2);
+    tapGains = allocator.allocate<float>(blockSize * 2);
+    mixGains = allocator.allocate<float>(blockSize);
+
+    const int numBins = fftSize / 2 + 1;
+    fftBuffer = allocator.allocate<float>(fftSize * 2);
+    analysisMagnitudes = allocator.allocate<float>(numBins);
+    analysisFrequencies = allocator.allocate<float>(numBins);
+    synthesisMagnitudes = allocator.allocate<float>(numBins);
+    synthesisFrequencies = allocator.allocate<float>(numBins);
+    channelState = allocator.allocate<float>((fftSize * 4 + numBins * 2) * numChannels);
+}
+
+void PitchShiftEffect::process(juce::AudioBuffer<float>& buffer)
+{
+    if (!isEnabled || fft == nullptr)
+        return;
+
+    if (mode != activeMode)
+    {
+        activeMode = mode;
+        clearState();
+    }
+
+    smoothedMix.setTargetValue(mix);
+
+    if (activeMode == Mode::highQuality)
+    {
+        processPhaseVocoder(buffer);
+        return;
+    }
+
+    const int numSamples = buffer.getNumSamples();
+    for (int start = 0; start < numSamples; start += blockSize)
+        processGranular(buffer, start, juce::jmin(blockSize, numSamples - start));
+}
+
+void PitchShiftEffect::processGranular(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // ヘッドのディレイは 1 〜 grainSamples + 1 を鋸歯状に動く。平均ディレイがレイテンシになる
+    const float phaseIncrement = (1.0f - getPitchRatio()) / static_cast<float>(grainSamples);
+    const float grainLength = static_cast<float>(grainSamples);
+    float* delays[2] = { tapDelays, tapDelays + blockSize };
+    float* gains[2] = { tapGains, tapGains + blockSize };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        grainPhase += phaseIncrement;
+        grainPhase -= std::floor(grainPhase);
+
+        for (int head = 0; head < 2; ++head)
+        {
+            float phase = grainPhase + 0.5f * static_cast<float>(head);
+            phase -= std::floor(phase);
+
+            delays[head][i] = 1.0f + phase * grainLength;
+            gains[head][i] = grainWindow[static_cast<int>(phase * windowTableSize) & (windowTableSize - 1)];
+        }
+
+        mixGains[i] = smoothedMix.getNextValue();
+    }
+
+    const int latency = getLatencySamples();
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* ring = grainRing + static_cast<size_t>(ch * grainRingSize);
+        float* data = buffer.getWritePointer(ch, startSample);
+
+        // 最小ディレイが1サンプルなので、ブロック分を先にまとめて書き込んでから読み出せる
+        for (int i = 0; i < numSamples; ++i)
+            ring[(grainWriteIndex + i) & grainRingMask] = data[i];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float wet = 0.0f;
+            for (int head = 0; head < 2; ++head)
+            {
+                const int delayInt = static_cast<int>(delays[head][i]);
+                const float frac = delays[head][i] - static_cast<float>(delayInt);
+                const int index = grainWriteIndex + i - delayInt;
+
+                const float x0 = ring[index & grainRingMask];
+                const float x1 = ring[(index - 1) & grainRingMask];
+                wet += gains[head][i] * (x0 + frac * (x1 - x0));
+            }
+
+            // ドライもレイテンシ分遅らせて位相を揃える
+            const float dry = ring[(grainWriteIndex + i - latency) & grainRingMask];
+            data[i] = dry + mixGains[i] * (wet - dry);
+        }
+    }
+
+    grainWriteIndex = (grainWriteIndex + numSamples) & grainRingMask;
+}
+
+void PitchShiftEffect::processPhaseVocoder(juce::AudioBuffer<float>& buffer)
+{
+    // 入力FIFOは fftSize - hopSize まで溜まった状態からホップ分ずつ進む。
+    // ウェットはフレームを処理した直後のホップで出るので、入力から fftSize 遅れる
+    const int fillStart = fftSize - hopSize;
+    const int numSamples = buffer.getNumSamples();
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+    auto* const* channelData = buffer.getArrayOfWritePointers();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float wetGain = smoothedMix.getNextValue();
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            const auto state = getSpectralChannel(ch);
+            const float wet = state.outputFifo[fifoPosition - fillStart];
+            const float dry = state.outputFifo[hopSize + fifoPosition - fillStart];
+
+            state.inputFifo[fifoPosition] = channelData[ch][i];
+            channelData[ch][i] = dry + wetGain * (wet - dry);
+        }
+
+        if (++fifoPosition >= fftSize)
+        {
+            fifoPosition = fillStart;
+            for (int ch = 0; ch < channels; ++ch)
+                processSpectralFrame(ch);
+        }
+    }
+}
+
+void PitchShiftEffect::processSpectralFrame(int channel)
+{
+    const auto state = getSpectralChannel(channel);
+    const int numBins = fftSize / 2 + 1;
+    const float ratio = getPitchRatio();
+    const float expectedPhaseAdvance = juce::MathConstants<float>::twoPi * static_cast<float>(hopSize) / static_cast<float>(fftSize);
+    constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+    // 分析
+    juce::FloatVectorOperations::multiply(fftBuffer, state.inputFifo, analysisWindow, fftSize);
+    juce::FloatVectorOperations::clear(fftBuffer + fftSize, fftSize);
+    fft->performRealOnlyForwardTransform(fftBuffer, true);
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const float re = fftBuffer[2 * k];
+        const float im = fftBuffer[2 * k + 1];
+        const float phase = std::atan2(im, re);
+
+        float deviation = phase - state.lastPhase[k] - static_cast<float>(k) * expectedPhaseAdvance;
+        deviation -= twoPi * std::round(deviation / twoPi);
+        state.lastPhase[k] = phase;
+
+        analysisMagnitudes[k] = std::sqrt(re * re + im * im);
+        analysisFrequencies[k] = static_cast<float>(k) + deviation / expectedPhaseAdvance; // ビン単位の真の周波数
+    }
+
+    // ビンの移動
+    juce::FloatVectorOperations::clear(synthesisMagnitudes, numBins);
+    juce::FloatVectorOperations::clear(synthesisFrequencies, numBins);
+    for (int k = 0; k < numBins; ++k)
+    {
+        const int target = juce::roundToInt(static_cast<float>(k) * ratio);
+        if (target < numBins)
+        {
+            synthesisMagnitudes[target] += analysisMagnitudes[k];
+            synthesisFrequencies[target] = analysisFrequencies[k] * ratio;
+        }
+    }
+
+    // 合成
+    for (int k = 0; k < numBins; ++k)
+    {
+        float phase = state.phaseSum[k] + synthesisFrequencies[k] * expectedPhaseAdvance;
+        phase -= twoPi * std::round(phase / twoPi);
+        state.phaseSum[k] = phase;
+
+        fftBuffer[2 * k] = synthesisMagnitudes[k] * std::cos(phase);
+        fftBuffer[2 * k + 1] = synthesisMagnitudes[k] * std::sin(phase);
+    }
+    juce::FloatVectorOperations::clear(fftBuffer + 2 * numBins, fftSize * 2 - 2 * numBins);
+    fft->performRealOnlyInverseTransform(fftBuffer);
+
+    // オーバーラップ加算して1ホップ分を出力FIFOへ
+    juce::FloatVectorOperations::addWithMultiply(state.overlapAdd, fftBuffer, analysisWindow, fftSize);
+    juce::FloatVectorOperations::copy(state.outputFifo, state.overlapAdd, hopSize);
+
+    // ドライは入力FIFOから押し出される最も古いホップ。ウェットと同じく fftSize 遅れで出る
+    juce::FloatVectorOperations::copy(state.outputFifo + hopSize, state.inputFifo, hopSize);
+
+    std::memmove(state.overlapAdd, state.overlapAdd + hopSize, sizeof(float) * static_cast<size_t>(fftSize * 2 - hopSize));
+    juce::FloatVectorOperations::clear(state.overlapAdd + fftSize * 2 - hopSize, hopSize);
+    std::memmove(state.inputFifo, state.inputFifo + hopSize, sizeof(float) * static_cast<size_t>(fftSize - hopSize));
+}
+
+PitchShiftEffect::SpectralChannel PitchShiftEffect::getSpectralChannel(int channel) const
+{
+    const int numBins = fftSize / 2 + 1;
+    float* base = channelState + static_cast<size_t>(channel * (fftSize * 4 + numBins * 2));
+
+    return { base,                    // inputFifo:  fftSize
+             base + fftSize,          // outputFifo: fftSize（ウェットとドライを1ホップずつ）
+             base + fftSize * 2,      // overlapAdd: fftSize * 2
+             base + fftSize * 4,      // lastPhase:  numBins
+             base + fftSize * 4 + numBins };
+}
+
+void PitchShiftEffect::resetScalars()
+{
+    grainWriteIndex = 0;
+    grainPhase = 0.0f;
+    fifoPosition = fftSize - hopSize;
+    smoothedMix.setCurrentAndTargetValue(mix);
+}
+
+void PitchShiftEffect::clearState()
+{
+    if (grainRingSize > 0)
+        juce::FloatVectorOperations::clear(grainRing, grainRingSize * numChannels);
+    grainWriteIndex = 0;
+    grainPhase = 0.0f;
+
+    if (fftSize > 0)
+        juce::FloatVectorOperations::clear(channelState, (fftSize * 4 + (fftSize / 2 + 1) * 2) * numChannels);
+    fifoPosition = fftSize - hopSize;
+}
+
+int PitchShiftEffect::getLatencySamples() const
+{
+    // グラニュラーはヘッドの平均ディレイ、フェーズボコーダーはFFT長（入力FIFOとオーバーラップ加算の1ホップ）
+    return mode == Mode::live ? grainSamples / 2 + 1 : fftSize;
+}
+
+float PitchShiftEffect::getPitchRatio() const
+{
+    return std::exp2((semitones + cents * 0.01f) / 12.0f);
+}
+
+juce::StringArray PitchShiftEffect::getParameterNames() const
+{
+    return {"Pitch", "Fine", "Mix", "Mode"};
+}
+
+juce::StringArray PitchShiftEffect::getParameterLabels() const
+{
+    return {"st", "ct", "%", ""};
+}
+
+juce::Array<float> PitchShiftEffect::getParameterRanges() const
+{
+    return {
+        -24.0f, 24.0f, 0.0f,    // Pitch: -24 - +24 半音
+        -100.0f, 100.0f, 0.0f,  // Fine: -100 - +100 セント
+        0.0f, 1.0f, 1.0f,       // Mix: 0 - 1
+        0.0f, 1.0f, 0.0f        // Mode: Live / HQ
+    };
+}
+
+void PitchShiftEffect::setParameter(int parameterIndex, float value)
+{
+    switch (parameterIndex)
+    {
+        case 0: semitones = juce::jlimit(-24.0f, 24.0f, value); break;
+        case 1: cents = juce::jlimit(-100.0f, 100.0f, value); break;
+        case 2: mix = juce::jlimit(0.0f, 1.0f, value); break;
+        case 3: mode = value >= 0.5f ? Mode::highQuality : Mode::live; break;
+        default: break;
+    }
+}
+
+float PitchShiftEffect::getParameter(int parameterIndex) const
+{
+    switch (parameterIndex)
+    {
+        case 0: return semitones;
+        case 1: return cents;
+        case 2: return mix;
+        case 3: return static_cast<float>(mode);
+        default: return 0.0f;
+    }
+}
+
+void PitchShiftEffect::saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const
+{
+    xml.setAttribute("Pitch", parameterValues[0]);
+    xml.setAttribute("Fine", parameterValues[1]);
+    xml.setAttribute("Mix", parameterValues[2]);
+    xml.setAttribute("Mode", juce::roundToInt(parameterValues[3]));
+}
+
+void PitchShiftEffect::loadFromXml(const juce::XmlElement& xml)
+{
+    setParameter(0, static_cast<float>(xml.getDoubleAttribute("Pitch", semitones)));
+    setParameter(1, static_cast<float>(xml.getDoubleAttribute("Fine", cents)));
+    setParameter(2, static_cast<float>(xml.getDoubleAttribute("Mix", mix)));
+    setParameter(3, static_cast<float>(xml.getIntAttribute("Mode", static_cast<int>(mode))));
+}
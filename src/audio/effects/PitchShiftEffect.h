@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Effect.h"
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * ピッチシフトエフェクト
+ * - Live: 2つの読み出しヘッドをクロスフェードする時間領域グラニュラー方式（低レイテンシ）
+ * - HQ: FFTフェーズボコーダー方式（高音質、オフラインレンダリング向け）
+ * - 窓関数とFFTは prepare で用意し、定常時の処理ではメモリ確保を行わない
+ * - リングバッファ・FIFO・スペクトルの作業領域は状態メモリから切り出す（窓のテーブルは係数なので別に持つ）
+ */
+class PitchShiftEffect : public Effect
+{
+public:
+    enum class Mode
+    {
+        live = 0,
+        highQuality
+    };
+
+    PitchShiftEffect();
+    ~PitchShiftEffect() override = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    void process(juce::AudioBuffer<float>& buffer) override;
+    void resetScalars() override;
+    int getLatencySamples() const override;
+
+    // パラメータ関連
+    juce::StringArray getParameterNames() const override;
+    juce::StringArray getParameterLabels() const override;
+    juce::Array<float> getParameterRanges() const override;
+    void setParameter(int parameterIndex, float value) override;
+    float getParameter(int parameterIndex) const override;
+
+    // エフェクト情報
+    juce::String getName() const override { return "Pitch"; }
+    juce::String getCategory() const override { return "Pitch"; }
+    EffectTypeId getTypeId() const override { return EffectTypeId::pitchShift; }
+    int getNumParameters() const override { return 4; }
+
+    // プリセット関連
+    void saveValuesToXml(juce::XmlElement& xml, const float* parameterValues) const override;
+    void loadFromXml(const juce::XmlElement& xml) override;
+
+protected:
+    void layoutState(DspArena::Allocator& allocator) override;
+
+private:
+    float getPitchRatio() const;
+
+    void processGranular(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void clearState();
+    void processPhaseVocoder(juce::AudioBuffer<float>& buffer);
+    void processSpectralFrame(int channel);
+
+    float semitones = 0.0f;  // ピッチ (-24 - +24 半音)
+    float cents = 0.0f;      // ファイン (-100 - +100 セント)
+    float mix = 1.0f;        // ウェット/ドライ (0.0 - 1.0)
+    Mode mode = Mode::live;
+    Mode activeMode = Mode::live;  // 処理中のモード。切り替え時に状態をクリアする
+
+    int numChannels = 0;
+
+    // ===== グラニュラー (Live) =====
+    static constexpr int windowTableSize = 1024;
+    juce::HeapBlock<float> grainWindow;   // sin^2 窓（位相 0-1 を1周期）
+    float* grainRing = nullptr;           // 全チャンネル分の連続した2のべき乗リングバッファ
+    float* tapDelays = nullptr;           // ブロック単位で共有するヘッドごとのディレイと窓ゲイン
+    float* tapGains = nullptr;
+    float* mixGains = nullptr;
+    int grainSamples = 0;
+    int grainRingSize = 0;
+    int grainRingMask = 0;
+    int grainWriteIndex = 0;
+    float grainPhase = 0.0f;
+
+    // ===== フェーズボコーダー (HQ) =====
+    static constexpr int overlapFactor = 4;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    int fftSize = 0;
+    int hopSize = 0;
+    int fifoPosition = 0;
+    juce::HeapBlock<float> analysisWindow;
+    float* fftBuffer = nullptr;             // 2 * fftSize（JUCEの実数FFTの作業領域）
+    float* analysisMagnitudes = nullptr;
+    float* analysisFrequencies = nullptr;
+    float* synthesisMagnitudes = nullptr;
+    float* synthesisFrequencies = nullptr;
+    float* channelState = nullptr;          // チャンネルごとの入出力FIFO、OLA、位相
+
+    struct SpectralChannel
+    {
+        float* inputFifo;
+        float* outputFifo;
+        float* overlapAdd;
+        float* lastPhase;
+        float* phaseSum;
+    };
+    SpectralChannel getSpectralChannel(int channel) const;
+
+    juce::SmoothedValue<float> smoothedMix;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchShiftEffect)
+};
@@ -0,0 +1,54 @@
+#include "DspKernels.h"
+#include <juce_core/juce_core.h>
+
+const DspKernels& DspKernels::getBest()
+{
+    // CPUID を見るのは最初の1回だけ
+    static const DspKernels& best = []() -> const DspKernels&
+    {
+        for (auto candidate : { InstructionSet::avx512, InstructionSet::avx2 })
+            if (const auto* kernels = find(candidate))
+                return *kernels;
+
+        return getBaseline();
+    }();
+
+    return best;
+}
+
+const DspKernels& DspKernels::getBaseline()
+{
+    return *getGenericVariant();
+}
+
+const DspKernels* DspKernels::find(InstructionSet instructionSet)
+{
+    // CPU が対応していない変種は、表を作る（静的変数を初期化する）ところから呼ばない
+    switch (instructionSet)
+    {
+        case InstructionSet::avx2:
+            return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3() ? getAvx2Variant() : nullptr;
+
+        case InstructionSet::avx512:
+            return juce::SystemStats::hasAVX512F() && juce::SystemStats::hasFMA3() ? getAvx512Variant() : nullptr;
+
+        case InstructionSet::generic:
+        case InstructionSet::sse2:
+        case InstructionSet::neon:
+        default:
+            return getBaseline().instructionSet == instructionSet ? &getBaseline() : nullptr;
+    }
+}
+
+const char* DspKernels::getName(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::sse2:   return "SSE2";
+        case InstructionSet::neon:   return "NEON";
+        case InstructionSet::avx2:   return "AVX2";
+        case InstructionSet::avx512: return "AVX-512";
+        case InstructionSet::generic:
+        default:                     return "Generic";
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * ホットループの命令セット別の実装（実行時に CPU を見て1つ選ぶ）
+ * - 同じループ（DspKernelsImpl.h）を命令セットごとの翻訳単位で別々のコンパイルフラグでビルドし、関数ポインタの表にする。
+ *   ベースライン（x86-64 なら SSE2、ARM64 なら NEON）は常にあり、AVX2 / AVX-512 はビルドできたときだけ加わる
+ * - getBest() は最初の呼び出しで CPUID（juce::SystemStats）を見て最も広いものを選び、以後は同じ表を返す。
+ *   使う側は prepare で表のポインタを取っておき、オーディオスレッドでは選び直さない
+ * - 変種どうしの違いは縮約の順序と FMA の有無による丸め誤差だけ（結果は許容誤差内で一致する）
+ * - このヘッダーと DspKernelsImpl.h は JUCE も標準ライブラリも読まない。AVX のフラグでビルドしたインライン関数が
+ *   リンク時にベースライン側の定義を置き換えると、古い CPU で落ちるため
+ */
+struct DspKernels
+{
+    enum class InstructionSet
+    {
+        generic = 0, // SSE2 も NEON もない環境のベースライン
+        sse2,
+        neon,
+        avx2,
+        avx512
+    };
+
+    InstructionSet instructionSet = InstructionSet::generic;
+
+    // メーター: 絶対値の最大と二乗和
+    void (*measure)(const float* data, int numSamples, float* peak, float* sumSquares) = nullptr;
+
+    // ミックス
+    void (*copyWithGain)(float* destination, const float* source, float gain, int numSamples) = nullptr;
+    void (*addWithGain)(float* destination, const float* source, float gain, int numSamples) = nullptr;
+    // destination = destination * destinationGains + source * sourceGains（サンプルごとの利得）
+    void (*mixWithGains)(float* destination, const float* destinationGains,
+                         const float* source, const float* sourceGains, int numSamples) = nullptr;
+
+    // TPT 状態変数フィルターのローパス出力。チャンネルをレーンに並べて同時に進める。
+    // states はチャンネルごとの (s1, s2)。g と h は coefficientStride（0 なら固定、1 ならサンプルごと）で読む
+    void (*stateVariableLowpass)(float* const* channels, int numChannels, int numSamples, float* states,
+                                 const float* g, const float* h, int coefficientStride, float R2) = nullptr;
+
+    // この CPU で使える中で最も広い変種
+    static const DspKernels& getBest();
+
+    // どの CPU でも動くベースライン
+    static const DspKernels& getBaseline();
+
+    // 指定の変種。ビルドされていないか CPU が対応していなければ nullptr
+    static const DspKernels* find(InstructionSet instructionSet);
+
+    static const char* getName(InstructionSet instructionSet);
+
+private:
+    // 命令セットごとの翻訳単位で定義する（フラグが効かずにビルドされた変種は nullptr を返す）
+    static const DspKernels* getGenericVariant();
+    static const DspKernels* getAvx2Variant();
+    static const DspKernels* getAvx512Variant();
+};
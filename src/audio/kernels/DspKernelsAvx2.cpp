@@ -0,0 +1,27 @@
+#include "DspKernels.h"
+
+// CMakeLists.txt で x86 のときだけ -mavx2 -mfma（MSVC は /arch:AVX2）を付けてビルドする
+#if defined(__AVX2__)
+
+namespace
+{
+    constexpr auto kernelInstructionSet = DspKernels::InstructionSet::avx2;
+    constexpr int kernelLanes = 8; // 256bit
+}
+
+#include "DspKernelsImpl.h"
+
+const DspKernels* DspKernels::getAvx2Variant()
+{
+    static const DspKernels kernels = makeKernels();
+    return &kernels;
+}
+
+#else
+
+const DspKernels* DspKernels::getAvx2Variant()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,27 @@
+#include "DspKernels.h"
+
+// CMakeLists.txt で x86 のときだけ -mavx512f -mfma（MSVC は /arch:AVX512）を付けてビルドする
+#if defined(__AVX512F__)
+
+namespace
+{
+    constexpr auto kernelInstructionSet = DspKernels::InstructionSet::avx512;
+    constexpr int kernelLanes = 16; // 512bit
+}
+
+#include "DspKernelsImpl.h"
+
+const DspKernels* DspKernels::getAvx512Variant()
+{
+    static const DspKernels kernels = makeKernels();
+    return &kernels;
+}
+
+#else
+
+const DspKernels* DspKernels::getAvx512Variant()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,22 @@
+#include "DspKernels.h"
+
+// ベースライン: 追加のフラグなしでビルドする（x86-64 では SSE2、ARM64 では NEON がもともと使える）
+namespace
+{
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    constexpr auto kernelInstructionSet = DspKernels::InstructionSet::sse2;
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    constexpr auto kernelInstructionSet = DspKernels::InstructionSet::neon;
+#else
+    constexpr auto kernelInstructionSet = DspKernels::InstructionSet::generic;
+#endif
+    constexpr int kernelLanes = 4; // 128bit
+}
+
+#include "DspKernelsImpl.h"
+
+const DspKernels* DspKernels::getGenericVariant()
+{
+    static const DspKernels kernels = makeKernels();
+    return &kernels;
+}
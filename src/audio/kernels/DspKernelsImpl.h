@@ -0,0 +1,119 @@
+// DspKernels の命令セット別の翻訳単位が、それぞれの名前空間の中で1回だけ読む（インクルードガードなし）
+// - 読む前に kernelLanes（1回に並べるサンプル数/チャンネル数）と kernelInstructionSet を定義しておく
+// - ループはコンパイラの自動ベクトル化に任せる。縮約はレーン数ぶんの部分和に分け、順序に依存しない形にしておく
+// - JUCE も標準ライブラリも使わない（DspKernels.h を参照）
+
+namespace
+{
+    inline float absolute(float x) { return x < 0.0f ? -x : x; }
+    inline float maximum(float a, float b) { return a > b ? a : b; }
+
+    void measure(const float* data, int numSamples, float* peak, float* sumSquares)
+    {
+        float peaks[kernelLanes] = {};
+        float sums[kernelLanes] = {};
+
+        int i = 0;
+        for (; i + kernelLanes <= numSamples; i += kernelLanes)
+            for (int lane = 0; lane < kernelLanes; ++lane)
+            {
+                const float x = data[i + lane];
+                peaks[lane] = maximum(peaks[lane], absolute(x));
+                sums[lane] += x * x;
+            }
+
+        for (int lane = 0; i < numSamples; ++i, ++lane)
+        {
+            peaks[lane] = maximum(peaks[lane], absolute(data[i]));
+            sums[lane] += data[i] * data[i];
+        }
+
+        float blockPeak = 0.0f;
+        float blockSum = 0.0f;
+        for (int lane = 0; lane < kernelLanes; ++lane)
+        {
+            blockPeak = maximum(blockPeak, peaks[lane]);
+            blockSum += sums[lane];
+        }
+
+        *peak = blockPeak;
+        *sumSquares = blockSum;
+    }
+
+    void copyWithGain(float* destination, const float* source, float gain, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = source[i] * gain;
+    }
+
+    void addWithGain(float* destination, const float* source, float gain, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] += source[i] * gain;
+    }
+
+    void mixWithGains(float* destination, const float* destinationGains, const float* source, const float* sourceGains, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = destination[i] * destinationGains[i] + source[i] * sourceGains[i];
+    }
+
+    void stateVariableLowpass(float* const* channels, int numChannels, int numSamples, float* states,
+                              const float* g, const float* h, int coefficientStride, float R2)
+    {
+        // 空きレーンは 0 を入れて計算し、書き戻さない
+        for (int first = 0; first < numChannels; first += kernelLanes)
+        {
+            const int count = numChannels - first < kernelLanes ? numChannels - first : kernelLanes;
+
+            float s1[kernelLanes] = {};
+            float s2[kernelLanes] = {};
+            for (int lane = 0; lane < count; ++lane)
+            {
+                s1[lane] = states[(first + lane) * 2];
+                s2[lane] = states[(first + lane) * 2 + 1];
+            }
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float gi = g[i * coefficientStride];
+                const float hi = h[i * coefficientStride];
+
+                float x[kernelLanes] = {};
+                for (int lane = 0; lane < count; ++lane)
+                    x[lane] = channels[first + lane][i];
+
+                for (int lane = 0; lane < kernelLanes; ++lane)
+                {
+                    const float yHP = hi * (x[lane] - s1[lane] * (gi + R2) - s2[lane]);
+                    const float yBP = yHP * gi + s1[lane];
+                    s1[lane] = yHP * gi + yBP;
+                    const float yLP = yBP * gi + s2[lane];
+                    s2[lane] = yBP * gi + yLP;
+                    x[lane] = yLP;
+                }
+
+                for (int lane = 0; lane < count; ++lane)
+                    channels[first + lane][i] = x[lane];
+            }
+
+            for (int lane = 0; lane < count; ++lane)
+            {
+                states[(first + lane) * 2] = s1[lane];
+                states[(first + lane) * 2 + 1] = s2[lane];
+            }
+        }
+    }
+
+    DspKernels makeKernels()
+    {
+        DspKernels kernels;
+        kernels.instructionSet = kernelInstructionSet;
+        kernels.measure = measure;
+        kernels.copyWithGain = copyWithGain;
+        kernels.addWithGain = addWithGain;
+        kernels.mixWithGains = mixWithGains;
+        kernels.stateVariableLowpass = stateVariableLowpass;
+        return kernels;
+    }
+}
@@ -0,0 +1,75 @@
+#include "LevelMeterSource.h"
+
+void LevelMeterSource::prepare(double sampleRate)
+{
+    windowSamples = juce::jmax(1, static_cast<int>(sampleRate * 0.05));
+    kernels = &DspKernels::getBest();
+    reset();
+}
+
+void LevelMeterSource::reset()
+{
+    for (auto& channel : channels)
+    {
+        channel.peak.store(0.0f);
+        channel.rms.store(0.0f);
+        channel.sumSquares = 0.0;
+    }
+
+    accumulatedSamples = 0;
+}
+
+void LevelMeterSource::measureBlock(const juce::AudioBuffer<float>& buffer)
+{
+    const int channelCount = juce::jmin(maxChannels, buffer.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+    numChannels.store(channelCount, std::memory_order_relaxed);
+
+    for (int ch = 0; ch < channelCount; ++ch)
+    {
+        auto& channel = channels[static_cast<size_t>(ch)];
+
+        // 1パスで絶対値の最大と二乗和を求める
+        float blockPeak = 0.0f;
+        float blockSum = 0.0f;
+        kernels->measure(buffer.getReadPointer(ch), numSamples, &blockPeak, &blockSum);
+        channel.sumSquares += static_cast<double>(blockSum);
+
+        // GUIが読み出してリセットするまでの最大値を保持する
+        auto current = channel.peak.load(std::memory_order_relaxed);
+        while (blockPeak > current
+               && !channel.peak.compare_exchange_weak(current, blockPeak, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    accumulatedSamples += numSamples;
+
+    if (accumulatedSamples >= windowSamples)
+    {
+        for (int ch = 0; ch < channelCount; ++ch)
+        {
+            auto& channel = channels[static_cast<size_t>(ch)];
+            channel.rms.store(static_cast<float>(std::sqrt(channel.sumSquares / accumulatedSamples)), std::memory_order_relaxed);
+            channel.sumSquares = 0.0;
+        }
+
+        accumulatedSamples = 0;
+    }
+}
+
+float LevelMeterSource::getPeakAndReset(int channel)
+{
+    if (!juce::isPositiveAndBelow(channel, maxChannels))
+        return 0.0f;
+
+    return channels[static_cast<size_t>(channel)].peak.exchange(0.0f, std::memory_order_relaxed);
+}
+
+float LevelMeterSource::getRms(int channel) const
+{
+    if (!juce::isPositiveAndBelow(channel, maxChannels))
+        return 0.0f;
+
+    return channels[static_cast<size_t>(channel)].rms.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../kernels/DspKernels.h"
+#include <array>
+#include <atomic>
+
+/**
+ * オーディオスレッドからGUIへレベルを渡すメーターの計測側
+ * - measureBlock はオーディオスレッド専用。prepare で選んだ DspKernels で1パスのピーク/二乗和を計算する
+ * - 結果はチャンネルごとの atomic で公開し、ロックもバッファの共有もしない
+ * - ピークは前回GUIが読んでからの最大値、RMSは約50msの窓ごとに更新する
+ */
+class LevelMeterSource
+{
+public:
+    // プロセッサーが受け付ける最大のバス（7.1.4）のチャンネル数。それを超えるチャンネルは計測しない
+    static constexpr int maxChannels = 12;
+
+    LevelMeterSource() = default;
+
+    void prepare(double sampleRate);
+    void reset();
+
+    // ===== オーディオスレッド =====
+    void measureBlock(const juce::AudioBuffer<float>& buffer);
+
+    // ===== GUIスレッド =====
+    // 前回の呼び出し以降のピーク（リニア）を返してリセットする
+    float getPeakAndReset(int channel);
+    float getRms(int channel) const;
+    int getNumChannels() const { return numChannels.load(std::memory_order_relaxed); }
+
+private:
+    struct Channel
+    {
+        std::atomic<float> peak { 0.0f };
+        std::atomic<float> rms { 0.0f };
+        double sumSquares = 0.0;  // オーディオスレッド専用
+    };
+
+    std::array<Channel, maxChannels> channels;
+    std::atomic<int> numChannels { 0 };
+    int windowSamples = 2048;
+    int accumulatedSamples = 0;
+    const DspKernels* kernels = &DspKernels::getBaseline(); // prepare で CPU に合わせて選び直す
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeterSource)
+};
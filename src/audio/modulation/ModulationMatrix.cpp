@@ -0,0 +1,499 @@
+#include "ModulationMatrix.h"
+#include "../../EffectChain.h"
+#include "../SubBlockScheduler.h"
+#include <algorithm>
+
+ModulationMatrix::ModulationMatrix(EffectChain& chainToModulate)
+    : chain(chainToModulate)
+{
+    chain.addChangeListener(this);
+}
+
+ModulationMatrix::~ModulationMatrix()
+{
+    chain.removeChangeListener(this);
+}
+
+int ModulationMatrix::addModulator(const Modulator& modulator)
+{
+    if (getNumModulators() >= maxModulators)
+        return -1;
+
+    modulators.push_back(modulator);
+    publishTable();
+    return getNumModulators() - 1;
+}
+
+void ModulationMatrix::setModulator(int index, const Modulator& modulator)
+{
+    if (!juce::isPositiveAndBelow(index, getNumModulators()))
+        return;
+
+    modulators[static_cast<size_t>(index)] = modulator;
+    publishTable();
+}
+
+void ModulationMatrix::removeModulator(int index)
+{
+    if (!juce::isPositiveAndBelow(index, getNumModulators()))
+        return;
+
+    modulators.erase(modulators.begin() + index);
+    routes.erase(std::remove_if(routes.begin(), routes.end(), [index](const Route& route) { return route.modulator == index; }),
+                 routes.end());
+    for (auto& route : routes)
+        if (route.modulator > index)
+            --route.modulator;
+
+    publishTable();
+}
+
+bool ModulationMatrix::addRoute(const Route& route)
+{
+    if (!appendRoute(route))
+        return false;
+
+    publishTable();
+    return true;
+}
+
+bool ModulationMatrix::appendRoute(const Route& route)
+{
+    if (static_cast<int>(routes.size()) >= maxRoutes || !juce::isPositiveAndBelow(route.modulator, getNumModulators()))
+        return false;
+
+    if (route.instanceId == reverbTarget)
+    {
+        if (!juce::isPositiveAndBelow(route.parameterIndex, maxReverbParameters))
+            return false;
+    }
+    else
+    {
+        auto* effect = findChainEffect(route.instanceId);
+        if (effect == nullptr || !juce::isPositiveAndBelow(route.parameterIndex, effect->getNumParameters()))
+            return false;
+    }
+
+    for (const auto& existing : routes)
+        if (existing.modulator == route.modulator && existing.instanceId == route.instanceId
+            && existing.parameterIndex == route.parameterIndex)
+            return false;
+
+    auto added = route;
+    added.depth = juce::jlimit(-1.0f, 1.0f, route.depth);
+    routes.push_back(added);
+    return true;
+}
+
+bool ModulationMatrix::removeRoute(int modulator, juce::uint32 instanceId, int parameterIndex)
+{
+    auto it = std::find_if(routes.begin(), routes.end(), [&](const Route& route)
+    {
+        return route.modulator == modulator && route.instanceId == instanceId && route.parameterIndex == parameterIndex;
+    });
+    if (it == routes.end())
+        return false;
+
+    routes.erase(it);
+    publishTable();
+    return true;
+}
+
+void ModulationMatrix::clear()
+{
+    modulators.clear();
+    routes.clear();
+    publishTable();
+}
+
+void ModulationMatrix::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    // エフェクトの位置や値域が変わったかもしれないので作り直す
+    publishTable();
+}
+
+Effect* ModulationMatrix::findChainEffect(juce::uint32 instanceId, int* position) const
+{
+    for (int i = 0; i < chain.getNumEffects(); ++i)
+    {
+        auto* effect = chain.getEffect(i);
+        if (effect != nullptr && effect->getInstanceId() == instanceId)
+        {
+            if (position != nullptr)
+                *position = i;
+            return effect;
+        }
+    }
+    return nullptr;
+}
+
+void ModulationMatrix::publishTable()
+{
+    auto& table = tables[static_cast<size_t>(backTable)];
+    table.numModulators = getNumModulators();
+    std::copy(modulators.begin(), modulators.end(), table.modulators.begin());
+
+    table.instanceIds.clear();
+    table.parameterIndices.clear();
+    table.effectPositions.clear();
+    table.minimums.clear();
+    table.maximums.clear();
+    table.rampRows.clear();
+
+    // 同じ行き先へのルートは1行にまとめる（行は最初に現れた順）
+    int numRampRows = 0;
+    std::vector<int> routeRows(routes.size(), -1);
+    for (size_t r = 0; r < routes.size(); ++r)
+    {
+        const auto& route = routes[r];
+        int row = 0;
+        const int numRows = static_cast<int>(table.instanceIds.size());
+        while (row < numRows && !(table.instanceIds[static_cast<size_t>(row)] == route.instanceId
+                                  && table.parameterIndices[static_cast<size_t>(row)] == route.parameterIndex))
+            ++row;
+
+        if (row == numRows)
+        {
+            int position = -1;
+            float minimum = 0.0f;
+            float maximum = 1.0f;
+            bool perSample = false;
+
+            if (route.instanceId != reverbTarget)
+            {
+                auto* effect = findChainEffect(route.instanceId, &position);
+                if (effect == nullptr)
+                    continue;
+
+                const auto ranges = effect->getParameterRanges();
+                if (route.parameterIndex * 3 + 1 >= ranges.size())
+                    continue;
+
+                minimum = ranges[route.parameterIndex * 3];
+                maximum = ranges[route.parameterIndex * 3 + 1];
+                perSample = effect->supportsSampleModulation(route.parameterIndex);
+            }
+
+            table.instanceIds.push_back(route.instanceId);
+            table.parameterIndices.push_back(route.parameterIndex);
+            table.effectPositions.push_back(position);
+            table.minimums.push_back(minimum);
+            table.maximums.push_back(maximum);
+            table.rampRows.push_back(perSample ? numRampRows++ : -1);
+        }
+
+        routeRows[r] = row;
+    }
+
+    // 行ごとの要素数を数えてから詰める
+    const auto numTargets = table.instanceIds.size();
+    table.rowStarts.assign(numTargets + 1, 0);
+    for (int row : routeRows)
+        if (row >= 0)
+            ++table.rowStarts[static_cast<size_t>(row) + 1];
+    for (size_t t = 0; t < numTargets; ++t)
+        table.rowStarts[t + 1] += table.rowStarts[t];
+
+    table.columns.assign(static_cast<size_t>(table.rowStarts.back()), 0);
+    table.depths.assign(static_cast<size_t>(table.rowStarts.back()), 0.0f);
+    std::vector<int> cursors(table.rowStarts.begin(), table.rowStarts.end() - 1);
+    for (size_t r = 0; r < routes.size(); ++r)
+    {
+        if (routeRows[r] < 0)
+            continue;
+
+        const auto entry = static_cast<size_t>(cursors[static_cast<size_t>(routeRows[r])]++);
+        table.columns[entry] = routes[r].modulator;
+        table.depths[entry] = routes[r].depth;
+    }
+
+    table.offsets.assign(numTargets, 0.0f);
+    table.previousOffsets.assign(numTargets, 0.0f);
+    table.baseValues.assign(numTargets, 0.0f);
+    table.writtenValues.assign(numTargets, 0.0f);
+    table.hasBase.assign(numTargets, 0);
+    table.ramps.assign(static_cast<size_t>(numRampRows * SubBlockScheduler::maxSubBlockSize), 0.0f);
+    assignBaseSlots(table);
+
+    backTable = sharedTable.exchange(backTable | newTableFlag, std::memory_order_acq_rel) & tableIndexMask;
+}
+
+void ModulationMatrix::assignBaseSlots(Table& table)
+{
+    const auto numTargets = table.instanceIds.size();
+    table.baseSlots.assign(numTargets, -1);
+
+    auto isBlockRateTarget = [&table](size_t t)
+    {
+        return table.instanceIds[t] != reverbTarget && table.rampRows[t] < 0;
+    };
+
+    // 新しいテーブルにない行き先の枠を空ける
+    for (auto& slot : publishedBases)
+    {
+        const auto key = slot.key.load(std::memory_order_relaxed);
+        if (key == 0)
+            continue;
+
+        bool isStillTarget = false;
+        for (size_t t = 0; t < numTargets && !isStillTarget; ++t)
+            isStillTarget = isBlockRateTarget(t) && makeKey(table.instanceIds[t], table.parameterIndices[t]) == key;
+
+        if (!isStillTarget)
+        {
+            slot.isValid.store(false, std::memory_order_relaxed);
+            slot.key.store(0, std::memory_order_release);
+        }
+    }
+
+    // 残っている行き先は同じ枠を使い続け、新しい行き先には空いた枠を割り当てる（ルートは maxRoutes 本までなので足りる）
+    for (size_t t = 0; t < numTargets; ++t)
+    {
+        if (!isBlockRateTarget(t))
+            continue;
+
+        const auto key = makeKey(table.instanceIds[t], table.parameterIndices[t]);
+        int freeSlot = -1;
+        for (int i = 0; i < maxRoutes; ++i)
+        {
+            const auto slotKey = publishedBases[static_cast<size_t>(i)].key.load(std::memory_order_relaxed);
+            if (slotKey == key)
+            {
+                table.baseSlots[t] = i;
+                break;
+            }
+            if (slotKey == 0 && freeSlot < 0)
+                freeSlot = i;
+        }
+
+        if (table.baseSlots[t] < 0 && freeSlot >= 0)
+        {
+            auto& slot = publishedBases[static_cast<size_t>(freeSlot)];
+            slot.isValid.store(false, std::memory_order_relaxed);
+            slot.key.store(key, std::memory_order_release);
+            table.baseSlots[t] = freeSlot;
+        }
+    }
+}
+
+float ModulationMatrix::getBaseValue(const Effect& effect, int parameterIndex, float current) const
+{
+    const auto key = makeKey(effect.getInstanceId(), parameterIndex);
+    for (const auto& slot : publishedBases)
+    {
+        if (slot.key.load(std::memory_order_acquire) != key)
+            continue;
+
+        if (slot.isValid.load(std::memory_order_acquire) && slot.written.load(std::memory_order_relaxed) == current)
+            return slot.base.load(std::memory_order_relaxed);
+        break;
+    }
+    return current;
+}
+
+void ModulationMatrix::prepare(double sampleRate)
+{
+    bank.prepare(sampleRate);
+}
+
+void ModulationMatrix::process(Effect* const* effects, int numEffects, const juce::AudioBuffer<float>& input)
+{
+    if ((sharedTable.load(std::memory_order_relaxed) & newTableFlag) != 0)
+    {
+        // 外れたルートの行き先を基準値へ戻してから新しいテーブルへ切り替える
+        restoreBaseValues(tables[static_cast<size_t>(audioTable)], effects, numEffects);
+        audioTable = sharedTable.exchange(audioTable, std::memory_order_acq_rel) & tableIndexMask;
+
+        auto& table = tables[static_cast<size_t>(audioTable)];
+        bank.setModulators(table.modulators.data(), table.numModulators);
+        reverbOffsets.fill(0.0f);
+    }
+
+    auto& table = tables[static_cast<size_t>(audioTable)];
+    const int numTargets = static_cast<int>(table.instanceIds.size());
+    if (numTargets == 0)
+        return;
+
+    const int numSamples = input.getNumSamples();
+    bank.advance(input, numSamples);
+    const float* values = bank.getValues();
+
+    for (int t = 0; t < numTargets; ++t)
+    {
+        const auto target = static_cast<size_t>(t);
+
+        // 疎行列の行とモジュレーターの値の内積
+        float offset = 0.0f;
+        for (int k = table.rowStarts[target]; k < table.rowStarts[target + 1]; ++k)
+            offset += table.depths[static_cast<size_t>(k)] * values[table.columns[static_cast<size_t>(k)]];
+
+        const float previousOffset = table.previousOffsets[target];
+        table.offsets[target] = offset;
+        table.previousOffsets[target] = offset;
+
+        const int parameterIndex = table.parameterIndices[target];
+        if (table.instanceIds[target] == reverbTarget)
+        {
+            reverbOffsets[static_cast<size_t>(parameterIndex)] = offset;
+            continue;
+        }
+
+        auto* effect = findEffect(effects, numEffects, table.effectPositions[target], table.instanceIds[target]);
+        if (effect == nullptr)
+        {
+            table.hasBase[target] = 0;
+            continue;
+        }
+
+        if (table.rampRows[target] >= 0)
+        {
+            if (numSamples > SubBlockScheduler::maxSubBlockSize)
+                continue;
+
+            // 前のサブブロックの値から直線で動かす
+            float* ramp = table.ramps.data() + table.rampRows[target] * SubBlockScheduler::maxSubBlockSize;
+            const float step = (offset - previousOffset) / static_cast<float>(numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                ramp[i] = previousOffset + step * static_cast<float>(i + 1);
+
+            effect->setSampleModulation(parameterIndex, ramp);
+            continue;
+        }
+
+        const float current = effect->getParameter(parameterIndex);
+        if (table.hasBase[target] == 0 || current != table.writtenValues[target])
+        {
+            table.baseValues[target] = current;
+            table.hasBase[target] = 1;
+        }
+
+        const float minimum = table.minimums[target];
+        const float maximum = table.maximums[target];
+        const float value = juce::jlimit(minimum, maximum, table.baseValues[target] + offset * (maximum - minimum));
+        if (value != current)
+            effect->setParameter(parameterIndex, value);
+        table.writtenValues[target] = effect->getParameter(parameterIndex);
+
+        // メッセージスレッドの保存とスナップショット用に公開する（枠が別の行き先へ移っていれば書かない）
+        const int baseSlot = table.baseSlots[target];
+        if (baseSlot >= 0)
+        {
+            auto& published = publishedBases[static_cast<size_t>(baseSlot)];
+            if (published.key.load(std::memory_order_relaxed) == makeKey(table.instanceIds[target], parameterIndex))
+            {
+                published.base.store(table.baseValues[target], std::memory_order_relaxed);
+                published.written.store(table.writtenValues[target], std::memory_order_relaxed);
+                published.isValid.store(true, std::memory_order_release);
+            }
+        }
+    }
+}
+
+void ModulationMatrix::restoreBaseValues(Table& table, Effect* const* effects, int numEffects)
+{
+    for (size_t t = 0; t < table.instanceIds.size(); ++t)
+    {
+        auto* effect = findEffect(effects, numEffects, table.effectPositions[t], table.instanceIds[t]);
+        if (effect == nullptr)
+            continue;
+
+        // 処理されずに残っているランプは古いテーブルを指しているので外す
+        if (table.rampRows[t] >= 0)
+            effect->setSampleModulation(table.parameterIndices[t], nullptr);
+        else if (table.hasBase[t] != 0 && effect->getParameter(table.parameterIndices[t]) == table.writtenValues[t])
+            effect->setParameter(table.parameterIndices[t], table.baseValues[t]);
+    }
+}
+
+Effect* ModulationMatrix::findEffect(Effect* const* effects, int numEffects, int position, juce::uint32 instanceId)
+{
+    // 通常はコンパイル時と同じ位置にある。並べ替えられていればインスタンス識別子で探す
+    if (position >= 0 && position < numEffects && effects[position]->getInstanceId() == instanceId)
+        return effects[position];
+
+    for (int i = 0; i < numEffects; ++i)
+        if (effects[i]->getInstanceId() == instanceId)
+            return effects[i];
+
+    return nullptr;
+}
+
+float ModulationMatrix::getReverbOffset(int parameterIndex) const
+{
+    return juce::isPositiveAndBelow(parameterIndex, maxReverbParameters) ? reverbOffsets[static_cast<size_t>(parameterIndex)] : 0.0f;
+}
+
+void ModulationMatrix::saveToXml(juce::XmlElement& xml) const
+{
+    for (const auto& modulator : modulators)
+    {
+        auto* element = xml.createNewChildElement("Modulator");
+        element->setAttribute("Source", static_cast<int>(modulator.source));
+        element->setAttribute("Shape", static_cast<int>(modulator.shape));
+        element->setAttribute("Rate", modulator.rateHz);
+        element->setAttribute("Phase", modulator.phaseOffset);
+        element->setAttribute("Attack", modulator.attackMs);
+        element->setAttribute("Release", modulator.releaseMs);
+        element->setAttribute("NumSteps", modulator.numSteps);
+        for (int s = 0; s < modulator.numSteps && s < ModulatorBank::maxSteps; ++s)
+            element->setAttribute("Step" + juce::String(s), modulator.steps[static_cast<size_t>(s)]);
+    }
+
+    for (const auto& route : routes)
+    {
+        int position = -1;
+        if (route.instanceId != reverbTarget && findChainEffect(route.instanceId, &position) == nullptr)
+            continue;
+
+        auto* element = xml.createNewChildElement("Route");
+        element->setAttribute("Modulator", route.modulator);
+        element->setAttribute("Effect", position);
+        element->setAttribute("Parameter", route.parameterIndex);
+        element->setAttribute("Depth", route.depth);
+    }
+}
+
+void ModulationMatrix::loadFromXml(const juce::XmlElement& xml)
+{
+    modulators.clear();
+    routes.clear();
+
+    forEachXmlChildElementWithTagName(xml, element, "Modulator")
+    {
+        if (getNumModulators() >= maxModulators)
+            break;
+
+        Modulator modulator;
+        modulator.source = static_cast<ModulatorBank::Source>(juce::jlimit(0, 2, element->getIntAttribute("Source", 0)));
+        modulator.shape = static_cast<ModulatorBank::Shape>(juce::jlimit(0, 3, element->getIntAttribute("Shape", 0)));
+        modulator.rateHz = static_cast<float>(element->getDoubleAttribute("Rate", modulator.rateHz));
+        modulator.phaseOffset = static_cast<float>(element->getDoubleAttribute("Phase", modulator.phaseOffset));
+        modulator.attackMs = static_cast<float>(element->getDoubleAttribute("Attack", modulator.attackMs));
+        modulator.releaseMs = static_cast<float>(element->getDoubleAttribute("Release", modulator.releaseMs));
+        modulator.numSteps = juce::jlimit(1, ModulatorBank::maxSteps, element->getIntAttribute("NumSteps", modulator.numSteps));
+        for (int s = 0; s < modulator.numSteps; ++s)
+            modulator.steps[static_cast<size_t>(s)] = static_cast<float>(element->getDoubleAttribute("Step" + juce::String(s), 0.0));
+        modulators.push_back(modulator);
+    }
+
+    forEachXmlChildElementWithTagName(xml, element, "Route")
+    {
+        Route route;
+        route.modulator = element->getIntAttribute("Modulator", -1);
+        route.parameterIndex = element->getIntAttribute("Parameter", 0);
+        route.depth = static_cast<float>(element->getDoubleAttribute("Depth", 0.0));
+
+        const int position = element->getIntAttribute("Effect", -1);
+        if (position >= 0)
+        {
+            auto* effect = chain.getEffect(position);
+            if (effect == nullptr)
+                continue;
+            route.instanceId = effect->getInstanceId();
+        }
+
+        appendRoute(route);
+    }
+
+    publishTable();
+}
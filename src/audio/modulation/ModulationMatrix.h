@@ -0,0 +1,159 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "ModulatorBank.h"
+#include "../effects/Effect.h"
+#include <array>
+#include <atomic>
+#include <vector>
+
+class EffectChain;
+
+/**
+ * モジュレーションマトリクス（ModulatorBank の値でチェーン内エフェクトとリバーブのパラメータを動かす）
+ * - ルートは (モジュレーター, 行き先, 深さ)。行き先はエフェクトの instanceId とパラメータの添字で、
+ *   instanceId が reverbTarget ならリバーブのパラメータ（ReverbParameters の添字）
+ * - 編集のたびにメッセージスレッドで行き先ごとの疎行列（行 = 行き先、列 = モジュレーター）へコンパイルし、
+ *   モジュレーターの設定と一緒にトリプルバッファでオーディオスレッドへ渡す。オーディオスレッドは行ごとに足し合わせるだけ
+ * - 深さとオフセットは値域に対する割合（-1〜1）
+ *   - サンプル単位の変調を受け付けるパラメータ（Effect::supportsSampleModulation）には、前のサブブロックの値からの
+ *     サンプルごとのランプを渡す。値への写し方（カットオフならオクターブ）はエフェクトに任せる
+ *   - それ以外はサブブロックにつき1回、基準値 + オフセット を setParameter で書く。最後に書いた値を覚えておき、
+ *     読み返した値が違えばオートメーションなどで基準値が変わったとみなす。ルートが外れたら基準値へ戻す
+ *   - リバーブはプロセッサーが getReverbOffset をホストの値に足してから渡す（APVTS の値は書き換えない）
+ *   - 基準値と最後に書いた値は行き先ごとに公開する。EffectChain は保存と編集履歴のスナップショットで getBaseValue を
+ *     通し、変調中の値ではなく基準値を記録する
+ * - チェーンの構造が変わるとコンパイルし直す。存在しないエフェクトへのルートは残すが処理しない（履歴の復元で戻ってくる）
+ */
+class ModulationMatrix : private juce::ChangeListener
+{
+public:
+    using Modulator = ModulatorBank::Settings;
+    static constexpr int maxModulators = ModulatorBank::maxModulators;
+    static constexpr int maxRoutes = 128;
+    static constexpr int maxReverbParameters = 16;
+
+    // チェーンのインスタンス識別子は 1 から振られるので 0 をリバーブに使う
+    static constexpr juce::uint32 reverbTarget = 0;
+
+    struct Route
+    {
+        int modulator = 0;
+        juce::uint32 instanceId = reverbTarget;
+        int parameterIndex = 0;
+        float depth = 0.0f; // -1〜1（値域に対する割合）
+    };
+
+    explicit ModulationMatrix(EffectChain& chainToModulate);
+    ~ModulationMatrix() override;
+
+    // ===== メッセージスレッド =====
+    // 追加したモジュレーターの添字。いっぱいなら -1
+    int addModulator(const Modulator& modulator);
+    void setModulator(int index, const Modulator& modulator);
+
+    // そのモジュレーターのルートも外し、後ろのモジュレーターの添字を詰める
+    void removeModulator(int index);
+
+    int getNumModulators() const { return static_cast<int>(modulators.size()); }
+    const Modulator& getModulator(int index) const { return modulators[static_cast<size_t>(index)]; }
+
+    // モジュレーターや行き先が存在しない、同じ (モジュレーター, 行き先) が既にある、maxRoutes を超える場合は false
+    bool addRoute(const Route& route);
+    bool removeRoute(int modulator, juce::uint32 instanceId, int parameterIndex);
+    const std::vector<Route>& getRoutes() const { return routes; }
+
+    void clear();
+
+    // ルートの行き先はエフェクトの並び順の添字で保存する（-1 はリバーブ）。読み込みはチェーンを読み込んだ後に行う
+    void saveToXml(juce::XmlElement& xml) const;
+    void loadFromXml(const juce::XmlElement& xml);
+
+    // ブロック単位で変調している行き先なら基準値を、そうでなければ current（エフェクトの現在値）を返す。
+    // current が最後に書いた値と違えば、基準値はまだ current に追従していないだけなので current を返す
+    float getBaseValue(const Effect& effect, int parameterIndex, float current) const;
+
+    // ===== オーディオスレッド =====
+    void prepare(double sampleRate);
+
+    // モジュレーターを進め、処理順序のエフェクトへオフセットを反映する（EffectChain::process から呼ばれる）。
+    // input はサブブロックのチェーンの入力で、エンベロープフォロワーのキーになる
+    void process(Effect* const* effects, int numEffects, const juce::AudioBuffer<float>& input);
+
+    // 直前のサブブロックでリバーブのパラメータに足す値（値域に対する割合）
+    float getReverbOffset(int parameterIndex) const;
+
+private:
+    // コンパイル済みの疎行列。行き先ごとの配列はすべて同じ長さ
+    struct Table
+    {
+        std::array<Modulator, maxModulators> modulators {};
+        int numModulators = 0;
+
+        std::vector<juce::uint32> instanceIds;
+        std::vector<int> parameterIndices;
+        std::vector<int> effectPositions; // 位置のヒント（リバーブは -1）
+        std::vector<float> minimums;
+        std::vector<float> maximums;
+        std::vector<int> rampRows;        // サンプル単位の行き先ならランプの行、そうでなければ -1
+        std::vector<int> baseSlots;       // ブロック単位のチェーンの行き先なら publishedBases の添字、そうでなければ -1
+
+        // 行 t の要素は rowStarts[t] から rowStarts[t + 1] の手前まで
+        std::vector<int> rowStarts;
+        std::vector<int> columns;         // モジュレーターの添字
+        std::vector<float> depths;
+
+        // オーディオスレッドの作業領域
+        std::vector<float> offsets;
+        std::vector<float> previousOffsets;
+        std::vector<float> baseValues;
+        std::vector<float> writtenValues;
+        std::vector<char> hasBase;
+        std::vector<float> ramps;         // サンプル単位の行き先 × maxSubBlockSize
+    };
+
+    // オーディオスレッドからメッセージスレッドへ公開する、ブロック単位の行き先の基準値
+    struct PublishedBase
+    {
+        std::atomic<juce::uint64> key { 0 }; // makeKey の値。0 は空き（チェーンの instanceId は 1 から）
+        std::atomic<float> base { 0.0f };
+        std::atomic<float> written { 0.0f };
+        std::atomic<bool> isValid { false };
+    };
+
+    static juce::uint64 makeKey(juce::uint32 instanceId, int parameterIndex)
+    {
+        return (static_cast<juce::uint64>(instanceId) << 32) | static_cast<juce::uint32>(parameterIndex);
+    }
+
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+    void assignBaseSlots(Table& table);
+    bool appendRoute(const Route& route); // 検証して追加するだけ（公開しない）
+    void publishTable();
+    Effect* findChainEffect(juce::uint32 instanceId, int* position = nullptr) const;
+    static Effect* findEffect(Effect* const* effects, int numEffects, int position, juce::uint32 instanceId);
+    void restoreBaseValues(Table& table, Effect* const* effects, int numEffects);
+
+    EffectChain& chain;
+
+    // メッセージスレッド専用
+    std::vector<Modulator> modulators;
+    std::vector<Route> routes;
+
+    // トリプルバッファ: sharedTable の下位ビットが添字、newTableFlag が未取得のテーブルがあることを示す
+    static constexpr int newTableFlag = 4;
+    static constexpr int tableIndexMask = 3;
+    std::array<Table, 3> tables;
+    std::atomic<int> sharedTable { 1 };
+    int audioTable = 0;  // オーディオスレッド専用
+    int backTable = 2;   // メッセージスレッド専用
+
+    // キーはメッセージスレッドが割り当て、値はオーディオスレッドが書く
+    std::array<PublishedBase, maxRoutes> publishedBases;
+
+    // オーディオスレッド専用
+    ModulatorBank bank;
+    std::array<float, maxReverbParameters> reverbOffsets {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationMatrix)
+};
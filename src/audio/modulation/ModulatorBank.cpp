@@ -0,0 +1,143 @@
+#include "ModulatorBank.h"
+
+void ModulatorBank::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    updateIncrements();
+    coefficientLength = 0;
+    reset();
+}
+
+void ModulatorBank::reset()
+{
+    phases.fill(Vector::expand(0.0f));
+    envelopes.fill(Vector::expand(0.0f));
+    values.fill(0.0f);
+    previousValues.fill(0.0f);
+}
+
+void ModulatorBank::setModulators(const Settings* settings, int newNumModulators)
+{
+    numModulators = juce::jlimit(0, maxModulators, newNumModulators);
+    numActiveGroups = (numModulators + lanes - 1) / lanes;
+    numSequencers = 0;
+
+    for (int m = 0; m < maxModulators; ++m)
+    {
+        const auto group = static_cast<size_t>(m / lanes);
+        const auto lane = static_cast<size_t>(m % lanes);
+        const auto index = static_cast<size_t>(m);
+        const bool active = m < numModulators;
+        const Settings current = active ? settings[m] : Settings {};
+
+        // 使わないレーンと、そのモジュレーターの種類で使わない波形の重みは 0
+        const bool isLfo = active && current.source == Source::lfo;
+        sineWeights[group].set(lane, isLfo && current.shape == Shape::sine ? 1.0f : 0.0f);
+        triangleWeights[group].set(lane, isLfo && current.shape == Shape::triangle ? 1.0f : 0.0f);
+        sawWeights[group].set(lane, isLfo && current.shape == Shape::saw ? 1.0f : 0.0f);
+        squareWeights[group].set(lane, isLfo && current.shape == Shape::square ? 1.0f : 0.0f);
+        envelopeWeights[group].set(lane, active && current.source == Source::envelope ? 1.0f : 0.0f);
+        phaseOffsets[group].set(lane, juce::jlimit(0.0f, 1.0f, current.phaseOffset));
+
+        rates[index] = active && current.source != Source::envelope ? juce::jmax(0.0f, current.rateHz) : 0.0f;
+        attackTimes[index] = juce::jmax(0.1f, current.attackMs);
+        releaseTimes[index] = juce::jmax(0.1f, current.releaseMs);
+
+        if (active && current.source == Source::stepSequencer)
+        {
+            sequencers[static_cast<size_t>(numSequencers++)] = m;
+            stepCounts[index] = juce::jlimit(1, maxSteps, current.numSteps);
+            stepValues[index] = current.steps;
+        }
+    }
+
+    updateIncrements();
+    coefficientLength = 0;
+}
+
+void ModulatorBank::updateIncrements()
+{
+    const float inverseRate = 1.0f / static_cast<float>(sampleRate);
+    for (int m = 0; m < maxModulators; ++m)
+        increments[static_cast<size_t>(m / lanes)].set(static_cast<size_t>(m % lanes), rates[static_cast<size_t>(m)] * inverseRate);
+}
+
+void ModulatorBank::updateEnvelopeCoefficients(int numSamples)
+{
+    // coeff^n = exp(-n / (time * fs))
+    const float samplesPerMs = static_cast<float>(sampleRate) * 0.001f;
+    for (int m = 0; m < maxModulators; ++m)
+    {
+        const auto group = static_cast<size_t>(m / lanes);
+        const auto lane = static_cast<size_t>(m % lanes);
+        const auto index = static_cast<size_t>(m);
+        attackCoefficients[group].set(lane, std::exp(-static_cast<float>(numSamples) / (attackTimes[index] * samplesPerMs)));
+        releaseCoefficients[group].set(lane, std::exp(-static_cast<float>(numSamples) / (releaseTimes[index] * samplesPerMs)));
+    }
+    coefficientLength = numSamples;
+}
+
+void ModulatorBank::advance(const juce::AudioBuffer<float>& key, int numSamples)
+{
+    previousValues = values;
+    if (numSamples <= 0 || numModulators == 0)
+        return;
+
+    if (numSamples != coefficientLength)
+        updateEnvelopeCoefficients(numSamples);
+
+    float peak = 0.0f;
+    for (int ch = 0; ch < key.getNumChannels(); ++ch)
+        peak = juce::jmax(peak, key.getMagnitude(ch, 0, juce::jmin(numSamples, key.getNumSamples())));
+
+    const Vector zero = Vector::expand(0.0f);
+    const Vector one = Vector::expand(1.0f);
+    const Vector half = Vector::expand(0.5f);
+    const Vector steep = Vector::expand(1.0e6f); // 比較の代わりに傾きの大きい直線をクリップする
+    const Vector length = Vector::expand(static_cast<float>(numSamples));
+    const Vector keyPeak = Vector::expand(peak);
+
+    for (int g = 0; g < numActiveGroups; ++g)
+    {
+        const auto group = static_cast<size_t>(g);
+
+        Vector phase = phases[group] + increments[group] * length;
+        phase = phase - Vector::truncate(phase);
+        phases[group] = phase;
+
+        Vector q = phase + phaseOffsets[group];
+        q = q - Vector::truncate(q);
+
+        const Vector saw = q * 2.0f + (-1.0f);
+        const Vector triangle = one - Vector::abs(q - half) * 4.0f;
+        const Vector square = Vector::min(Vector::max((half - q) * steep, zero - one), one);
+
+        // sin(2πq) = -sin(πu)（u = 2q - 1）。放物線近似に 1 回補正をかける
+        const Vector u = saw;
+        Vector y = u * (one - Vector::abs(u)) * 4.0f;
+        y = (y * Vector::abs(y) - y) * 0.225f + y;
+        const Vector sine = zero - y;
+
+        // 上がるときはアタック、下がるときはリリース（rising は 0 か 1）
+        const Vector envelope = envelopes[group];
+        const Vector rising = Vector::min(Vector::max((keyPeak - envelope) * steep, zero), one);
+        const Vector coefficient = releaseCoefficients[group] + (attackCoefficients[group] - releaseCoefficients[group]) * rising;
+        envelopes[group] = keyPeak + (envelope - keyPeak) * coefficient;
+
+        const Vector output = sine * sineWeights[group] + triangle * triangleWeights[group] + saw * sawWeights[group]
+                            + square * squareWeights[group] + envelopes[group] * envelopeWeights[group];
+        output.copyToRawArray(values.data() + g * lanes);
+    }
+
+    for (int s = 0; s < numSequencers; ++s)
+    {
+        const int m = sequencers[static_cast<size_t>(s)];
+        const auto index = static_cast<size_t>(m);
+        float q = phases[static_cast<size_t>(m / lanes)].get(static_cast<size_t>(m % lanes))
+                + phaseOffsets[static_cast<size_t>(m / lanes)].get(static_cast<size_t>(m % lanes));
+        q -= std::floor(q);
+
+        const int step = juce::jmin(stepCounts[index] - 1, static_cast<int>(q * static_cast<float>(stepCounts[index])));
+        values[index] = stepValues[index][static_cast<size_t>(step)];
+    }
+}
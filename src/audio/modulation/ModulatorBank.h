@@ -0,0 +1,112 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+
+/**
+ * モジュレーションの発生源（LFO / エンベロープフォロワー / ステップシーケンサー）を構造体配列で持つバンク
+ * - フィールドごとに SIMD レジスタの配列を持ち、グループ m / lanes のレーン m % lanes がモジュレーター m。
+ *   サブブロックごとに全員をまとめて進め、サブブロック末尾の値だけを求める（サンプル単位の補間は受け取る側が行う）
+ * - 波形や種類で分岐せず、すべての波形とエンベロープを計算して 0/1 の重みで足し合わせる。位相は LFO とシーケンサーで共通
+ * - エンベロープフォロワーのキーは advance に渡すバッファ。ピークはブロックにつき1回求め、
+ *   アタック/リリースの1次フィルターの係数はブロック長のぶん累乗したものを使う（ブロック長が変わったときだけ計算し直す）
+ * - ステップの値を引くところだけはレーンごとの表引きなので、シーケンサーのモジュレーターだけをスカラーで回す
+ */
+class ModulatorBank
+{
+public:
+    using Vector = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanes = static_cast<int>(Vector::SIMDNumElements);
+    static constexpr int maxModulators = 32;
+    static constexpr int numGroups = maxModulators / lanes;
+    static constexpr int maxSteps = 16;
+
+    enum class Source
+    {
+        lfo = 0,
+        envelope,
+        stepSequencer
+    };
+
+    enum class Shape
+    {
+        sine = 0,
+        triangle,
+        saw,
+        square
+    };
+
+    // 1つのモジュレーターの設定（LFO とシーケンサーは -1〜1、エンベロープは 0〜1 を出す）
+    struct Settings
+    {
+        Source source = Source::lfo;
+        Shape shape = Shape::sine;
+        float rateHz = 1.0f;                  // LFO の周波数 / シーケンサーが1周する速さ
+        float phaseOffset = 0.0f;             // 0〜1
+        float attackMs = 10.0f;               // エンベロープフォロワー
+        float releaseMs = 200.0f;
+        int numSteps = 8;                     // ステップシーケンサー
+        std::array<float, maxSteps> steps {}; // -1〜1
+    };
+
+    static_assert(maxModulators % lanes == 0, "maxModulators must fill whole SIMD groups");
+
+    ModulatorBank() = default;
+
+    void prepare(double newSampleRate);
+
+    // 位相とエンベロープを 0 に戻す
+    void reset();
+
+    // 設定をレーンへ展開する（位相とエンベロープは引き継ぐ）。確保しないのでオーディオスレッドから呼べる
+    void setModulators(const Settings* settings, int newNumModulators);
+
+    // numSamples 進め、key のピークでエンベロープフォロワーを更新する
+    void advance(const juce::AudioBuffer<float>& key, int numSamples);
+
+    // 直前の advance の終わりと始まりの値
+    const float* getValues() const { return values.data(); }
+    const float* getPreviousValues() const { return previousValues.data(); }
+    int getNumModulators() const { return numModulators; }
+
+private:
+    void updateIncrements();
+    void updateEnvelopeCoefficients(int numSamples);
+
+    double sampleRate = 44100.0;
+    int numModulators = 0;
+    int numActiveGroups = 0;
+
+    // 設定（レーンごと）
+    std::array<Vector, numGroups> phaseOffsets {};
+    std::array<Vector, numGroups> sineWeights {};
+    std::array<Vector, numGroups> triangleWeights {};
+    std::array<Vector, numGroups> sawWeights {};
+    std::array<Vector, numGroups> squareWeights {};
+    std::array<Vector, numGroups> envelopeWeights {};
+    std::array<float, maxModulators> rates {};
+    std::array<float, maxModulators> attackTimes {};  // ms
+    std::array<float, maxModulators> releaseTimes {}; // ms
+
+    // サンプルレートとブロック長から求める値
+    std::array<Vector, numGroups> increments {};
+    std::array<Vector, numGroups> attackCoefficients {};
+    std::array<Vector, numGroups> releaseCoefficients {};
+    int coefficientLength = 0; // 係数を求めたブロック長（0 なら未計算）
+
+    // 状態
+    std::array<Vector, numGroups> phases {};
+    std::array<Vector, numGroups> envelopes {};
+
+    // ステップシーケンサー（スカラー）
+    std::array<int, maxModulators> sequencers {};
+    int numSequencers = 0;
+    std::array<int, maxModulators> stepCounts {};
+    std::array<std::array<float, maxSteps>, maxModulators> stepValues {};
+
+    alignas(64) std::array<float, maxModulators> values {};
+    alignas(64) std::array<float, maxModulators> previousValues {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulatorBank)
+};
@@ -0,0 +1,37 @@
+#include "PadSample.h"
+
+PadSample::Ptr PadSample::loadFromFile(juce::AudioFormatManager& formatManager, const juce::File& file, int headFrames)
+{
+    return createFromReader(std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file)), file, headFrames);
+}
+
+PadSample::Ptr PadSample::createFromReader(std::unique_ptr<juce::AudioFormatReader> reader, const juce::File& file, int headFrames)
+{
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    Ptr sample(new PadSample());
+    sample->file = file;
+    sample->lengthInFrames = reader->lengthInSamples;
+    sample->sampleRate = reader->sampleRate;
+
+    const bool fitsInMemory = reader->lengthInSamples <= static_cast<juce::int64>(headFrames) * 2;
+    const int framesToLoad = fitsInMemory ? static_cast<int>(reader->lengthInSamples) : headFrames;
+
+    // モノラルは両チャンネルに複製される
+    sample->head.setSize(2, framesToLoad);
+    reader->read(&sample->head, 0, framesToLoad, 0, true, true);
+
+    if (!fitsInMemory)
+        sample->reader = std::move(reader);
+
+    return sample;
+}
+
+void PadSample::readFrames(juce::AudioBuffer<float>& dest, int destStartFrame, int numFrames, juce::int64 sourceStartFrame)
+{
+    if (reader != nullptr)
+        reader->read(&dest, destStartFrame, numFrames, sourceStartFrame, true, true);
+    else
+        dest.clear(destStartFrame, numFrames);
+}
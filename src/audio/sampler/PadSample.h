@@ -0,0 +1,42 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+/**
+ * パッドに割り当てられたサンプル
+ * - 先頭部分（ヘッド）は常にメモリに置き、トリガー直後から遅延なく再生できる
+ * - ヘッドより長いサンプルの残りは SampleStreamer がディスクから読み込む
+ * - オーディオスレッドで解放されないよう、SamplerEngine がメッセージスレッド側で参照を保持する
+ */
+class PadSample : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<PadSample>;
+
+    // ヘッドの2倍以下の長さなら全体をメモリに読み込み、ストリーミングしない
+    static Ptr loadFromFile(juce::AudioFormatManager& formatManager, const juce::File& file, int headFrames);
+
+    // 変換済みキャッシュなど、任意のリーダーから作る。file には元のサンプルファイルを渡す
+    static Ptr createFromReader(std::unique_ptr<juce::AudioFormatReader> reader, const juce::File& file, int headFrames);
+
+    const juce::AudioBuffer<float>& getHead() const { return head; }
+    int getHeadLength() const { return head.getNumSamples(); }
+    juce::int64 getLengthInFrames() const { return lengthInFrames; }
+    double getSampleRate() const { return sampleRate; }
+    bool needsStreaming() const { return lengthInFrames > head.getNumSamples(); }
+    const juce::File& getFile() const { return file; }
+
+    // ストリーミングスレッド専用（リーダーはスレッドセーフではない）
+    void readFrames(juce::AudioBuffer<float>& dest, int destStartFrame, int numFrames, juce::int64 sourceStartFrame);
+
+private:
+    PadSample() = default;
+
+    juce::File file;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::AudioBuffer<float> head;
+    juce::int64 lengthInFrames = 0;
+    double sampleRate = 44100.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PadSample)
+};
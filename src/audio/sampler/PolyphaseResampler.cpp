@@ -0,0 +1,129 @@
+#include "PolyphaseResampler.h"
+#include <numeric>
+
+namespace
+{
+    // 0次第1種変形ベッセル関数（カイザー窓用）
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x * 0.5 / k) * (x * 0.5 / k);
+            sum += term;
+
+            if (term < sum * 1.0e-12)
+                break;
+        }
+
+        return sum;
+    }
+
+    // 阻止域の減衰 A [dB] ≈ β / 0.1102 + 8.7、必要なタップ数 ≈ (A - 8) / (2.285 Δω)
+    constexpr double kaiserBeta = 10.0;
+    constexpr double transitionWidth = 0.08; // 阻止域の端に対する比
+}
+
+PolyphaseResampler::PolyphaseResampler(double sourceRate, double targetRate)
+{
+    // 実用上のサンプルレートは整数なので、整数に丸めてから約分する
+    const auto source = juce::jmax<juce::int64>(1, static_cast<juce::int64>(std::llround(sourceRate)));
+    const auto target = juce::jmax<juce::int64>(1, static_cast<juce::int64>(std::llround(targetRate)));
+    const auto divisor = std::gcd(source, target);
+
+    upFactor = target / divisor;
+    downFactor = source / divisor;
+
+    if (isIdentity())
+        return;
+
+    numPhases = static_cast<int>(juce::jmin<juce::int64>(upFactor, maxPhases));
+
+    // 阻止域の端（入力ナイキストを 1 とした値）を低い方のナイキストに合わせ、遷移帯域の中央を -6dB のカットオフにする。
+    // baseHalfTaps は阻止域の端が 1 のときのタップ数で、遷移帯域が狭くなる分だけ増やす
+    const double stopbandEdge = juce::jmin(1.0, static_cast<double>(upFactor) / static_cast<double>(downFactor));
+    const double cutoff = stopbandEdge * (1.0 - 0.5 * transitionWidth);
+    halfTaps = static_cast<int>(std::ceil(baseHalfTaps / stopbandEdge));
+    numTaps = 2 * halfTaps;
+
+    coefficients.resize(static_cast<size_t>(numPhases) * static_cast<size_t>(numTaps));
+    const double windowNorm = besselI0(kaiserBeta);
+
+    for (int p = 0; p < numPhases; ++p)
+    {
+        auto* phase = coefficients.data() + static_cast<size_t>(p) * static_cast<size_t>(numTaps);
+        const double fraction = static_cast<double>(p) / numPhases;
+        double sum = 0.0;
+
+        for (int k = 0; k < numTaps; ++k)
+        {
+            // 入力サンプル (i - halfTaps + 1 + k) から出力時刻 (i + fraction) までの距離
+            const double tau = fraction + (halfTaps - 1 - k);
+            const double x = tau / halfTaps;
+
+            double value = 0.0;
+            if (std::abs(x) < 1.0)
+            {
+                const double arg = juce::MathConstants<double>::pi * cutoff * tau;
+                const double sinc = tau == 0.0 ? 1.0 : std::sin(arg) / arg;
+                value = cutoff * sinc * besselI0(kaiserBeta * std::sqrt(1.0 - x * x)) / windowNorm;
+            }
+
+            phase[k] = static_cast<float>(value);
+            sum += value;
+        }
+
+        // 位相ごとの直流ゲインを 1 に揃える
+        if (sum != 0.0)
+            for (int k = 0; k < numTaps; ++k)
+                phase[k] = static_cast<float>(phase[k] / sum);
+    }
+}
+
+juce::int64 PolyphaseResampler::getOutputLength(juce::int64 inputLength) const
+{
+    return (inputLength * upFactor + downFactor - 1) / downFactor;
+}
+
+void PolyphaseResampler::process(const float* input, juce::int64 numInput, float* output, juce::int64 numOutput) const
+{
+    if (isIdentity())
+    {
+        const auto count = juce::jmin(numInput, numOutput);
+        std::copy(input, input + count, output);
+        std::fill(output + count, output + numOutput, 0.0f);
+        return;
+    }
+
+    for (juce::int64 n = 0; n < numOutput; ++n)
+    {
+        // 出力 n の入力側の時刻は n * M / L
+        const auto position = n * downFactor;
+        const auto index = position / upFactor;
+        const auto phaseIndex = static_cast<int>(((position % upFactor) * numPhases) / upFactor);
+        const auto* phase = coefficients.data() + static_cast<size_t>(phaseIndex) * static_cast<size_t>(numTaps);
+
+        const auto first = index - halfTaps + 1;
+        const int kStart = static_cast<int>(juce::jmax<juce::int64>(0, -first));
+        const int kEnd = static_cast<int>(juce::jmin<juce::int64>(numTaps, numInput - first));
+
+        double sum = 0.0;
+        for (int k = kStart; k < kEnd; ++k)
+            sum += static_cast<double>(phase[k]) * input[first + k];
+
+        output[n] = static_cast<float>(sum);
+    }
+}
+
+juce::AudioBuffer<float> PolyphaseResampler::process(const juce::AudioBuffer<float>& input) const
+{
+    const auto numOutput = getOutputLength(input.getNumSamples());
+    juce::AudioBuffer<float> output(input.getNumChannels(), static_cast<int>(numOutput));
+
+    for (int ch = 0; ch < input.getNumChannels(); ++ch)
+        process(input.getReadPointer(ch), input.getNumSamples(), output.getWritePointer(ch), numOutput);
+
+    return output;
+}
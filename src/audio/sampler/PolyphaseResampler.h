@@ -0,0 +1,41 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+/**
+ * サンプルのインポート用オフライン・ポリフェーズリサンプラー
+ * - 変換比を L/M の有理数に約分し、カイザー窓付き sinc を L 位相のテーブルに展開する
+ * - L が maxPhases を超える場合は maxPhases 位相に量子化する（誤差は -90dB 程度）
+ * - 阻止域の端を入出力の低い方のナイキストに置き、遷移帯域はその 8%（44.1kHz 出力で通過域は約 20.3kHz まで）。
+ *   カイザー窓は阻止域 -100dB 程度で、遷移帯域の幅からタップ数を決める（ダウンサンプリングでは比に応じて増やす）
+ */
+class PolyphaseResampler
+{
+public:
+    static constexpr int baseHalfTaps = 80;
+    static constexpr int maxPhases = 4096;
+
+    PolyphaseResampler(double sourceRate, double targetRate);
+
+    bool isIdentity() const { return upFactor == downFactor; }
+    juce::int64 getOutputLength(juce::int64 inputLength) const;
+
+    // input 全体を変換して output に書き出す（output は getOutputLength の長さを持つこと）
+    void process(const float* input, juce::int64 numInput, float* output, juce::int64 numOutput) const;
+
+    // 全チャンネルを変換した新しいバッファを返す
+    juce::AudioBuffer<float> process(const juce::AudioBuffer<float>& input) const;
+
+private:
+    juce::int64 upFactor = 1;    // L
+    juce::int64 downFactor = 1;  // M
+    int numPhases = 1;
+    int halfTaps = baseHalfTaps;
+    int numTaps = 2 * baseHalfTaps;
+
+    // 位相 p の係数は coefficients[p * numTaps, (p + 1) * numTaps)
+    std::vector<float> coefficients;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolyphaseResampler)
+};
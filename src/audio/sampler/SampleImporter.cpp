@@ -0,0 +1,150 @@
+#include "SampleImporter.h"
+#include "../../presets/PresetManager.h"
+
+SampleImporter::SampleImporter(juce::AudioFormatManager& formatManagerToUse, int headFramesToUse)
+    : formatManager(formatManagerToUse),
+      headFrames(headFramesToUse),
+      pool(juce::jlimit(1, 4, juce::SystemStats::getNumCpus() - 1))
+{
+}
+
+SampleImporter::~SampleImporter()
+{
+    pool.removeAllJobs(true, 10000);
+}
+
+void SampleImporter::importFile(const juce::File& file, Callback onComplete)
+{
+    ++pendingImports;
+    const double sampleRate = getTargetSampleRate();
+
+    pool.addJob([this, file, sampleRate, onComplete = std::move(onComplete)]
+    {
+        auto sample = importNow(file, sampleRate);
+        --pendingImports;
+
+        juce::MessageManager::callAsync([onComplete, sample]
+        {
+            if (onComplete != nullptr)
+                onComplete(sample);
+        });
+    });
+}
+
+PadSample::Ptr SampleImporter::importNow(const juce::File& file, double sampleRate)
+{
+    if (!file.existsAsFile())
+        return nullptr;
+
+    const auto cacheFile = getCacheFile(hashFileContents(file), sampleRate);
+
+    // キャッシュがあればデコードせずにメモリマップで開く
+    if (cacheFile.existsAsFile())
+    {
+        if (auto sample = openCachedFile(cacheFile, file))
+            return sample;
+
+        // 壊れたキャッシュは作り直す
+        cacheFile.deleteFile();
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0
+        || reader->lengthInSamples > std::numeric_limits<int>::max())
+        return nullptr;
+
+    // パッドはステレオ再生なので、3チャンネル以上は先頭2チャンネルのみ使う
+    const int numChannels = juce::jlimit(1, 2, static_cast<int>(reader->numChannels));
+    const int numFrames = static_cast<int>(reader->lengthInSamples);
+
+    juce::AudioBuffer<float> decoded(numChannels, numFrames);
+    if (!reader->read(&decoded, 0, numFrames, 0, true, numChannels > 1))
+        return nullptr;
+
+    const PolyphaseResampler resampler(reader->sampleRate, sampleRate);
+    if (!resampler.isIdentity())
+        decoded = resampler.process(decoded);
+
+    if (!writeCacheFile(cacheFile, decoded, sampleRate))
+        return nullptr;
+
+    return openCachedFile(cacheFile, file);
+}
+
+juce::File SampleImporter::getCacheDirectory()
+{
+    return PresetManager::getRootDirectory().getChildFile("SampleCache");
+}
+
+juce::File SampleImporter::getCacheFile(juce::uint64 contentHash, double sampleRate)
+{
+    return getCacheDirectory()
+        .getChildFile(juce::String::toHexString(static_cast<juce::int64>(contentHash)).paddedLeft('0', 16)
+                      + "_" + juce::String(juce::roundToInt(sampleRate)) + ".wav");
+}
+
+juce::uint64 SampleImporter::hashFileContents(const juce::File& file)
+{
+    // 64bit FNV-1a。暗号学的な強度は不要で、デコードより十分速ければよい
+    juce::uint64 hash = 0xcbf29ce484222325ull;
+
+    juce::FileInputStream stream(file);
+    if (!stream.openedOk())
+        return hash;
+
+    juce::HeapBlock<juce::uint8> chunk(65536);
+
+    for (;;)
+    {
+        const int bytesRead = stream.read(chunk.get(), 65536);
+        if (bytesRead <= 0)
+            break;
+
+        for (int i = 0; i < bytesRead; ++i)
+        {
+            hash ^= chunk[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    return hash;
+}
+
+PadSample::Ptr SampleImporter::openCachedFile(const juce::File& cacheFile, const juce::File& sourceFile) const
+{
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader(wavFormat.createMemoryMappedReader(cacheFile));
+
+    if (reader == nullptr || !reader->mapEntireFile())
+        return nullptr;
+
+    return PadSample::createFromReader(std::move(reader), sourceFile, headFrames);
+}
+
+bool SampleImporter::writeCacheFile(const juce::File& cacheFile, const juce::AudioBuffer<float>& data, double sampleRate) const
+{
+    getCacheDirectory().createDirectory();
+
+    // 一時ファイルに書いてから置き換え、読み込み途中のキャッシュを他のジョブに見せない
+    juce::TemporaryFile tempFile(cacheFile);
+
+    {
+        std::unique_ptr<juce::FileOutputStream> stream(tempFile.getFile().createOutputStream());
+        if (stream == nullptr || !stream->openedOk())
+            return false;
+
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            wavFormat.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(data.getNumChannels()), 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // 以降はライターが所有する
+
+        if (!writer->writeFromAudioSampleBuffer(data, 0, data.getNumSamples()))
+            return false;
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
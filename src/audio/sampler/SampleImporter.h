@@ -0,0 +1,51 @@
+#pragma once
+
+#include "PadSample.h"
+#include "PolyphaseResampler.h"
+#include <functional>
+
+/**
+ * サンプルのバックグラウンド・インポート
+ * - ワーカースレッドプールで WAV/AIFF/FLAC をデコードし、セッションのサンプルレートへ変換する
+ * - 変換結果は SP404MKIIClone/SampleCache に 32bit float WAV として保存する
+ *   （ファイル名は内容ハッシュと変換先サンプルレート）
+ * - キャッシュはメモリマップで開くので、プロジェクトの再読み込み時はデコードも変換も行わない
+ * - 完了コールバックはメッセージスレッドで呼ばれる
+ */
+class SampleImporter
+{
+public:
+    using Callback = std::function<void(PadSample::Ptr)>;
+
+    SampleImporter(juce::AudioFormatManager& formatManagerToUse, int headFramesToUse);
+    ~SampleImporter();
+
+    void setTargetSampleRate(double newSampleRate) { targetSampleRate.store(newSampleRate); }
+    double getTargetSampleRate() const { return targetSampleRate.load(); }
+
+    // メッセージスレッドから呼ぶ。失敗した場合は nullptr がコールバックに渡る
+    void importFile(const juce::File& file, Callback onComplete);
+
+    // 呼び出したスレッドで同期的にインポートする（ワーカースレッド用）
+    PadSample::Ptr importNow(const juce::File& file, double sampleRate);
+
+    int getNumPendingImports() const { return pendingImports.load(); }
+
+    static juce::File getCacheDirectory();
+    static juce::File getCacheFile(juce::uint64 contentHash, double sampleRate);
+    static juce::uint64 hashFileContents(const juce::File& file);
+
+private:
+    PadSample::Ptr openCachedFile(const juce::File& cacheFile, const juce::File& sourceFile) const;
+    bool writeCacheFile(const juce::File& cacheFile, const juce::AudioBuffer<float>& data, double sampleRate) const;
+
+    juce::AudioFormatManager& formatManager;
+    const int headFrames;
+
+    std::atomic<double> targetSampleRate { 44100.0 };
+    std::atomic<int> pendingImports { 0 };
+
+    juce::ThreadPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleImporter)
+};
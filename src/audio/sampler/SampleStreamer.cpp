@@ -0,0 +1,154 @@
+#include "SampleStreamer.h"
+
+SampleStreamer::SampleStreamer()
+    : juce::Thread("Krump Sample Streamer")
+{
+    for (auto& slot : slots)
+        slot.ring.setSize(2, ringFrames);
+}
+
+SampleStreamer::~SampleStreamer()
+{
+    stop();
+}
+
+void SampleStreamer::start()
+{
+    if (!isThreadRunning())
+        startThread();
+}
+
+void SampleStreamer::stop()
+{
+    stopThread(2000);
+}
+
+int SampleStreamer::acquireSlot(PadSample* sample, juce::int64 startFrame)
+{
+    for (int i = 0; i < numSlots; ++i)
+    {
+        auto& slot = slots[static_cast<size_t>(i)];
+
+        // idle のスロットはオーディオスレッドしか取得しないので、ここでの書き込みは競合しない
+        if (slot.state.load(std::memory_order_acquire) == idle)
+        {
+            slot.sample = sample;
+            slot.startFrame = startFrame;
+            slot.state.store(requested, std::memory_order_release);
+            return i;
+        }
+    }
+    return -1;
+}
+
+int SampleStreamer::read(int slotIndex, juce::AudioBuffer<float>& dest, int destStartFrame, int numFrames)
+{
+    auto& slot = slots[static_cast<size_t>(slotIndex)];
+
+    if (slot.state.load(std::memory_order_acquire) != streaming)
+    {
+        ++underruns;
+        return 0;
+    }
+
+    const int available = juce::jmin(numFrames, slot.fifo.getNumReady());
+    if (available < numFrames)
+        ++underruns;
+
+    int start1, size1, start2, size2;
+    slot.fifo.prepareToRead(available, start1, size1, start2, size2);
+
+    for (int ch = 0; ch < juce::jmin(2, dest.getNumChannels()); ++ch)
+    {
+        if (size1 > 0)
+            dest.copyFrom(ch, destStartFrame, slot.ring, ch, start1, size1);
+        if (size2 > 0)
+            dest.copyFrom(ch, destStartFrame + size1, slot.ring, ch, start2, size2);
+    }
+
+    slot.fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
+
+void SampleStreamer::releaseSlot(int slotIndex)
+{
+    if (slotIndex >= 0 && slotIndex < numSlots)
+        slots[static_cast<size_t>(slotIndex)].state.store(releasing, std::memory_order_release);
+}
+
+void SampleStreamer::run()
+{
+    while (!threadShouldExit())
+    {
+        bool didWork = false;
+
+        for (int i = 0; i < numSlots; ++i)
+        {
+            auto& slot = slots[static_cast<size_t>(i)];
+
+            switch (slot.state.load(std::memory_order_acquire))
+            {
+                case requested:
+                {
+                    slot.fifo.reset();
+                    slot.nextFrame = slot.startFrame;
+                    didWork |= fillSlot(i);
+
+                    // 初期化中に返却された場合は releasing のまま残し、次の周回で後始末する
+                    int expected = requested;
+                    slot.state.compare_exchange_strong(expected, streaming, std::memory_order_acq_rel);
+                    break;
+                }
+
+                case streaming:
+                    didWork |= fillSlot(i);
+                    break;
+
+                case releasing:
+                    // 参照の解放はこのスレッドで行う（最後の参照はメッセージスレッド側が持っている）
+                    slot.sample = nullptr;
+                    slot.state.store(idle, std::memory_order_release);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if (!didWork)
+            wait(2);
+    }
+}
+
+bool SampleStreamer::fillSlot(int slotIndex)
+{
+    auto& slot = slots[static_cast<size_t>(slotIndex)];
+    if (slot.sample == nullptr)
+        return false;
+
+    bool didWork = false;
+    const auto length = slot.sample->getLengthInFrames();
+
+    while (slot.fifo.getFreeSpace() >= chunkFrames && slot.nextFrame < length && !threadShouldExit())
+    {
+        // 返却されたスロットは読み込みを打ち切る
+        if (slot.state.load(std::memory_order_acquire) == releasing)
+            break;
+
+        const int numFrames = static_cast<int>(juce::jmin(static_cast<juce::int64>(chunkFrames), length - slot.nextFrame));
+
+        int start1, size1, start2, size2;
+        slot.fifo.prepareToWrite(numFrames, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            slot.sample->readFrames(slot.ring, start1, size1, slot.nextFrame);
+        if (size2 > 0)
+            slot.sample->readFrames(slot.ring, start2, size2, slot.nextFrame + size1);
+
+        slot.fifo.finishedWrite(size1 + size2);
+        slot.nextFrame += size1 + size2;
+        didWork = true;
+    }
+
+    return didWork;
+}
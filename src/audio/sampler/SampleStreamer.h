@@ -0,0 +1,61 @@
+#pragma once
+
+#include "PadSample.h"
+#include <array>
+
+/**
+ * 長いサンプルをバックグラウンドスレッドでディスクから読み込むストリーマー
+ * - 固定数のスロットを持ち、各スロットは読み込みスレッド→オーディオスレッドの SPSC リングバッファ
+ * - オーディオスレッドはスロットの取得/読み出し/返却のみを行い、ロックもメモリ確保もしない
+ */
+class SampleStreamer : private juce::Thread
+{
+public:
+    static constexpr int numSlots = 16;
+    static constexpr int ringFrames = 32768;
+    static constexpr int chunkFrames = 4096;
+
+    SampleStreamer();
+    ~SampleStreamer() override;
+
+    void start();
+    void stop();
+
+    // ===== オーディオスレッドから呼ぶ =====
+    // sample の startFrame 以降のストリーミングを要求する。空きがなければ -1
+    int acquireSlot(PadSample* sample, juce::int64 startFrame);
+
+    // 準備済みのフレームを dest に書き出し、実際に読めたフレーム数を返す
+    int read(int slot, juce::AudioBuffer<float>& dest, int destStartFrame, int numFrames);
+
+    void releaseSlot(int slot);
+
+    int getNumUnderruns() const { return underruns.load(); }
+
+private:
+    void run() override;
+    bool fillSlot(int slotIndex);
+
+    enum SlotState
+    {
+        idle = 0,   // オーディオスレッドが取得可能
+        requested,  // オーディオスレッドが要求、読み込みスレッドの初期化待ち
+        streaming,  // 読み込み中、オーディオスレッドが読み出し可能
+        releasing   // オーディオスレッドが返却、読み込みスレッドの後始末待ち
+    };
+
+    struct Slot
+    {
+        std::atomic<int> state { idle };
+        PadSample::Ptr sample;          // idle の間だけオーディオスレッドが書き込む
+        juce::int64 startFrame = 0;
+        juce::int64 nextFrame = 0;      // 読み込みスレッド専用
+        juce::AbstractFifo fifo { ringFrames };
+        juce::AudioBuffer<float> ring;
+    };
+
+    std::array<Slot, numSlots> slots;
+    std::atomic<int> underruns { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleStreamer)
+};
@@ -0,0 +1,309 @@
+#include "SamplerEngine.h"
+
+SamplerEngine::SamplerEngine()
+{
+    formatManager.registerBasicFormats();
+    startTimer(1000);
+}
+
+SamplerEngine::~SamplerEngine()
+{
+    stopTimer();
+    streamer.stop();
+}
+
+void SamplerEngine::prepare(double sampleRate, int maximumBlockSize)
+{
+    // 既存のパッドはタイマーで新しいレートへ再インポートされる
+    importer.setTargetSampleRate(sampleRate);
+    voiceBuffer.setSize(2, juce::jmax(1, maximumBlockSize));
+
+    for (auto& voice : voices)
+        stopVoice(voice);
+
+    streamer.start();
+}
+
+void SamplerEngine::releaseResources()
+{
+    for (auto& voice : voices)
+        stopVoice(voice);
+}
+
+void SamplerEngine::process(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages)
+{
+    handlePendingTriggers();
+
+    // MIDIイベントの位置でブロックを区切り、サンプル単位で正確に発音する
+    int position = 0;
+    const int numSamples = buffer.getNumSamples();
+
+    for (const auto metadata : midiMessages)
+    {
+        const auto message = metadata.getMessage();
+        if (!message.isNoteOn())
+            continue;
+
+        const int padIndex = message.getNoteNumber() - firstPadNote;
+        if (padIndex < 0 || padIndex >= numPads)
+            continue;
+
+        const int eventPosition = juce::jlimit(position, numSamples, metadata.samplePosition);
+        renderVoices(buffer, position, eventPosition - position);
+        position = eventPosition;
+
+        startVoice(padIndex, message.getFloatVelocity());
+    }
+
+    renderVoices(buffer, position, numSamples - position);
+}
+
+void SamplerEngine::loadPad(int padIndex, const juce::File& file)
+{
+    if (padIndex < 0 || padIndex >= numPads)
+        return;
+
+    padFiles[static_cast<size_t>(padIndex)] = file;
+    requestedSampleRates[static_cast<size_t>(padIndex)] = importer.getTargetSampleRate();
+
+    importer.importFile(file, [safeThis = juce::WeakReference<SamplerEngine>(this), padIndex, file](PadSample::Ptr sample)
+    {
+        // 完了までに別のファイルが割り当てられていたら結果は捨てる
+        if (auto* engine = safeThis.get())
+            if (sample != nullptr && engine->padFiles[static_cast<size_t>(padIndex)] == file)
+                engine->setPadSample(padIndex, sample);
+    });
+}
+
+bool SamplerEngine::setPadSample(int padIndex, PadSample::Ptr sample)
+{
+    if (padIndex < 0 || padIndex >= numPads || sample == nullptr)
+        return false;
+
+    loadedSamples.addIfNotAlreadyThere(sample);
+
+    const juce::SpinLock::ScopedLockType lock(padLock);
+    pads[static_cast<size_t>(padIndex)] = sample;
+    return true;
+}
+
+void SamplerEngine::clearPad(int padIndex)
+{
+    if (padIndex < 0 || padIndex >= numPads)
+        return;
+
+    padFiles[static_cast<size_t>(padIndex)] = juce::File();
+
+    const juce::SpinLock::ScopedLockType lock(padLock);
+    pads[static_cast<size_t>(padIndex)] = nullptr;
+}
+
+PadSample::Ptr SamplerEngine::getPadSample(int padIndex) const
+{
+    if (padIndex < 0 || padIndex >= numPads)
+        return nullptr;
+
+    const juce::SpinLock::ScopedLockType lock(padLock);
+    return pads[static_cast<size_t>(padIndex)];
+}
+
+void SamplerEngine::triggerPad(int padIndex, float velocity)
+{
+    int start1, size1, start2, size2;
+    triggerFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        triggerQueue[static_cast<size_t>(start1)] = { padIndex, velocity };
+
+    triggerFifo.finishedWrite(size1);
+}
+
+void SamplerEngine::saveToXml(juce::XmlElement& xml) const
+{
+    auto* padsXml = xml.createNewChildElement("SamplerPads");
+    for (int i = 0; i < numPads; ++i)
+    {
+        const auto& file = padFiles[static_cast<size_t>(i)];
+        if (file != juce::File())
+        {
+            auto* padXml = padsXml->createNewChildElement("Pad");
+            padXml->setAttribute("Index", i);
+            padXml->setAttribute("File", file.getFullPathName());
+        }
+    }
+}
+
+void SamplerEngine::loadFromXml(const juce::XmlElement& xml)
+{
+    auto* padsXml = xml.getChildByName("SamplerPads");
+    if (padsXml == nullptr)
+        return;
+
+    for (int i = 0; i < numPads; ++i)
+        clearPad(i);
+
+    for (auto* padXml : padsXml->getChildWithTagNameIterator("Pad"))
+    {
+        const juce::File file(padXml->getStringAttribute("File"));
+        if (file.existsAsFile())
+            loadPad(padXml->getIntAttribute("Index", -1), file);
+    }
+}
+
+void SamplerEngine::timerCallback()
+{
+    // セッションのサンプルレートが変わったパッドを変換し直す
+    const double targetRate = importer.getTargetSampleRate();
+    for (int i = 0; i < numPads; ++i)
+        if (padFiles[static_cast<size_t>(i)] != juce::File() && requestedSampleRates[static_cast<size_t>(i)] != targetRate)
+            loadPad(i, padFiles[static_cast<size_t>(i)]);
+
+    // どのパッドにもボイスにもストリーマーにも参照されなくなったサンプルを解放する
+    for (int i = loadedSamples.size(); --i >= 0;)
+        if (loadedSamples.getObjectPointerUnchecked(i)->getReferenceCount() == 1)
+            loadedSamples.remove(i);
+}
+
+void SamplerEngine::handlePendingTriggers()
+{
+    int start1, size1, start2, size2;
+    triggerFifo.prepareToRead(triggerFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        startVoice(triggerQueue[static_cast<size_t>(start1 + i)].padIndex, triggerQueue[static_cast<size_t>(start1 + i)].velocity);
+    for (int i = 0; i < size2; ++i)
+        startVoice(triggerQueue[static_cast<size_t>(start2 + i)].padIndex, triggerQueue[static_cast<size_t>(start2 + i)].velocity);
+
+    triggerFifo.finishedRead(size1 + size2);
+}
+
+void SamplerEngine::startVoice(int padIndex, float velocity)
+{
+    if (padIndex < 0 || padIndex >= numPads)
+        return;
+
+    PadSample::Ptr sample;
+    {
+        const juce::SpinLock::ScopedLockType lock(padLock);
+        sample = pads[static_cast<size_t>(padIndex)];
+    }
+
+    if (sample == nullptr)
+        return;
+
+    // パッドはモノフォニック: 鳴っている発音はフェードアウトさせる
+    for (auto& voice : voices)
+        if (voice.isActive() && voice.padIndex == padIndex && voice.fadeRemaining == 0)
+            voice.fadeRemaining = fadeOutFrames;
+
+    // 空きボイスがなければ最も古いボイスを奪う
+    Voice* target = nullptr;
+    for (auto& voice : voices)
+    {
+        if (!voice.isActive())
+        {
+            target = &voice;
+            break;
+        }
+        if (target == nullptr || voice.startOrder < target->startOrder)
+            target = &voice;
+    }
+
+    stopVoice(*target);
+
+    target->sample = sample;
+    target->position = 0;
+    target->padIndex = padIndex;
+    target->gain = velocity;
+    target->fadeRemaining = 0;
+    target->startOrder = ++voiceCounter;
+
+    // ヘッドを再生している間にストリーマーがリングバッファを満たす
+    if (sample->needsStreaming())
+        target->streamSlot = streamer.acquireSlot(sample.get(), sample->getHeadLength());
+}
+
+void SamplerEngine::renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // ボイスの作業バッファより長い区間（prepare より大きなブロックをホストが渡した場合）は分けて描画する
+    const int chunkSize = voiceBuffer.getNumSamples();
+    if (numSamples <= 0 || chunkSize == 0)
+        return;
+
+    for (int offset = 0; offset < numSamples; offset += chunkSize)
+    {
+        const int count = juce::jmin(chunkSize, numSamples - offset);
+        for (auto& voice : voices)
+            if (voice.isActive())
+                renderVoice(voice, buffer, startSample + offset, count);
+    }
+}
+
+void SamplerEngine::renderVoice(Voice& voice, juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    auto& sample = *voice.sample;
+    const auto& head = sample.getHead();
+    const int outputChannels = juce::jmin(2, buffer.getNumChannels());
+
+    jassert(numSamples <= voiceBuffer.getNumSamples());
+    int rendered = 0;
+
+    // ヘッド部分（メモリ上）
+    if (voice.position < sample.getHeadLength())
+    {
+        const int count = static_cast<int>(juce::jmin(static_cast<juce::int64>(numSamples),
+                                                      sample.getHeadLength() - voice.position));
+        for (int ch = 0; ch < 2; ++ch)
+            voiceBuffer.copyFrom(ch, 0, head, ch, static_cast<int>(voice.position), count);
+
+        rendered = count;
+    }
+
+    // ストリーミング部分
+    if (rendered < numSamples && voice.position + rendered < sample.getLengthInFrames() && voice.streamSlot >= 0)
+    {
+        const int wanted = static_cast<int>(juce::jmin(static_cast<juce::int64>(numSamples - rendered),
+                                                       sample.getLengthInFrames() - voice.position - rendered));
+        rendered += streamer.read(voice.streamSlot, voiceBuffer, rendered, wanted);
+    }
+
+    const bool reachedEnd = voice.position + rendered >= sample.getLengthInFrames()
+                         || (rendered < numSamples && voice.streamSlot < 0);
+
+    // 出力へ加算（フェードアウト中はランプをかける）
+    int count = rendered;
+    float startGain = voice.gain;
+    float endGain = voice.gain;
+
+    if (voice.fadeRemaining > 0)
+    {
+        count = juce::jmin(count, voice.fadeRemaining);
+        startGain = voice.gain * static_cast<float>(voice.fadeRemaining) / fadeOutFrames;
+        endGain = voice.gain * static_cast<float>(voice.fadeRemaining - count) / fadeOutFrames;
+        voice.fadeRemaining -= count;
+    }
+
+    for (int ch = 0; ch < outputChannels; ++ch)
+        buffer.addFromWithRamp(ch, startSample, voiceBuffer.getReadPointer(ch), count, startGain, endGain);
+
+    voice.position += rendered;
+
+    // アンダーラン時は位置を進めずに次のブロックで再試行する
+    const bool fadeFinished = voice.fadeRemaining == 0 && endGain == 0.0f;
+    const bool stalledWhileFading = rendered == 0 && voice.fadeRemaining > 0;
+
+    if (reachedEnd || fadeFinished || stalledWhileFading)
+        stopVoice(voice);
+}
+
+void SamplerEngine::stopVoice(Voice& voice)
+{
+    if (voice.streamSlot >= 0)
+        streamer.releaseSlot(voice.streamSlot);
+
+    // 最後の参照は loadedSamples が持っているので、ここでは解放されない
+    voice.sample = nullptr;
+    voice.streamSlot = -1;
+    voice.padIndex = -1;
+    voice.fadeRemaining = 0;
+}
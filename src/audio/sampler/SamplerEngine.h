@@ -0,0 +1,100 @@
+#pragma once
+
+#include "PadSample.h"
+#include "SampleStreamer.h"
+#include "SampleImporter.h"
+
+/**
+ * SP-404スタイルのパッドサンプラー
+ * - 16パッド、各パッドはモノフォニック（再トリガーで前の発音を短いフェードで止める）
+ * - 固定数のボイスプール。ヘッドはメモリから、それ以降は SampleStreamer から読み出す
+ * - MIDIノート（36 = パッド1 〜 51 = パッド16）はブロック内のサンプル位置で正確に発音する
+ * - GUIからのトリガーはロックフリーFIFO経由でオーディオスレッドへ渡す
+ * - サンプルの読み込みは SampleImporter が非同期に行い、セッションのサンプルレートへ変換済みのものを再生する
+ */
+class SamplerEngine : private juce::Timer
+{
+public:
+    static constexpr int numPads = 16;
+    static constexpr int numVoices = 32;
+    static constexpr int firstPadNote = 36;
+    static constexpr int headFrames = 65536;
+    static constexpr int fadeOutFrames = 64;
+
+    SamplerEngine();
+    ~SamplerEngine() override;
+
+    void prepare(double sampleRate, int maximumBlockSize);
+    void releaseResources();
+
+    // オーディオスレッド: パッドの出力を buffer に加算する
+    void process(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages);
+
+    // ===== メッセージスレッドから呼ぶ =====
+    // インポート完了後にパッドへ割り当てる（完了までは以前のサンプルが鳴る）
+    void loadPad(int padIndex, const juce::File& file);
+    bool setPadSample(int padIndex, PadSample::Ptr sample);
+    void clearPad(int padIndex);
+    PadSample::Ptr getPadSample(int padIndex) const;
+    void triggerPad(int padIndex, float velocity = 1.0f);
+
+    // パッドに割り当てたファイルの保存/復元（変換済みキャッシュがあれば再デコードしない）
+    void saveToXml(juce::XmlElement& xml) const;
+    void loadFromXml(const juce::XmlElement& xml);
+
+    juce::AudioFormatManager& getFormatManager() { return formatManager; }
+    int getNumStreamUnderruns() const { return streamer.getNumUnderruns(); }
+
+private:
+    struct Voice
+    {
+        PadSample::Ptr sample;
+        juce::int64 position = 0;
+        int padIndex = -1;
+        int streamSlot = -1;
+        float gain = 1.0f;
+        int fadeRemaining = 0;      // 0 以外ならフェードアウト中
+        juce::uint32 startOrder = 0;
+
+        bool isActive() const { return sample != nullptr; }
+    };
+
+    struct PadTrigger
+    {
+        int padIndex;
+        float velocity;
+    };
+
+    void timerCallback() override;
+
+    void startVoice(int padIndex, float velocity);
+    void renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void renderVoice(Voice& voice, juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void stopVoice(Voice& voice);
+    void handlePendingTriggers();
+
+    juce::AudioFormatManager formatManager;
+    SampleImporter importer { formatManager, headFrames };
+    SampleStreamer streamer;
+
+    // メッセージスレッド専用: パッドの元ファイルと、インポートを要求したときの変換先レート
+    std::array<juce::File, numPads> padFiles;
+    std::array<double, numPads> requestedSampleRates {};
+
+    // パッドの差し替えはポインタのコピーだけをロック内で行う
+    juce::SpinLock padLock;
+    std::array<PadSample::Ptr, numPads> pads;
+
+    // オーディオスレッドで最後の参照が外れないよう、使用中のサンプルをすべて保持する
+    juce::ReferenceCountedArray<PadSample> loadedSamples;
+
+    std::array<Voice, numVoices> voices;
+    juce::uint32 voiceCounter = 0;
+    juce::AudioBuffer<float> voiceBuffer;
+
+    juce::AbstractFifo triggerFifo { 64 };
+    std::array<PadTrigger, 64> triggerQueue {};
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(SamplerEngine)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplerEngine)
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../audio/effects/Effect.h"
+#include <vector>
+
+/**
+ * エフェクト1個分の不変な状態
+ * - 作成後は書き換えない。変更があったエフェクトだけ新しく作り、それ以外は前のスナップショットと共有する
+ * - instanceId でチェーン内の同じインスタンスを指すので、復元時にエフェクトを作り直さずに済む
+ */
+struct EffectState : public juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<EffectState>;
+
+    EffectState(EffectTypeId type, juce::uint32 id, bool enabled, int slot, std::vector<float> values)
+        : typeId(type), instanceId(id), isEnabled(enabled), parameterSlot(slot), parameters(std::move(values))
+    {
+    }
+
+    bool hasSameValues(bool enabled, const std::vector<float>& values) const
+    {
+        return isEnabled == enabled && parameters == values;
+    }
+
+    const EffectTypeId typeId;
+    const juce::uint32 instanceId;
+    const bool isEnabled;
+    const int parameterSlot;
+    const std::vector<float> parameters;
+};
+
+/**
+ * ルーティングの接続1本（EffectChain::Connection と同じ内容。ノードは instanceId）
+ */
+struct ConnectionState
+{
+    juce::uint32 source = 0;
+    juce::uint32 destination = 0;
+    float gain = 1.0f;
+
+    bool operator==(const ConnectionState& other) const
+    {
+        return source == other.source && destination == other.destination && gain == other.gain;
+    }
+};
+
+/**
+ * ルーティング全体の不変な状態。接続が変わらなければ前のスナップショットと共有する
+ */
+struct RoutingState : public juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<RoutingState>;
+
+    explicit RoutingState(std::vector<ConnectionState> newConnections)
+        : connections(std::move(newConnections))
+    {
+    }
+
+    const std::vector<ConnectionState> connections;
+};
+
+/**
+ * エフェクトチェーン全体の不変なスナップショット
+ * - 中身はエフェクト状態へのポインタの並びとルーティングへのポインタだけなので、1ステップあたりのコストは
+ *   「エフェクト数 × ポインタ」＋「変更されたエフェクトの状態」（＋接続を変えたときはその一覧）に収まる
+ */
+struct ChainSnapshot : public juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<ChainSnapshot>;
+
+    ChainSnapshot(std::vector<EffectState::Ptr> states, RoutingState::Ptr routingState)
+        : effects(std::move(states)), routing(std::move(routingState))
+    {
+    }
+
+    // エフェクトの状態とルーティングをすべて共有している（同じ状態である）か
+    bool sharesAllStatesWith(const ChainSnapshot& other) const
+    {
+        return effects == other.effects && routing == other.routing;
+    }
+
+    const std::vector<EffectState::Ptr> effects;
+    const RoutingState::Ptr routing;
+};
@@ -0,0 +1,128 @@
+#include "EditHistory.h"
+
+EditHistory::EditHistory(EffectChain& chainToTrack, int maxStepsToKeep)
+    : chain(chainToTrack),
+      maxSteps(juce::jmax(2, maxStepsToKeep))
+{
+    chain.addChangeListener(this);
+    clear();
+}
+
+EditHistory::~EditHistory()
+{
+    cancelPendingUpdate();
+    chain.removeChangeListener(this);
+    for (auto* parameter : gestureParameters)
+        parameter->removeListener(this);
+}
+
+void EditHistory::trackParameter(juce::RangedAudioParameter& parameter)
+{
+    trackedParameters.push_back(&parameter);
+    clear();
+}
+
+void EditHistory::listenForGestures(juce::AudioProcessorParameter& parameter)
+{
+    parameter.addListener(this);
+    gestureParameters.push_back(&parameter);
+}
+
+bool EditHistory::undo()
+{
+    flushPendingCommits();
+    if (!canUndo())
+        return false;
+
+    restore(steps[static_cast<size_t>(--currentStep)]);
+    return true;
+}
+
+bool EditHistory::redo()
+{
+    flushPendingCommits();
+    if (!canRedo())
+        return false;
+
+    restore(steps[static_cast<size_t>(++currentStep)]);
+    return true;
+}
+
+void EditHistory::commit()
+{
+    const auto* previous = currentStep >= 0 ? &steps[static_cast<size_t>(currentStep)] : nullptr;
+    auto step = capture(previous);
+
+    if (previous != nullptr
+        && step.parameters == previous->parameters
+        && step.chain->sharesAllStatesWith(*previous->chain))
+        return;
+
+    // 新しい編集でリドゥ側は捨てる
+    steps.erase(steps.begin() + (currentStep + 1), steps.end());
+    steps.push_back(std::move(step));
+
+    if (static_cast<int>(steps.size()) > maxSteps)
+        steps.pop_front();
+
+    currentStep = static_cast<int>(steps.size()) - 1;
+}
+
+void EditHistory::clear()
+{
+    steps.clear();
+    steps.push_back(capture(nullptr));
+    currentStep = 0;
+}
+
+EditHistory::Step EditHistory::capture(const Step* previous) const
+{
+    Step step;
+    step.chain = chain.createSnapshot(previous != nullptr ? previous->chain.get() : nullptr);
+
+    std::vector<float> values;
+    values.reserve(trackedParameters.size());
+    for (auto* parameter : trackedParameters)
+        values.push_back(parameter->getValue());
+
+    if (previous != nullptr && previous->parameters->values == values)
+        step.parameters = previous->parameters;
+    else
+        step.parameters = new ParameterValues(std::move(values));
+
+    return step;
+}
+
+void EditHistory::restore(const Step& step)
+{
+    chain.restoreSnapshot(*step.chain);
+
+    const auto& values = step.parameters->values;
+    for (size_t i = 0; i < trackedParameters.size() && i < values.size(); ++i)
+        if (trackedParameters[i]->getValue() != values[i])
+            trackedParameters[i]->setValueNotifyingHost(values[i]);
+}
+
+void EditHistory::flushPendingCommits()
+{
+    // 操作直後のアンドゥで、まだ積まれていない変更を取りこぼさない
+    chain.dispatchPendingMessages();
+    handleUpdateNowIfNeeded();
+}
+
+void EditHistory::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    commit();
+}
+
+void EditHistory::parameterGestureChanged(int, bool gestureIsStarting)
+{
+    // ジェスチャーはホストのスレッドから届くこともあるので、メッセージスレッドで積む
+    if (!gestureIsStarting)
+        triggerAsyncUpdate();
+}
+
+void EditHistory::handleAsyncUpdate()
+{
+    commit();
+}
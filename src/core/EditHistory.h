@@ -0,0 +1,79 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../EffectChain.h"
+#include "ChainSnapshot.h"
+#include <deque>
+
+/**
+ * チェーン編集・パラメータ変更・プリセットロードのアンドゥ/リドゥ履歴
+ * - 各ステップは不変なスナップショット（ChainSnapshot とパラメータ値のブロック）へのポインタの組
+ * - 変わっていないエフェクトの状態やパラメータのブロックは前のステップと共有するので、
+ *   1ステップのコストは数百バイト程度に収まり、数千ステップを保持できる
+ * - 復元は EffectChain::restoreSnapshot を通してインスタンスを再利用し、ロックフリーに順序を差し替える
+ * - チェーンの変更通知とパラメータ操作の終了（ジェスチャー）で自動的に積む。メッセージスレッドで使うこと
+ */
+class EditHistory : private juce::ChangeListener,
+                    private juce::AudioProcessorParameter::Listener,
+                    private juce::AsyncUpdater
+{
+public:
+    explicit EditHistory(EffectChain& chainToTrack, int maxSteps = defaultMaxSteps);
+    ~EditHistory() override;
+
+    // スナップショットに値を含めるチェーン外のパラメータ（リバーブなど）
+    void trackParameter(juce::RangedAudioParameter& parameter);
+
+    // 操作が終わった時点で履歴を積むパラメータ（チェーンのスロットを含むすべて）
+    void listenForGestures(juce::AudioProcessorParameter& parameter);
+
+    bool undo();
+    bool redo();
+    bool canUndo() const { return currentStep > 0; }
+    bool canRedo() const { return currentStep + 1 < static_cast<int>(steps.size()); }
+
+    // 現在の状態を1ステップとして積む（前のステップと同じなら何もしない）
+    void commit();
+
+    // 履歴を捨て、現在の状態を起点にする（状態の復元後など）
+    void clear();
+
+    int getNumSteps() const { return static_cast<int>(steps.size()); }
+    int getCurrentStep() const { return currentStep; }
+
+    static constexpr int defaultMaxSteps = 4096;
+
+private:
+    struct ParameterValues : public juce::ReferenceCountedObject
+    {
+        using Ptr = juce::ReferenceCountedObjectPtr<ParameterValues>;
+
+        explicit ParameterValues(std::vector<float> newValues) : values(std::move(newValues)) {}
+
+        const std::vector<float> values;
+    };
+
+    struct Step
+    {
+        ChainSnapshot::Ptr chain;
+        ParameterValues::Ptr parameters;
+    };
+
+    Step capture(const Step* previous) const;
+    void restore(const Step& step);
+    void flushPendingCommits();
+
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+    void parameterValueChanged(int, float) override {}
+    void parameterGestureChanged(int, bool gestureIsStarting) override;
+    void handleAsyncUpdate() override;
+
+    EffectChain& chain;
+    std::vector<juce::RangedAudioParameter*> trackedParameters;
+    std::vector<juce::AudioProcessorParameter*> gestureParameters;
+    std::deque<Step> steps;
+    int currentStep = -1;
+    const int maxSteps;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EditHistory)
+};
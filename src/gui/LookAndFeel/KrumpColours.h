@@ -0,0 +1,12 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+
+/**
+ * エディターとコンポーネントで共有する配色
+ * - エディターの LookAndFeel とメーター・スペクトラム・ブラウザ・モーフパッドが同じ値を参照する
+ */
+namespace KrumpColours
+{
+    inline const juce::Colour accent { 0xffe53935 }; // レッド
+}
@@ -1,28 +1,20 @@
 #include "EffectComponent.h"
 #include "../../audio/effects/Effect.h"
 
-// ドラッグ＆ドロップ用のインターフェース
-class DragAndDropInterface
-{
-public:
-    virtual ~DragAndDropInterface() = default;
-    virtual void handleEffectDragAndDrop(int fromIndex, int toIndex) = 0;
-};
-
-EffectComponent::EffectComponent(Effect* effect) : effect(effect)
+EffectComponent::EffectComponent()
 {
     // タイトルラベルの設定
-    titleLabel.setText(effect->getName(), juce::dontSendNotification);
     titleLabel.setFont(juce::Font(18.0f, juce::Font::bold));
     titleLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(titleLabel);
 
     // バイパスボタンの設定
     bypassButton.setButtonText("Bypass");
-    bypassButton.setToggleState(!effect->isEnabled, juce::dontSendNotification);
-    bypassButton.onClick = [this, effect]
+    bypassButton.setClickingTogglesState(true);
+    bypassButton.onClick = [this]
     {
-        effect->isEnabled = !bypassButton.getToggleState();
+        if (effect != nullptr)
+            effect->isEnabled = !bypassButton.getToggleState();
     };
     addAndMakeVisible(bypassButton);
 
@@ -31,50 +23,175 @@ EffectComponent::EffectComponent(Effect* effect) : effect(effect)
     removeButton.setColour(juce::TextButton::buttonColourId, juce::Colours::red);
     addAndMakeVisible(removeButton);
 
-    // パラメーターコントロールの作成
-    const auto paramNames = effect->getParameterNames();
-    const auto paramLabels = effect->getParameterLabels();
-    const auto paramRanges = effect->getParameterRanges();
+    // 出力メーターの設定
+    outputMeter.setMeterColour(juce::Colours::orange);
+    addAndMakeVisible(outputMeter);
+
+    // ドラッグ＆ドロップの設定
+    setMouseCursor(juce::MouseCursor::DraggingHandCursor);
+}
+
+EffectComponent::EffectComponent(Effect* effect, EffectParameterPool* parameterPool)
+    : EffectComponent()
+{
+    setEffect(effect, parameterPool, -1);
+}
 
-    for (int i = 0; i < effect->getNumParameters(); ++i)
+EffectComponent::~EffectComponent()
+{
+    outputMeter.setSource(nullptr);
+}
+
+void EffectComponent::setEffect(Effect* newEffect, EffectParameterPool* newParameterPool, int newChainIndex)
+{
+    effect = newEffect;
+    parameterPool = newParameterPool;
+    chainIndex = newChainIndex;
+    outputMeter.setSource(effect != nullptr ? &effect->getOutputMeter() : nullptr);
+
+    if (effect == nullptr)
+        return;
+
+    bypassButton.setToggleState(!effect->isEnabled, juce::dontSendNotification);
+
+    // 同じ種別なら名前と範囲はそのままで、値だけを更新する（プリセットのロードや同じ種別の再利用）
+    if (effect->getTypeId() != configuredType)
+    {
+        configuredType = effect->getTypeId();
+        titleLabel.setText(effect->getName(), juce::dontSendNotification);
+
+        const auto paramNames = effect->getParameterNames();
+        const auto paramLabels = effect->getParameterLabels();
+        const auto paramRanges = effect->getParameterRanges();
+
+        numVisibleParameters = effect->getNumParameters();
+        ensureControls(numVisibleParameters);
+
+        groupSize = effect->getParameterGroupSize();
+        numGroups = groupSize > 0 ? (numVisibleParameters + groupSize - 1) / groupSize : 0;
+        ensureGroupButtons(numGroups);
+
+        for (int i = 0; i < numVisibleParameters; ++i)
+        {
+            sliders[i]->setRange(paramRanges[i * 3],     // minimum
+                                 paramRanges[i * 3 + 1], // maximum
+                                 (paramRanges[i * 3 + 1] - paramRanges[i * 3]) / 100.0f); // interval
+            sliders[i]->setTextValueSuffix(" " + paramLabels[i]);
+            labels[i]->setText(paramNames[i], juce::dontSendNotification);
+        }
+
+        // 表示するスライダーを決めてレイアウトする
+        selectGroup(0);
+    }
+    else
+    {
+        // バインドし直したエフェクト（スナップショットの復元など）は先頭の組に戻っているので、表示中の組を割り当て直す
+        assignSelectedGroupToSlot();
+    }
+
+    updateParameters();
+}
+
+void EffectComponent::ensureControls(int numParameters)
+{
+    // 足りない分だけ作る（作ったコントロールは差し替え後も使い回す）
+    for (int i = sliders.size(); i < numParameters; ++i)
     {
         auto* slider = new juce::Slider(juce::Slider::RotaryHorizontalVerticalDrag,
-                                      juce::Slider::TextBoxBelow);
-        
-        slider->setRange(paramRanges[i * 3],     // minimum
-                        paramRanges[i * 3 + 1],   // maximum
-                        (paramRanges[i * 3 + 1] - paramRanges[i * 3]) / 100.0f); // interval
-        slider->setValue(paramRanges[i * 3 + 2], juce::dontSendNotification); // default
-        slider->setTextValueSuffix(" " + paramLabels[i]);
+                                        juce::Slider::TextBoxBelow);
         slider->setPopupDisplayEnabled(true, false, this);
         slider->setColour(juce::Slider::thumbColourId, juce::Colours::orange);
         slider->setColour(juce::Slider::rotarySliderFillColourId, juce::Colours::orange);
         slider->setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colours::darkgrey);
-        
+
         auto* label = new juce::Label();
-        label->setText(paramNames[i], juce::dontSendNotification);
         label->setJustificationType(juce::Justification::centred);
-        
+
         sliders.add(slider);
         labels.add(label);
-        
-        slider->onValueChange = [this, effect, i]
+
+        slider->onValueChange = [this, i] { sliderValueChanged(i); };
+        slider->onDragStart = [this, i]
         {
-            effect->setParameter(i, static_cast<float>(sliders[i]->getValue()));
+            if (effect != nullptr && parameterPool != nullptr)
+                parameterPool->beginGesture(*effect, i);
         };
-        
+        slider->onDragEnd = [this, i]
+        {
+            if (effect != nullptr && parameterPool != nullptr)
+                parameterPool->endGesture(*effect, i);
+        };
+
         addAndMakeVisible(slider);
         addAndMakeVisible(label);
     }
+}
 
-    // ドラッグ＆ドロップの設定
-    setMouseCursor(juce::MouseCursor::DraggingHandCursor);
+void EffectComponent::ensureGroupButtons(int numGroupsToShow)
+{
+    for (int g = groupButtons.size(); g < numGroupsToShow; ++g)
+    {
+        auto* button = new juce::TextButton(juce::String(g + 1));
+        button->setColour(juce::TextButton::buttonOnColourId, juce::Colours::orange);
+        button->onClick = [this, g] { selectGroup(g); };
+
+        groupButtons.add(button);
+        addChildComponent(button);
+    }
 }
 
-EffectComponent::~EffectComponent()
+void EffectComponent::selectGroup(int group)
+{
+    selectedGroup = juce::jlimit(0, juce::jmax(0, numGroups - 1), group);
+    assignSelectedGroupToSlot();
+
+    for (int g = 0; g < groupButtons.size(); ++g)
+    {
+        groupButtons[g]->setVisible(g < numGroups);
+        groupButtons[g]->setToggleState(g == selectedGroup, juce::dontSendNotification);
+    }
+
+    for (int i = 0; i < sliders.size(); ++i)
+    {
+        const bool isShown = i < numVisibleParameters && isParameterShown(i);
+        sliders[i]->setVisible(isShown);
+        labels[i]->setVisible(isShown);
+    }
+
+    resized();
+}
+
+void EffectComponent::assignSelectedGroupToSlot()
+{
+    // スロットの幅より多くのパラメータを持つエフェクト（EQ）は、表示中の組をスロットの先頭に割り当ててオートメーションできるようにする
+    if (effect != nullptr && parameterPool != nullptr && groupSize > 0)
+        parameterPool->setFirstParameter(*effect, selectedGroup * groupSize);
+}
+
+bool EffectComponent::isParameterShown(int parameterIndex) const
 {
-    sliders.clear(true);
-    labels.clear(true);
+    return groupSize <= 0 || parameterIndex / groupSize == selectedGroup;
+}
+
+void EffectComponent::sliderValueChanged(int parameterIndex)
+{
+    if (effect == nullptr)
+        return;
+
+    const auto value = static_cast<float>(sliders[parameterIndex]->getValue());
+    if (parameterPool != nullptr)
+        parameterPool->setParameterFromUi(*effect, parameterIndex, value);
+    else
+        effect->setParameter(parameterIndex, value);
+}
+
+float EffectComponent::getDisplayedValue(int parameterIndex) const
+{
+    // ホストパラメータ経由の値はオーディオスレッドが反映する前から表示する
+    if (parameterPool != nullptr)
+        return parameterPool->getParameterValue(*effect, parameterIndex);
+
+    return effect->getParameter(parameterIndex);
 }
 
 void EffectComponent::paint(juce::Graphics& g)
@@ -104,17 +221,33 @@ void EffectComponent::resized()
     auto headerBounds = bounds.removeFromTop(30);
     removeButton.setBounds(headerBounds.removeFromRight(30).reduced(2));
     bypassButton.setBounds(headerBounds.removeFromRight(60).reduced(2));
+    outputMeter.setBounds(headerBounds.removeFromLeft(12).reduced(0, 2));
     titleLabel.setBounds(headerBounds);
 
-    // パラメーターコントロール
-    const int numParams = effect->getNumParameters();
-    const int sliderWidth = bounds.getWidth() / 2;
-    const int sliderHeight = (bounds.getHeight() - 20) / ((numParams + 1) / 2);
+    // 組の選択ボタン（EQのバンドなど）
+    if (numGroups > 0)
+    {
+        auto groupBounds = bounds.removeFromTop(24);
+        const int buttonWidth = groupBounds.getWidth() / numGroups;
+        for (int g = 0; g < numGroups; ++g)
+            groupButtons[g]->setBounds(groupBounds.removeFromLeft(buttonWidth).reduced(1));
+    }
+
+    // パラメーターコントロール（組に分かれていれば選んだ組だけ）
+    const int firstParam = groupSize > 0 ? selectedGroup * groupSize : 0;
+    const int numParams = groupSize > 0 ? juce::jmin(groupSize, numVisibleParameters - firstParam) : numVisibleParameters;
+    if (numParams <= 0)
+        return;
+
+    // 通常は2列。組は選択ボタンの分だけ高さが減るので1行に並べる
+    const int numColumns = groupSize > 0 ? numParams : 2;
+    const int sliderWidth = bounds.getWidth() / numColumns;
+    const int sliderHeight = (bounds.getHeight() - 20) / ((numParams + numColumns - 1) / numColumns);
 
     for (int i = 0; i < numParams; ++i)
     {
-        const int row = i / 2;
-        const int col = i % 2;
+        const int row = i / numColumns;
+        const int col = i % numColumns;
         
         auto sliderBounds = bounds.withTrimmedTop(row * sliderHeight)
                                  .withTrimmedLeft(col * sliderWidth)
@@ -123,8 +256,8 @@ void EffectComponent::resized()
                                  .reduced(5);
         
         auto labelBounds = sliderBounds.removeFromTop(20);
-        labels[i]->setBounds(labelBounds);
-        sliders[i]->setBounds(sliderBounds);
+        labels[firstParam + i]->setBounds(labelBounds);
+        sliders[firstParam + i]->setBounds(sliderBounds);
     }
 }
 
@@ -174,42 +307,28 @@ void EffectComponent::itemDropped(const SourceDetails& dragSourceDetails)
 {
     if (auto* draggedEffect = dynamic_cast<EffectComponent*>(dragSourceDetails.sourceComponent.get()))
     {
-        if (auto* parent = dynamic_cast<DragAndDropInterface*>(getParentComponent()))
-        {
-            const int fromIndex = draggedEffect->getIndexInParent();
-            const int toIndex = getIndexInParent();
-            parent->handleEffectDragAndDrop(fromIndex, toIndex);
-        }
+        // ラックは表示する範囲だけを子に持つので、子の順番ではなくチェーン内の位置を使う
+        auto* parent = findParentComponentOfClass<DragAndDropInterface>();
+        if (parent != nullptr && draggedEffect->getChainIndex() >= 0 && getChainIndex() >= 0)
+            parent->handleEffectDragAndDrop(draggedEffect->getChainIndex(), getChainIndex());
     }
 }
 
 void EffectComponent::updateParameters()
 {
-    for (int i = 0; i < sliders.size(); ++i)
+    if (effect == nullptr)
+        return;
+
+    for (int i = 0; i < numVisibleParameters; ++i)
     {
-        sliders[i]->setValue(effect->getParameter(i), juce::dontSendNotification);
+        sliders[i]->setValue(getDisplayedValue(i), juce::dontSendNotification);
     }
 }
 
 void EffectComponent::parameterChanged(int parameterIndex, float newValue)
 {
-    if (parameterIndex >= 0 && parameterIndex < sliders.size())
+    if (parameterIndex >= 0 && parameterIndex < numVisibleParameters)
     {
         sliders[parameterIndex]->setValue(newValue, juce::dontSendNotification);
     }
 }
-
-int EffectComponent::getIndexInParent() const
-{
-    if (auto* parent = getParentComponent())
-    {
-        for (int i = 0; i < parent->getNumChildComponents(); ++i)
-        {
-            if (parent->getChildComponent(i) == this)
-            {
-                return i;
-            }
-        }
-    }
-    return -1;
-} 
\ No newline at end of file
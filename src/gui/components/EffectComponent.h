@@ -2,15 +2,41 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../../audio/effects/Effect.h"
-#include "../LookAndFeel/KrumpLookAndFeel.h"
+#include "../../audio/effects/EffectParameterPool.h"
+#include "LevelMeter.h"
 
+// ドラッグ＆ドロップ用のインターフェース（エフェクトを並べる親が実装する）
+class DragAndDropInterface
+{
+public:
+    virtual ~DragAndDropInterface() = default;
+    virtual void handleEffectDragAndDrop(int fromIndex, int toIndex) = 0;
+};
+
+/**
+ * チェーン内の1エフェクトの表示
+ * - 表示するエフェクトは setEffect で差し替えられる（ラックのスクロールやチェーンの変更で再利用される）
+ * - スライダーとラベルは必要な数まで増やすだけで、差し替え時は範囲と名前を設定し直し、余った分は隠す
+ * - パラメータが組に分かれるエフェクト（EQのバンドなど）は組の選択ボタンを並べ、選んだ組のスライダーだけを表示する
+ */
 class EffectComponent : public juce::Component,
                        public juce::DragAndDropTarget
 {
 public:
-    explicit EffectComponent(Effect* effect);
+    EffectComponent();
+
+    // parameterPool を渡すとスライダー操作はホストパラメータ経由になり、オートメーションとして記録される
+    explicit EffectComponent(Effect* effect, EffectParameterPool* parameterPool = nullptr);
     ~EffectComponent() override;
 
+    // 表示するエフェクトを差し替える（nullptr で未使用にする）。chainIndex はドラッグ＆ドロップで使う
+    void setEffect(Effect* newEffect, EffectParameterPool* newParameterPool, int newChainIndex);
+    Effect* getEffect() const { return effect; }
+    EffectTypeId getConfiguredType() const { return configuredType; }
+
+    void setChainIndex(int newChainIndex) { chainIndex = newChainIndex; }
+    int getChainIndex() const { return chainIndex; }
+
     void paint(juce::Graphics&) override;
     void resized() override;
 
@@ -25,22 +51,40 @@ public:
     void itemDragExit(const SourceDetails&) override;
     void itemDropped(const SourceDetails& dragSourceDetails) override;
 
-    // パラメーター更新
+    // パラメーター更新（エフェクトの現在値をコントロールへ反映する。値が同じなら何もしない）
     void updateParameters();
     void parameterChanged(int parameterIndex, float newValue);
-    int getIndexInParent() const;
 
     juce::TextButton removeButton;
     juce::TextButton bypassButton;
 
 private:
-    Effect* effect;
-    KrumpLookAndFeel lookAndFeel;
+    void ensureControls(int numParameters);
+    void ensureGroupButtons(int numGroupsToShow);
+    void selectGroup(int group);
+    void assignSelectedGroupToSlot();
+    bool isParameterShown(int parameterIndex) const;
+    void sliderValueChanged(int parameterIndex);
+    float getDisplayedValue(int parameterIndex) const;
+
+    Effect* effect = nullptr;
+    EffectParameterPool* parameterPool = nullptr;
+    int chainIndex = -1;
+    int numVisibleParameters = 0;
+    EffectTypeId configuredType = EffectTypeId::none; // コントロールを設定済みの種別
+
     juce::Label titleLabel;
+    LevelMeter outputMeter;
     juce::OwnedArray<juce::Slider> sliders;
     juce::OwnedArray<juce::Label> labels;
+
+    // パラメータの組（getParameterGroupSize が 0 なら numGroups も 0 で、すべて表示する）
+    juce::OwnedArray<juce::TextButton> groupButtons;
+    int groupSize = 0;
+    int numGroups = 0;
+    int selectedGroup = 0;
     juce::ComponentDragger dragger;
     bool isBeingDragged = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectComponent)
-}; 
\ No newline at end of file
+};
@@ -0,0 +1,155 @@
+#include "EffectRackView.h"
+
+EffectRackView::EffectRackView(EffectChain& chainToShow)
+    : chain(chainToShow)
+{
+    // LookAndFeel はラックで1つだけ持ち、子へ継承させる
+    content.setLookAndFeel(&lookAndFeel);
+
+    viewport.setViewedComponent(&content, false);
+    viewport.setScrollBarsShown(true, false);
+    addAndMakeVisible(viewport);
+
+    chain.addChangeListener(this);
+    updateContentSize();
+    startTimerHz(refreshRateHz);
+}
+
+EffectRackView::~EffectRackView()
+{
+    stopTimer();
+    chain.removeChangeListener(this);
+    content.setLookAndFeel(nullptr);
+}
+
+void EffectRackView::resized()
+{
+    viewport.setBounds(getLocalBounds());
+    updateContentSize();
+}
+
+void EffectRackView::handleEffectDragAndDrop(int fromIndex, int toIndex)
+{
+    chain.moveEffect(fromIndex, toIndex);
+}
+
+void EffectRackView::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    updateContentSize();
+}
+
+void EffectRackView::timerCallback()
+{
+    // アンドゥなど通知のない構造の変更は割り当てをやり直し、それ以外は見えている行の値だけを更新する
+    if (!isShowingCurrentChain())
+    {
+        updateContentSize();
+        return;
+    }
+
+    for (auto* component : activeComponents)
+        component->updateParameters();
+}
+
+void EffectRackView::updateContentSize()
+{
+    shownNumEffects = chain.getNumEffects();
+    content.setSize(viewport.getMaximumVisibleWidth(), shownNumEffects * rowHeight);
+
+    // サイズが変わらなければ visibleAreaChanged は呼ばれないので、ここで割り当てをやり直す
+    updateVisibleRows();
+}
+
+bool EffectRackView::isShowingCurrentChain() const
+{
+    if (chain.getNumEffects() != shownNumEffects)
+        return false;
+
+    for (auto* component : activeComponents)
+        if (chain.getEffect(component->getChainIndex()) != component->getEffect())
+            return false;
+
+    return true;
+}
+
+void EffectRackView::updateVisibleRows()
+{
+    const auto visibleArea = viewport.getViewArea();
+    const int numEffects = chain.getNumEffects();
+    const int firstRow = juce::jmax(0, visibleArea.getY() / rowHeight - overscanRows);
+    const int lastRow = juce::jmin(numEffects - 1, visibleArea.getBottom() / rowHeight + overscanRows);
+
+    // 範囲内のエフェクトをすでに表示している部品はそのまま使う（並べ替えなら位置だけ変わる）
+    std::vector<EffectComponent*> rows(static_cast<size_t>(juce::jmax(0, lastRow - firstRow + 1)), nullptr);
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        auto* effect = chain.getEffect(row);
+        for (auto it = activeComponents.begin(); it != activeComponents.end(); ++it)
+        {
+            if ((*it)->getEffect() == effect)
+            {
+                rows[static_cast<size_t>(row - firstRow)] = *it;
+                activeComponents.erase(it);
+                break;
+            }
+        }
+    }
+
+    // 残りは範囲外か、チェーンから外れたエフェクトを表示している
+    for (auto* component : activeComponents)
+        releaseComponent(component);
+    activeComponents.clear();
+
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        auto* effect = chain.getEffect(row);
+        auto*& component = rows[static_cast<size_t>(row - firstRow)];
+        if (component == nullptr)
+        {
+            component = acquireComponent(effect->getTypeId());
+            component->setEffect(effect, chain.getParameterPool(), row);
+        }
+        else
+        {
+            component->setChainIndex(row);
+        }
+
+        component->setBounds(0, row * rowHeight, content.getWidth(), rowHeight);
+        component->setVisible(true);
+        activeComponents.push_back(component);
+    }
+}
+
+EffectComponent* EffectRackView::acquireComponent(EffectTypeId typeId)
+{
+    // 同じ種別に設定済みのものを優先し、なければ何でも、それもなければ作る
+    auto found = std::find_if(freeComponents.begin(), freeComponents.end(),
+                              [typeId](EffectComponent* component) { return component->getConfiguredType() == typeId; });
+    if (found == freeComponents.end() && !freeComponents.empty())
+        found = freeComponents.end() - 1;
+
+    if (found != freeComponents.end())
+    {
+        auto* component = *found;
+        freeComponents.erase(found);
+        return component;
+    }
+
+    auto component = std::make_unique<EffectComponent>();
+    auto* rawComponent = component.get();
+    rawComponent->removeButton.onClick = [this, rawComponent]
+    {
+        chain.removeEffect(rawComponent->getChainIndex());
+    };
+    content.addChildComponent(rawComponent);
+    components.push_back(std::move(component));
+    return rawComponent;
+}
+
+void EffectRackView::releaseComponent(EffectComponent* component)
+{
+    // 種別の設定は残したまま、エフェクトとの結び付きだけを外す（メーターのタイマーも止まる）
+    component->setVisible(false);
+    component->setEffect(nullptr, nullptr, -1);
+    freeComponents.push_back(component);
+}
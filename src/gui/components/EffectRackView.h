@@ -0,0 +1,69 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../../EffectChain.h"
+#include "../LookAndFeel/KrumpLookAndFeel.h"
+#include "EffectComponent.h"
+
+/**
+ * エフェクトチェーンの縦並びラック表示（仮想化）
+ * - ビューポートに見えている行（と前後 overscanRows 行）のエフェクトにだけ EffectComponent を割り当てる
+ * - 外れた EffectComponent はプールへ戻し、次に必要になったとき同じ種別のものを優先して再利用する
+ *   （同じ種別ならコントロールの作り直しも範囲の再設定もなく、値の更新だけで済む）
+ * - チェーンの変更通知で割り当てをやり直す。通知を伴わない変更（アンドゥなど）とオートメーションの値は
+ *   タイマーで拾う
+ */
+class EffectRackView : public juce::Component,
+                       public DragAndDropInterface,
+                       private juce::ChangeListener,
+                       private juce::Timer
+{
+public:
+    static constexpr int rowHeight = 200;
+    static constexpr int overscanRows = 1;
+    static constexpr int refreshRateHz = 15;
+
+    explicit EffectRackView(EffectChain& chainToShow);
+    ~EffectRackView() override;
+
+    void resized() override;
+
+    void handleEffectDragAndDrop(int fromIndex, int toIndex) override;
+
+    // 割り当て中 / プールにある EffectComponent の数（生成済みの総数はこの和）
+    int getNumActiveComponents() const { return static_cast<int>(activeComponents.size()); }
+    int getNumPooledComponents() const { return static_cast<int>(freeComponents.size()); }
+
+private:
+    class RackViewport : public juce::Viewport
+    {
+    public:
+        explicit RackViewport(EffectRackView& ownerToNotify) : owner(ownerToNotify) {}
+        void visibleAreaChanged(const juce::Rectangle<int>&) override { owner.updateVisibleRows(); }
+
+    private:
+        EffectRackView& owner;
+    };
+
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+    void timerCallback() override;
+
+    void updateContentSize();
+    void updateVisibleRows();
+    bool isShowingCurrentChain() const;
+
+    EffectComponent* acquireComponent(EffectTypeId typeId);
+    void releaseComponent(EffectComponent* component);
+
+    EffectChain& chain;
+    KrumpLookAndFeel lookAndFeel;
+    RackViewport viewport { *this };
+    juce::Component content;
+
+    std::vector<std::unique_ptr<EffectComponent>> components; // 生成したすべての EffectComponent
+    std::vector<EffectComponent*> activeComponents;
+    std::vector<EffectComponent*> freeComponents;
+    int shownNumEffects = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectRackView)
+};
@@ -0,0 +1,122 @@
+#include "LevelMeter.h"
+
+namespace
+{
+    // 1フレームあたりのピークホールドの減衰（30fpsで約 20dB/秒）
+    constexpr float peakDecayPerFrame = 0.86f;
+}
+
+LevelMeter::LevelMeter(LevelMeterSource& sourceToUse)
+    : LevelMeter()
+{
+    setSource(&sourceToUse);
+}
+
+LevelMeter::LevelMeter()
+{
+    setOpaque(false);
+}
+
+void LevelMeter::setSource(LevelMeterSource* newSource)
+{
+    if (newSource == source)
+        return;
+
+    source = newSource;
+    for (auto& display : channels)
+        display = {};
+    repaint();
+
+    if (source != nullptr)
+        startTimerHz(refreshRateHz);
+    else
+        stopTimer();
+}
+
+LevelMeter::~LevelMeter()
+{
+    stopTimer();
+}
+
+void LevelMeter::paint(juce::Graphics& g)
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto bounds = getChannelBounds(ch);
+        const auto& display = channels[static_cast<size_t>(ch)];
+
+        // 背景
+        g.setColour(juce::Colour(0xff222222));
+        g.fillRect(bounds);
+
+        // RMSバー
+        g.setColour(meterColour.withAlpha(0.8f));
+        g.fillRect(bounds.withTop(bounds.getBottom() - display.rmsHeight));
+
+        // ピークライン（0dBFSを超えたら白）
+        if (display.peakHeight > 0)
+        {
+            g.setColour(display.peak >= 1.0f ? juce::Colours::white : meterColour.brighter(0.5f));
+            g.fillRect(bounds.getX(), bounds.getBottom() - display.peakHeight, bounds.getWidth(), 2);
+        }
+    }
+}
+
+void LevelMeter::resized()
+{
+    for (auto& display : channels)
+    {
+        display.peakHeight = 0;
+        display.rmsHeight = 0;
+    }
+}
+
+void LevelMeter::timerCallback()
+{
+    if (source == nullptr)
+        return;
+
+    const int sourceChannels = juce::jlimit(1, LevelMeterSource::maxChannels, source->getNumChannels());
+    if (sourceChannels != numChannels)
+    {
+        numChannels = sourceChannels;
+        repaint();
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto& display = channels[static_cast<size_t>(ch)];
+        const auto bounds = getChannelBounds(ch);
+
+        display.peak = juce::jmax(source->getPeakAndReset(ch), display.peak * peakDecayPerFrame);
+        display.rms = source->getRms(ch);
+
+        const int newPeakHeight = levelToHeight(display.peak, bounds.getHeight());
+        const int newRmsHeight = levelToHeight(display.rms, bounds.getHeight());
+
+        if (newPeakHeight == display.peakHeight && newRmsHeight == display.rmsHeight)
+            continue;
+
+        // 前回と今回の表示が重なる範囲だけを再描画する
+        const int top = bounds.getBottom() - juce::jmax(newPeakHeight, display.peakHeight, juce::jmax(newRmsHeight, display.rmsHeight)) - 2;
+        const int bottom = bounds.getBottom() - juce::jmin(newPeakHeight, display.peakHeight, juce::jmin(newRmsHeight, display.rmsHeight)) + 2;
+
+        display.peakHeight = newPeakHeight;
+        display.rmsHeight = newRmsHeight;
+        repaint(bounds.withTop(juce::jmax(bounds.getY(), top)).withBottom(juce::jmin(bounds.getBottom(), bottom)));
+    }
+}
+
+juce::Rectangle<int> LevelMeter::getChannelBounds(int channel) const
+{
+    auto bounds = getLocalBounds();
+    const int width = bounds.getWidth() / juce::jmax(1, numChannels);
+    return bounds.withX(channel * width).withWidth(width - 1);
+}
+
+int LevelMeter::levelToHeight(float level, int totalHeight) const
+{
+    const float db = juce::Decibels::gainToDecibels(level, minimumDb);
+    const float proportion = juce::jlimit(0.0f, 1.0f, (db - minimumDb) / -minimumDb);
+    return juce::roundToInt(proportion * static_cast<float>(totalHeight));
+}
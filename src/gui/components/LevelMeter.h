@@ -0,0 +1,52 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../../audio/metering/LevelMeterSource.h"
+#include "../LookAndFeel/KrumpColours.h"
+
+/**
+ * 縦型のピーク/RMSメーター
+ * - LevelMeterSource の atomic をタイマーで読むだけで、オーディオバッファには触れない
+ * - 描画はフレームレートを上限とし、表示が1ピクセル以上変わったチャンネルの領域だけ再描画する
+ * - ソースを持たない間はタイマーを止めておく
+ */
+class LevelMeter : public juce::Component,
+                   private juce::Timer
+{
+public:
+    static constexpr int refreshRateHz = 30;
+    static constexpr float minimumDb = -60.0f;
+
+    explicit LevelMeter(LevelMeterSource& sourceToUse);
+    LevelMeter();
+    ~LevelMeter() override;
+
+    // 表示するソースを差し替える（再利用されるエフェクト表示用）。nullptr ならタイマーを止める
+    void setSource(LevelMeterSource* newSource);
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    void setMeterColour(juce::Colour newColour) { meterColour = newColour; repaint(); }
+
+private:
+    void timerCallback() override;
+
+    juce::Rectangle<int> getChannelBounds(int channel) const;
+    int levelToHeight(float level, int totalHeight) const;
+
+    struct ChannelDisplay
+    {
+        float peak = 0.0f;   // ピークホールド（減衰付き）
+        float rms = 0.0f;
+        int peakHeight = 0;  // 最後に描画した高さ
+        int rmsHeight = 0;
+    };
+
+    LevelMeterSource* source = nullptr;
+    std::array<ChannelDisplay, LevelMeterSource::maxChannels> channels;
+    int numChannels = 2;
+    juce::Colour meterColour = KrumpColours::accent;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeter)
+};
@@ -6,12 +6,33 @@
 
 MainComponent::MainComponent(AudioPluginAudioProcessor& processor)
     : audioProcessor(processor),
-      presetManager(std::make_unique<PresetManager>(processor.effectChain))
+      presetManager(std::make_unique<PresetManager>(processor.effectChain)),
+      inputMeter(processor.inputMeter),
+      outputMeter(processor.outputMeter),
+      presetBrowser(presetManager->getLibrary()),
+      morphPad(*processor.presetMorpher.getXParameter(), *processor.presetMorpher.getYParameter())
 {
     // ディスプレイの設定
     display = std::make_unique<DisplayLabel>("SP-404MKII Clone");
     addAndMakeVisible(display.get());
 
+    // 入出力メーターの設定
+    inputMeter.setMeterColour(SP404LookAndFeel::accentColor);
+    outputMeter.setMeterColour(SP404LookAndFeel::accentColor);
+    addAndMakeVisible(inputMeter);
+    addAndMakeVisible(outputMeter);
+
+    // プリセットブラウザ（選んだプリセットをそのままチェーンへ読み込む）
+    presetBrowser.onPresetChosen = [this](const juce::File& file)
+    {
+        presetManager->loadPreset(file);
+        updateDisplay();
+    };
+    addAndMakeVisible(presetBrowser);
+
+    // プリセットモーフィング
+    setupMorph();
+
     // コントロールの初期化
     setupKnobs();
     setupButtons();
@@ -39,6 +60,10 @@ void MainComponent::resized()
     // ディスプレイの配置
     display->setBounds(getScaledBounds(0.1f, 0.05f, 0.8f, 0.1f));
 
+    // メーターの配置（ディスプレイの左右）
+    inputMeter.setBounds(getScaledBounds(0.02f, 0.05f, 0.04f, 0.6f));
+    outputMeter.setBounds(getScaledBounds(0.94f, 0.05f, 0.04f, 0.6f));
+
     // エフェクトボタンの配置
     for (size_t i = 0; i < effectButtons.size(); ++i)
     {
@@ -63,6 +88,13 @@ void MainComponent::resized()
         presetButtons[i]->setBounds(getScaledBounds(x, y, 0.2f, 0.1f));
     }
 
+    // プリセットブラウザの配置
+    presetBrowser.setBounds(getScaledBounds(0.1f, 0.62f, 0.6f, 0.12f));
+
+    // モーフパッドの配置（ブラウザの右）
+    morphButton.setBounds(getScaledBounds(0.72f, 0.62f, 0.18f, 0.03f));
+    morphPad.setBounds(getScaledBounds(0.72f, 0.655f, 0.18f, 0.085f));
+
     // パッドの配置
     const int padRows = 4;
     const int padCols = 4;
@@ -104,6 +136,16 @@ void MainComponent::buttonClicked(juce::Button* button)
             return;
         }
     }
+
+    // パッドの処理（オーディオスレッドへはロックフリーキュー経由で渡る）
+    for (size_t i = 0; i < pads.size(); ++i)
+    {
+        if (button == pads[i].get())
+        {
+            audioProcessor.samplerEngine.triggerPad(static_cast<int>(i), 1.0f);
+            return;
+        }
+    }
 }
 
 void MainComponent::sliderValueChanged(juce::Slider* slider)
@@ -194,6 +236,38 @@ void MainComponent::setupPads()
     }
 }
 
+void MainComponent::setupMorph()
+{
+    // 保存済みのプリセット 1〜4 のうち、4つあれば XY、2つ以上あれば最初の2つでクロスフェードする
+    morphButton.setClickingTogglesState(true);
+    morphButton.onClick = [this]
+    {
+        auto& morpher = audioProcessor.presetMorpher;
+        if (!morphButton.getToggleState())
+        {
+            morpher.clear();
+            morphPad.setNumCorners(0);
+            return;
+        }
+
+        juce::Array<const juce::XmlElement*> states;
+        for (int i = 0; i < PresetMorpher::maxCorners; ++i)
+            if (auto* state = presetManager->getPresetState(i))
+                states.add(state);
+
+        if (states.size() == 3)
+            states.removeLast();
+
+        if (!morpher.setPresets(audioProcessor.effectChain, states))
+            morphButton.setToggleState(false, juce::dontSendNotification);
+
+        morphPad.setNumCorners(morpher.getNumCorners());
+        updateDisplay();
+    };
+    addAndMakeVisible(morphButton);
+    addAndMakeVisible(morphPad);
+}
+
 void MainComponent::updateDisplay()
 {
     // アクティブなエフェクトの状態を表示
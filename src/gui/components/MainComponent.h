@@ -7,6 +7,9 @@
 #include "EffectButton.h"
 #include "PresetButton.h"
 #include "DisplayLabel.h"
+#include "LevelMeter.h"
+#include "PresetBrowser.h"
+#include "MorphPad.h"
 
 class MainComponent : public juce::Component,
                      public juce::Button::Listener,
@@ -32,6 +35,11 @@ private:
     std::vector<std::unique_ptr<PresetButton>> presetButtons;
     std::vector<std::unique_ptr<juce::TextButton>> pads;
     std::unique_ptr<DisplayLabel> display;
+    LevelMeter inputMeter;
+    LevelMeter outputMeter;
+    PresetBrowser presetBrowser;
+    juce::TextButton morphButton { "Morph" };
+    MorphPad morphPad;
 
     // Layout helpers
     juce::Rectangle<int> getScaledBounds(float x, float y, float w, float h) const;
@@ -40,6 +48,7 @@ private:
     void setupPads();
     void updateDisplay();
     void updatePresetList();
+    void setupMorph();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 }; 
\ No newline at end of file
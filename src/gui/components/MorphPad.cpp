@@ -0,0 +1,69 @@
+#include "MorphPad.h"
+#include "../LookAndFeel/KrumpColours.h"
+
+MorphPad::MorphPad(juce::RangedAudioParameter& xParameter, juce::RangedAudioParameter& yParameter)
+    : xAttachment(xParameter, [this](float value) { x = value; repaint(); }),
+      yAttachment(yParameter, [this](float value) { y = value; repaint(); })
+{
+    xAttachment.sendInitialUpdate();
+    yAttachment.sendInitialUpdate();
+}
+
+void MorphPad::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+
+    g.setColour(juce::Colour(0xff222222));
+    g.fillRoundedRectangle(bounds, 4.0f);
+
+    const bool isActive = numCorners > 0;
+    const bool usesY = numCorners == 4;
+    g.setColour(isActive ? KrumpColours::accent : juce::Colours::grey);
+
+    const float px = bounds.getX() + x * bounds.getWidth();
+    const float py = usesY ? bounds.getBottom() - y * bounds.getHeight() : bounds.getCentreY();
+    if (usesY)
+        g.fillEllipse(px - 6.0f, py - 6.0f, 12.0f, 12.0f);
+    else
+        g.fillRect(px - 2.0f, bounds.getY(), 4.0f, bounds.getHeight());
+
+    g.setColour(juce::Colours::white.withAlpha(0.5f));
+    g.drawRoundedRectangle(bounds, 4.0f, 1.0f);
+}
+
+void MorphPad::setNumCorners(int newNumCorners)
+{
+    numCorners = newNumCorners;
+    repaint();
+}
+
+void MorphPad::mouseDown(const juce::MouseEvent& event)
+{
+    // 操作中にコーナー数が変わってもジェスチャーの対応が崩れないよう、開始時の状態を覚えておく
+    isDraggingY = numCorners == 4;
+    xAttachment.beginGesture();
+    if (isDraggingY)
+        yAttachment.beginGesture();
+    setPositionFromMouse(event.position);
+}
+
+void MorphPad::mouseDrag(const juce::MouseEvent& event)
+{
+    setPositionFromMouse(event.position);
+}
+
+void MorphPad::mouseUp(const juce::MouseEvent&)
+{
+    xAttachment.endGesture();
+    if (isDraggingY)
+        yAttachment.endGesture();
+    isDraggingY = false;
+}
+
+void MorphPad::setPositionFromMouse(juce::Point<float> position)
+{
+    auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+    xAttachment.setValueAsPartOfGesture(juce::jlimit(0.0f, 1.0f, (position.x - bounds.getX()) / bounds.getWidth()));
+    if (isDraggingY)
+        yAttachment.setValueAsPartOfGesture(juce::jlimit(0.0f, 1.0f, (bounds.getBottom() - position.y) / bounds.getHeight()));
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+/**
+ * プリセットモーフィングの XY パッド
+ * - "morphX" / "morphY" のホストパラメータへ ParameterAttachment で結び付く（ドラッグがジェスチャーになる）
+ * - 縦軸は4コーナーのモーフのときだけ有効で、2つのときは横方向のクロスフェーダーとして振る舞う
+ */
+class MorphPad : public juce::Component
+{
+public:
+    MorphPad(juce::RangedAudioParameter& xParameter, juce::RangedAudioParameter& yParameter);
+    ~MorphPad() override = default;
+
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent& event) override;
+    void mouseDrag(const juce::MouseEvent& event) override;
+    void mouseUp(const juce::MouseEvent& event) override;
+
+    // 2 ならクロスフェーダー、4 なら XY パッド、0 ならモーフなし（表示のみ変わる）
+    void setNumCorners(int newNumCorners);
+
+private:
+    void setPositionFromMouse(juce::Point<float> position);
+
+    float x = 0.0f;
+    float y = 0.0f;
+    int numCorners = 0;
+    bool isDraggingY = false;
+
+    juce::ParameterAttachment xAttachment;
+    juce::ParameterAttachment yAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MorphPad)
+};
@@ -0,0 +1,120 @@
+#include "MorphPanel.h"
+#include "../../EffectChain.h"
+
+MorphPanel::MorphPanel(PresetMorpher& morpherToUse, EffectChain& chainToUse, PresetLibrary& libraryToUse,
+                       CornerFiles& cornerFilesToUse)
+    : morpher(morpherToUse),
+      chain(chainToUse),
+      library(libraryToUse),
+      cornerFiles(cornerFilesToUse),
+      morphPad(*morpherToUse.getXParameter(), *morpherToUse.getYParameter())
+{
+    // コーナーは (0,0) (1,0) (0,1) (1,1) の順。パッドの Y は下が 0 なので、XY のときは A/B が下の辺になる
+    const juce::StringArray cornerNames { "A (left)", "B (right)", "C (top left)", "D (top right)" };
+    for (int i = 0; i < PresetMorpher::maxCorners; ++i)
+    {
+        auto& box = cornerBoxes[static_cast<size_t>(i)];
+        box.setTextWhenNothingSelected(cornerNames[i]);
+        box.onChange = [this, i]
+        {
+            const int row = cornerBoxes[static_cast<size_t>(i)].getSelectedId() - 1;
+            cornerFiles[static_cast<size_t>(i)] = juce::isPositiveAndBelow(row, static_cast<int>(presets.size()))
+                                                ? presets[static_cast<size_t>(row)].file : juce::File();
+
+            if (morphButton.getToggleState())
+                applyMorph();
+        };
+        addAndMakeVisible(box);
+    }
+
+    morphButton.setClickingTogglesState(true);
+    morphButton.onClick = [this] { applyMorph(); };
+    addAndMakeVisible(morphButton);
+
+    morphPad.setNumCorners(morpher.getNumCorners());
+    morphButton.setToggleState(morpher.getNumCorners() > 0, juce::dontSendNotification);
+    addAndMakeVisible(morphPad);
+
+    library.addChangeListener(this);
+    updatePresetList();
+}
+
+MorphPanel::~MorphPanel()
+{
+    library.removeChangeListener(this);
+}
+
+void MorphPanel::resized()
+{
+    auto bounds = getLocalBounds();
+
+    // 左にコーナーの選択とボタン、右にパッド
+    auto controls = bounds.removeFromLeft(bounds.getWidth() / 2);
+    const int rowHeight = controls.getHeight() / (PresetMorpher::maxCorners + 1);
+    for (auto& box : cornerBoxes)
+        box.setBounds(controls.removeFromTop(rowHeight).reduced(0, 2));
+    morphButton.setBounds(controls.reduced(0, 2));
+
+    morphPad.setBounds(bounds.reduced(4, 0));
+}
+
+void MorphPanel::updatePresetList()
+{
+    // 選択はファイルで覚えているので、並びが変わっても選び直せる
+    presets = library.search({}, juce::jmax(1, library.getNumPresets()));
+
+    for (size_t i = 0; i < cornerBoxes.size(); ++i)
+    {
+        auto& box = cornerBoxes[i];
+        box.clear(juce::dontSendNotification);
+
+        for (size_t row = 0; row < presets.size(); ++row)
+        {
+            box.addItem(presets[row].name, static_cast<int>(row) + 1);
+            if (presets[row].file == cornerFiles[i])
+                box.setSelectedId(static_cast<int>(row) + 1, juce::dontSendNotification);
+        }
+    }
+}
+
+void MorphPanel::applyMorph()
+{
+    if (!morphButton.getToggleState())
+    {
+        morpher.clear();
+        morphPad.setNumCorners(0);
+        return;
+    }
+
+    // 選ばれたコーナーを順に読み込む（XML は展開が終わるまで持っておく）
+    std::vector<std::unique_ptr<juce::XmlElement>> documents;
+    juce::Array<const juce::XmlElement*> states;
+    for (auto& box : cornerBoxes)
+    {
+        const int row = box.getSelectedId() - 1;
+        if (!juce::isPositiveAndBelow(row, static_cast<int>(presets.size())))
+            continue;
+
+        if (auto xml = juce::XmlDocument::parse(presets[static_cast<size_t>(row)].file))
+        {
+            states.add(xml.get());
+            documents.push_back(std::move(xml));
+        }
+    }
+
+    if (states.size() == 3)
+        states.removeLast();
+
+    if (!morpher.setPresets(chain, states))
+    {
+        morpher.clear();
+        morphButton.setToggleState(false, juce::dontSendNotification);
+    }
+
+    morphPad.setNumCorners(morpher.getNumCorners());
+}
+
+void MorphPanel::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    updatePresetList();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "MorphPad.h"
+#include "../../presets/PresetLibrary.h"
+#include "../../presets/PresetMorpher.h"
+#include <array>
+
+class EffectChain;
+
+/**
+ * プリセットモーフィングの操作パネル
+ * - コーナーごとのコンボボックスでライブラリのプリセットを選び、Morph ボタンでモーファーへ展開する
+ * - 2つ選べば X のクロスフェーダー、4つ選べば XY パッドになる（3つのときは先頭の2つを使う）
+ * - モーフ中にコーナーを選び直すと展開し直す。ライブラリが更新されたら候補を取り直し、選択はファイルで保つ
+ * - コーナーの選択は呼び出し側（プロセッサー）が持つ配列に置くので、エディターを開き直しても残る
+ */
+class MorphPanel : public juce::Component,
+                   private juce::ChangeListener
+{
+public:
+    using CornerFiles = std::array<juce::File, PresetMorpher::maxCorners>;
+
+    MorphPanel(PresetMorpher& morpherToUse, EffectChain& chainToUse, PresetLibrary& libraryToUse, CornerFiles& cornerFilesToUse);
+    ~MorphPanel() override;
+
+    void resized() override;
+
+private:
+    void updatePresetList();
+    void applyMorph();
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+
+    PresetMorpher& morpher;
+    EffectChain& chain;
+    PresetLibrary& library;
+    CornerFiles& cornerFiles;
+
+    // コンボボックスの ID は presets の添字 + 1
+    std::vector<PresetLibrary::PresetInfo> presets;
+    std::array<juce::ComboBox, PresetMorpher::maxCorners> cornerBoxes;
+    juce::TextButton morphButton { "Morph" };
+    MorphPad morphPad;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MorphPanel)
+};
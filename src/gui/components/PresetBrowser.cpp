@@ -0,0 +1,86 @@
+#include "PresetBrowser.h"
+#include "../LookAndFeel/KrumpColours.h"
+
+PresetBrowser::PresetBrowser(PresetLibrary& libraryToUse)
+    : library(libraryToUse)
+{
+    searchBox.setTextToShowWhenEmpty("Search presets (name, tag:, type:, cutoff<800)", juce::Colours::grey);
+    searchBox.onTextChange = [this] { updateResults(); };
+    searchBox.onReturnKey = [this] { returnKeyPressed(juce::jmax(0, resultList.getSelectedRow())); };
+    addAndMakeVisible(searchBox);
+
+    resultList.setModel(this);
+    resultList.setRowHeight(22);
+    resultList.setColour(juce::ListBox::backgroundColourId, juce::Colour(0xff222222));
+    addAndMakeVisible(resultList);
+
+    library.addChangeListener(this);
+    updateResults();
+}
+
+PresetBrowser::~PresetBrowser()
+{
+    library.removeChangeListener(this);
+    resultList.setModel(nullptr);
+}
+
+void PresetBrowser::resized()
+{
+    auto bounds = getLocalBounds();
+    searchBox.setBounds(bounds.removeFromTop(26));
+    bounds.removeFromTop(4);
+    resultList.setBounds(bounds);
+}
+
+void PresetBrowser::updateResults()
+{
+    results = library.search(searchBox.getText());
+    resultList.updateContent();
+    resultList.repaint();
+}
+
+int PresetBrowser::getNumRows()
+{
+    return static_cast<int>(results.size());
+}
+
+void PresetBrowser::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+    if (!juce::isPositiveAndBelow(rowNumber, static_cast<int>(results.size())))
+        return;
+
+    const auto& preset = results[static_cast<size_t>(rowNumber)];
+
+    if (rowIsSelected)
+        g.fillAll(KrumpColours::accent.withAlpha(0.4f));
+
+    // 名前を左に、エフェクト種別とタグを右に薄く表示する
+    auto area = juce::Rectangle<int>(0, 0, width, height).reduced(6, 0);
+    g.setColour(juce::Colours::white);
+    g.setFont(14.0f);
+    g.drawText(preset.name, area.removeFromLeft(width / 2), juce::Justification::centredLeft, true);
+
+    auto details = preset.effectTypes.joinIntoString(" / ");
+    if (!preset.tags.isEmpty())
+        details << "  #" << preset.tags.joinIntoString(" #");
+
+    g.setColour(juce::Colours::white.withAlpha(0.5f));
+    g.setFont(12.0f);
+    g.drawText(details, area, juce::Justification::centredRight, true);
+}
+
+void PresetBrowser::listBoxItemDoubleClicked(int row, const juce::MouseEvent&)
+{
+    returnKeyPressed(row);
+}
+
+void PresetBrowser::returnKeyPressed(int lastRowSelected)
+{
+    if (onPresetChosen != nullptr && juce::isPositiveAndBelow(lastRowSelected, static_cast<int>(results.size())))
+        onPresetChosen(results[static_cast<size_t>(lastRowSelected)].file);
+}
+
+void PresetBrowser::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    updateResults();
+}
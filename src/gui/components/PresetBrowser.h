@@ -0,0 +1,39 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../../presets/PresetLibrary.h"
+
+/**
+ * プリセットの検索ブラウザ
+ * - 入力のたびに PresetLibrary のインデックスを引き直す（検索自体はインデックスで完結し、ファイルは読まない）
+ * - ライブラリのスキャンが終わると結果を更新する
+ * - ダブルクリックまたは Enter で onPresetChosen を呼ぶ
+ */
+class PresetBrowser : public juce::Component,
+                      private juce::ListBoxModel,
+                      private juce::ChangeListener
+{
+public:
+    explicit PresetBrowser(PresetLibrary& libraryToUse);
+    ~PresetBrowser() override;
+
+    void resized() override;
+
+    std::function<void(const juce::File&)> onPresetChosen;
+
+private:
+    void updateResults();
+
+    int getNumRows() override;
+    void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override;
+    void returnKeyPressed(int lastRowSelected) override;
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+
+    PresetLibrary& library;
+    juce::TextEditor searchBox;
+    juce::ListBox resultList;
+    std::vector<PresetLibrary::PresetInfo> results;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBrowser)
+};
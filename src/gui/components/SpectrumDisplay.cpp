@@ -0,0 +1,52 @@
+#include "SpectrumDisplay.h"
+#include "../LookAndFeel/KrumpColours.h"
+
+SpectrumDisplay::SpectrumDisplay(SpectrumAnalyzer& analyzerToUse)
+    : analyzer(analyzerToUse)
+{
+    analyzer.addClient();
+    startTimerHz(refreshRateHz);
+}
+
+SpectrumDisplay::~SpectrumDisplay()
+{
+    stopTimer();
+    analyzer.removeClient();
+}
+
+void SpectrumDisplay::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+
+    // 背景
+    g.setColour(juce::Colour(0xff222222));
+    g.fillRoundedRectangle(bounds, 6.0f);
+
+    // -12dB ごとのグリッド
+    g.setColour(juce::Colours::white.withAlpha(0.08f));
+    const float dbRange = SpectrumAnalyzer::maximumDb - SpectrumAnalyzer::minimumDb;
+    for (float db = 0.0f; db > SpectrumAnalyzer::minimumDb; db -= 12.0f)
+    {
+        const float y = bounds.getY() + bounds.getHeight() * (SpectrumAnalyzer::maximumDb - db) / dbRange;
+        g.drawHorizontalLine(juce::roundToInt(y), bounds.getX(), bounds.getRight());
+    }
+
+    const auto transform = juce::AffineTransform::scale(bounds.getWidth(), bounds.getHeight())
+                               .translated(bounds.getX(), bounds.getY());
+
+    // プリフィルター（入力）は薄く、ポストリバーブ（出力）は強調して描く
+    g.setColour(juce::Colours::white.withAlpha(0.35f));
+    g.strokePath(analyzer.getPath(SpectrumAnalyzer::preFilter), juce::PathStrokeType(1.0f), transform);
+
+    g.setColour(KrumpColours::accent);
+    g.strokePath(analyzer.getPath(SpectrumAnalyzer::postReverb), juce::PathStrokeType(1.5f), transform);
+}
+
+void SpectrumDisplay::timerCallback()
+{
+    const bool preChanged = analyzer.updatePath(SpectrumAnalyzer::preFilter);
+    const bool postChanged = analyzer.updatePath(SpectrumAnalyzer::postReverb);
+
+    if (preChanged || postChanged)
+        repaint();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../../audio/analysis/SpectrumAnalyzer.h"
+
+/**
+ * プリフィルター/ポストリバーブのスペクトラム表示
+ * - 表示中だけアナライザーのクライアントとして登録し、解析スレッドを動かす
+ * - 解析スレッドが作った正規化済みパスを拡大して描くだけで、GUIではFFTを行わない
+ */
+class SpectrumDisplay : public juce::Component,
+                        private juce::Timer
+{
+public:
+    static constexpr int refreshRateHz = 30;
+
+    explicit SpectrumDisplay(SpectrumAnalyzer& analyzerToUse);
+    ~SpectrumDisplay() override;
+
+    void paint(juce::Graphics& g) override;
+
+private:
+    void timerCallback() override;
+
+    SpectrumAnalyzer& analyzer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumDisplay)
+};
@@ -0,0 +1,536 @@
+#include "PresetLibrary.h"
+#include <algorithm>
+#include <map>
+
+namespace
+{
+    // Term::text の1文字目に置くフィールドの識別子
+    constexpr char nameField = 'n';
+    constexpr char tagField = 't';
+    constexpr char typeField = 'y';
+
+    const juce::StringArray reservedAttributes { "Index", "Type", "TypeId", "ParameterSlot" };
+
+    std::string toKey(const juce::String& text)
+    {
+        return text.toLowerCase().toStdString();
+    }
+
+    // 英数字以外で区切った小文字の語
+    juce::StringArray tokenise(const juce::String& text)
+    {
+        juce::StringArray words;
+        juce::String current;
+        for (auto p = text.getCharPointer(); !p.isEmpty(); ++p)
+        {
+            const auto c = *p;
+            if (juce::CharacterFunctions::isLetterOrDigit(c))
+            {
+                current += juce::CharacterFunctions::toLowerCase(c);
+            }
+            else if (current.isNotEmpty())
+            {
+                words.add(current);
+                current.clear();
+            }
+        }
+        if (current.isNotEmpty())
+            words.add(current);
+        return words;
+    }
+
+    void unionInto(std::vector<juce::uint32>& dest, const std::vector<juce::uint32>& source)
+    {
+        std::vector<juce::uint32> merged;
+        merged.reserve(dest.size() + source.size());
+        std::set_union(dest.begin(), dest.end(), source.begin(), source.end(), std::back_inserter(merged));
+        dest.swap(merged);
+    }
+}
+
+PresetLibrary::PresetLibrary(const juce::File& presetDirectory, const juce::File& indexFileToUse)
+    : juce::Thread("Preset Library"),
+      directory(presetDirectory),
+      indexFile(indexFileToUse),
+      currentIndex(std::make_shared<Index>())
+{
+    startThread();
+    rescan();
+}
+
+PresetLibrary::~PresetLibrary()
+{
+    stopThread(4000);
+}
+
+void PresetLibrary::rescan()
+{
+    rescanRequested = true;
+    notify();
+}
+
+std::vector<PresetLibrary::PresetInfo> PresetLibrary::search(const juce::String& query, int maxResults) const
+{
+    const auto index = getIndex();
+    std::vector<PresetInfo> results;
+
+    juce::StringArray textTokens;
+    std::vector<RangeQuery> rangeQueries;
+    for (const auto& token : juce::StringArray::fromTokens(query.trim(), true))
+    {
+        if (token.containsAnyOf("<>="))
+            rangeQueries.push_back(parseRangeQuery(token));
+        else
+            textTokens.add(token);
+    }
+
+    std::vector<juce::uint32> matches;
+    bool hasCandidates = false;
+
+    for (const auto& token : textTokens)
+    {
+        // フィールド指定がなければ名前・タグ・種別のいずれかに前方一致すればよい
+        const auto hasField = token.containsChar(':');
+        const auto field = hasField ? token.upToFirstOccurrenceOf(":", false, false).toLowerCase() : juce::String();
+        const auto text = toKey(hasField ? token.fromFirstOccurrenceOf(":", false, false) : token);
+
+        std::vector<juce::uint32> tokenMatches;
+        if (!hasField || field == "name")
+            unionInto(tokenMatches, findPrefix(*index, nameField + text));
+        if (!hasField || field == "tag")
+            unionInto(tokenMatches, findPrefix(*index, tagField + text));
+        if (!hasField || field == "type")
+            unionInto(tokenMatches, findPrefix(*index, typeField + text));
+
+        matches = hasCandidates ? intersect(matches, tokenMatches) : std::move(tokenMatches);
+        hasCandidates = true;
+
+        if (matches.empty())
+            return results;
+    }
+
+    // 範囲条件は、語で絞り込めていれば候補の値を直接調べ、そうでなければ範囲インデックスから引く
+    for (const auto& range : rangeQueries)
+    {
+        if (hasCandidates)
+        {
+            matches.erase(std::remove_if(matches.begin(), matches.end(), [&index, &range](juce::uint32 id)
+            {
+                return !matchesRange(index->documents[id], range);
+            }), matches.end());
+        }
+        else
+        {
+            matches = findRange(*index, range);
+            hasCandidates = true;
+        }
+
+        if (matches.empty())
+            return results;
+    }
+
+    // クエリが空ならすべて（文書は名前順なので番号順がそのまま名前順）
+    const auto count = hasCandidates ? matches.size() : index->documents.size();
+    const auto limit = juce::jmin(count, static_cast<size_t>(juce::jmax(0, maxResults)));
+    results.reserve(limit);
+    for (size_t i = 0; i < limit; ++i)
+        results.push_back(index->documents[hasCandidates ? matches[i] : i].info);
+
+    return results;
+}
+
+int PresetLibrary::getNumPresets() const
+{
+    return static_cast<int>(getIndex()->documents.size());
+}
+
+void PresetLibrary::run()
+{
+    while (!threadShouldExit())
+    {
+        // 走査中に届いた要求は取りこぼさず、終わった後にもう一度走査する
+        if (rescanRequested.exchange(false))
+        {
+            scanInProgress = true;
+            if (scan())
+                sendChangeMessage();
+            scanInProgress = false;
+            continue;
+        }
+
+        wait(-1);
+    }
+}
+
+bool PresetLibrary::scan()
+{
+    // 初回は保存済みの文書を前回の結果として使う
+    std::vector<Document> previous;
+    if (!documentsLoaded)
+    {
+        documentsLoaded = true;
+
+        // 走査が終わる前でも、前回の結果で検索できるようにしておく
+        if (loadDocuments(previous))
+        {
+            auto index = buildIndex(previous);
+            {
+                const juce::SpinLock::ScopedLockType lock(indexLock);
+                currentIndex = std::move(index);
+            }
+            sendChangeMessage();
+        }
+    }
+    else
+    {
+        previous = getIndex()->documents;
+    }
+
+    std::map<juce::String, const Document*> previousByPath;
+    for (const auto& document : previous)
+        previousByPath[document.info.file.getFullPathName()] = &document;
+
+    std::vector<Document> documents;
+    bool changed = false;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(directory, true, "*.xml", juce::File::findFiles))
+    {
+        if (threadShouldExit())
+            return false;
+
+        const auto& file = entry.getFile();
+        const auto modificationTime = entry.getModificationTime().toMilliseconds();
+        const auto fileSize = entry.getFileSize();
+
+        // 更新日時とサイズが同じなら前回の解析結果をそのまま使う
+        if (auto it = previousByPath.find(file.getFullPathName()); it != previousByPath.end())
+        {
+            if (it->second->modificationTime == modificationTime && it->second->fileSize == fileSize)
+            {
+                documents.push_back(*it->second);
+                previousByPath.erase(it);
+                continue;
+            }
+            previousByPath.erase(it);
+        }
+
+        Document document;
+        document.modificationTime = modificationTime;
+        document.fileSize = fileSize;
+        if (parseDocument(file, document))
+            documents.push_back(std::move(document));
+
+        changed = true;
+    }
+
+    // 残っているのは削除されたファイル
+    if (!changed && previousByPath.empty())
+        return false;
+
+    auto index = buildIndex(std::move(documents));
+    saveDocuments(index->documents);
+
+    {
+        const juce::SpinLock::ScopedLockType lock(indexLock);
+        currentIndex = std::move(index);
+    }
+    return true;
+}
+
+bool PresetLibrary::parseDocument(const juce::File& file, Document& document)
+{
+    const auto xml = juce::XmlDocument::parse(file);
+    if (xml == nullptr)
+        return false;
+
+    document.info.file = file;
+    document.info.name = xml->getStringAttribute("Name", file.getFileNameWithoutExtension());
+    document.info.tags = juce::StringArray::fromTokens(xml->getStringAttribute("Tags"), ",", "");
+    document.info.tags.trim();
+    document.info.tags.removeEmptyStrings();
+
+    forEachXmlChildElementWithTagName(*xml, effectElement, "Effect")
+    {
+        const auto type = effectElement->getStringAttribute("Type");
+        if (type.isEmpty())
+            continue;
+
+        document.info.effectTypes.addIfNotAlreadyThere(type);
+
+        // 予約済み以外の数値属性をパラメータとして索引に載せる
+        for (int i = 0; i < effectElement->getNumAttributes(); ++i)
+        {
+            const auto attribute = effectElement->getAttributeName(i);
+            const auto value = effectElement->getAttributeValue(i);
+            if (reservedAttributes.contains(attribute) || !value.containsOnly("0123456789.-+eE"))
+                continue;
+
+            document.parameters.emplace_back(toKey(type + "." + attribute), value.getFloatValue());
+        }
+    }
+
+    return true;
+}
+
+std::shared_ptr<PresetLibrary::Index> PresetLibrary::buildIndex(std::vector<Document> documents)
+{
+    auto index = std::make_shared<Index>();
+
+    std::sort(documents.begin(), documents.end(), [](const Document& a, const Document& b)
+    {
+        return a.info.name.compareNatural(b.info.name) < 0;
+    });
+    index->documents = std::move(documents);
+
+    std::map<std::string, std::vector<juce::uint32>> terms;
+    std::map<std::string, std::vector<std::pair<float, juce::uint32>>> ranges;
+
+    for (size_t i = 0; i < index->documents.size(); ++i)
+    {
+        const auto id = static_cast<juce::uint32>(i);
+        const auto& document = index->documents[i];
+
+        // 文書番号の昇順に追加するので、同じ文書が続いた場合だけ重複を避ければよい
+        auto addTerm = [&terms, id](char field, const juce::String& text)
+        {
+            auto& postings = terms[field + toKey(text)];
+            if (postings.empty() || postings.back() != id)
+                postings.push_back(id);
+        };
+
+        for (const auto& word : tokenise(document.info.name))
+            addTerm(nameField, word);
+
+        for (const auto& tag : document.info.tags)
+        {
+            addTerm(tagField, tag);
+            for (const auto& word : tokenise(tag))
+                addTerm(tagField, word);
+        }
+
+        for (const auto& type : document.info.effectTypes)
+            addTerm(typeField, type);
+
+        for (const auto& [key, value] : document.parameters)
+            ranges[key].emplace_back(value, id);
+    }
+
+    index->terms.reserve(terms.size());
+    for (auto& [text, postings] : terms)
+        index->terms.push_back({ text, std::move(postings) });
+
+    index->ranges.reserve(ranges.size());
+    for (auto& [key, entries] : ranges)
+    {
+        std::sort(entries.begin(), entries.end());
+        index->ranges.push_back({ key, std::move(entries) });
+    }
+
+    return index;
+}
+
+bool PresetLibrary::loadDocuments(std::vector<Document>& documents) const
+{
+    juce::FileInputStream stream(indexFile);
+    if (!stream.openedOk())
+        return false;
+
+    if (stream.readInt() != indexFileVersion)
+        return false;
+
+    const auto count = stream.readInt();
+    if (count < 0)
+        return false;
+
+    documents.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count && !stream.isExhausted(); ++i)
+    {
+        Document document;
+        document.info.file = juce::File(stream.readString());
+        document.modificationTime = stream.readInt64();
+        document.fileSize = stream.readInt64();
+        document.info.name = stream.readString();
+        document.info.tags = juce::StringArray::fromLines(stream.readString());
+        document.info.tags.removeEmptyStrings();
+        document.info.effectTypes = juce::StringArray::fromLines(stream.readString());
+        document.info.effectTypes.removeEmptyStrings();
+
+        const auto numParameters = stream.readInt();
+        for (int p = 0; p < numParameters && !stream.isExhausted(); ++p)
+        {
+            auto key = toKey(stream.readString());
+            document.parameters.emplace_back(std::move(key), stream.readFloat());
+        }
+
+        documents.push_back(std::move(document));
+    }
+
+    return static_cast<int>(documents.size()) == count;
+}
+
+void PresetLibrary::saveDocuments(const std::vector<Document>& documents) const
+{
+    indexFile.getParentDirectory().createDirectory();
+
+    // 書き込み途中で終了しても壊れたインデックスを残さない
+    juce::TemporaryFile temporary(indexFile);
+    {
+        juce::FileOutputStream stream(temporary.getFile());
+        if (!stream.openedOk())
+            return;
+
+        stream.writeInt(indexFileVersion);
+        stream.writeInt(static_cast<int>(documents.size()));
+        for (const auto& document : documents)
+        {
+            stream.writeString(document.info.file.getFullPathName());
+            stream.writeInt64(document.modificationTime);
+            stream.writeInt64(document.fileSize);
+            stream.writeString(document.info.name);
+            stream.writeString(document.info.tags.joinIntoString("\n"));
+            stream.writeString(document.info.effectTypes.joinIntoString("\n"));
+
+            stream.writeInt(static_cast<int>(document.parameters.size()));
+            for (const auto& [key, value] : document.parameters)
+            {
+                stream.writeString(juce::String(key));
+                stream.writeFloat(value);
+            }
+        }
+    }
+
+    temporary.overwriteTargetFileWithTemporary();
+}
+
+std::vector<juce::uint32> PresetLibrary::findPrefix(const Index& index, const std::string& prefix)
+{
+    auto it = std::lower_bound(index.terms.begin(), index.terms.end(), prefix,
+                               [](const Term& term, const std::string& text) { return term.text < text; });
+
+    const auto isMatch = [&index, &prefix](std::vector<Term>::const_iterator term)
+    {
+        return term != index.terms.end() && term->text.compare(0, prefix.size(), prefix) == 0;
+    };
+
+    // 一致する語が1つならその転置リストをそのまま使う
+    if (!isMatch(it))
+        return {};
+    if (!isMatch(std::next(it)))
+        return it->postings;
+
+    // 複数なら文書数分のビット列に印を付けて集める（短い接頭辞で大量の語に一致しても整列しない）
+    std::vector<juce::uint64> bits((index.documents.size() + 63) / 64);
+    for (; isMatch(it); ++it)
+        for (auto id : it->postings)
+            bits[id >> 6] |= juce::uint64 { 1 } << (id & 63);
+
+    std::vector<juce::uint32> result;
+    for (size_t word = 0; word < bits.size(); ++word)
+        if (bits[word] != 0)
+            for (juce::uint32 bit = 0; bit < 64; ++bit)
+                if ((bits[word] >> bit) & 1)
+                    result.push_back(static_cast<juce::uint32>(word * 64) + bit);
+
+    return result;
+}
+
+PresetLibrary::RangeQuery PresetLibrary::parseRangeQuery(const juce::String& token)
+{
+    // "cutoff<800" → キー "cutoff"、演算子 "<"、値 800
+    const auto operatorStart = token.indexOfAnyOf("<>=");
+    const auto rest = token.substring(operatorStart);
+    const auto orEqual = rest.length() > 1 && rest[1] == '=';
+
+    RangeQuery range;
+    range.key = toKey(token.substring(0, operatorStart));
+    range.value = rest.substring(orEqual ? 2 : 1).getFloatValue();
+
+    switch (rest[0])
+    {
+        case '<': range.op = orEqual ? RangeQuery::lessOrEqual : RangeQuery::less; break;
+        case '>': range.op = orEqual ? RangeQuery::greaterOrEqual : RangeQuery::greater; break;
+        default:  range.op = RangeQuery::equal; break;
+    }
+    return range;
+}
+
+bool PresetLibrary::matchesKey(const std::string& name, const std::string& key)
+{
+    // "filter.cutoff" はそのまま、"cutoff" はどの種別の cutoff にも一致させる
+    if (key.empty())
+        return false;
+
+    return name == key
+        || (name.size() > key.size()
+            && name[name.size() - key.size() - 1] == '.'
+            && name.compare(name.size() - key.size(), key.size(), key) == 0);
+}
+
+bool PresetLibrary::matchesRange(const Document& document, const RangeQuery& range)
+{
+    for (const auto& [key, value] : document.parameters)
+    {
+        if (!matchesKey(key, range.key))
+            continue;
+
+        switch (range.op)
+        {
+            case RangeQuery::less:           if (value < range.value) return true; break;
+            case RangeQuery::lessOrEqual:    if (value <= range.value) return true; break;
+            case RangeQuery::greater:        if (value > range.value) return true; break;
+            case RangeQuery::greaterOrEqual: if (value >= range.value) return true; break;
+            case RangeQuery::equal:          if (value == range.value) return true; break;
+        }
+    }
+    return false;
+}
+
+std::vector<juce::uint32> PresetLibrary::findRange(const Index& index, const RangeQuery& range)
+{
+    std::vector<juce::uint32> result;
+
+    for (const auto& list : index.ranges)
+    {
+        if (!matchesKey(list.key, range.key))
+            continue;
+
+        const auto& entries = list.entries;
+        const auto byValue = [](const std::pair<float, juce::uint32>& entry, float v) { return entry.first < v; };
+        const auto valueBefore = [](float v, const std::pair<float, juce::uint32>& entry) { return v < entry.first; };
+
+        auto lower = entries.begin();
+        auto upper = entries.end();
+        switch (range.op)
+        {
+            case RangeQuery::less:           upper = std::lower_bound(entries.begin(), entries.end(), range.value, byValue); break;
+            case RangeQuery::lessOrEqual:    upper = std::upper_bound(entries.begin(), entries.end(), range.value, valueBefore); break;
+            case RangeQuery::greater:        lower = std::upper_bound(entries.begin(), entries.end(), range.value, valueBefore); break;
+            case RangeQuery::greaterOrEqual: lower = std::lower_bound(entries.begin(), entries.end(), range.value, byValue); break;
+            case RangeQuery::equal:
+                lower = std::lower_bound(entries.begin(), entries.end(), range.value, byValue);
+                upper = std::upper_bound(entries.begin(), entries.end(), range.value, valueBefore);
+                break;
+        }
+
+        for (auto it = lower; it < upper; ++it)
+            result.push_back(it->second);
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+std::vector<juce::uint32> PresetLibrary::intersect(const std::vector<juce::uint32>& a, const std::vector<juce::uint32>& b)
+{
+    std::vector<juce::uint32> result;
+    result.reserve(juce::jmin(a.size(), b.size()));
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
+
+PresetLibrary::IndexPtr PresetLibrary::getIndex() const
+{
+    const juce::SpinLock::ScopedLockType lock(indexLock);
+    return currentIndex;
+}
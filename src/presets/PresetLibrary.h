@@ -0,0 +1,117 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * プリセットディレクトリの検索サービス
+ * - バックグラウンドスレッドでディレクトリを走査し、名前・タグ・エフェクト種別の転置インデックスと
+ *   パラメータ値の範囲インデックスを作る
+ * - 文書（ファイルごとの解析結果）はディスクに保存し、次回は更新日時とサイズが変わったファイルだけを解析し直す
+ * - インデックスは不変なので、完成したものをポインタの差し替えで公開する（検索はロックを長く持たない）
+ * - インデックスが更新されると ChangeBroadcaster で通知する
+ *
+ * 検索クエリは空白区切りのトークンで、すべてを満たすプリセットを名前順に返す
+ * - "dusty"          名前・タグ・エフェクト種別の前方一致
+ * - "tag:lofi"       タグだけ / "type:delay" エフェクト種別だけ / "name:vox" 名前だけ
+ * - "cutoff<800"     パラメータ範囲（"filter.cutoff>=1000" のように種別で限定もできる。< <= > >= =）
+ */
+class PresetLibrary : public juce::ChangeBroadcaster,
+                      private juce::Thread
+{
+public:
+    struct PresetInfo
+    {
+        juce::File file;
+        juce::String name;
+        juce::StringArray tags;
+        juce::StringArray effectTypes;
+    };
+
+    PresetLibrary(const juce::File& presetDirectory, const juce::File& indexFile);
+    ~PresetLibrary() override;
+
+    // 差分スキャンを要求する（保存・削除の後など）。すぐに戻る
+    void rescan();
+
+    // 任意のスレッドから呼べる。maxResults 件までを名前順で返す
+    std::vector<PresetInfo> search(const juce::String& query, int maxResults = defaultMaxResults) const;
+
+    int getNumPresets() const;
+    bool isScanning() const { return rescanRequested.load() || scanInProgress.load(); }
+
+    static constexpr int defaultMaxResults = 256;
+    static constexpr int indexFileVersion = 1;
+
+private:
+    struct Document
+    {
+        PresetInfo info;
+        juce::int64 modificationTime = 0;
+        juce::int64 fileSize = 0;
+        std::vector<std::pair<std::string, float>> parameters; // "filter.cutoff" -> 値（キーは toKey 済み）
+    };
+
+    // 前方一致で引く語。フィールドを1文字目に埋め込んで1本のソート済み配列にまとめる
+    struct Term
+    {
+        std::string text;
+        std::vector<juce::uint32> postings; // 文書番号（昇順）
+    };
+
+    // パラメータ1種類分の (値, 文書番号) を値の昇順に並べたもの
+    struct RangeList
+    {
+        std::string key;
+        std::vector<std::pair<float, juce::uint32>> entries;
+    };
+
+    struct RangeQuery
+    {
+        enum Operator { less, lessOrEqual, greater, greaterOrEqual, equal };
+
+        std::string key;
+        Operator op = equal;
+        float value = 0.0f;
+    };
+
+    struct Index
+    {
+        std::vector<Document> documents; // 名前順
+        std::vector<Term> terms;         // text の昇順
+        std::vector<RangeList> ranges;   // key の昇順
+    };
+
+    using IndexPtr = std::shared_ptr<const Index>;
+
+    void run() override;
+    bool scan();
+
+    static bool parseDocument(const juce::File& file, Document& document);
+    static std::shared_ptr<Index> buildIndex(std::vector<Document> documents);
+    bool loadDocuments(std::vector<Document>& documents) const;
+    void saveDocuments(const std::vector<Document>& documents) const;
+
+    static std::vector<juce::uint32> findPrefix(const Index& index, const std::string& prefix);
+    static std::vector<juce::uint32> findRange(const Index& index, const RangeQuery& range);
+    static RangeQuery parseRangeQuery(const juce::String& token);
+    static bool matchesKey(const std::string& name, const std::string& key);
+    static bool matchesRange(const Document& document, const RangeQuery& range);
+    static std::vector<juce::uint32> intersect(const std::vector<juce::uint32>& a, const std::vector<juce::uint32>& b);
+
+    IndexPtr getIndex() const;
+
+    const juce::File directory;
+    const juce::File indexFile;
+
+    juce::SpinLock indexLock;
+    IndexPtr currentIndex;
+    std::atomic<bool> rescanRequested { false };
+    std::atomic<bool> scanInProgress { false };
+    bool documentsLoaded = false; // スキャンスレッド専用
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetLibrary)
+};
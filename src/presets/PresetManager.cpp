@@ -1,18 +1,20 @@
 #include "PresetManager.h"
-#include "../PluginProcessor.h"
 
 PresetManager::PresetManager(EffectChain& effectChainToUse)
-    : effectChain(effectChainToUse)
+    : effectChain(effectChainToUse),
+      library(getRootDirectory().getChildFile("Presets"), getRootDirectory().getChildFile("PresetIndex.bin"))
 {
     // プリセットディレクトリが存在しない場合は作成
     getPresetDirectory().createDirectory();
 }
 
-void PresetManager::savePreset(int index, const juce::String& name)
+void PresetManager::savePreset(int index, const juce::String& name, const juce::StringArray& tags)
 {
     // エフェクトチェーンの状態をXMLに保存
     auto state = std::make_unique<juce::XmlElement>("Preset");
     state->setAttribute("Name", name);
+    if (!tags.isEmpty())
+        state->setAttribute("Tags", tags.joinIntoString(","));
     effectChain.saveToXml(*state);
 
     // プリセットを保存
@@ -23,6 +25,8 @@ void PresetManager::savePreset(int index, const juce::String& name)
     auto file = getPresetFile(index);
     if (auto* xml = presets[index].state.get())
         xml->writeTo(file, {});
+
+    library.rescan();
 }
 
 void PresetManager::loadPreset(int index)
@@ -39,12 +43,20 @@ void PresetManager::loadPreset(int index)
     }
 }
 
+void PresetManager::loadPreset(const juce::File& file)
+{
+    // ブラウザで選ばれたファイル（インデックス番号を持たないプリセットも含む）
+    if (auto xml = juce::XmlDocument::parse(file))
+        effectChain.loadFromXml(*xml);
+}
+
 void PresetManager::deletePreset(int index)
 {
     if (presetExists(index))
     {
         presets.erase(index);
         getPresetFile(index).deleteFile();
+        library.rescan();
     }
 }
 
@@ -65,6 +77,13 @@ int PresetManager::getNumPresets() const
     return static_cast<int>(presets.size());
 }
 
+const juce::XmlElement* PresetManager::getPresetState(int index) const
+{
+    if (auto it = presets.find(index); it != presets.end())
+        return it->second.state.get();
+    return nullptr;
+}
+
 void PresetManager::saveToXml(juce::XmlElement& xml) const
 {
     auto* presetsXml = xml.createNewChildElement("Presets");
@@ -104,9 +123,7 @@ void PresetManager::loadFromXml(const juce::XmlElement& xml)
 
 juce::File PresetManager::getPresetDirectory() const
 {
-    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-        .getChildFile("SP404MKIIClone")
-        .getChildFile("Presets");
+    return getRootDirectory().getChildFile("Presets");
 }
 
 juce::File PresetManager::getPresetFile(int index) const
@@ -2,6 +2,8 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "../EffectChain.h"
+#include "PresetLibrary.h"
+#include <map>
 
 class PresetManager
 {
@@ -9,17 +11,31 @@ public:
     PresetManager(EffectChain& effectChainToUse);
     ~PresetManager() = default;
 
-    void savePreset(int index, const juce::String& name);
+    void savePreset(int index, const juce::String& name, const juce::StringArray& tags = {});
     void loadPreset(int index);
+    void loadPreset(const juce::File& file);
     void deletePreset(int index);
 
     bool presetExists(int index) const;
     juce::String getPresetName(int index) const;
     int getNumPresets() const;
 
+    // 保存済みプリセットの状態（モーフィングの展開用）。なければ nullptr
+    const juce::XmlElement* getPresetState(int index) const;
+
     void saveToXml(juce::XmlElement& xml) const;
     void loadFromXml(const juce::XmlElement& xml);
 
+    // プリセットディレクトリ全体の検索（ブラウザ用）
+    PresetLibrary& getLibrary() { return library; }
+
+    // ユーザーデータのルート（Presets / SampleCache などはこの下に置く）
+    static juce::File getRootDirectory()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile("SP404MKIIClone");
+    }
+
 private:
     struct Preset
     {
@@ -29,6 +45,7 @@ private:
 
     EffectChain& effectChain;
     std::map<int, Preset> presets;
+    PresetLibrary library;
 
     juce::File getPresetDirectory() const;
     juce::File getPresetFile(int index) const;
@@ -0,0 +1,213 @@
+#include "PresetMorpher.h"
+#include "../EffectChain.h"
+
+const juce::String PresetMorpher::xParameterId { "morphX" };
+const juce::String PresetMorpher::yParameterId { "morphY" };
+
+namespace
+{
+    // TypeId を優先し、古いプリセットは Type 文字列から解決する（EffectChain::loadFromXml と同じ規則）
+    EffectTypeId resolveTypeId(const juce::XmlElement& effectElement)
+    {
+        const auto& registry = EffectRegistry::getInstance();
+        auto typeId = static_cast<EffectTypeId>(effectElement.getIntAttribute("TypeId", 0));
+        if (!registry.isRegistered(typeId))
+            typeId = registry.findTypeId(effectElement.getStringAttribute("Type"));
+        return typeId;
+    }
+
+    // 同じ種別の occurrence 番目のエフェクト要素（構成の違うプリセットでも種別ごとの並びで対応させる）
+    const juce::XmlElement* findEffectElement(const juce::XmlElement& preset, EffectTypeId typeId, int occurrence)
+    {
+        forEachXmlChildElementWithTagName(preset, effectElement, "Effect")
+            if (resolveTypeId(*effectElement) == typeId && occurrence-- == 0)
+                return effectElement;
+
+        return nullptr;
+    }
+}
+
+void PresetMorpher::addParametersTo(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    auto group = std::make_unique<juce::AudioProcessorParameterGroup>("morph", "Morph", "|");
+
+    auto x = std::make_unique<juce::AudioParameterFloat>(xParameterId, "Morph X", 0.0f, 1.0f, 0.0f);
+    auto y = std::make_unique<juce::AudioParameterFloat>(yParameterId, "Morph Y", 0.0f, 1.0f, 0.0f);
+    xParameter = x.get();
+    yParameter = y.get();
+    group->addChild(std::move(x));
+    group->addChild(std::move(y));
+
+    layout.add(std::move(group));
+}
+
+void PresetMorpher::prepare(double sampleRate)
+{
+    smoothedX.reset(sampleRate, 0.02);
+    smoothedY.reset(sampleRate, 0.02);
+    smoothedX.setCurrentAndTargetValue(xParameter != nullptr ? xParameter->get() : 0.0f);
+    smoothedY.setCurrentAndTargetValue(yParameter != nullptr ? yParameter->get() : 0.0f);
+    tableChanged = true;
+}
+
+bool PresetMorpher::setPresets(EffectChain& chain, const juce::Array<const juce::XmlElement*>& presets)
+{
+    const int count = presets.size();
+    if (count != 2 && count != maxCorners)
+        return false;
+
+    for (auto* preset : presets)
+        if (preset == nullptr)
+            return false;
+
+    // 最初のプリセットがエフェクト構成を決める
+    chain.loadFromXml(*presets.getFirst());
+
+    auto& table = tables[static_cast<size_t>(backTable)];
+    table.effectPositions.clear();
+    table.instanceIds.clear();
+    table.parameterIndices.clear();
+    for (auto& corner : table.corners)
+        corner.clear();
+
+    auto& effectPool = chain.getEffectPool();
+    std::array<float, maxCorners> values {};
+
+    for (int position = 0; position < chain.getNumEffects(); ++position)
+    {
+        auto* effect = chain.getEffect(position);
+        const auto typeId = effect->getTypeId();
+
+        int occurrence = 0;
+        for (int i = 0; i < position; ++i)
+            if (chain.getEffect(i)->getTypeId() == typeId)
+                ++occurrence;
+
+        // 各コーナーのエフェクトを一度だけ展開する（プリセットにない場合は最初のプリセットの値のまま）
+        std::array<std::unique_ptr<Effect>, maxCorners> decoded;
+        for (int corner = 1; corner < count; ++corner)
+        {
+            if (auto* element = findEffectElement(*presets[corner], typeId, occurrence))
+            {
+                decoded[static_cast<size_t>(corner)] = effectPool.acquire(typeId);
+                if (decoded[static_cast<size_t>(corner)] != nullptr)
+                    decoded[static_cast<size_t>(corner)]->loadFromXml(*element);
+            }
+        }
+
+        for (int p = 0; p < effect->getNumParameters(); ++p)
+        {
+            bool varies = false;
+            for (int corner = 0; corner < count; ++corner)
+            {
+                const auto* source = decoded[static_cast<size_t>(corner)] != nullptr ? decoded[static_cast<size_t>(corner)].get() : effect;
+                values[static_cast<size_t>(corner)] = source->getParameter(p);
+                varies = varies || values[static_cast<size_t>(corner)] != values[0];
+            }
+
+            // どのコーナーでも同じ値のパラメータはモーフしても変わらないので対象にしない
+            if (!varies)
+                continue;
+
+            table.effectPositions.push_back(position);
+            table.instanceIds.push_back(effect->getInstanceId());
+            table.parameterIndices.push_back(p);
+            for (int corner = 0; corner < count; ++corner)
+                table.corners[static_cast<size_t>(corner)].push_back(values[static_cast<size_t>(corner)]);
+        }
+
+        for (auto& scratch : decoded)
+            effectPool.release(std::move(scratch));
+    }
+
+    table.output.assign(table.parameterIndices.size(), 0.0f);
+    table.numCorners = count;
+    publishTable();
+
+    numCorners = count;
+    return true;
+}
+
+void PresetMorpher::clear()
+{
+    auto& table = tables[static_cast<size_t>(backTable)];
+    table.numCorners = 0;
+    table.effectPositions.clear();
+    table.instanceIds.clear();
+    table.parameterIndices.clear();
+    for (auto& corner : table.corners)
+        corner.clear();
+    table.output.clear();
+    publishTable();
+
+    numCorners = 0;
+}
+
+void PresetMorpher::publishTable()
+{
+    backTable = sharedTable.exchange(backTable | newTableFlag, std::memory_order_acq_rel) & tableIndexMask;
+}
+
+void PresetMorpher::process(Effect* const* effects, int numEffects, int numSamples)
+{
+    if ((sharedTable.load(std::memory_order_relaxed) & newTableFlag) != 0)
+    {
+        audioTable = sharedTable.exchange(audioTable, std::memory_order_acq_rel) & tableIndexMask;
+        tableChanged = true;
+    }
+
+    auto& table = tables[static_cast<size_t>(audioTable)];
+    if (table.numCorners == 0 || xParameter == nullptr || yParameter == nullptr)
+        return;
+
+    smoothedX.setTargetValue(xParameter->get());
+    smoothedY.setTargetValue(yParameter->get());
+
+    // 位置が止まっていれば静的なパラメータと同じく何もしない
+    if (!tableChanged && !smoothedX.isSmoothing() && !smoothedY.isSmoothing())
+        return;
+
+    tableChanged = false;
+
+    // ブロック末尾の位置を目標にする（サンプル単位の補間は各エフェクトのスムージングが受け持つ）
+    const float x = smoothedX.skip(numSamples);
+    const float y = smoothedY.skip(numSamples);
+
+    std::array<float, maxCorners> weights {};
+    if (table.numCorners == maxCorners)
+    {
+        weights = { (1.0f - x) * (1.0f - y), x * (1.0f - y), (1.0f - x) * y, x * y };
+    }
+    else
+    {
+        weights[0] = 1.0f - x;
+        weights[1] = x;
+    }
+
+    const int numTargets = static_cast<int>(table.output.size());
+    auto* output = table.output.data();
+    juce::FloatVectorOperations::copyWithMultiply(output, table.corners[0].data(), weights[0], numTargets);
+    for (int corner = 1; corner < table.numCorners; ++corner)
+        juce::FloatVectorOperations::addWithMultiply(output, table.corners[static_cast<size_t>(corner)].data(),
+                                                     weights[static_cast<size_t>(corner)], numTargets);
+
+    for (int i = 0; i < numTargets; ++i)
+    {
+        const auto index = static_cast<size_t>(i);
+        if (auto* effect = findEffect(effects, numEffects, table.effectPositions[index], table.instanceIds[index]))
+            effect->setParameter(table.parameterIndices[index], output[i]);
+    }
+}
+
+Effect* PresetMorpher::findEffect(Effect* const* effects, int numEffects, int position, juce::uint32 instanceId)
+{
+    // 通常は展開時と同じ位置にある。並べ替えられていればインスタンス識別子で探す（削除されていれば対象外）
+    if (position < numEffects && effects[position]->getInstanceId() == instanceId)
+        return effects[position];
+
+    for (int i = 0; i < numEffects; ++i)
+        if (effects[i]->getInstanceId() == instanceId)
+            return effects[i];
+
+    return nullptr;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../audio/effects/Effect.h"
+#include <array>
+#include <atomic>
+#include <vector>
+
+class EffectChain;
+
+/**
+ * 保存済みプリセット間のリアルタイムモーフィング
+ * - 2つ（クロスフェーダー: X のみ）または4つ（XYパッド: 双線形）のプリセットを、設定時に
+ *   チェーンのパラメータ並びと同じ平坦な値の配列へ展開しておく（オーディオスレッドではXMLを扱わない）
+ * - コーナー間で値が異なるパラメータだけを対象にし、1ステップは重み付き和のベクトル演算で求める
+ * - 求めた値はエフェクトの setParameter へ渡し、各エフェクトのスムージングで滑らかに追従させる
+ * - モーフ位置はホストパラメータ（"morphX" / "morphY"）で、位置が動いていないブロックでは何もしない
+ * - 展開済みのテーブルはトリプルバッファでオーディオスレッドへ渡す
+ */
+class PresetMorpher
+{
+public:
+    static constexpr int maxCorners = 4;
+
+    PresetMorpher() = default;
+
+    // APVTSのレイアウトにモーフ位置のパラメータを追加する（プロセッサーの構築時に1回だけ）
+    void addParametersTo(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
+
+    // ===== メッセージスレッド =====
+    // presets[0] をチェーンへ読み込み、残りをそのエフェクト構成に合わせて展開する。
+    // 2つなら X だけのクロスフェード、4つなら (0,0) (1,0) (0,1) (1,1) の順の XY モーフ
+    bool setPresets(EffectChain& chain, const juce::Array<const juce::XmlElement*>& presets);
+    void clear();
+
+    int getNumCorners() const { return numCorners; }
+
+    // モーフ位置のホストパラメータ（addParametersTo の後で有効）
+    juce::AudioParameterFloat* getXParameter() const { return xParameter; }
+    juce::AudioParameterFloat* getYParameter() const { return yParameter; }
+
+    // ===== オーディオスレッド =====
+    // 処理順序のエフェクトへモーフ位置の値を反映する（EffectChain::process から呼ばれる）
+    void process(Effect* const* effects, int numEffects, int numSamples);
+
+    void prepare(double sampleRate);
+
+    static const juce::String xParameterId;
+    static const juce::String yParameterId;
+
+private:
+    // モーフ対象のパラメータを平坦に並べたもの（すべての配列は同じ長さ）
+    struct MorphTable
+    {
+        int numCorners = 0; // 0 ならモーフしない
+        std::vector<int> effectPositions;
+        std::vector<juce::uint32> instanceIds;
+        std::vector<int> parameterIndices;
+        std::array<std::vector<float>, maxCorners> corners;
+        std::vector<float> output; // オーディオスレッドの作業領域
+    };
+
+    void publishTable();
+    static Effect* findEffect(Effect* const* effects, int numEffects, int position, juce::uint32 instanceId);
+
+    juce::AudioParameterFloat* xParameter = nullptr;
+    juce::AudioParameterFloat* yParameter = nullptr;
+    int numCorners = 0; // メッセージスレッド専用
+
+    // トリプルバッファ: sharedTable の下位ビットが添字、newTableFlag が未取得のテーブルがあることを示す
+    static constexpr int newTableFlag = 4;
+    static constexpr int tableIndexMask = 3;
+    std::array<MorphTable, 3> tables;
+    std::atomic<int> sharedTable { 1 };
+    int audioTable = 0;  // オーディオスレッド専用
+    int backTable = 2;   // メッセージスレッド専用
+
+    // オーディオスレッド専用
+    juce::SmoothedValue<float> smoothedX;
+    juce::SmoothedValue<float> smoothedY;
+    bool tableChanged = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetMorpher)
+};
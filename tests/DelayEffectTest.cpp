@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/effects/DelayEffect.h"
+
+TEST_CASE("DelayEffect basic functionality", "[delay]")
+{
+    DelayEffect delay;
+
+    SECTION("Default parameters")
+    {
+        CHECK(delay.getParameter(0) == Approx(250.0f)); // Time
+        CHECK(delay.getParameter(1) == Approx(0.4f));   // Feedback
+        CHECK(delay.getParameter(2) == Approx(0.5f));   // Mix
+        CHECK(delay.getParameter(3) == Approx(0.0f));   // Interpolation
+    }
+
+    SECTION("Impulse is delayed and fed back")
+    {
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = 48000.0;
+        spec.maximumBlockSize = 128;
+        spec.numChannels = 2;
+
+        for (int mode = 0; mode < 3; ++mode)
+        {
+            delay.setParameter(0, 10.0f);  // 480 samples
+            delay.setParameter(1, 0.5f);
+            delay.setParameter(2, 1.0f);   // Wet only
+            delay.setParameter(3, static_cast<float>(mode));
+            delay.prepare(spec);
+
+            // ホストのブロックサイズと揃わない長さで処理してもタイミングがずれないこと
+            std::vector<float> output;
+            for (int block = 0; block < 12; ++block)
+            {
+                juce::AudioBuffer<float> buffer(2, 100);
+                buffer.clear();
+                if (block == 0)
+                {
+                    buffer.setSample(0, 0, 1.0f);
+                    buffer.setSample(1, 0, 1.0f);
+                }
+                delay.process(buffer);
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    output.push_back(buffer.getSample(0, i));
+            }
+
+            CHECK(output[480] == Approx(1.0f).margin(0.01f));
+            CHECK(output[960] == Approx(0.5f).margin(0.01f));
+            CHECK(std::abs(output[479]) < 0.01f);
+            CHECK(std::abs(output[700]) < 0.01f);
+        }
+    }
+}
+
+TEST_CASE("DelayEffect XML serialization", "[delay]")
+{
+    DelayEffect delay;
+    delay.setParameter(0, 375.0f);
+    delay.setParameter(1, 0.7f);
+    delay.setParameter(2, 0.25f);
+    delay.setParameter(3, 1.0f);
+
+    juce::XmlElement xml("TestDelay");
+    delay.saveToXml(xml);
+
+    DelayEffect loadedDelay;
+    loadedDelay.loadFromXml(xml);
+
+    CHECK(loadedDelay.getParameter(0) == Approx(375.0f));
+    CHECK(loadedDelay.getParameter(1) == Approx(0.7f));
+    CHECK(loadedDelay.getParameter(2) == Approx(0.25f));
+    CHECK(loadedDelay.getParameter(3) == Approx(1.0f));
+}
@@ -0,0 +1,162 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/effects/DistortionEffect.h"
+#include <complex>
+
+namespace
+{
+    double evaluateAt(const DistortionEffect& distortion, double x, int level)
+    {
+        double result = 0.0;
+        distortion.evaluate(&x, &result, 1, level);
+        return result;
+    }
+
+    // level - 1 の関数を a から b まで中点則で積分する
+    double integrate(const DistortionEffect& distortion, double a, double b, int level)
+    {
+        constexpr int numSteps = 20000;
+        const double h = (b - a) / numSteps;
+        std::vector<double> x(numSteps), y(numSteps);
+        for (int i = 0; i < numSteps; ++i)
+            x[static_cast<size_t>(i)] = a + (i + 0.5) * h;
+
+        distortion.evaluate(x.data(), y.data(), numSteps, level - 1);
+
+        double sum = 0.0;
+        for (const double value : y)
+            sum += value;
+        return sum * h;
+    }
+
+    // 入力と同じ長さの出力を返す（ドライブ 0dB、ウェットのみ）
+    std::vector<float> processSignal(DistortionEffect::Shape shape, int order, float driveDb, const std::vector<float>& signal)
+    {
+        DistortionEffect distortion;
+        distortion.setParameter(0, driveDb);
+        distortion.setParameter(1, 1.0f);
+        distortion.setParameter(2, static_cast<float>(shape));
+        distortion.setParameter(3, static_cast<float>(order));
+        distortion.prepare({ 44100.0, 256, 1 });
+
+        std::vector<float> output;
+        for (size_t start = 0; start < signal.size(); start += 256)
+        {
+            const int length = static_cast<int>(std::min<size_t>(256, signal.size() - start));
+            juce::AudioBuffer<float> buffer(1, length);
+            for (int i = 0; i < length; ++i)
+                buffer.setSample(0, i, signal[start + static_cast<size_t>(i)]);
+
+            distortion.process(buffer);
+            for (int i = 0; i < length; ++i)
+                output.push_back(buffer.getSample(0, i));
+        }
+        return output;
+    }
+}
+
+TEST_CASE("DistortionEffect antiderivatives integrate their shapers", "[distortion]")
+{
+    using Shape = DistortionEffect::Shape;
+
+    for (const auto shape : { Shape::tanh, Shape::softClip, Shape::foldback, Shape::bitCrush })
+    {
+        DistortionEffect distortion;
+        distortion.setParameter(2, static_cast<float>(shape));
+        distortion.setParameter(4, 4.0f);
+
+        // 飽和する範囲の外と、フォールドバックのテーブル1周期より遥かに外も含める
+        const std::vector<std::pair<double, double>> intervals {
+            { -0.3, 0.7 }, { -3.0, 2.5 }, { 0.9, 14.0 }, { 120.0, 127.0 }, { -260.0, -250.5 }
+        };
+
+        for (const auto& [a, b] : intervals)
+            for (int level = 1; level <= 2; ++level)
+            {
+                const double expected = integrate(distortion, a, b, level);
+                const double actual = evaluateAt(distortion, b, level) - evaluateAt(distortion, a, level);
+                CHECK(actual == Approx(expected).margin(2.0e-4 * (b - a)));
+            }
+    }
+}
+
+TEST_CASE("DistortionEffect foldback keeps folding at any drive", "[distortion]")
+{
+    DistortionEffect distortion;
+    distortion.setParameter(2, static_cast<float>(DistortionEffect::Shape::foldback));
+
+    // f = sin(πx/2) はどれだけ大きな引数でも ±1 の間を往復する
+    for (const double x : { 0.5, 63.0, 64.5, 65.0, 200.25, -1001.0 })
+        CHECK(evaluateAt(distortion, x, 0) == Approx(std::sin(juce::MathConstants<double>::halfPi * x)).margin(1.0e-6));
+}
+
+TEST_CASE("DistortionEffect ADAA fallback is continuous", "[distortion]")
+{
+    using Shape = DistortionEffect::Shape;
+
+    // 1サンプルあたりの増分を、中点評価に切り替わるしきい値 (1e-5) の前後でゆっくり変える
+    std::vector<float> ramp;
+    double x = 0.2;
+    for (int i = 0; i < 2048; ++i)
+    {
+        x += 0.2e-5 + 2.0e-5 * i / 2048.0;
+        ramp.push_back(static_cast<float>(x));
+    }
+
+    for (const auto shape : { Shape::tanh, Shape::softClip, Shape::foldback })
+        for (int order = 1; order <= 2; ++order)
+        {
+            const auto output = processSignal(shape, order, 0.0f, ramp);
+
+            // 出力の増分は入力の増分 × 傾き（最大でも π/2 倍）を超えて跳ばない。
+            // 先頭は履歴の 0 からの立ち上がりなので除く
+            double largestStep = 0.0;
+            for (size_t i = 4; i < output.size(); ++i)
+                largestStep = std::max(largestStep, static_cast<double>(std::abs(output[i] - output[i - 1])));
+
+            CHECK(largestStep < 5.0e-5);
+        }
+}
+
+TEST_CASE("DistortionEffect ADAA reduces aliasing", "[distortion]")
+{
+    using Shape = DistortionEffect::Shape;
+
+    // 5kHz 付近の正弦波をビンにちょうど乗せ、高調波と折り返しを DFT のビンで分ける
+    constexpr int fftSize = 2048;
+    constexpr int bin = 233;
+    constexpr int warmUp = 4096;
+
+    std::vector<float> sine;
+    for (int i = 0; i < warmUp + fftSize; ++i)
+        sine.push_back(0.8f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * bin * i / fftSize)));
+
+    // 本来の高調波（ナイキスト未満の bin の整数倍）以外に落ちた電力
+    auto measureAliasing = [&](Shape shape, int order)
+    {
+        const auto output = processSignal(shape, order, 18.0f, sine);
+
+        double aliasPower = 0.0;
+        for (int k = 1; k < fftSize / 2; ++k)
+        {
+            if (k % bin == 0)
+                continue;
+
+            std::complex<double> sum;
+            for (int n = 0; n < fftSize; ++n)
+                sum += static_cast<double>(output[static_cast<size_t>(warmUp + n)])
+                     * std::polar(1.0, -juce::MathConstants<double>::twoPi * k * n / fftSize);
+            aliasPower += std::norm(sum);
+        }
+        return 10.0 * std::log10(aliasPower);
+    };
+
+    for (const auto shape : { Shape::tanh, Shape::softClip, Shape::foldback })
+    {
+        const double off = measureAliasing(shape, 0);
+        const double firstOrder = measureAliasing(shape, 1);
+        const double secondOrder = measureAliasing(shape, 2);
+
+        CHECK(firstOrder < off - 6.0);
+        CHECK(secondOrder < firstOrder);
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+#include "../src/EffectChain.h"
+
+namespace
+{
+    void processImpulse(EffectChain& chain)
+    {
+        juce::AudioBuffer<float> buffer(2, 512);
+        buffer.clear();
+        buffer.setSample(0, 0, 1.0f);
+        buffer.setSample(1, 0, 1.0f);
+        chain.process(buffer);
+    }
+}
+
+TEST_CASE("DspArena carves aligned regions in request order", "[arena]")
+{
+    DspArena::Allocator measure;
+    CHECK(measure.allocate<float>(3) == nullptr);
+    CHECK(measure.allocate<double>(5) == nullptr);
+    REQUIRE(measure.getBytesUsed() == 2 * DspArena::alignment);
+
+    DspArena arena;
+    arena.allocate(measure.getBytesUsed());
+    REQUIRE(arena.getSize() == measure.getBytesUsed());
+    CHECK(reinterpret_cast<juce::pointer_sized_uint>(arena.getData()) % DspArena::alignment == 0);
+
+    DspArena::Allocator allocator(arena.getData());
+    auto* first = allocator.allocate<float>(3);
+    auto* second = allocator.allocate<double>(5);
+    CHECK(reinterpret_cast<char*>(first) == arena.getData());
+    CHECK(reinterpret_cast<char*>(second) == arena.getData() + DspArena::alignment);
+}
+
+TEST_CASE("EffectChain packs effect state into one arena", "[arena]")
+{
+    EffectChain chain;
+    chain.addEffect(EffectTypeId::filter);
+    chain.addEffect(EffectTypeId::delay);
+    chain.addEffect(EffectTypeId::distortion);
+    chain.prepare({ 48000.0, 512, 2 });
+
+    SECTION("The arena holds exactly the chain's state in processing order")
+    {
+        REQUIRE(chain.getStateBytes() > 0);
+        CHECK(chain.getArenaBytes() == chain.getStateBytes());
+
+        for (int i = 0; i < chain.getNumEffects(); ++i)
+        {
+            CHECK_FALSE(chain.getEffect(i)->ownsStateMemory());
+            CHECK(chain.getEffect(i)->getStateBytes() % DspArena::alignment == 0);
+        }
+    }
+
+    SECTION("Reset clears the delay line through the arena")
+    {
+        processImpulse(chain);
+        chain.reset();
+
+        juce::AudioBuffer<float> buffer(2, 48000);
+        buffer.clear();
+        chain.process(buffer);
+
+        float peak = 0.0f;
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            peak = juce::jmax(peak, std::abs(buffer.getSample(0, i)));
+        CHECK(peak == 0.0f);
+    }
+
+    SECTION("Effects added later own their state until the next prepare")
+    {
+        auto* added = chain.addEffect(EffectTypeId::filter);
+        REQUIRE(added != nullptr);
+        CHECK(added->ownsStateMemory());
+        CHECK(chain.getArenaBytes() < chain.getStateBytes());
+
+        chain.prepare({ 48000.0, 512, 2 });
+        CHECK_FALSE(added->ownsStateMemory());
+        CHECK(chain.getArenaBytes() == chain.getStateBytes());
+    }
+}
@@ -0,0 +1,158 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/kernels/DspKernels.h"
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace
+{
+    using InstructionSet = DspKernels::InstructionSet;
+
+    // この CPU で動く変種（ベースラインを含む）
+    std::vector<const DspKernels*> getAvailableKernels()
+    {
+        std::vector<const DspKernels*> available;
+        for (auto instructionSet : { InstructionSet::generic, InstructionSet::sse2, InstructionSet::neon,
+                                     InstructionSet::avx2, InstructionSet::avx512 })
+            if (const auto* kernels = DspKernels::find(instructionSet))
+                available.push_back(kernels);
+
+        return available;
+    }
+
+    std::vector<float> makeNoise(int numSamples, juce::Random& random)
+    {
+        std::vector<float> samples(static_cast<size_t>(numSamples));
+        for (auto& sample : samples)
+            sample = random.nextFloat() * 2.0f - 1.0f;
+        return samples;
+    }
+}
+
+TEST_CASE("DspKernels selects a variant the CPU supports", "[kernels]")
+{
+    const auto available = getAvailableKernels();
+    REQUIRE_FALSE(available.empty());
+    CHECK(available.front() == &DspKernels::getBaseline());
+
+    // 最も広い変種が選ばれ、何度呼んでも同じ表が返る
+    const auto& best = DspKernels::getBest();
+    CHECK(&best == available.back());
+    CHECK(&best == &DspKernels::getBest());
+    CHECK(juce::String(DspKernels::getName(best.instructionSet)).isNotEmpty());
+}
+
+TEST_CASE("Every DspKernels variant matches the baseline", "[kernels]")
+{
+    const auto& baseline = DspKernels::getBaseline();
+    juce::Random random(7);
+
+    // レーン数で割り切れない長さと、端数だけの長さも試す
+    for (const int numSamples : { 0, 1, 7, 64, 131 })
+    {
+        const auto input = makeNoise(numSamples, random);
+        const auto other = makeNoise(numSamples, random);
+        const auto gains = makeNoise(numSamples, random);
+        const auto otherGains = makeNoise(numSamples, random);
+
+        float expectedPeak = 0.0f;
+        float expectedSum = 0.0f;
+        baseline.measure(input.data(), numSamples, &expectedPeak, &expectedSum);
+
+        auto expectedMix = input;
+        baseline.mixWithGains(expectedMix.data(), gains.data(), other.data(), otherGains.data(), numSamples);
+        auto expectedAdd = input;
+        baseline.addWithGain(expectedAdd.data(), other.data(), 0.3f, numSamples);
+
+        for (const auto* kernels : getAvailableKernels())
+        {
+            INFO(DspKernels::getName(kernels->instructionSet) << ", " << numSamples << " samples");
+
+            float peak = -1.0f;
+            float sum = -1.0f;
+            kernels->measure(input.data(), numSamples, &peak, &sum);
+            CHECK(peak == expectedPeak);
+            CHECK(sum == Approx(expectedSum).epsilon(1.0e-5).margin(1.0e-6));
+
+            auto mixed = input;
+            kernels->mixWithGains(mixed.data(), gains.data(), other.data(), otherGains.data(), numSamples);
+            auto added = input;
+            kernels->addWithGain(added.data(), other.data(), 0.3f, numSamples);
+            auto copied = input;
+            kernels->copyWithGain(copied.data(), copied.data(), -0.5f, numSamples);
+
+            for (size_t i = 0; i < static_cast<size_t>(numSamples); ++i)
+            {
+                CHECK(mixed[i] == Approx(expectedMix[i]).margin(1.0e-6));
+                CHECK(added[i] == Approx(expectedAdd[i]).margin(1.0e-6));
+                CHECK(copied[i] == input[i] * -0.5f);
+            }
+        }
+    }
+}
+
+TEST_CASE("Every state variable filter variant matches the baseline", "[kernels][filter]")
+{
+    constexpr int numSamples = 200;
+    const auto& baseline = DspKernels::getBaseline();
+    juce::Random random(11);
+
+    // サンプルごとの係数（カットオフ 200Hz〜8kHz を 48kHz で）
+    std::vector<float> g(numSamples), h(numSamples);
+    const float R2 = 1.0f / 0.7f;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float frequency = 200.0f * std::pow(40.0f, static_cast<float>(i) / numSamples);
+        g[static_cast<size_t>(i)] = std::tan(juce::MathConstants<float>::pi * frequency / 48000.0f);
+        h[static_cast<size_t>(i)] = 1.0f / (1.0f + R2 * g[static_cast<size_t>(i)] + g[static_cast<size_t>(i)] * g[static_cast<size_t>(i)]);
+    }
+
+    // モノ、ステレオ、7.1.4 と、どのレーン数でも端数が出るチャンネル数
+    for (const int numChannels : { 1, 2, 12, 17 })
+    {
+        std::vector<std::vector<float>> input;
+        std::vector<float> initialStates;
+        for (int ch = 0; ch < numChannels; ++ch)
+            input.push_back(makeNoise(numSamples, random));
+        for (int i = 0; i < numChannels * 2; ++i)
+            initialStates.push_back(random.nextFloat() * 0.2f - 0.1f);
+
+        for (const int stride : { 0, 1 })
+        {
+            auto run = [&](const DspKernels& kernels, std::vector<std::vector<float>>& channels, std::vector<float>& states)
+            {
+                channels = input;
+                states = initialStates;
+                std::vector<float*> pointers;
+                for (auto& channel : channels)
+                    pointers.push_back(channel.data());
+
+                // 2回に分けて呼び、状態の引き継ぎも確かめる
+                kernels.stateVariableLowpass(pointers.data(), numChannels, 50, states.data(), g.data(), h.data(), stride, R2);
+                for (auto& pointer : pointers)
+                    pointer += 50;
+                kernels.stateVariableLowpass(pointers.data(), numChannels, numSamples - 50, states.data(),
+                                             g.data() + 50 * stride, h.data() + 50 * stride, stride, R2);
+            };
+
+            std::vector<std::vector<float>> expected;
+            std::vector<float> expectedStates;
+            run(baseline, expected, expectedStates);
+
+            for (const auto* kernels : getAvailableKernels())
+            {
+                INFO(DspKernels::getName(kernels->instructionSet) << ", " << numChannels << " channels, stride " << stride);
+
+                std::vector<std::vector<float>> output;
+                std::vector<float> states;
+                run(*kernels, output, states);
+
+                for (size_t ch = 0; ch < static_cast<size_t>(numChannels); ++ch)
+                    for (size_t i = 0; i < static_cast<size_t>(numSamples); ++i)
+                        CHECK(output[ch][i] == Approx(expected[ch][i]).margin(1.0e-5));
+
+                for (size_t i = 0; i < states.size(); ++i)
+                    CHECK(states[i] == Approx(expectedStates[i]).margin(1.0e-5));
+            }
+        }
+    }
+}
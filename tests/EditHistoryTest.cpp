@@ -0,0 +1,125 @@
+#include <catch2/catch.hpp>
+#include "../src/core/EditHistory.h"
+
+TEST_CASE("EditHistory undoes chain and parameter edits through shared snapshots", "[history]")
+{
+    EffectChain chain;
+    EditHistory history(chain);
+
+    auto* filter = chain.addEffect(EffectTypeId::filter);
+    history.commit();
+    chain.addEffect(EffectTypeId::delay);
+    history.commit();
+
+    REQUIRE(filter != nullptr);
+    REQUIRE(history.getNumSteps() == 3);
+
+    SECTION("Unchanged effects share their state with the previous snapshot")
+    {
+        auto before = chain.createSnapshot(nullptr);
+        filter->setParameter(0, 500.0f);
+        auto after = chain.createSnapshot(before.get());
+
+        REQUIRE(after->effects.size() == 2);
+        CHECK(after->effects[0] != before->effects[0]);
+        CHECK(after->effects[1] == before->effects[1]);
+    }
+
+    SECTION("Committing an unchanged state adds no step")
+    {
+        history.commit();
+        CHECK(history.getNumSteps() == 3);
+    }
+
+    SECTION("Undo and redo reuse the live instances")
+    {
+        filter->setParameter(0, 500.0f);
+        history.commit();
+
+        REQUIRE(history.undo());
+        CHECK(chain.getEffect(0) == filter);
+        CHECK(filter->getParameter(0) == Approx(1000.0f));
+
+        REQUIRE(history.undo());
+        CHECK(chain.getNumEffects() == 1);
+        CHECK(chain.getEffect(0) == filter);
+
+        REQUIRE(history.redo());
+        REQUIRE(chain.getNumEffects() == 2);
+        CHECK(chain.getEffect(1)->getTypeId() == EffectTypeId::delay);
+
+        REQUIRE(history.redo());
+        CHECK(filter->getParameter(0) == Approx(500.0f));
+        CHECK_FALSE(history.canRedo());
+    }
+
+    SECTION("A new edit discards the redo steps")
+    {
+        REQUIRE(history.undo());
+        chain.moveEffect(0, 0);
+        filter->setParameter(1, 2.0f);
+        history.commit();
+
+        CHECK_FALSE(history.canRedo());
+        CHECK(history.getNumSteps() == 3);
+    }
+}
+
+TEST_CASE("EditHistory records and restores routing edits", "[history]")
+{
+    EffectChain chain;
+    EditHistory history(chain);
+
+    auto* filter = chain.addEffect(EffectTypeId::filter);
+    auto* delay = chain.addEffect(EffectTypeId::delay);
+    REQUIRE(filter != nullptr);
+    REQUIRE(delay != nullptr);
+
+    // フィルターとディレイを並列にした状態を起点にする
+    REQUIRE(chain.addConnection({ EffectChain::inputNodeId, filter->getInstanceId(), 1.0f }));
+    REQUIRE(chain.addConnection({ EffectChain::inputNodeId, delay->getInstanceId(), 1.0f }));
+    REQUIRE(chain.addConnection({ filter->getInstanceId(), EffectChain::outputNodeId, 0.5f }));
+    REQUIRE(chain.addConnection({ delay->getInstanceId(), EffectChain::outputNodeId, 0.5f }));
+    history.clear();
+
+    auto parallel = chain.createSnapshot(nullptr);
+
+    // ルーティングだけを変える（エフェクトの状態は変えない）
+    REQUIRE(chain.removeConnection(delay->getInstanceId(), EffectChain::outputNodeId));
+    history.commit();
+
+    SECTION("A routing-only edit is a step and shares the effect states")
+    {
+        CHECK(history.getNumSteps() == 2);
+
+        auto rerouted = chain.createSnapshot(parallel.get());
+        CHECK(rerouted->effects == parallel->effects);
+        CHECK_FALSE(rerouted->sharesAllStatesWith(*parallel));
+
+        auto unchanged = chain.createSnapshot(rerouted.get());
+        CHECK(unchanged->routing == rerouted->routing);
+    }
+
+    SECTION("Undo and redo restore the connections")
+    {
+        REQUIRE(history.undo());
+        REQUIRE(chain.getConnections().size() == 4);
+        CHECK(chain.getConnections()[3].source == delay->getInstanceId());
+        CHECK(chain.getConnections()[3].gain == Approx(0.5f));
+        CHECK(chain.getEffect(0) == filter);
+        CHECK(chain.getEffect(1) == delay);
+
+        REQUIRE(history.redo());
+        CHECK(chain.getConnections().size() == 3);
+    }
+
+    SECTION("Restoring a removed effect brings back its connections")
+    {
+        chain.removeEffect(1);
+        REQUIRE(chain.getConnections().size() == 2);
+
+        chain.restoreSnapshot(*parallel);
+        CHECK(chain.getNumEffects() == 2);
+        CHECK(chain.getConnections().size() == 4);
+    }
+}
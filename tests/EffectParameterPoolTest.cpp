@@ -0,0 +1,86 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/effects/EffectParameterPool.h"
+#include "../src/audio/effects/FilterEffect.h"
+#include "../src/audio/effects/EqualizerEffect.h"
+
+TEST_CASE("EffectParameterPool routes slot values to bound effects", "[parameters]")
+{
+    // レイアウトがパラメータを所有するので、テスト中は保持しておく
+    EffectParameterPool pool;
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    pool.addParametersTo(layout);
+
+    FilterEffect first;
+    FilterEffect second;
+
+    SECTION("Binding assigns free slots and honours the preferred slot")
+    {
+        CHECK(pool.bind(first, 5) == 5);
+        CHECK(pool.bind(second, 5) == 0);
+        CHECK(first.getParameterSlot() == 5);
+
+        pool.unbind(first);
+        CHECK(first.getParameterSlot() == -1);
+        CHECK(pool.bind(second) == 0); // 既に結び付いていれば同じスロットを返す
+    }
+
+    SECTION("Bound effect values are published normalised")
+    {
+        first.setParameter(0, 20.0f);
+        pool.bind(first);
+        CHECK(pool.getNormalisedValue(0, 0) == Approx(0.0f));
+    }
+
+    SECTION("Changes reach the effect only when the audio thread applies them")
+    {
+        pool.bind(first);
+        pool.setParameterFromUi(first, 0, 10010.0f);
+        CHECK(first.getParameter(0) == Approx(1000.0f));
+
+        pool.applyChanges();
+        CHECK(first.getParameter(0) == Approx(10010.0f).margin(0.5f));
+    }
+
+    SECTION("Unbound effects are set directly")
+    {
+        pool.setParameterFromUi(first, 1, 2.0f);
+        CHECK(first.getParameter(1) == Approx(2.0f));
+    }
+
+    CHECK(EffectParameterPool::getParameterId(0, 0) == "fx01_p1");
+    CHECK(EffectParameterPool::getParameterId(15, 7) == "fx16_p8");
+}
+
+TEST_CASE("EffectParameterPool maps the selected EQ band onto the slot", "[parameters]")
+{
+    EffectParameterPool pool;
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    pool.addParametersTo(layout);
+
+    EqualizerEffect equalizer;
+    REQUIRE(equalizer.getNumParameters() > EffectParameterPool::parametersPerSlot);
+    REQUIRE(pool.bind(equalizer) == 0);
+
+    // エディターで最後のバンドを選ぶと、そのバンドがスロットの先頭に来る
+    const int lastBand = (EqualizerEffect::numBands - 1) * EqualizerEffect::parametersPerBand;
+    const int lastGain = lastBand + 2;
+    equalizer.setParameter(lastGain, -3.0f);
+    pool.setFirstParameter(equalizer, lastBand);
+
+    const auto ranges = equalizer.getParameterRanges();
+    const float gainMinimum = ranges[lastGain * 3];
+    const float gainMaximum = ranges[lastGain * 3 + 1];
+    CHECK(pool.getNormalisedValue(0, 2) == Approx((-3.0f - gainMinimum) / (gainMaximum - gainMinimum)).margin(1.0e-4f));
+
+    // 割り当てたバンドはホストパラメータを経由し、オーディオスレッドで反映される
+    pool.setParameterFromUi(equalizer, lastGain, 6.0f);
+    CHECK(pool.getParameterValue(equalizer, lastGain) == Approx(6.0f).margin(0.01f));
+    CHECK(equalizer.getParameter(lastGain) == Approx(-3.0f).margin(0.01f));
+
+    pool.applyChanges();
+    CHECK(equalizer.getParameter(lastGain) == Approx(6.0f).margin(0.01f));
+
+    // 割り当てから外れたバンドは直接設定される
+    pool.setParameterFromUi(equalizer, 2, 4.0f);
+    CHECK(equalizer.getParameter(2) == Approx(4.0f).margin(0.01f));
+}
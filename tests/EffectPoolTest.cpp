@@ -0,0 +1,85 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/effects/EffectPool.h"
+
+TEST_CASE("EffectPool hands out prepared instances and takes them back", "[pool]")
+{
+    EffectPool pool(2);
+    pool.prepare({ 48000.0, 64, 2 });
+
+    SECTION("Every registered type is stocked up front")
+    {
+        EffectRegistry::getInstance().forEachType([&pool](EffectTypeId typeId)
+        {
+            CHECK(pool.getNumAvailable(typeId) == 2);
+        });
+    }
+
+    SECTION("Released instances are reused with default parameters")
+    {
+        auto delay = pool.acquire(EffectTypeId::delay);
+        REQUIRE(delay != nullptr);
+        CHECK(delay->getTypeId() == EffectTypeId::delay);
+        CHECK(pool.getNumAvailable(EffectTypeId::delay) == 1);
+
+        // 前回の使用で変えたパラメータと無効化は、次に取り出すときに戻る
+        const float defaultTime = delay->getParameter(0);
+        delay->setParameter(0, 1000.0f);
+        delay->setEnabled(false);
+        auto* instance = delay.get();
+        pool.release(std::move(delay));
+        CHECK(pool.getNumAvailable(EffectTypeId::delay) == 2);
+
+        auto reused = pool.acquire(EffectTypeId::delay);
+        CHECK(reused.get() == instance);
+        CHECK(reused->getParameter(0) == Approx(defaultTime));
+        CHECK(reused->getEnabled());
+    }
+
+    SECTION("Running out of stock creates a new prepared instance")
+    {
+        std::vector<std::unique_ptr<Effect>> taken;
+        for (int i = 0; i < 3; ++i)
+            taken.push_back(pool.acquire(EffectTypeId::filter));
+
+        CHECK(pool.getNumAvailable(EffectTypeId::filter) == 0);
+        for (auto& effect : taken)
+            REQUIRE(effect != nullptr);
+
+        // 在庫切れで作ったインスタンスも prepare 済みで、すぐに処理できる
+        juce::AudioBuffer<float> buffer(2, 64);
+        buffer.clear();
+        buffer.setSample(0, 0, 1.0f);
+        taken.back()->process(buffer);
+        CHECK(buffer.getMagnitude(0, 0, 64) > 0.0f);
+
+        // 返却すると在庫は増える（容量は最初の数に縛られない）
+        for (auto& effect : taken)
+            pool.release(std::move(effect));
+        CHECK(pool.getNumAvailable(EffectTypeId::filter) == 3);
+    }
+
+    SECTION("Unknown types and null releases are ignored")
+    {
+        CHECK(pool.acquire(EffectTypeId::none) == nullptr);
+        pool.release(nullptr);
+        CHECK(pool.getNumAvailable(EffectTypeId::none) == 0);
+    }
+}
+
+TEST_CASE("EffectPool resets instances created on an empty pool", "[pool]")
+{
+    // 在庫なしで始め、最初の acquire で作ったインスタンスも返却後は既定値に戻る
+    EffectPool pool(0);
+    pool.prepare({ 48000.0, 64, 2 });
+    REQUIRE(pool.getNumAvailable(EffectTypeId::delay) == 0);
+
+    auto delay = pool.acquire(EffectTypeId::delay);
+    REQUIRE(delay != nullptr);
+    const float defaultTime = delay->getParameter(0);
+    delay->setParameter(0, 1000.0f);
+    pool.release(std::move(delay));
+
+    auto reused = pool.acquire(EffectTypeId::delay);
+    REQUIRE(reused != nullptr);
+    CHECK(reused->getParameter(0) == Approx(defaultTime));
+}
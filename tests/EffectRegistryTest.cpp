@@ -0,0 +1,61 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/effects/EffectRegistry.h"
+#include "../src/EffectChain.h"
+
+TEST_CASE("EffectRegistry knows every built-in effect", "[registry]")
+{
+    const auto& registry = EffectRegistry::getInstance();
+
+    // 登録はリンクアンカーの一覧から集まる（EffectRegistry.cpp に手で書き足さない）
+    std::vector<EffectTypeId> types;
+    registry.forEachType([&types](EffectTypeId typeId) { types.push_back(typeId); });
+    CHECK(types.size() == static_cast<size_t>(EffectRegistry::maxTypes - 1));
+
+    for (const auto typeId : types)
+    {
+        auto effect = registry.create(typeId);
+        REQUIRE(effect != nullptr);
+        CHECK(effect->getTypeId() == typeId);
+
+        // プリセットの "Type" 文字列と相互に変換できる
+        const auto typeName = registry.getTypeName(typeId);
+        CHECK(typeName.isNotEmpty());
+        CHECK(registry.findTypeId(typeName) == typeId);
+    }
+
+    SECTION("Unknown types")
+    {
+        CHECK_FALSE(registry.isRegistered(EffectTypeId::none));
+        CHECK(registry.create(EffectTypeId::none) == nullptr);
+        CHECK(registry.getTypeName(EffectTypeId::none).isEmpty());
+        CHECK(registry.findTypeId("NoSuchEffect") == EffectTypeId::none);
+    }
+}
+
+TEST_CASE("Preset loading resolves effects by TypeId, then by Type name", "[registry][chain]")
+{
+    EffectChain chain;
+    chain.prepare({ 48000.0, 64, 2 });
+
+    juce::XmlElement xml("EffectChain");
+    auto* byId = xml.createNewChildElement("Effect");
+    byId->setAttribute("Type", "Filter");
+    byId->setAttribute("TypeId", static_cast<int>(EffectTypeId::delay)); // TypeId が優先される
+
+    auto* legacy = xml.createNewChildElement("Effect");
+    legacy->setAttribute("Type", "Distortion"); // TypeId のない古いプリセット
+
+    auto* unknownId = xml.createNewChildElement("Effect");
+    unknownId->setAttribute("Type", "Filter");
+    unknownId->setAttribute("TypeId", 999);
+
+    auto* unknown = xml.createNewChildElement("Effect");
+    unknown->setAttribute("Type", "NoSuchEffect"); // 読み飛ばす
+
+    chain.loadFromXml(xml);
+
+    REQUIRE(chain.getNumEffects() == 3);
+    CHECK(chain.getEffect(0)->getTypeId() == EffectTypeId::delay);
+    CHECK(chain.getEffect(1)->getTypeId() == EffectTypeId::distortion);
+    CHECK(chain.getEffect(2)->getTypeId() == EffectTypeId::filter);
+}
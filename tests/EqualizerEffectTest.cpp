@@ -0,0 +1,207 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/effects/EqualizerEffect.h"
+#include <chrono>
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+
+    // 定常状態になった後半の振幅
+    float measureGain(EqualizerEffect& eq, float frequency)
+    {
+        eq.reset();
+        float peak = 0.0f;
+        for (int block = 0; block < 200; ++block)
+        {
+            juce::AudioBuffer<float> buffer(2, 120);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                const float value = std::sin(juce::MathConstants<float>::twoPi * frequency
+                                             * static_cast<float>(block * 120 + i) / static_cast<float>(testSampleRate));
+                buffer.setSample(0, i, value);
+                buffer.setSample(1, i, value);
+            }
+            eq.process(buffer);
+
+            if (block >= 150)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    peak = juce::jmax(peak, std::abs(buffer.getSample(0, i)));
+        }
+        return peak;
+    }
+
+    void fillNoise(juce::AudioBuffer<float>& buffer, int seed)
+    {
+        juce::Random random(seed);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+}
+
+TEST_CASE("EqualizerEffect basic functionality", "[eq]")
+{
+    EqualizerEffect eq;
+    eq.prepare({ testSampleRate, 256, 2 });
+
+    SECTION("Default bands are flat and skipped")
+    {
+        CHECK(eq.getNumParameters() == EqualizerEffect::numBands * EqualizerEffect::parametersPerBand);
+        CHECK(eq.getNumActiveBands() == 0);
+
+        juce::AudioBuffer<float> buffer(2, 256);
+        fillNoise(buffer, 1);
+        juce::AudioBuffer<float> original(buffer);
+        eq.process(buffer);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            CHECK(buffer.getSample(0, i) == original.getSample(0, i));
+    }
+
+    SECTION("A peak band boosts its centre frequency only")
+    {
+        eq.setParameter(3 * EqualizerEffect::parametersPerBand + 1, 1000.0f); // Band 4 Freq
+        eq.setParameter(3 * EqualizerEffect::parametersPerBand + 2, 6.0f);    // Band 4 Gain
+        eq.setParameter(3 * EqualizerEffect::parametersPerBand + 3, 1.0f);    // Band 4 Q
+        eq.reset();
+        CHECK(eq.getNumActiveBands() == 1);
+
+        CHECK(measureGain(eq, 1000.0f) == Approx(juce::Decibels::decibelsToGain(6.0f)).epsilon(0.02));
+        CHECK(measureGain(eq, 60.0f) == Approx(1.0f).epsilon(0.02));
+    }
+
+    SECTION("High-pass and low-pass bands attenuate outside their band")
+    {
+        eq.setParameter(0, 4.0f);    // Band 1: High Pass
+        eq.setParameter(1, 1000.0f);
+        eq.setParameter(4, 5.0f);    // Band 2: Low Pass
+        eq.setParameter(5, 2000.0f);
+        eq.reset();
+        CHECK(eq.getNumActiveBands() == 2);
+
+        CHECK(measureGain(eq, 100.0f) < 0.02f);
+        CHECK(measureGain(eq, 20000.0f) < 0.05f);
+    }
+
+    SECTION("Parameter changes are smoothed into the coefficients")
+    {
+        eq.setParameter(2, 12.0f); // Band 1 Gain
+        juce::AudioBuffer<float> buffer(2, 64);
+        buffer.clear();
+        eq.process(buffer);
+        CHECK(eq.getNumActiveBands() == 1);
+    }
+}
+
+TEST_CASE("EqualizerEffect packs channels without mixing them", "[eq]")
+{
+    // 5チャンネル（2グループ）をまとめて処理した結果が、1チャンネルずつ処理した結果と一致する
+    auto configure = [](EqualizerEffect& eq)
+    {
+        for (int b = 0; b < EqualizerEffect::numBands; ++b)
+            eq.setParameter(b * EqualizerEffect::parametersPerBand + 2, b % 2 == 0 ? 4.0f : -3.0f);
+    };
+
+    EqualizerEffect packed;
+    configure(packed);
+    packed.prepare({ testSampleRate, 256, 5 });
+
+    juce::AudioBuffer<float> buffer(5, 256);
+    fillNoise(buffer, 7);
+    juce::AudioBuffer<float> original(buffer);
+    packed.process(buffer);
+
+    for (int ch = 0; ch < 5; ++ch)
+    {
+        EqualizerEffect single;
+        configure(single);
+        single.prepare({ testSampleRate, 256, 1 });
+
+        juce::AudioBuffer<float> mono(1, 256);
+        mono.copyFrom(0, 0, original, ch, 0, 256);
+        single.process(mono);
+
+        for (int i = 0; i < 256; ++i)
+            CHECK(buffer.getSample(ch, i) == Approx(mono.getSample(0, i)).margin(1.0e-6));
+    }
+}
+
+TEST_CASE("EqualizerEffect XML serialization", "[eq]")
+{
+    EqualizerEffect eq;
+    eq.setParameter(8, 4.0f);
+    eq.setParameter(9, 150.0f);
+    eq.setParameter(30, -6.0f);
+
+    juce::XmlElement xml("Effect");
+    eq.saveToXml(xml);
+
+    EqualizerEffect loaded;
+    loaded.loadFromXml(xml);
+    for (int p = 0; p < eq.getNumParameters(); ++p)
+        CHECK(loaded.getParameter(p) == Approx(eq.getParameter(p)));
+}
+
+TEST_CASE("EqualizerEffect channel packing benchmark", "[eq][.benchmark]")
+{
+    // 全バンドを有効にした EQ と、同じ段数の双2次をチャンネルごとにスカラーで処理する場合の
+    // 1チャンネル・1サンプルあたりの時間を比べる（バンドはレーンに並べられないので、チャンネルを並べる根拠）
+    constexpr int blockSize = 256;
+    constexpr int numBlocks = 2000;
+
+    auto nanosecondsPerSample = [](int channels, auto&& processBlock)
+    {
+        juce::AudioBuffer<float> buffer(channels, blockSize);
+        fillNoise(buffer, 3);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < numBlocks; ++block)
+            processBlock(buffer);
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        return elapsed.count() / (static_cast<double>(numBlocks) * blockSize * channels);
+    };
+
+    for (const int channels : { 2, EqualizerEffect::lanes, 2 * EqualizerEffect::lanes })
+    {
+        EqualizerEffect eq;
+        for (int b = 0; b < EqualizerEffect::numBands; ++b)
+        {
+            eq.setParameter(b * EqualizerEffect::parametersPerBand, static_cast<float>(EqualizerEffect::BandType::peak));
+            eq.setParameter(b * EqualizerEffect::parametersPerBand + 2, 3.0f);
+        }
+        eq.prepare({ testSampleRate, blockSize, static_cast<juce::uint32>(channels) });
+        REQUIRE(eq.getNumActiveBands() == EqualizerEffect::numBands);
+
+        const double packed = nanosecondsPerSample(channels, [&eq](juce::AudioBuffer<float>& buffer) { eq.process(buffer); });
+
+        // 比較用: 安定な双2次（係数は時間に関係しない）を numBands 段、1チャンネルずつ
+        std::vector<float> s1(static_cast<size_t>(channels * EqualizerEffect::numBands)), s2(s1.size());
+        const double scalar = nanosecondsPerSample(channels, [&](juce::AudioBuffer<float>& buffer)
+        {
+            constexpr float b0 = 0.2f, b1 = 0.4f, b2 = 0.2f, a1 = -0.5f, a2 = 0.3f;
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                float* data = buffer.getWritePointer(ch);
+                for (int b = 0; b < EqualizerEffect::numBands; ++b)
+                {
+                    const auto state = static_cast<size_t>(ch * EqualizerEffect::numBands + b);
+                    float z1 = s1[state];
+                    float z2 = s2[state];
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const float x = data[i];
+                        const float y = b0 * x + z1;
+                        z1 = b1 * x - a1 * y + z2;
+                        z2 = b2 * x - a2 * y;
+                        data[i] = y;
+                    }
+                    s1[state] = z1;
+                    s2[state] = z2;
+                }
+            }
+        });
+
+        WARN(channels << " channels: packed " << packed << " ns, scalar " << scalar << " ns per channel sample");
+    }
+}
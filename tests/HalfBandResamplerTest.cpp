@@ -0,0 +1,72 @@
+#include <catch2/catch.hpp>
+#include "../Source/DSP/HalfBandResampler.h"
+#include <cmath>
+
+namespace
+{
+    // 不揃いなブロック長で down → up を通した出力を返す
+    std::vector<float> roundTrip(HalfBandResampler& resampler, const std::vector<float>& input)
+    {
+        std::vector<float> output(input.size());
+        std::vector<float> low(512);
+        const int blockSizes[] = { 256, 131, 1, 17, 200 };
+
+        size_t position = 0;
+        for (int block = 0; position < input.size(); ++block)
+        {
+            const int numSamples = juce::jmin(blockSizes[block % 5], static_cast<int>(input.size() - position));
+            const int numLow = resampler.downsample(input.data() + position, numSamples, low.data());
+            resampler.upsample(low.data(), numLow, output.data() + position, numSamples);
+            position += static_cast<size_t>(numSamples);
+        }
+        return output;
+    }
+
+    std::vector<float> makeSine(double frequency, double sampleRate, int length)
+    {
+        std::vector<float> signal(static_cast<size_t>(length));
+        for (int i = 0; i < length; ++i)
+            signal[static_cast<size_t>(i)] = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate));
+        return signal;
+    }
+}
+
+TEST_CASE("HalfBandResampler round trips with a fixed latency", "[dsp]")
+{
+    for (int numStages = 1; numStages <= HalfBandResampler::maxStages; ++numStages)
+    {
+        HalfBandResampler resampler;
+        resampler.prepare(numStages, 256);
+        const double sampleRate = 48000.0 * resampler.getFactor();
+        const int latency = resampler.getLatencySamples();
+
+        // 通過域の信号は遅延以外そのまま戻る
+        const auto input = makeSine(5000.0, sampleRate, 8192);
+        const auto output = roundTrip(resampler, input);
+
+        float maxError = 0.0f;
+        for (size_t i = 2048; i < output.size(); ++i)
+            maxError = juce::jmax(maxError, std::abs(output[i] - input[i - static_cast<size_t>(latency)]));
+        CHECK(maxError < 1.0e-3f);
+    }
+
+    SECTION("Content above the internal Nyquist is removed")
+    {
+        HalfBandResampler resampler;
+        resampler.prepare(1, 256);
+        const auto output = roundTrip(resampler, makeSine(32000.0, 96000.0, 8192));
+
+        float peak = 0.0f;
+        for (size_t i = 2048; i < output.size(); ++i)
+            peak = juce::jmax(peak, std::abs(output[i]));
+        CHECK(juce::Decibels::gainToDecibels(peak) < -70.0f);
+    }
+
+    SECTION("No stages is a pass-through")
+    {
+        HalfBandResampler resampler;
+        resampler.prepare(0, 256);
+        CHECK(resampler.getLatencySamples() == 0);
+        CHECK(resampler.getFactor() == 1);
+    }
+}
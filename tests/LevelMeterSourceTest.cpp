@@ -0,0 +1,46 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/metering/LevelMeterSource.h"
+
+TEST_CASE("LevelMeterSource publishes block peak and RMS", "[metering]")
+{
+    LevelMeterSource meter;
+    meter.prepare(1000.0); // RMS窓 = 50サンプル
+
+    // SIMDの整列境界をまたぐよう、端数のある長さで計測する
+    juce::AudioBuffer<float> buffer(2, 51);
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+    {
+        buffer.setSample(0, i, 0.5f);
+        buffer.setSample(1, i, i == 37 ? -0.9f : 0.1f);
+    }
+
+    meter.measureBlock(buffer);
+
+    CHECK(meter.getNumChannels() == 2);
+    CHECK(meter.getPeakAndReset(0) == Approx(0.5f));
+    CHECK(meter.getPeakAndReset(1) == Approx(0.9f));
+    CHECK(meter.getRms(0) == Approx(0.5f));
+    CHECK(meter.getRms(1) == Approx(std::sqrt((50.0f * 0.01f + 0.81f) / 51.0f)));
+
+    // 読み出したピークはリセットされる
+    CHECK(meter.getPeakAndReset(1) == 0.0f);
+}
+
+TEST_CASE("LevelMeterSource meters every channel of a 7.1.4 bus", "[metering]")
+{
+    LevelMeterSource meter;
+    meter.prepare(1000.0);
+
+    juce::AudioBuffer<float> buffer(12, 64);
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        buffer.clear(ch, 0, 64);
+        buffer.setSample(ch, 5, 0.05f * static_cast<float>(ch + 1));
+    }
+
+    meter.measureBlock(buffer);
+
+    REQUIRE(meter.getNumChannels() == 12);
+    for (int ch = 0; ch < 12; ++ch)
+        CHECK(meter.getPeakAndReset(ch) == Approx(0.05f * static_cast<float>(ch + 1)));
+}
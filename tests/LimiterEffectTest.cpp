@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/effects/LimiterEffect.h"
+
+namespace
+{
+    // 4倍に補間した波形のピーク（フィルターの遅延と端は無視する）
+    float measureTruePeak(const std::vector<float>& signal, int skip)
+    {
+        float peak = 0.0f;
+        for (size_t i = static_cast<size_t>(skip); i + 1 < signal.size(); ++i)
+            for (int p = 0; p < 4; ++p)
+            {
+                const float t = static_cast<float>(p) / 4.0f;
+                peak = juce::jmax(peak, std::abs(signal[i] + t * (signal[i + 1] - signal[i])));
+            }
+        return peak;
+    }
+
+    std::vector<float> processSine(LimiterEffect& limiter, float frequency, float amplitude, float phase, int numSamples)
+    {
+        std::vector<float> output;
+        int sample = 0;
+        while (sample < numSamples)
+        {
+            juce::AudioBuffer<float> buffer(2, 96);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                const float value = amplitude * std::sin(juce::MathConstants<float>::twoPi * frequency * (sample + i) / 48000.0f + phase);
+                buffer.setSample(0, i, value);
+                buffer.setSample(1, i, value);
+            }
+            limiter.process(buffer);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                output.push_back(buffer.getSample(0, i));
+            sample += buffer.getNumSamples();
+        }
+        return output;
+    }
+}
+
+TEST_CASE("LimiterEffect basic functionality", "[limiter]")
+{
+    LimiterEffect limiter;
+    limiter.prepare({ 48000.0, 64, 2 });
+
+    SECTION("Default parameters")
+    {
+        CHECK(limiter.getParameter(0) == Approx(-1.0f));  // Ceiling
+        CHECK(limiter.getParameter(1) == Approx(5.0f));   // Lookahead
+        CHECK(limiter.getParameter(2) == Approx(100.0f)); // Release
+        CHECK(limiter.getParameter(3) == Approx(1.0f));   // True Peak
+    }
+
+    SECTION("Latency follows the lookahead")
+    {
+        CHECK(limiter.getLatencySamples() == 240 + LimiterEffect::detectorDelay);
+        limiter.setParameter(1, 1.0f);
+        CHECK(limiter.getLatencySamples() == 48 + LimiterEffect::detectorDelay);
+    }
+
+    SECTION("Quiet signals pass through delayed by the latency")
+    {
+        const int latency = limiter.getLatencySamples();
+        std::vector<float> output;
+        for (int block = 0; block < 8; ++block)
+        {
+            juce::AudioBuffer<float> buffer(2, 64);
+            buffer.clear();
+            if (block == 0)
+                buffer.setSample(0, 3, 0.5f);
+            limiter.process(buffer);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                output.push_back(buffer.getSample(0, i));
+        }
+
+        CHECK(output[static_cast<size_t>(latency + 3)] == Approx(0.5f));
+        CHECK(output[static_cast<size_t>(latency + 2)] == Approx(0.0f));
+    }
+
+    SECTION("Loud signals never exceed the ceiling")
+    {
+        const float ceiling = juce::Decibels::decibelsToGain(-1.0f);
+        const auto output = processSine(limiter, 997.0f, 4.0f, 0.0f, 9600);
+
+        float peak = 0.0f;
+        for (float sample : output)
+            peak = juce::jmax(peak, std::abs(sample));
+
+        CHECK(peak <= ceiling * 1.0001f);
+        CHECK(peak > ceiling * 0.9f);
+        CHECK(limiter.getGainReductionDb() < -10.0f);
+    }
+}
+
+TEST_CASE("LimiterEffect catches inter-sample peaks", "[limiter]")
+{
+    // fs/4 のサイン波を45度ずらすと、サンプルは振幅の 0.707 倍だが波形のピークは振幅そのもの
+    const float amplitude = 1.2f;
+
+    LimiterEffect samplePeak;
+    samplePeak.setParameter(0, 0.0f);
+    samplePeak.setParameter(3, 0.0f);
+    samplePeak.prepare({ 48000.0, 64, 2 });
+    const auto sampleOutput = processSine(samplePeak, 12000.0f, amplitude, juce::MathConstants<float>::pi / 4.0f, 9600);
+
+    LimiterEffect truePeak;
+    truePeak.setParameter(0, 0.0f);
+    truePeak.prepare({ 48000.0, 64, 2 });
+    const auto trueOutput = processSine(truePeak, 12000.0f, amplitude, juce::MathConstants<float>::pi / 4.0f, 9600);
+
+    // サンプルピークでは天井を超えないので何もしない。トゥルーピークでは波形のピークを天井まで下げる
+    const int settled = 4800;
+    CHECK(std::abs(sampleOutput[static_cast<size_t>(settled)]) == Approx(amplitude * std::sqrt(0.5f)).margin(0.01f));
+
+    float samplePeakLevel = 0.0f;
+    for (size_t i = static_cast<size_t>(settled); i < trueOutput.size(); ++i)
+        samplePeakLevel = juce::jmax(samplePeakLevel, std::abs(trueOutput[i]));
+    CHECK(samplePeakLevel == Approx(std::sqrt(0.5f)).margin(0.03f));
+    CHECK(measureTruePeak(trueOutput, settled) < amplitude * std::sqrt(0.5f));
+}
+
+TEST_CASE("LimiterEffect XML serialization", "[limiter]")
+{
+    LimiterEffect limiter;
+    limiter.setParameter(0, -3.0f);
+    limiter.setParameter(1, 2.5f);
+    limiter.setParameter(2, 250.0f);
+    limiter.setParameter(3, 0.0f);
+
+    juce::XmlElement xml("Effect");
+    limiter.saveToXml(xml);
+
+    LimiterEffect loaded;
+    loaded.loadFromXml(xml);
+    CHECK(loaded.getParameter(0) == Approx(-3.0f));
+    CHECK(loaded.getParameter(1) == Approx(2.5f));
+    CHECK(loaded.getParameter(2) == Approx(250.0f));
+    CHECK(loaded.getParameter(3) == Approx(0.0f));
+}
@@ -0,0 +1,275 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/modulation/ModulationMatrix.h"
+#include "../src/audio/effects/FilterEffect.h"
+#include "../src/EffectChain.h"
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+    constexpr int blockSize = 64;
+
+    ModulatorBank::Settings makeLfo(ModulatorBank::Shape shape, float rateHz)
+    {
+        ModulatorBank::Settings settings;
+        settings.shape = shape;
+        settings.rateHz = rateHz;
+        return settings;
+    }
+
+    void processSilence(EffectChain& chain, int numBlocks)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            buffer.clear();
+            chain.process(buffer);
+        }
+    }
+}
+
+TEST_CASE("ModulatorBank advances every source per block", "[modulation]")
+{
+    ModulatorBank bank;
+    bank.prepare(testSampleRate);
+    juce::AudioBuffer<float> silence(1, blockSize);
+    silence.clear();
+
+    SECTION("LFO shapes follow their phase")
+    {
+        // 1周 = 4800 サンプル。折り返す直前（74 ブロック）まで見る
+        const std::array<ModulatorBank::Settings, 4> settings {
+            makeLfo(ModulatorBank::Shape::sine, 10.0f), makeLfo(ModulatorBank::Shape::triangle, 10.0f),
+            makeLfo(ModulatorBank::Shape::saw, 10.0f), makeLfo(ModulatorBank::Shape::square, 10.0f)
+        };
+        bank.setModulators(settings.data(), 4);
+
+        for (int block = 1; block < 75; ++block)
+        {
+            bank.advance(silence, blockSize);
+            const float phase = static_cast<float>(block * blockSize % 4800) / 4800.0f;
+
+            CHECK(bank.getValues()[0] == Approx(std::sin(juce::MathConstants<float>::twoPi * phase)).margin(0.002));
+            CHECK(bank.getValues()[1] == Approx(1.0f - 4.0f * std::abs(phase - 0.5f)).margin(1.0e-4));
+            CHECK(bank.getValues()[2] == Approx(2.0f * phase - 1.0f).margin(1.0e-4));
+            CHECK(bank.getValues()[3] == Approx(phase < 0.5f ? 1.0f : -1.0f));
+        }
+    }
+
+    SECTION("The envelope follower rises with the key and releases")
+    {
+        ModulatorBank::Settings settings;
+        settings.source = ModulatorBank::Source::envelope;
+        settings.attackMs = 1.0f;
+        settings.releaseMs = 50.0f;
+        bank.setModulators(&settings, 1);
+
+        juce::AudioBuffer<float> key(2, blockSize);
+        key.clear();
+        key.setSample(1, 10, -0.5f);
+        for (int block = 0; block < 10; ++block)
+            bank.advance(key, blockSize);
+        CHECK(bank.getValues()[0] == Approx(0.5f).margin(1.0e-3));
+
+        // 50ms（2400 サンプル）で 1/e まで下がる
+        for (int block = 0; block < 2400 / blockSize; ++block)
+            bank.advance(silence, blockSize);
+        CHECK(bank.getValues()[0] == Approx(0.5f * std::exp(-1.0f)).margin(0.01));
+    }
+
+    SECTION("The step sequencer holds each step for its share of the cycle")
+    {
+        ModulatorBank::Settings settings;
+        settings.source = ModulatorBank::Source::stepSequencer;
+        settings.rateHz = 10.0f;
+        settings.numSteps = 4;
+        settings.steps = { 0.25f, -0.5f, 1.0f, 0.0f };
+        bank.setModulators(&settings, 1);
+
+        // 1ステップ = 1200 サンプル
+        const std::array<float, 4> expected { 0.25f, -0.5f, 1.0f, 0.0f };
+        for (int block = 1; block < 75; ++block)
+        {
+            bank.advance(silence, blockSize);
+            CHECK(bank.getValues()[0] == expected[static_cast<size_t>(block * blockSize / 1200)]);
+        }
+    }
+
+    SECTION("Settings can change without resetting the phase")
+    {
+        auto settings = makeLfo(ModulatorBank::Shape::saw, 10.0f);
+        bank.setModulators(&settings, 1);
+        for (int block = 0; block < 10; ++block)
+            bank.advance(silence, blockSize);
+        const float before = bank.getValues()[0];
+
+        settings.rateHz = 0.0f;
+        bank.setModulators(&settings, 1);
+        bank.advance(silence, blockSize);
+        CHECK(bank.getValues()[0] == Approx(before));
+        CHECK(bank.getPreviousValues()[0] == Approx(before));
+    }
+}
+
+TEST_CASE("FilterEffect applies per-sample cutoff modulation in octaves", "[modulation][filter]")
+{
+    // 1オクターブ分の一定のオフセットは、カットオフを2倍にしたのと同じ
+    FilterEffect modulated;
+    FilterEffect reference;
+    reference.setParameter(0, 2000.0f);
+    for (auto* filter : { &modulated, &reference })
+        filter->prepare({ testSampleRate, blockSize, 2 });
+
+    CHECK(modulated.supportsSampleModulation(0));
+    CHECK_FALSE(modulated.supportsSampleModulation(1));
+
+    std::array<float, blockSize> offsets;
+    offsets.fill(0.1f);
+
+    juce::Random random(3);
+    for (int block = 0; block < 4; ++block)
+    {
+        juce::AudioBuffer<float> a(2, blockSize);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                a.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+        juce::AudioBuffer<float> b(a);
+
+        modulated.setSampleModulation(0, offsets.data());
+        modulated.process(a);
+        reference.process(b);
+
+        for (int i = 0; i < blockSize; ++i)
+            CHECK(a.getSample(1, i) == Approx(b.getSample(1, i)).margin(1.0e-5));
+    }
+}
+
+TEST_CASE("ModulationMatrix routes modulators to chain and reverb parameters", "[modulation]")
+{
+    EffectChain chain;
+    ModulationMatrix matrix(chain);
+    chain.setModulationMatrix(&matrix);
+
+    auto* distortion = chain.addEffect(EffectTypeId::distortion);
+    auto* filter = chain.addEffect(EffectTypeId::filter);
+    REQUIRE(distortion != nullptr);
+    REQUIRE(filter != nullptr);
+    distortion->setParameter(1, 0.5f); // Mix
+    chain.prepare({ testSampleRate, blockSize, 2 });
+
+    const int square = matrix.addModulator(makeLfo(ModulatorBank::Shape::square, 1.0f));
+    REQUIRE(square == 0);
+
+    SECTION("Routes are validated")
+    {
+        CHECK_FALSE(matrix.addRoute({ 1, distortion->getInstanceId(), 1, 0.5f }));   // モジュレーターがない
+        CHECK_FALSE(matrix.addRoute({ 0, 9999, 0, 0.5f }));                          // エフェクトがない
+        CHECK_FALSE(matrix.addRoute({ 0, distortion->getInstanceId(), 42, 0.5f }));  // パラメータがない
+        CHECK(matrix.addRoute({ 0, distortion->getInstanceId(), 1, 0.5f }));
+        CHECK_FALSE(matrix.addRoute({ 0, distortion->getInstanceId(), 1, 0.2f }));   // 重複
+    }
+
+    SECTION("Block-rate targets move around their base value and return to it")
+    {
+        REQUIRE(matrix.addRoute({ square, distortion->getInstanceId(), 1, 0.25f }));
+
+        // 最初の半周期は +1
+        processSilence(chain, 10);
+        CHECK(distortion->getParameter(1) == Approx(0.75f));
+
+        // オートメーションで基準値が変わったらそれに乗る
+        distortion->setParameter(1, 0.4f);
+        processSilence(chain, 1);
+        CHECK(distortion->getParameter(1) == Approx(0.65f));
+
+        // ルートを外すと基準値に戻る
+        REQUIRE(matrix.removeRoute(square, distortion->getInstanceId(), 1));
+        processSilence(chain, 1);
+        CHECK(distortion->getParameter(1) == Approx(0.4f));
+    }
+
+    SECTION("Saving and snapshots record the base value, not the modulated one")
+    {
+        REQUIRE(matrix.addRoute({ square, distortion->getInstanceId(), 1, 0.25f }));
+        processSilence(chain, 10);
+        REQUIRE(distortion->getParameter(1) == Approx(0.75f));
+
+        juce::XmlElement xml("Chain");
+        chain.saveToXml(xml);
+        auto* saved = xml.getChildByName("Effect");
+        REQUIRE(saved != nullptr);
+        CHECK(saved->getDoubleAttribute("Mix") == Approx(0.5));
+        CHECK(distortion->getParameter(1) == Approx(0.75f));
+
+        CHECK(chain.createSnapshot(nullptr)->effects[0]->parameters[1] == Approx(0.5f));
+
+        // オートメーションで基準値が変わったら、変調を乗せた後もその値を記録する
+        distortion->setParameter(1, 0.4f);
+        processSilence(chain, 1);
+        REQUIRE(distortion->getParameter(1) == Approx(0.65f));
+        CHECK(chain.createSnapshot(nullptr)->effects[0]->parameters[1] == Approx(0.4f));
+
+        // ルートを外した後は現在値そのもの
+        REQUIRE(matrix.removeRoute(square, distortion->getInstanceId(), 1));
+        processSilence(chain, 1);
+        CHECK(chain.createSnapshot(nullptr)->effects[0]->parameters[1] == Approx(0.4f));
+    }
+
+    SECTION("Per-sample targets keep their base value")
+    {
+        REQUIRE(matrix.addRoute({ square, filter->getInstanceId(), 0, 0.1f }));
+        processSilence(chain, 10);
+        CHECK(filter->getParameter(0) == Approx(1000.0f));
+    }
+
+    SECTION("Routes to the same target are summed")
+    {
+        const int saw = matrix.addModulator(makeLfo(ModulatorBank::Shape::saw, 0.0f));
+        REQUIRE(matrix.addRoute({ square, ModulationMatrix::reverbTarget, 0, 0.2f }));
+        REQUIRE(matrix.addRoute({ saw, ModulationMatrix::reverbTarget, 0, 0.1f }));
+        processSilence(chain, 1);
+
+        // 矩形波は +1、周波数 0 の鋸歯状波は -1
+        CHECK(matrix.getReverbOffset(0) == Approx(0.2f - 0.1f));
+        CHECK(matrix.getReverbOffset(1) == 0.0f);
+    }
+
+    SECTION("Removing a modulator drops its routes and renumbers the rest")
+    {
+        const int saw = matrix.addModulator(makeLfo(ModulatorBank::Shape::saw, 2.0f));
+        REQUIRE(matrix.addRoute({ square, ModulationMatrix::reverbTarget, 0, 0.2f }));
+        REQUIRE(matrix.addRoute({ saw, ModulationMatrix::reverbTarget, 1, 0.1f }));
+
+        matrix.removeModulator(square);
+        REQUIRE(matrix.getRoutes().size() == 1);
+        CHECK(matrix.getRoutes()[0].modulator == 0);
+        CHECK(matrix.getRoutes()[0].parameterIndex == 1);
+    }
+
+    SECTION("XML stores routes by effect position")
+    {
+        auto sequencer = makeLfo(ModulatorBank::Shape::sine, 3.0f);
+        sequencer.source = ModulatorBank::Source::stepSequencer;
+        sequencer.numSteps = 3;
+        sequencer.steps = { 0.5f, -0.25f, 1.0f };
+        matrix.addModulator(sequencer);
+        REQUIRE(matrix.addRoute({ 1, filter->getInstanceId(), 1, -0.3f }));
+        REQUIRE(matrix.addRoute({ 0, ModulationMatrix::reverbTarget, 2, 0.4f }));
+
+        juce::XmlElement xml("Modulation");
+        matrix.saveToXml(xml);
+
+        // 並べ替えてから読み込んでも、保存時の位置のエフェクトを指す
+        chain.moveEffect(1, 0);
+        matrix.loadFromXml(xml);
+
+        REQUIRE(matrix.getNumModulators() == 2);
+        CHECK(matrix.getModulator(1).source == ModulatorBank::Source::stepSequencer);
+        CHECK(matrix.getModulator(1).numSteps == 3);
+        CHECK(matrix.getModulator(1).steps[1] == Approx(-0.25f));
+
+        REQUIRE(matrix.getRoutes().size() == 2);
+        CHECK(matrix.getRoutes()[0].instanceId == chain.getEffect(1)->getInstanceId());
+        CHECK(matrix.getRoutes()[0].depth == Approx(-0.3f));
+        CHECK(matrix.getRoutes()[1].instanceId == ModulationMatrix::reverbTarget);
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+#include "../Source/DSP/MultichannelReverb.h"
+
+namespace
+{
+    float energy(const juce::AudioBuffer<float>& buffer, int channel)
+    {
+        float sum = 0.0f;
+        const float* data = buffer.getReadPointer(channel);
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            sum += data[i] * data[i];
+        return sum;
+    }
+}
+
+TEST_CASE("MultichannelReverb processes channel groups in SIMD lanes", "[reverb]")
+{
+    constexpr int numChannels = 6; // 5.1（LFE は 3）
+    constexpr int lfe = 3;
+    constexpr int numSamples = 4096;
+
+    MultichannelReverb reverb;
+    reverb.prepare(44100.0, numChannels, 512, lfe);
+
+    juce::Reverb::Parameters parameters;
+    parameters.wetLevel = 0.5f;
+    parameters.dryLevel = 0.0f;
+    reverb.setParameters(parameters);
+    reverb.reset();
+
+    SECTION("Channels are packed into groups without the LFE")
+    {
+        const int expectedGroups = (numChannels - 1 + MultichannelReverb::lanes - 1) / MultichannelReverb::lanes;
+        CHECK(reverb.getNumGroups() == expectedGroups);
+    }
+
+    SECTION("Each channel only reverberates its own input")
+    {
+        juce::AudioBuffer<float> buffer(numChannels, numSamples);
+        buffer.clear();
+        buffer.setSample(0, 0, 1.0f);
+        buffer.setSample(lfe, 0, 1.0f);
+        reverb.process(buffer);
+
+        CHECK(energy(buffer, 0) > 0.0f);
+        CHECK(energy(buffer, 1) == 0.0f);
+        CHECK(energy(buffer, 5) == 0.0f);
+
+        // LFE はドライだけ（ここではドライ 0）
+        CHECK(energy(buffer, lfe) == 0.0f);
+    }
+
+    SECTION("Lanes in the same group share the tuning")
+    {
+        juce::AudioBuffer<float> buffer(numChannels, numSamples);
+        buffer.clear();
+        buffer.setSample(0, 0, 1.0f);
+        buffer.setSample(1, 0, 1.0f);
+        reverb.process(buffer);
+
+        for (int i = 0; i < numSamples; ++i)
+            REQUIRE(buffer.getSample(0, i) == buffer.getSample(1, i));
+    }
+
+    SECTION("Dry gain follows juce::Reverb scaling")
+    {
+        parameters.wetLevel = 0.0f;
+        parameters.dryLevel = 0.5f;
+        reverb.setParameters(parameters);
+        reverb.prepare(44100.0, numChannels, 512, lfe);
+
+        juce::AudioBuffer<float> buffer(numChannels, 64);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < 64; ++i)
+                buffer.setSample(ch, i, 0.25f);
+        reverb.process(buffer);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            CHECK(buffer.getSample(ch, 63) == Approx(0.25f));
+    }
+}
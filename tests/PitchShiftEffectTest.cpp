@@ -0,0 +1,65 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/effects/PitchShiftEffect.h"
+
+namespace
+{
+    // impulseAt にインパルスを置いた信号を処理し、出力の絶対値が最大のサンプル位置を返す
+    int findPeak(PitchShiftEffect& pitch, int impulseAt, int length)
+    {
+        std::vector<float> output;
+        for (int start = 0; start < length; start += 100)
+        {
+            // ホストのブロックサイズとホップが揃わない長さで処理する
+            juce::AudioBuffer<float> buffer(2, 100);
+            buffer.clear();
+            if (impulseAt >= start && impulseAt < start + 100)
+            {
+                buffer.setSample(0, impulseAt - start, 1.0f);
+                buffer.setSample(1, impulseAt - start, 1.0f);
+            }
+
+            pitch.process(buffer);
+            for (int i = 0; i < 100; ++i)
+                output.push_back(buffer.getSample(0, i));
+        }
+
+        int peak = 0;
+        for (int i = 1; i < static_cast<int>(output.size()); ++i)
+            if (std::abs(output[static_cast<size_t>(i)]) > std::abs(output[static_cast<size_t>(peak)]))
+                peak = i;
+        return peak;
+    }
+}
+
+TEST_CASE("PitchShiftEffect wet and dry line up with the reported latency", "[pitch]")
+{
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = 48000.0;
+    spec.maximumBlockSize = 128;
+    spec.numChannels = 2;
+
+    constexpr int impulseAt = 150;
+
+    for (const auto mode : { PitchShiftEffect::Mode::live, PitchShiftEffect::Mode::highQuality })
+    {
+        INFO("mode " << static_cast<int>(mode));
+
+        PitchShiftEffect pitch;
+        pitch.setParameter(3, static_cast<float>(mode));
+        pitch.prepare(spec);
+
+        const int latency = pitch.getLatencySamples();
+        REQUIRE(latency > 0);
+        const int length = impulseAt + latency + 400;
+
+        // 0 半音のウェットはインパルスをそのまま遅らせる
+        pitch.setParameter(2, 1.0f);
+        pitch.reset();
+        CHECK(findPeak(pitch, impulseAt, length) == impulseAt + latency);
+
+        // ドライも同じだけ遅れる（ミックスで位相がずれない）
+        pitch.setParameter(2, 0.0f);
+        pitch.reset();
+        CHECK(findPeak(pitch, impulseAt, length) == impulseAt + latency);
+    }
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/sampler/PolyphaseResampler.h"
+
+namespace
+{
+    // 振幅 0.5 の正弦波を 1/4 秒ぶん変換する
+    std::vector<float> resampleSine(double sourceRate, double targetRate, double frequency)
+    {
+        PolyphaseResampler resampler(sourceRate, targetRate);
+
+        const int numInput = static_cast<int>(sourceRate) / 4;
+        std::vector<float> input(static_cast<size_t>(numInput));
+        for (int i = 0; i < numInput; ++i)
+            input[static_cast<size_t>(i)] = 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * i / sourceRate));
+
+        std::vector<float> output(static_cast<size_t>(resampler.getOutputLength(numInput)));
+        resampler.process(input.data(), numInput, output.data(), static_cast<juce::int64>(output.size()));
+        return output;
+    }
+
+    // 端のフィルタ過渡を除き、出力レートでの理想的な正弦波との最大誤差
+    float measureSineError(const std::vector<float>& output, double targetRate, double frequency)
+    {
+        float maxError = 0.0f;
+        for (size_t i = 400; i + 400 < output.size(); ++i)
+        {
+            const auto expected = 0.5 * std::sin(juce::MathConstants<double>::twoPi * frequency * static_cast<double>(i) / targetRate);
+            maxError = juce::jmax(maxError, std::abs(output[i] - static_cast<float>(expected)));
+        }
+        return maxError;
+    }
+}
+
+TEST_CASE("PolyphaseResampler converts between session rates", "[sampler]")
+{
+    SECTION("Same rate is a copy")
+    {
+        PolyphaseResampler resampler(48000.0, 48000.0);
+        CHECK(resampler.isIdentity());
+        CHECK(resampler.getOutputLength(1000) == 1000);
+    }
+
+    SECTION("Sine keeps its frequency and level")
+    {
+        const double rates[][2] = { { 44100.0, 48000.0 }, { 48000.0, 44100.0 }, { 22050.0, 48000.0 }, { 96000.0, 44100.0 } };
+
+        for (const auto& rate : rates)
+        {
+            INFO(rate[0] << " -> " << rate[1] << " Hz");
+            const auto output = resampleSine(rate[0], rate[1], 1000.0);
+            // 22050Hz の 1/4 秒は整数サンプルにならないので、1 サンプルの丸めは許す
+            CHECK(std::abs(static_cast<double>(output.size()) - rate[1] / 4.0) <= 1.0);
+            CHECK(measureSineError(output, rate[1], 1000.0) < 1.0e-4f);
+        }
+    }
+
+    SECTION("Passband is flat up to 20 kHz")
+    {
+        // 誤差 1e-4 は振幅 0.5 に対して ±0.002dB
+        const double rates[][2] = { { 44100.0, 48000.0 }, { 48000.0, 44100.0 }, { 96000.0, 44100.0 }, { 88200.0, 48000.0 } };
+
+        for (const auto& rate : rates)
+            for (const double frequency : { 15000.0, 19000.0, 20000.0 })
+            {
+                INFO(rate[0] << " -> " << rate[1] << " Hz, " << frequency << " Hz");
+                CHECK(measureSineError(resampleSine(rate[0], rate[1], frequency), rate[1], frequency) < 1.0e-4f);
+            }
+    }
+
+    SECTION("Content above the output Nyquist does not alias")
+    {
+        // 阻止域の端（出力ナイキスト）のすぐ上から入力ナイキストの近くまで。-90dB 未満に抑える
+        const double rates[][2] = { { 96000.0, 44100.0 }, { 48000.0, 44100.0 }, { 96000.0, 48000.0 } };
+        const float limit = 0.5f * juce::Decibels::decibelsToGain(-90.0f);
+
+        for (const auto& rate : rates)
+        {
+            const double outputNyquist = 0.5 * rate[1];
+            const double inputNyquist = 0.5 * rate[0];
+            for (const double frequency : { outputNyquist * 1.01, 0.5 * (outputNyquist + inputNyquist), inputNyquist * 0.98 })
+            {
+                INFO(rate[0] << " -> " << rate[1] << " Hz, " << frequency << " Hz");
+                CHECK(measureSineError(resampleSine(rate[0], rate[1], frequency), rate[1], 0.0) < limit);
+            }
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include <catch2/catch.hpp>
+#include "../src/presets/PresetLibrary.h"
+
+namespace
+{
+    void writePreset(const juce::File& directory, const juce::String& fileName, const juce::String& name,
+                     const juce::String& tags, const juce::String& type, const juce::String& attribute, double value)
+    {
+        juce::XmlElement preset("Preset");
+        preset.setAttribute("Name", name);
+        preset.setAttribute("Tags", tags);
+        auto* effect = preset.createNewChildElement("Effect");
+        effect->setAttribute("Index", 0);
+        effect->setAttribute("Type", type);
+        effect->setAttribute(attribute, value);
+        preset.writeTo(directory.getChildFile(fileName), {});
+    }
+
+    void waitForScan(const PresetLibrary& library)
+    {
+        for (int i = 0; i < 500 && library.isScanning(); ++i)
+            juce::Thread::sleep(10);
+    }
+}
+
+TEST_CASE("PresetLibrary indexes names, tags, types and parameter values", "[presets]")
+{
+    const auto root = juce::File::getSpecialLocation(juce::File::tempDirectory).getNonexistentChildFile("PresetLibraryTest", "");
+    const auto directory = root.getChildFile("Presets");
+    const auto indexFile = root.getChildFile("PresetIndex.bin");
+    directory.createDirectory();
+
+    writePreset(directory, "a.xml", "Dusty Tape", "lofi, warm", "Filter", "Cutoff", 600.0);
+    writePreset(directory, "b.xml", "Bright Air", "clean", "Filter", "Cutoff", 9000.0);
+    writePreset(directory, "c.xml", "Dub Echo", "lofi", "Delay", "Feedback", 0.8);
+
+    {
+        PresetLibrary library(directory, indexFile);
+        waitForScan(library);
+
+        REQUIRE(library.getNumPresets() == 3);
+        CHECK(library.search("").size() == 3);
+
+        // 名前の前方一致（結果は名前順）
+        auto results = library.search("du");
+        REQUIRE(results.size() == 2);
+        CHECK(results[0].name == "Dub Echo");
+        CHECK(results[1].name == "Dusty Tape");
+
+        CHECK(library.search("tag:lofi type:filter").size() == 1);
+        CHECK(library.search("cutoff<1000").size() == 1);
+        CHECK(library.search("delay.feedback>=0.5").size() == 1);
+        CHECK(library.search("lofi cutoff>1000").empty());
+
+        // 追加したファイルだけを解析し直す
+        writePreset(directory, "d.xml", "Warm Pad", "warm", "Filter", "Cutoff", 400.0);
+        library.rescan();
+        waitForScan(library);
+        CHECK(library.search("warm").size() == 2);
+    }
+
+    // 保存したインデックスから、走査の完了前でも検索できる
+    REQUIRE(indexFile.existsAsFile());
+    {
+        PresetLibrary library(directory, indexFile);
+        waitForScan(library);
+        CHECK(library.getNumPresets() == 4);
+    }
+
+    root.deleteRecursively();
+}
@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+#include "../src/presets/PresetMorpher.h"
+#include "../src/EffectChain.h"
+
+namespace
+{
+    // フィルターとディレイのチェーンを cutoff / feedback だけ変えてプリセット化する
+    std::unique_ptr<juce::XmlElement> makePreset(float cutoff, float feedback)
+    {
+        EffectChain source;
+        source.addEffect(EffectTypeId::filter)->setParameter(0, cutoff);
+        source.addEffect(EffectTypeId::delay)->setParameter(1, feedback);
+
+        auto preset = std::make_unique<juce::XmlElement>("Preset");
+        source.saveToXml(*preset);
+        return preset;
+    }
+
+    void processBlocks(EffectChain& chain, int numBlocks)
+    {
+        juce::AudioBuffer<float> buffer(2, 512);
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            buffer.clear();
+            chain.process(buffer);
+        }
+    }
+}
+
+TEST_CASE("PresetMorpher interpolates pre-decoded presets on the audio thread", "[presets]")
+{
+    // レイアウトがパラメータを所有するので、テスト中は保持しておく
+    PresetMorpher morpher;
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    morpher.addParametersTo(layout);
+
+    EffectChain chain;
+    chain.setPresetMorpher(&morpher);
+    chain.prepare({ 44100.0, 512, 2 });
+
+    auto first = makePreset(500.0f, 0.2f);
+    auto second = makePreset(1500.0f, 0.6f);
+    auto third = makePreset(500.0f, 0.2f);
+    auto fourth = makePreset(2500.0f, 0.2f);
+
+    SECTION("The crossfader blends two presets")
+    {
+        REQUIRE(morpher.setPresets(chain, { first.get(), second.get() }));
+        REQUIRE(chain.getNumEffects() == 2);
+
+        processBlocks(chain, 1);
+        CHECK(chain.getEffect(0)->getParameter(0) == Approx(500.0f));
+
+        morpher.getXParameter()->setValue(0.5f);
+        processBlocks(chain, 4);
+        CHECK(chain.getEffect(0)->getParameter(0) == Approx(1000.0f));
+        CHECK(chain.getEffect(1)->getParameter(1) == Approx(0.4f));
+    }
+
+    SECTION("Four presets are mixed bilinearly")
+    {
+        REQUIRE(morpher.setPresets(chain, { first.get(), second.get(), third.get(), fourth.get() }));
+
+        morpher.getXParameter()->setValue(1.0f);
+        morpher.getYParameter()->setValue(0.5f);
+        processBlocks(chain, 4);
+
+        // (1, 0.5) は second と fourth の中間
+        CHECK(chain.getEffect(0)->getParameter(0) == Approx(2000.0f));
+        CHECK(chain.getEffect(1)->getParameter(1) == Approx(0.4f));
+    }
+
+    SECTION("Other counts are rejected and clearing stops the morph")
+    {
+        CHECK_FALSE(morpher.setPresets(chain, { first.get() }));
+        REQUIRE(morpher.setPresets(chain, { first.get(), second.get() }));
+        morpher.clear();
+        CHECK(morpher.getNumCorners() == 0);
+
+        morpher.getXParameter()->setValue(1.0f);
+        processBlocks(chain, 4);
+        CHECK(chain.getEffect(0)->getParameter(0) == Approx(500.0f));
+    }
+}
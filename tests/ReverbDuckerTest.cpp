@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+#include "../Source/DSP/ReverbDucker.h"
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+    constexpr int blockSize = 64;
+
+    // numBlocks ブロック分キーを流し、最後のブロックのゲインを返す
+    std::vector<float> runKey(ReverbDucker& ducker, float level, int numBlocks)
+    {
+        juce::AudioBuffer<float> key(2, blockSize);
+        std::vector<float> gains(static_cast<size_t>(blockSize));
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                key.setSample(0, i, i % 2 == 0 ? level : -level);
+                key.setSample(1, i, 0.0f);
+            }
+            ducker.process(key, 0, blockSize, gains.data());
+        }
+        return gains;
+    }
+}
+
+TEST_CASE("ReverbDucker follows the key envelope", "[reverb][ducking]")
+{
+    ReverbDucker ducker;
+    ducker.prepare(testSampleRate);
+    ducker.setParameters(0.8f, -30.0f, 5.0f, 100.0f);
+
+    SECTION("A quiet key leaves the wet signal alone")
+    {
+        const auto gains = runKey(ducker, juce::Decibels::decibelsToGain(-40.0f), 50);
+        for (float gain : gains)
+            CHECK(gain == Approx(1.0f));
+    }
+
+    SECTION("A loud key reaches the full depth and releases afterwards")
+    {
+        const auto ducked = runKey(ducker, 1.0f, 100);
+        CHECK(ducked.back() == Approx(0.2f).margin(1.0e-3));
+        CHECK(ducker.getEnvelopeDb() == Approx(0.0f).margin(0.1));
+
+        // 300ms 後はエンベロープが約 -26dB でニーの途中、十分後には元に戻る
+        runKey(ducker, 0.0f, 225);
+        CHECK(ducker.getCurrentGain() > 0.2f);
+        CHECK(ducker.getCurrentGain() < 1.0f);
+
+        runKey(ducker, 0.0f, 1500);
+        CHECK(ducker.getCurrentGain() == Approx(1.0f));
+    }
+
+    SECTION("The gain ramps per sample without steps")
+    {
+        juce::AudioBuffer<float> key(1, blockSize);
+        std::vector<float> gains(static_cast<size_t>(blockSize));
+        float previous = 1.0f;
+        float largestStep = 0.0f;
+
+        for (int block = 0; block < 20; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+                key.setSample(0, i, 0.5f);
+            ducker.process(key, 0, blockSize, gains.data());
+
+            for (float gain : gains)
+            {
+                CHECK(gain <= previous);
+                largestStep = juce::jmax(largestStep, previous - gain);
+                previous = gain;
+            }
+        }
+
+        CHECK(previous < 0.5f);
+        CHECK(largestStep < 0.02f);
+    }
+
+    SECTION("Zero amount never ducks")
+    {
+        ducker.setParameters(0.0f, -30.0f, 5.0f, 100.0f);
+        const auto gains = runKey(ducker, 1.0f, 20);
+        for (float gain : gains)
+            CHECK(gain == 1.0f);
+    }
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+#include "../Source/DSP/ReverbEffect.h"
+
+TEST_CASE("ReverbEffect parameters follow the generated table", "[reverb]")
+{
+    ReverbEffect reverb;
+
+    SECTION("Every parameter in the spec is exposed")
+    {
+        CHECK(reverb.getNumParameters() == 11);
+        CHECK(reverb.getParameterNames().size() == reverb.getNumParameters());
+        CHECK(reverb.getParameterRanges().size() == reverb.getNumParameters() * 3);
+    }
+
+    SECTION("Defaults come from the spec")
+    {
+        for (const auto& descriptor : ReverbParameters::descriptors)
+            CHECK(reverb.getParameter(descriptor.index) == Approx(descriptor.defaultValue));
+    }
+
+    SECTION("Values are clamped and booleans snapped")
+    {
+        reverb.setParameter(ReverbParameters::roomSize, 2.0f);
+        reverb.setParameter(ReverbParameters::freezeMode, 0.7f);
+
+        CHECK(reverb.getParameter(ReverbParameters::roomSize) == Approx(1.0f));
+        CHECK(reverb.getParameter(ReverbParameters::freezeMode) == Approx(1.0f));
+    }
+
+    SECTION("The reduced-rate wet path only decimates at high sample rates")
+    {
+        reverb.setReducedRateWetPath(true);
+
+        reverb.prepareToPlay(48000.0, 512);
+        CHECK(reverb.getLatencySamples() == 0);
+        CHECK(reverb.getInternalSampleRate() == Approx(48000.0));
+
+        reverb.prepareToPlay(192000.0, 512);
+        CHECK(reverb.getInternalSampleRate() == Approx(48000.0));
+        CHECK(reverb.getLatencySamples() > 0);
+
+        reverb.setReducedRateWetPath(false);
+        reverb.prepareToPlay(192000.0, 512);
+        CHECK(reverb.getLatencySamples() == 0);
+    }
+
+    SECTION("The kernel follows the output layout and mono buffers stay mono")
+    {
+        reverb.prepareToPlay(44100.0, 256, juce::AudioChannelSet::mono());
+        CHECK(reverb.getKernel() == ReverbEffect::Kernel::mono);
+
+        juce::AudioBuffer<float> monoBuffer(1, 256);
+        monoBuffer.clear();
+        reverb.processBlock(monoBuffer);
+
+        // 低減レートでもモノは1チャンネルだけを扱う
+        reverb.setReducedRateWetPath(true);
+        reverb.prepareToPlay(192000.0, 256, juce::AudioChannelSet::mono());
+        CHECK(reverb.getLatencySamples() > 0);
+        reverb.processBlock(monoBuffer);
+
+        reverb.prepareToPlay(44100.0, 256, juce::AudioChannelSet::stereo());
+        CHECK(reverb.getKernel() == ReverbEffect::Kernel::stereo);
+
+        // サラウンドは低減レートを使わない
+        reverb.prepareToPlay(192000.0, 256, juce::AudioChannelSet::create7point1point4());
+        CHECK(reverb.getKernel() == ReverbEffect::Kernel::multichannel);
+        CHECK(reverb.getLatencySamples() == 0);
+
+        juce::AudioBuffer<float> bedBuffer(12, 256);
+        bedBuffer.clear();
+        reverb.processBlock(bedBuffer);
+    }
+}
+
+TEST_CASE("ReverbEffect ducks the wet signal from the selected key", "[reverb][ducking]")
+{
+    ReverbEffect reverb;
+    reverb.setParameter(ReverbParameters::duckAmount, 1.0f);
+    reverb.setParameter(ReverbParameters::duckAttack, 1.0f);
+    reverb.prepareToPlay(48000.0, 64);
+
+    juce::AudioBuffer<float> buffer(2, 64);
+    juce::AudioBuffer<float> sidechain(2, 64);
+    auto runBlocks = [&](float inputLevel, float sidechainLevel)
+    {
+        for (int block = 0; block < 50; ++block)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 64; ++i)
+                {
+                    buffer.setSample(ch, i, inputLevel);
+                    sidechain.setSample(ch, i, sidechainLevel);
+                }
+            reverb.processBlock(buffer, &sidechain);
+        }
+    };
+
+    SECTION("The dry input keys the ducker by default")
+    {
+        runBlocks(0.0f, 1.0f);
+        CHECK(reverb.getDuckGain() == Approx(1.0f));
+
+        runBlocks(1.0f, 0.0f);
+        CHECK(reverb.getDuckGain() == Approx(0.0f).margin(1.0e-3));
+    }
+
+    SECTION("The sidechain keys the ducker when selected")
+    {
+        reverb.setParameter(ReverbParameters::duckSidechain, 1.0f);
+
+        runBlocks(1.0f, 0.0f);
+        CHECK(reverb.getDuckGain() == Approx(1.0f));
+
+        runBlocks(0.0f, 1.0f);
+        CHECK(reverb.getDuckGain() == Approx(0.0f).margin(1.0e-3));
+
+        // サイドチェインが届かなければドライ入力をキーにする
+        reverb.reset();
+        for (int block = 0; block < 50; ++block)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 64; ++i)
+                    buffer.setSample(ch, i, 1.0f);
+            reverb.processBlock(buffer, nullptr);
+        }
+        CHECK(reverb.getDuckGain() == Approx(0.0f).margin(1.0e-3));
+    }
+
+    SECTION("Ducking settings are saved with the preset")
+    {
+        reverb.setParameter(ReverbParameters::duckThreshold, -18.0f);
+        reverb.setParameter(ReverbParameters::duckSidechain, 1.0f);
+
+        juce::XmlElement xml("Reverb");
+        reverb.saveToXml(xml);
+
+        ReverbEffect loaded;
+        loaded.loadFromXml(xml);
+        CHECK(loaded.getParameter(ReverbParameters::duckAmount) == Approx(1.0f));
+        CHECK(loaded.getParameter(ReverbParameters::duckThreshold) == Approx(-18.0f));
+        CHECK(loaded.getParameter(ReverbParameters::duckSidechain) == Approx(1.0f));
+    }
+}
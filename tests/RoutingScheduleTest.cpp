@@ -0,0 +1,271 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/RoutingSchedule.h"
+#include "../src/EffectChain.h"
+#include <algorithm>
+
+namespace
+{
+    using Connection = RoutingSchedule::Connection;
+    using Type = RoutingSchedule::Step::Type;
+
+    int countSteps(const RoutingSchedule& schedule, Type type)
+    {
+        int count = 0;
+        for (const auto& step : schedule.getSteps())
+            if (step.type == type)
+                ++count;
+        return count;
+    }
+}
+
+TEST_CASE("RoutingSchedule compiles graphs into flat steps", "[routing]")
+{
+    RoutingSchedule schedule;
+
+    SECTION("A series chain runs in place on the host bus")
+    {
+        REQUIRE(schedule.compile(4, RoutingSchedule::makeSeries(4), 8));
+        CHECK(schedule.getNumBuses() == 1);
+        CHECK(schedule.getSteps().size() == 4);
+        CHECK(countSteps(schedule, Type::process) == 4);
+        CHECK(schedule.getExecutionOrder() == std::vector<int> { 0, 1, 2, 3 });
+    }
+
+    SECTION("A parallel split and mix needs one extra bus")
+    {
+        // 入力 → 0 → (1 | 2) → 3 → 出力
+        const std::vector<Connection> connections {
+            { RoutingSchedule::inputNode, 0, 1.0f },
+            { 0, 1, 1.0f }, { 0, 2, 0.5f },
+            { 1, 3, 1.0f }, { 2, 3, 1.0f },
+            { 3, RoutingSchedule::outputNode, 1.0f }
+        };
+        REQUIRE(schedule.compile(4, connections, 8));
+        CHECK(schedule.getNumBuses() == 2);
+        CHECK(countSteps(schedule, Type::process) == 4);
+        CHECK(countSteps(schedule, Type::add) == 1);
+    }
+
+    SECTION("Width, not node count, decides the number of buses")
+    {
+        // 2本ずつの並列を直列に4段つなぐ
+        std::vector<Connection> connections;
+        int previous = RoutingSchedule::inputNode;
+        for (int stage = 0; stage < 4; ++stage)
+        {
+            const int a = stage * 3;
+            const int b = stage * 3 + 1;
+            const int mix = stage * 3 + 2;
+            connections.push_back({ previous, a, 1.0f });
+            connections.push_back({ previous, b, 1.0f });
+            connections.push_back({ a, mix, 1.0f });
+            connections.push_back({ b, mix, 1.0f });
+            previous = mix;
+        }
+        connections.push_back({ previous, RoutingSchedule::outputNode, 1.0f });
+
+        REQUIRE(schedule.compile(12, connections, 8));
+        CHECK(schedule.getNumBuses() == 2);
+        CHECK(countSteps(schedule, Type::process) == 12);
+    }
+
+    SECTION("A dry send to the output is mixed on the host bus")
+    {
+        const std::vector<Connection> connections {
+            { RoutingSchedule::inputNode, 0, 1.0f },
+            { RoutingSchedule::inputNode, RoutingSchedule::outputNode, 0.5f },
+            { 0, RoutingSchedule::outputNode, 1.0f }
+        };
+        REQUIRE(schedule.compile(1, connections, 8));
+        CHECK(schedule.getNumBuses() == 2);
+
+        const auto& last = schedule.getSteps().back();
+        CHECK(last.destination == 0);
+        CHECK(last.type == Type::add);
+    }
+
+    SECTION("Cycles and overly wide graphs are rejected")
+    {
+        const std::vector<Connection> cycle {
+            { RoutingSchedule::inputNode, 0, 1.0f }, { 0, 1, 1.0f }, { 1, 0, 1.0f },
+            { 1, RoutingSchedule::outputNode, 1.0f }
+        };
+        CHECK_FALSE(schedule.compile(2, cycle, 8));
+
+        std::vector<Connection> wide;
+        for (int node = 0; node < 4; ++node)
+        {
+            wide.push_back({ RoutingSchedule::inputNode, node, 1.0f });
+            wide.push_back({ node, RoutingSchedule::outputNode, 1.0f });
+        }
+        CHECK(schedule.compile(4, wide, 4));
+        CHECK_FALSE(schedule.compile(4, wide, 3));
+    }
+
+    SECTION("Nodes that do not reach the output are skipped")
+    {
+        const std::vector<Connection> connections {
+            { RoutingSchedule::inputNode, 0, 1.0f }, { RoutingSchedule::inputNode, 1, 1.0f },
+            { 0, RoutingSchedule::outputNode, 1.0f }
+        };
+        REQUIRE(schedule.compile(2, connections, 8));
+        CHECK(schedule.getExecutionOrder() == std::vector<int> { 0 });
+    }
+}
+
+TEST_CASE("RoutingSchedule compensates latency on parallel paths", "[routing][latency]")
+{
+    RoutingSchedule schedule;
+
+    SECTION("A series chain sums latency without compensating delays")
+    {
+        REQUIRE(schedule.compile(3, RoutingSchedule::makeSeries(3), 8, { 10, 0, 5 }));
+        CHECK(schedule.getLatencySamples() == 15);
+        CHECK(schedule.getMaxDelay() == 0);
+        for (const auto& step : schedule.getSteps())
+            CHECK(step.delay == 0);
+    }
+
+    SECTION("The faster branch is delayed to meet the slower one")
+    {
+        // 入力 → (0 | 1) → 出力、さらにドライを直接出力へ
+        const std::vector<Connection> connections {
+            { RoutingSchedule::inputNode, 0, 1.0f }, { RoutingSchedule::inputNode, 1, 1.0f },
+            { 0, RoutingSchedule::outputNode, 1.0f }, { 1, RoutingSchedule::outputNode, 1.0f },
+            { RoutingSchedule::inputNode, RoutingSchedule::outputNode, 0.5f }
+        };
+        REQUIRE(schedule.compile(2, connections, 8, { 100, 30 }));
+        CHECK(schedule.getLatencySamples() == 100);
+        CHECK(schedule.getMaxDelay() == 100);
+
+        std::vector<int> delays;
+        for (const auto& step : schedule.getSteps())
+            if (step.delay > 0)
+                delays.push_back(step.delay);
+        std::sort(delays.begin(), delays.end());
+        CHECK(delays == std::vector<int> { 70, 100 });
+    }
+}
+
+TEST_CASE("EffectChain mixes parallel paths with their send gains", "[routing]")
+{
+    EffectChain chain;
+    auto* first = chain.addEffect(EffectTypeId::distortion);
+    auto* second = chain.addEffect(EffectTypeId::distortion);
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+
+    // 無効なエフェクトは素通しなので、出力はゲインの和になる
+    first->setEnabled(false);
+    second->setEnabled(false);
+    chain.prepare({ 48000.0, 512, 2 });
+
+    const auto a = first->getInstanceId();
+    const auto b = second->getInstanceId();
+    REQUIRE(chain.addConnection({ EffectChain::inputNodeId, a, 0.5f }));
+    REQUIRE(chain.addConnection({ EffectChain::inputNodeId, b, 0.25f }));
+    REQUIRE(chain.addConnection({ a, EffectChain::outputNodeId, 1.0f }));
+    REQUIRE(chain.addConnection({ b, EffectChain::outputNodeId, 1.0f }));
+    REQUIRE(chain.addConnection({ EffectChain::inputNodeId, EffectChain::outputNodeId, 1.0f }));
+
+    juce::AudioBuffer<float> buffer(2, 200);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(ch, i, 0.5f);
+    chain.process(buffer);
+
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            CHECK(buffer.getSample(ch, i) == Approx(0.5f * 1.75f));
+
+    SECTION("Cycles are rejected and the graph stays intact")
+    {
+        REQUIRE(chain.addConnection({ a, b, 1.0f }));
+        CHECK_FALSE(chain.addConnection({ b, a, 1.0f }));
+        CHECK(chain.getConnections().size() == 6);
+    }
+
+    SECTION("Routing survives a save and load")
+    {
+        juce::XmlElement xml("Chain");
+        chain.saveToXml(xml);
+
+        EffectChain loaded;
+        loaded.prepare({ 48000.0, 512, 2 });
+        loaded.loadFromXml(xml);
+        CHECK(loaded.getConnections().size() == chain.getConnections().size());
+    }
+
+    SECTION("Removing an effect drops its connections")
+    {
+        chain.removeEffect(0);
+        CHECK(chain.getConnections().size() == 3);
+    }
+}
+
+TEST_CASE("EffectChain delays a dry send to line up with a latent effect", "[routing][latency]")
+{
+    EffectChain chain;
+    auto* pitch = chain.addEffect(EffectTypeId::pitchShift);
+    REQUIRE(pitch != nullptr);
+    pitch->setParameter(2, 0.0f); // ドライのみ（レイテンシ分遅れて出る）
+    chain.prepare({ 48000.0, 512, 2 });
+
+    const int latency = pitch->getLatencySamples();
+    REQUIRE(latency > 0);
+    REQUIRE(chain.addConnection({ EffectChain::inputNodeId, pitch->getInstanceId(), 1.0f }));
+    REQUIRE(chain.addConnection({ pitch->getInstanceId(), EffectChain::outputNodeId, 1.0f }));
+    REQUIRE(chain.addConnection({ EffectChain::inputNodeId, EffectChain::outputNodeId, 1.0f }));
+    CHECK(chain.getLatencySamples() == latency);
+
+    juce::AudioBuffer<float> buffer(2, latency + 256);
+    buffer.clear();
+    buffer.setSample(0, 0, 1.0f);
+    chain.process(buffer);
+
+    // 両方の経路が同じサンプルに揃う
+    CHECK(buffer.getSample(0, latency) == Approx(2.0f).margin(1.0e-4));
+    CHECK(buffer.getSample(0, 0) == Approx(0.0f).margin(1.0e-4));
+
+    SECTION("Disabling the effect is picked up as a latency change")
+    {
+        pitch->setEnabled(false);
+        CHECK(chain.isLatencyCompensationStale());
+        chain.updateLatencyCompensation();
+        CHECK(chain.getLatencySamples() == 0);
+
+        chain.process(buffer);
+        CHECK_FALSE(chain.isLatencyCompensationStale());
+        CHECK(chain.getProcessingLatencySamples() == 0);
+    }
+}
+
+TEST_CASE("EffectChain handles host blocks longer than the prepared size", "[routing]")
+{
+    // ホストは prepare より長いブロックを渡すことがある。サブブロック (64) は prepare の 32 より長い
+    EffectChain chain;
+    auto* first = chain.addEffect(EffectTypeId::distortion);
+    auto* second = chain.addEffect(EffectTypeId::delay);
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+    chain.prepare({ 48000.0, 32, 2 });
+    REQUIRE(chain.getSubBlockScheduler().getSubBlockSize() > 32);
+
+    // 並列の経路は作業バスを使う
+    const auto a = first->getInstanceId();
+    const auto b = second->getInstanceId();
+    REQUIRE(chain.addConnection({ EffectChain::inputNodeId, a, 0.5f }));
+    REQUIRE(chain.addConnection({ EffectChain::inputNodeId, b, 0.5f }));
+    REQUIRE(chain.addConnection({ a, EffectChain::outputNodeId, 1.0f }));
+    REQUIRE(chain.addConnection({ b, EffectChain::outputNodeId, 1.0f }));
+
+    juce::AudioBuffer<float> buffer(2, 1000);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(ch, i, 0.25f * std::sin(0.01f * static_cast<float>(i)));
+    chain.process(buffer);
+
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            REQUIRE(std::isfinite(buffer.getSample(ch, i)));
+}
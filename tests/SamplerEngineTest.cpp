@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/sampler/SamplerEngine.h"
+
+namespace
+{
+    // フレーム番号そのものを値にするモノラルのリーダー（どのフレームも値が異なり、float で正確に表せる）
+    float rampValue(juce::int64 frame)
+    {
+        return static_cast<float>(frame) / 262144.0f;
+    }
+
+    class RampReader : public juce::AudioFormatReader
+    {
+    public:
+        explicit RampReader(juce::int64 length)
+            : juce::AudioFormatReader(nullptr, "Ramp")
+        {
+            sampleRate = 48000.0;
+            lengthInSamples = length;
+            numChannels = 1;
+            bitsPerSample = 32;
+            usesFloatingPointData = true;
+        }
+
+        bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                         juce::int64 startSampleInFile, int numSamples) override
+        {
+            for (int ch = 0; ch < numDestChannels; ++ch)
+                if (destChannels[ch] != nullptr)
+                {
+                    auto* dest = reinterpret_cast<float*>(destChannels[ch]) + startOffsetInDestBuffer;
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const juce::int64 frame = startSampleInFile + i;
+                        dest[i] = frame < lengthInSamples ? rampValue(frame) : 0.0f;
+                    }
+                }
+            return true;
+        }
+    };
+
+    // パッド1を triggers の位置で鳴らした出力と、モノフォニックなパッドとして期待される出力を比べる
+    struct Render
+    {
+        std::vector<float> output;
+        std::vector<float> expected;
+    };
+
+    Render renderTriggers(SamplerEngine& engine, juce::int64 sampleLength, const std::vector<int>& triggers, int totalLength)
+    {
+        // prepare より大きなブロックで処理する
+        constexpr int hostBlockSize = 1000;
+        Render render;
+
+        for (int start = 0; start < totalLength; start += hostBlockSize)
+        {
+            juce::AudioBuffer<float> buffer(2, hostBlockSize);
+            buffer.clear();
+
+            juce::MidiBuffer midi;
+            for (const int trigger : triggers)
+                if (trigger >= start && trigger < start + hostBlockSize)
+                    midi.addEvent(juce::MidiMessage::noteOn(1, SamplerEngine::firstPadNote, 1.0f), trigger - start);
+
+            engine.process(buffer, midi);
+            for (int i = 0; i < hostBlockSize; ++i)
+                render.output.push_back(buffer.getSample(1, i));
+
+            // ストリーマーが実時間より先に読み込めるだけの間を空ける
+            juce::Thread::sleep(1);
+        }
+
+        // 次のトリガーでフェードアウトし、サンプルの終わりで止まる
+        render.expected.assign(render.output.size(), 0.0f);
+        for (size_t v = 0; v < triggers.size(); ++v)
+        {
+            const int fadeStart = v + 1 < triggers.size() ? triggers[v + 1] : totalLength;
+            for (int n = triggers[v]; n < static_cast<int>(render.expected.size()); ++n)
+            {
+                const juce::int64 frame = n - triggers[v];
+                const int faded = n - fadeStart;
+                if (frame >= sampleLength || faded >= SamplerEngine::fadeOutFrames)
+                    break;
+
+                const float gain = faded < 0 ? 1.0f
+                                 : static_cast<float>(SamplerEngine::fadeOutFrames - faded) / SamplerEngine::fadeOutFrames;
+                render.expected[static_cast<size_t>(n)] += gain * rampValue(frame);
+            }
+        }
+        return render;
+    }
+
+    int countMismatches(const Render& render)
+    {
+        int mismatches = 0;
+        for (size_t i = 0; i < render.output.size(); ++i)
+            if (std::abs(render.output[i] - render.expected[i]) > 1.0e-6f)
+                ++mismatches;
+        return mismatches;
+    }
+}
+
+TEST_CASE("SamplerEngine streams past the head sample-accurately", "[sampler]")
+{
+    // ヘッドの2倍より長いのでストリーミングになる
+    const juce::int64 sampleLength = SamplerEngine::headFrames * 2 + 30000;
+
+    SamplerEngine engine;
+    engine.prepare(48000.0, 256);
+    const auto sample = PadSample::createFromReader(std::make_unique<RampReader>(sampleLength), juce::File(), SamplerEngine::headFrames);
+    REQUIRE(sample != nullptr);
+    REQUIRE(sample->needsStreaming());
+    REQUIRE(engine.setPadSample(0, sample));
+
+    const auto render = renderTriggers(engine, sampleLength, { 300 }, static_cast<int>(sampleLength) + 2000);
+
+    CHECK(engine.getNumStreamUnderruns() == 0);
+    CHECK(countMismatches(render) == 0);
+    CHECK(render.output.back() == 0.0f);
+}
+
+TEST_CASE("SamplerEngine recycles stream slots across retriggers", "[sampler]")
+{
+    const juce::int64 sampleLength = SamplerEngine::headFrames * 2 + 30000;
+
+    SamplerEngine engine;
+    engine.prepare(48000.0, 256);
+    REQUIRE(engine.setPadSample(0, PadSample::createFromReader(std::make_unique<RampReader>(sampleLength), juce::File(), SamplerEngine::headFrames)));
+
+    // ヘッドの再生中にスロット数より多く再トリガーし（要求したスロットを読み込み前に返却する）、
+    // ストリーミング中の発音のフェード中にもう一度再トリガーする。最後の発音は最後まで途切れずに鳴る
+    std::vector<int> triggers { 300 };
+    for (int i = 1; i <= SampleStreamer::numSlots + 4; ++i)
+        triggers.push_back(1000 * i + 10);
+
+    const int streamingRetrigger = triggers.back() + SamplerEngine::headFrames + 5000;
+    triggers.push_back(streamingRetrigger);
+    triggers.push_back(streamingRetrigger + 20);
+
+    const auto render = renderTriggers(engine, sampleLength, triggers, triggers.back() + static_cast<int>(sampleLength) + 2000);
+
+    CHECK(engine.getNumStreamUnderruns() == 0);
+    CHECK(countMismatches(render) == 0);
+}
@@ -0,0 +1,51 @@
+#include <catch2/catch.hpp>
+#include "../src/audio/SubBlockScheduler.h"
+#include <vector>
+
+TEST_CASE("SubBlockScheduler slices host blocks into fixed sub-blocks", "[scheduler]")
+{
+    SubBlockScheduler scheduler;
+    REQUIRE(scheduler.getSubBlockSize() == SubBlockScheduler::defaultSubBlockSize);
+
+    SECTION("The size is clamped to the cache-sized range")
+    {
+        scheduler.setSubBlockSize(8);
+        CHECK(scheduler.getSubBlockSize() == SubBlockScheduler::minSubBlockSize);
+        scheduler.setSubBlockSize(4096);
+        CHECK(scheduler.getSubBlockSize() == SubBlockScheduler::maxSubBlockSize);
+
+        CHECK(scheduler.getMaximumBlockSize() == SubBlockScheduler::maxSubBlockSize);
+    }
+
+    SECTION("Every host size is covered exactly once, in order")
+    {
+        for (int hostSize : { 1, 17, 63, 64, 65, 1000, 8192 })
+        {
+            juce::AudioBuffer<float> buffer(2, hostSize);
+            buffer.clear();
+
+            std::vector<int> sizes;
+            int expectedStart = 0;
+            scheduler.process(buffer, [&](juce::AudioBuffer<float>& subBlock, int start)
+            {
+                CHECK(start == expectedStart);
+                CHECK(subBlock.getNumChannels() == 2);
+                CHECK(subBlock.getNumSamples() <= scheduler.getSubBlockSize());
+
+                // サブブロックへの書き込みはホストのバッファへそのまま届く
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < subBlock.getNumSamples(); ++i)
+                        subBlock.getWritePointer(ch)[i] += 1.0f;
+
+                expectedStart += subBlock.getNumSamples();
+                sizes.push_back(subBlock.getNumSamples());
+            });
+
+            CHECK(expectedStart == hostSize);
+            CHECK(static_cast<int>(sizes.size()) == (hostSize + scheduler.getSubBlockSize() - 1) / scheduler.getSubBlockSize());
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < hostSize; ++i)
+                    REQUIRE(buffer.getSample(ch, i) == 1.0f);
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+int main(int argc, char* argv[])
+{
+    // ChangeBroadcaster や Timer を使うテストのためにメッセージマネージャを用意しておく
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    // PluginTests.cpp は juce::UnitTest なので、Catch2 のテストの前に JUCE のランナーで走らせる
+    juce::UnitTestRunner runner;
+    runner.runAllTests();
+
+    int juceFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        juceFailures += runner.getResult(i)->failures;
+
+    const int catchFailures = Catch::Session().run(argc, argv);
+    return (juceFailures > 0 || catchFailures != 0) ? 1 : 0;
+}
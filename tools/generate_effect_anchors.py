@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+"""KRUMP_REGISTER_EFFECT を書いたエフェクトの .cpp から、リンクアンカーを参照するヘッダーを生成する。
+
+使い方: generate_effect_anchors.py <出力ヘッダー> <エフェクトの .cpp>...
+
+EffectRegistry.cpp がこのヘッダーを読み、静的ライブラリから登録オブジェクトが捨てられないようにする。
+エフェクトを追加しても EffectRegistry.cpp を編集しなくてよい。
+"""
+
+import re
+import sys
+
+REGISTRATION = re.compile(r"^\s*KRUMP_REGISTER_EFFECT\(\s*([A-Za-z_][A-Za-z0-9_]*)\s*,", re.MULTILINE)
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("usage: generate_effect_anchors.py <output.h> <effect sources>...\n")
+        return 1
+
+    classes = []
+    for path in sorted(sys.argv[2:]):
+        with open(path, encoding="utf-8") as f:
+            classes += REGISTRATION.findall(f.read())
+
+    out = ["// generate_effect_anchors.py が生成する。編集しないこと", "#pragma once", ""]
+    out.append("#define KRUMP_LINK_BUILT_IN_EFFECTS() \\")
+    out += ["    KRUMP_LINK_EFFECT({}) \\".format(name) for name in classes]
+    out.append("")
+    header = "\n".join(out) + "\n"
+
+    # 内容が変わらないときは書き込まず、不要な再コンパイルを避ける
+    # （再実行の判定は CMakeLists.txt 側のスタンプファイルで行う）
+    try:
+        with open(sys.argv[1], encoding="utf-8") as f:
+            if f.read() == header:
+                return 0
+    except OSError:
+        pass
+
+    with open(sys.argv[1], "w", encoding="utf-8") as f:
+        f.write(header)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
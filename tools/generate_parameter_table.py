@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""src/specs/project_spec.yaml の dsp_effects からパラメータ記述子テーブル (constexpr) を生成する。
+
+使い方: generate_parameter_table.py <project_spec.yaml> <出力ヘッダー>
+
+ビルド環境に PyYAML を要求しないよう、仕様ファイルで使っている範囲の YAML
+（インデントによるマップ/リスト、インライン配列、引用符付き文字列、ブロックスカラー）だけを解釈する。
+"""
+
+import re
+import sys
+
+
+def parse_scalar(text):
+    text = text.strip()
+    if text.startswith("[") and text.endswith("]"):
+        inner = text[1:-1].strip()
+        return [parse_scalar(item) for item in inner.split(",")] if inner else []
+    if len(text) >= 2 and text[0] == text[-1] and text[0] in "\"'":
+        return text[1:-1]
+    if text in ("true", "false"):
+        return text == "true"
+    try:
+        return int(text)
+    except ValueError:
+        pass
+    try:
+        return float(text)
+    except ValueError:
+        return text
+
+
+def strip_comment(line):
+    # 引用符の外にある " #" 以降をコメントとして除く
+    quote = None
+    for i, ch in enumerate(line):
+        if ch in "\"'":
+            quote = None if quote == ch else (ch if quote is None else quote)
+        elif ch == "#" and quote is None and (i == 0 or line[i - 1] in " \t"):
+            return line[:i].rstrip()
+    return line.rstrip()
+
+
+def tokenize(path):
+    lines = []
+    with open(path, encoding="utf-8") as f:
+        raw = f.read().splitlines()
+
+    i = 0
+    while i < len(raw):
+        line = strip_comment(raw[i])
+        i += 1
+        if not line.strip():
+            continue
+        indent = len(line) - len(line.lstrip(" "))
+        lines.append((indent, line.strip()))
+
+        # ブロックスカラー (key: |) の本文は読み飛ばす
+        if re.match(r"^[^:]+:\s*[|>][-+]?$", line.strip()):
+            while i < len(raw) and (not raw[i].strip() or len(raw[i]) - len(raw[i].lstrip(" ")) > indent):
+                i += 1
+    return lines
+
+
+def parse_block(lines, pos, indent):
+    """lines[pos] から始まる indent のブロックを解釈し、(値, 次の位置) を返す"""
+    if lines[pos][1].startswith("- ") or lines[pos][1] == "-":
+        result = []
+        while pos < len(lines) and lines[pos][0] == indent and lines[pos][1].startswith("-"):
+            content = lines[pos][1][1:].strip()
+            if not content:
+                value, pos = parse_block(lines, pos + 1, lines[pos + 1][0])
+                result.append(value)
+                continue
+            if re.match(r"^[\w\-]+:(\s|$)", content):
+                # "- key: value" はマップの先頭要素。続くキーは item_indent に揃う
+                item_indent = indent + 2
+                synthetic = [(item_indent, content)]
+                pos += 1
+                while pos < len(lines) and lines[pos][0] >= item_indent:
+                    synthetic.append(lines[pos])
+                    pos += 1
+                value, _ = parse_block(synthetic, 0, item_indent)
+                result.append(value)
+            else:
+                result.append(parse_scalar(content))
+                pos += 1
+        return result, pos
+
+    result = {}
+    while pos < len(lines) and lines[pos][0] == indent and not lines[pos][1].startswith("- "):
+        key, _, rest = lines[pos][1].partition(":")
+        rest = rest.strip()
+        pos += 1
+        if rest and not re.match(r"^[|>][-+]?$", rest):
+            result[key.strip()] = parse_scalar(rest)
+        elif pos < len(lines) and lines[pos][0] > indent:
+            result[key.strip()], pos = parse_block(lines, pos, lines[pos][0])
+        elif pos < len(lines) and lines[pos][0] == indent and lines[pos][1].startswith("-"):
+            # YAML ではリストがキーと同じインデントに置ける
+            result[key.strip()], pos = parse_block(lines, pos, indent)
+        else:
+            result[key.strip()] = None
+    return result, pos
+
+
+def to_camel_case(identifier):
+    head, *tail = identifier.split("_")
+    return head + "".join(word.capitalize() for word in tail)
+
+
+def cpp_float(value):
+    return repr(float(value)) + "f"
+
+
+def cpp_string(value):
+    return '"' + str(value).replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def generate(spec):
+    effects = spec["project_specification"]["features"]["dsp_effects"]
+
+    out = [
+        "// 自動生成ファイル: tools/generate_parameter_table.py が src/specs/project_spec.yaml から生成する。",
+        "// 直接編集せず、仕様ファイルを変更すること。",
+        "#pragma once",
+        "",
+        "#include <array>",
+        "#include <string_view>",
+        "",
+        "namespace KrumpParameters",
+        "{",
+        "    enum class Type",
+        "    {",
+        "        floatValue,",
+        "        boolValue",
+        "    };",
+        "",
+        "    struct Descriptor",
+        "    {",
+        "        std::string_view id;        // APVTS / ホストのパラメータID（保存済みセッションとの互換のため固定）",
+        "        std::string_view specId;    // 仕様ファイル上のID",
+        "        std::string_view name;",
+        "        std::string_view unit;",
+        "        Type type;",
+        "        float minimum;",
+        "        float maximum;",
+        "        float defaultValue;",
+        "        int index;",
+        "    };",
+        "}",
+    ]
+
+    for effect in effects:
+        parameters = sorted(effect.get("parameters") or [], key=lambda p: p.get("order", 0))
+        namespace = re.sub(r"\W", "", effect["name"]) + "Parameters"
+
+        out += ["", "namespace " + namespace, "{"]
+        out += ["    enum Index : int", "    {"]
+        for i, parameter in enumerate(parameters):
+            out.append("        {}{},".format(to_camel_case(parameter["id"]), " = 0" if i == 0 else ""))
+        out += ["        numParameters", "    };", ""]
+
+        out.append("    inline constexpr std::array<KrumpParameters::Descriptor, numParameters> descriptors")
+        out.append("    {{")
+        for parameter in parameters:
+            is_bool = parameter.get("type") == "bool"
+            minimum, maximum = parameter.get("range", [0.0, 1.0])
+            default = parameter.get("default", minimum)
+            if isinstance(default, bool):
+                default = 1.0 if default else 0.0
+            out.append("        {{ {}, {}, {}, {}, KrumpParameters::Type::{}, {}, {}, {}, {} }},".format(
+                cpp_string(parameter.get("host_id", parameter["id"])),
+                cpp_string(parameter["id"]),
+                cpp_string(parameter.get("label", parameter["id"])),
+                cpp_string(parameter.get("unit", "")),
+                "boolValue" if is_bool else "floatValue",
+                cpp_float(minimum), cpp_float(maximum), cpp_float(default),
+                to_camel_case(parameter["id"])))
+        out.append("    }};")
+        out += ["", "    constexpr const KrumpParameters::Descriptor& get(Index index) { return descriptors[static_cast<size_t>(index)]; }"]
+        out.append("}")
+
+    return "\n".join(out) + "\n"
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write("usage: generate_parameter_table.py <project_spec.yaml> <output.h>\n")
+        return 1
+
+    lines = tokenize(sys.argv[1])
+    spec, _ = parse_block(lines, 0, lines[0][0])
+    header = generate(spec)
+
+    # 内容が変わらないときは書き込まず、不要な再コンパイルを避ける
+    # （再実行の判定は CMakeLists.txt 側のスタンプファイルで行う）
+    try:
+        with open(sys.argv[2], encoding="utf-8") as f:
+            if f.read() == header:
+                return 0
+    except OSError:
+        pass
+
+    with open(sys.argv[2], "w", encoding="utf-8") as f:
+        f.write(header)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())